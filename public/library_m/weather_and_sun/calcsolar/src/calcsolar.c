@@ -40,6 +40,9 @@
  * Version  Author          Changes                             Date
  * 3.1.0    Bernd Hafner(hf)created                             25dec2008
  * 6.1.0    hf              changed loop for SOLARTIME          04oct2014
+ * 6.2.0    hf              time vector with carlib batch call  19oct2026
+ *                          solar_ephemeris_batch, no indexing
+ *                          beyond scalar inputs
  *
  *
  * 
@@ -68,7 +71,7 @@
 void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
 {
     double *x, *t, *prop, *lat, *lon, *lon0;
-    int    rows, num, cols, m, n, i, matrix;
+    int    rows, num, cols, m, n, i, type, matrix;
   
     /* Check for proper number of arguments. */
     if (nrhs != 5) 
@@ -99,6 +102,7 @@ void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
     rows = 1;
     cols = 1;
     num = 0;
+    matrix = 0;
     for (i = 0; i < 3; i++) {
         m = (int_T)(mxGetM(prhs[i]));
         n = (int_T)(mxGetN(prhs[i]));
@@ -125,31 +129,51 @@ void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
     x = mxGetPr(plhs[0]);
 
     /* call the required calculation */
-    for (n = 0; n < num; n++)                               /* loop over vector length */
-    {        
-        switch ((int)(prop[0]+0.5))
+    type = (int)(prop[0]+0.5);
+    if (matrix == 0)                                        /* time is the vector */
+    {
+        switch (type)
         {
-            case EXTRATERRARADIATION:
-                x[n] = extraterrestrial_radiation(t[n]);    /* call function for extraterrestrial solar radiation in carlib */
+            case EXTRATERRARADIATION:                       /* extraterrestrial solar radiation in carlib */
+                solar_ephemeris_batch(NULL, NULL, x, num, t, 0.0, 0.0);
                 break;
-            case DECLINATION:
-                x[n] = RAD2DEG*solar_declination(t[n]);     /* call solar declination in carlib and transfer result to degrees */
+            case DECLINATION:                               /* solar declination in carlib */
+                solar_ephemeris_batch(x, NULL, NULL, num, t, 0.0, 0.0);
+                for (n = 0; n < num; n++)
+                    x[n] = RAD2DEG*x[n];                    /* transfer result to degrees */
                 break;
-            case SOLARTIME:
-                if (matrix == 0)                            /* time is the vector */
-                    x[n] = solar_time(t[n],lon0[0],lon[0]); /* call function for solar time in carlib */
-                else if (matrix == 1)                       /* ref-longitude is the vector */
-                    x[n] = solar_time(t[0],lon0[n],lon[0]); /* call function for solar time in carlib */
-                else if (matrix == 2)                       /* longitude is the vector */
-                    x[n] = solar_time(t[0],lon0[0],lon[n]); /* call function for solar time in carlib */
-                else
-                    x[n] = 0.0;
+            case SOLARTIME:                                 /* solar time in carlib */
+                solar_ephemeris_batch(NULL, x, NULL, num, t, lon0[0], lon[0]);
                 break;
             default:
             case SOLARPOSITION:
                 break;
         } /* end switch */
-    } /* end for n */
+    }
+    else                                                    /* time is a scalar */
+    {
+        for (n = 0; n < num; n++)                           /* loop over vector length */
+        {        
+            switch (type)
+            {
+                case EXTRATERRARADIATION:
+                    x[n] = extraterrestrial_radiation(t[0]);
+                    break;
+                case DECLINATION:
+                    x[n] = RAD2DEG*solar_declination(t[0]);
+                    break;
+                case SOLARTIME:
+                    if (matrix == 2)                        /* longitude is the vector */
+                        x[n] = solar_time(t[0],lon0[0],lon[n]);
+                    else                                    /* latitude does not change the solar time */
+                        x[n] = solar_time(t[0],lon0[0],lon[0]);
+                    break;
+                default:
+                case SOLARPOSITION:
+                    break;
+            } /* end switch */
+        } /* end for n */
+    }
 
     return;
 }
@@ -0,0 +1,180 @@
+function [v, s] = verify_calcsolar(varargin)
+% verification of the time vector path of calcsolar and sunangles: the 
+% results must be exactly the same as the scalar functions of carlib.
+%  - calcsolar with a time vector (solar_ephemeris_batch) is compared with
+%    calcsolar for each single time and a latitude vector, which calls 
+%    solar_declination, solar_time and extraterrestrial_radiation
+%  - sunangles (solar_position_batch) is compared with the block sunpos
+%    (solar_position), declination and hour angle with calcsolar. The 
+%    block sunpos interpolates the angles in the steps with sunrise or 
+%    sunset, these steps are not compared.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_calcsolar(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_calcsolar' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_calcsolar:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0;          % results must be exactly the same
+
+% ---------- set model file or function name ------------------------------
+functionname = 'calcsolar';
+
+latitude = 52.4;        % Potsdam
+longitude = -13.1;
+longitude_timezone = -15;
+% two years with a time step which is not a divisor of the hour, also 
+% negative times
+time = (-3*86400:1234.5:2*365*86400)';
+
+%% -------------- calcsolar with the time vector and for each time --------
+% type 1: extraterrestrial radiation, 2: declination, 3: solar time
+% with a scalar time and a latitude vector calcsolar calls the scalar 
+% functions (the latitude is not used by these types)
+y0 = zeros(length(time), 3);
+y2 = zeros(length(time), 3);
+for type = 1:3
+    y2(:,type) = calcsolar(time, latitude, longitude, longitude_timezone, type);
+    for n = 1:length(time)
+        x = calcsolar(time(n), [latitude; latitude], longitude, longitude_timezone, type);
+        y0(n,type) = x(1);
+    end
+end
+e1 = max(max(abs(y0-y2)));
+
+%% -------------- sunangles and the block sunpos --------------------------
+mdl = 'verify_calcsolar_mdl';
+tstep = 1800;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/sunpos'], ...
+    'FunctionName', 'sunpos', 'Parameters', ...
+    sprintf('%g, %g, %g', longitude, latitude, longitude_timezone));
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'sunpos/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(365*86400), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout', ...
+    'SaveTime', 'on', 'TimeSaveName', 'tout');
+yy = simOut.get('yout');        % zenith, azimuth in degree
+tt = simOut.get('tout');
+close_system(mdl, 0)            % close system, but do not save it
+
+% [Declination Altitude Zenith Azimut HourAngle] = sunangles(...)
+[decl, ~, zenith, azimut, hourangle] = ...
+    sunangles(tt, latitude, longitude, longitude_timezone);
+% steps with sunrise or sunset are interpolated by sunpos
+sunset = [false; (90-zenith(1:end-1)).*(90-zenith(2:end)) < 0];
+e2 = max(max(abs(yy(~sunset,:) - [zenith(~sunset), azimut(~sunset)])));
+% declination and hour angle from the scalar functions
+dref = zeros(length(tt), 1);
+href = zeros(length(tt), 1);
+for n = 1:length(tt)
+    x = calcsolar(tt(n), [latitude; latitude], longitude, longitude_timezone, 2);
+    dref(n) = x(1);
+    x = calcsolar(tt(n), [latitude; latitude], longitude, longitude_timezone, 3);
+    href(n) = (x(1) - 43200)*7.272205216643040e-5*57.29577951308232;
+end
+e3 = max(max(abs([dref, href] - [decl, hourangle])));
+
+%% ------------- decide if verification is ok --------------------------------
+if e1 > max_error
+    v = false;
+    s = sprintf('verification %s time vector with single times FAILED: error %3.3g', ...
+        functionname, e1);
+    show = true;
+elseif e2 > max_error
+    v = false;
+    s = sprintf('verification sunangles with sunpos FAILED: error %3.3g', e2);
+    show = true;
+elseif e3 > max_error
+    v = false;
+    s = sprintf('verification sunangles with calcsolar FAILED: error %3.3g', e3);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s and sunangles OK: results are the same as the scalar functions', ...
+        functionname);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    figure
+    subplot(2,1,1)
+    plot(time/86400, y2-y0)
+    title('calcsolar: time vector - single times')
+    legend('extraterrestrial radiation', 'declination', 'solar time')
+    xlabel('time in days')
+    subplot(2,1,2)
+    plot(tt/86400, [yy(:,1)-zenith, yy(:,2)-azimut])
+    title('sunpos - sunangles')
+    legend('zenith', 'azimuth')
+    xlabel('time in days')
+end
@@ -4,17 +4,25 @@ function erg = cloudindex(time,I,latitude,longitude,longitudenull,SkyType)
 %
 %            INPUT
 %         
-%            1. time          :   time in Seconds
+%            1. time          :   time in Seconds (scalar or vector)
 %            2. I             :   global radiation on horizontal, W/m2
 %            3. latitude      :   geographical latitude ([-90,90],north positive)
 %            4. longitude     :   geographical longitude ([-180,180],West positive)
 %            5. longitudenull :   Referenzlngengrad (Zeitzone)
-%            6. SkyType       :   1,2,3,4 (s.u.)
+%            6. SkyType       :   1 high mountain, 2 lowland, 3 urban region,
+%                                 4 industrial zone
 %					
 %            OUTPUT
 %
-%            1. CloudIndex   :   cloudiness degree
+%            1. CloudFraction :  ratio of the global radiation and the clear
+%                                sky radiation 0..1, 0 at night (column 
+%                                vector for vector input)
 %
+%  The calculation is done by the mex function radiationdiagnostics
+%  (carlib radiation_diagnostics), the cloud index of the block metcloud_s
+%  is calculated from the cloud fraction:
+%  CloudIndex = ((1 - CloudFraction)/0.75)^(1/3.2), maximum 1
+%  See also radiationdiagnostics, radiationdivision
 
 % ***********************************************************************
 % This file is part of the CARNOT Blockset.
@@ -60,193 +68,23 @@ function erg = cloudindex(time,I,latitude,longitude,longitudenull,SkyType)
 % Modifizierung des M-Skriptes metcalc.m von Markus Werner, Solar-Institut Juelich
 %
 % Thomas Wenzel, 18.10.1999
+% Bernd Hafner: calculation by radiationdiagnostics (carlib    19oct2026
+%     kernel), returns the cloud fraction as before
 %
 
+% ------------ check the inputs -------------------------------------------
+if nargin ~= 6
+    help cloudindex
+    error('number of input arguments must be 6')
+end
+if any(SkyType == [1 2 3 4]) == 0
+    error('cloudindex: SkyType must be 1, 2, 3 or 4')
+end
 
-% Sttzstellen fr Transmissionsfaktoren "TauXY" (nach Meli,1993, S.38):
-SunAngleRef	= [0 2.5 5 10 20 30 40 60 90];
-% a)Transmssion nach Rayleigh-Streuung in der Atmosphre:
-TauRS = [.01 .450 .575 .681 .790 .837 .870 .895 .906];
-% b)Transmission nach Absorption durch Spurengase in der Atmosphre:
-TauAB = [.01 .750 .805 .838 .870 .888 .900 .908 .913];	
-% c)Transmission nach Streuung und Absorption durch Aerosol in der Atmosphre ...
-TauMS1 = [.01 .650 .754 .846 .920 .959 .980 .993 1;...	% ... ber Hochgebirge
-   		.01 .340 .465 .613 .750 .823 .870 .911 .925;...	% ... ber Flachland
-  	      .01 .150 .274 .417 .600 .688 .740 .790 .839;...	% ... ber Grostadt
-     	   .01 .070 .135 .257 .430 .551 .620 .705 .744];	% ... ber Industriegebiet
-   
-   % Eingabe des Typs der Atmosphre am Standort (SkyType):
-   % 1 - Hochgebirge
-   % 2 - Flachland
-   % 3 - Grostadt
-   % 4 - Industriegebiet
-   
-   % Skytype wird als Ziffer von der Popup-Liste der Maske geliefert;
-   % Achtung: In Popup-Liste auf richtige Reihenfolge achten!
-TauMS = TauMS1(SkyType,:);
+%------------------------------------ program code ------------------------------------
+[~, ~, ~, ~, ~, ~, CloudFraction] = ...
+    radiationdiagnostics(time, I, latitude, longitude, longitudenull, SkyType);
 
+CloudFraction(CloudFraction < 0) = 0;   % night
 
-
-
-
-% Besetzen diverser Variablen mit Default-Werten:
-SunHour = 0;	% Kennung fr Tagesstunden; "0" = NACHTstunden
-
-Idfu = 0;	% Default: "0" = NACHT
-
-cosLat 			= cos(latitude * pi/180);
-sinLat 			= sin(latitude * pi/180);
-DeclDayAmpl 	= -23.45 * pi/180; 
-HourAngleAmpl 	= 15 * pi/180;
-a = 0.75; % Parameter fr Berechnung von "CloudIndex"
-b = 3.2;  % Parameter fr Berechnung von "CloudIndex"
-
-%TageProMonat = [31  28  31  30  31  30  31  31  30  31  30  31]
-Tagebisher  = [0 31  59  90 120 151 181 212 243 273 304 334 365];
-
-DEG2RAD =  0.01745329251994;
-RAD2DEG =  57.29577951308232;
-
-CloudIndex = 0;
-CloudFraction = 0;
-
-Datum = sec2date(time);
-day = Datum(2) + Tagebisher(Datum(1));   % Tage + Tage in den Vormonaten
-   
-   
-      % Tgliche Deklination der Sonne "DeclDay" (nach Meli,1988,S.32):
-      DeclDay = DeclDayAmpl * cos(2*pi*(day+10)/365);
-   
-      % bertragung der tglichen Deklination der Sonne auf stndl. Werte "Decl":
-      %   Decl(StartHour:StopHour,1) = DeclDay;
-      
-      % Tagesmittelwert der extraterrestrischen Strahlung "IextraDay", die senkrecht
-      % auf eine zur Sonne orientierten Flche fllt (nach Duffie/Beckman,1993,S.10):
-      IextraDay = 1353 * (1+0.033*cos(2*pi*day/365));   
-      
-      
-   % ------------------------------------------------------------------------------- 
-	% 	"Decl"			Deklination der Sonne
-	%	"HourAngle" 	Stundenwinkel der Sonne 
-	%	"zenit"			Zenithwinkel 
-   %	"SunAngle"		Sonnenhhenwinkel
-	% 	"azimut"			Azimutwinkel 
-	%	"Iextra"			Extraterrestrische Strahlung auf HORIZONTALE Flche
-   %	"SunHour"		Tag-/Nachterkennung rkennung
-   %	"dimness"		Trbungsfaktor der Atmosphre
-   % 	"Idirclear"		direkte Strahlung auf der Erdoberflche fr KLAREN Himmel 
-	% 	"Idfuclear"		diffuse Strahlung auf der Erdoberflche fr KLAREN Himmel 
-   % ------------------------------------------------------------------------------- 
-   zeitgz = Datum(3)*3600+Datum(4)*60+Datum(5);        % standard time in seconds */
-    
-    % declination of the sun */
-    xj = 0.9856*(time/86400.)-2.72;
-    xbogen = DEG2RAD*xj;
-    arg2 = DEG2RAD*(xj - 77.51 + 1.92*sin(xbogen));
-    arg3 = sin(arg2);
-    delta = asin(0.3978*arg3);                      % declination angle */
-    deltaangle = RAD2DEG*delta;
-
-    arg5 = DEG2RAD*2.0*xj+24.99+3.83*sin(xbogen);
-
-    % determine solar hour angle in radian (noon = 0,  6 a.m. = -PI) */
-    z   = 60.0*(-7.66*sin(xbogen)-9.87*sin(arg5));  % z is in seconds */
-    moz = zeitgz + (longitudenull-longitude)*240.0;
-    woz = moz + z;                                  % true local time */
-    HourAngle = DEG2RAD*(woz - 43200.0)*0.00416666666667; % is in seconds */
-    
-    latitude  = DEG2RAD*latitude;
-       
-    % solar zenith angle in degrees (0 = zenith position, 90 = horizont) */
-    coszenit = sin(latitude)*sin(delta) ...
-        + cos(latitude)*cos(delta)*cos(HourAngle);
-    zenith  =  acos(coszenit)*RAD2DEG;
-      
-		% Sonnenhhenwinkel "SunAngle":
-   	SunAngle = 90 - zenith;
-		if SunAngle < .01
-   		SunAngle = .01; % da sonst Warnung "log(0)" (s.u.), falls SunAngle = 0.
-		end
-      
-      % Auf eine HORIZONTALE (= der Erdoberflche parallelen) Flche unter dem
-      % Winkel "zenit" treffende extraterrestrische Strahlung "Iextra":
-      Iextra = IextraDay * coszenit;
-      % Kennung fr Tagesstunden "SunHour":
-      if (Iextra > 0)
-        SunHour = 1;
-     else
-        SunHour = 0;
-      end
-      
-		% Spline-Interpolation der Zwischenwerte der Transmissionsfaktoren "TauXY":
-		Trs = interp1(SunAngleRef,TauRS,SunAngle,'cubic');
-		Tab = interp1(SunAngleRef,TauAB,SunAngle,'cubic');
-		Tms = interp1(SunAngleRef,TauMS,SunAngle,'cubic');
-
-   	% Trbungsfaktor "dimness" (nach Meli, 1993, S.38ff):
-		dimness = 1 + ( (log(Tms) + log(Tab)) / log(Trs) );
-      
-      % KLARER Himmel: Transmissionsfaktor "Taudir" und DIREKTstrahlung "Idirclear" 
-      % auf eine zur Einfallsrichtung senkrechte Flche (nach Kasten/Meli,1993,S.38ff):
-      Taudir = exp( -dimness/(0.9 + 9.4 * coszenit) );
-		Idirclear = Iextra * Taudir;
-      
-		% KLARER Himmel: Transmissionsfaktor "Taudfu" und DIFFUSstrahlung "Idfuclear" 
-      % auf eine zur Einfallsrichtung senkrechte Flche
-      %(nach Liu/Jordan bzw. nach Duffie/Beckman,1991,S.75):
-      Taudfu = 0.2710 - 0.2939 * Taudir; 
-      Idfuclear	= Iextra * Taudfu;
-
-		% KLARER Himmel: Globalstrahlung auf HORIZONTALE "Iclear":
-		Iclear= Idirclear + Idfuclear;
-      
-      % Unterdrckung von nchtlichen Offset-Werten in "I":
-      if (SunHour == 0)&(I > 0)
-         I = 0;
-      end
-   	
-	% ------------------------------------------------------------------------------- 
-	% 	"ClearIndex"	Klarheitsindex der Atmosphre (TAG)
-	% 	"CloudIndex"	Bedeckungsgrad des Himmels (TAG)
-	% 	"Idir"			direkte Strahlung auf der Erdoberflche
-	% 	"Idfu"			diffuse Strahlung auf der Erdoberflche
-	% ------------------------------------------------------------------------------- 
-
-      if SunHour == 1
-         CloudFraction = I/Iclear;
-
-         if CloudFraction > 1
-	         % ggfs. Korrektur, damit "CloudIndex" <= 1 bleibt:
-    			CloudFraction = 1;
-         end
-         CloudIndex = ( 1/a * (1 - CloudFraction) )^(1/b);
-         
-         if CloudIndex > 1
-            CloudIndex = 1;
-         end
-    end
-    
-      % Diskretisierung von "CloudIndex" in Okta [0, 1/8, 2/8, ... ,8/8]:
-      if CloudIndex >= 1
-      	CloudIndex = 1;
-		elseif CloudIndex >= .875
-  			CloudIndex = .875;
-		elseif CloudIndex >= .75
-  			CloudIndex = .75;
-		elseif CloudIndex >= .625
-  			CloudIndex = .625;
-		elseif CloudIndex >= .5
-  			CloudIndex = .5;
-		elseif CloudIndex >= .375
-  			CloudIndex = .375;
-		elseif CloudIndex >= .25
-  			CloudIndex = .25;
-		elseif CloudIndex > 0
-  			CloudIndex = .125;
-		elseif CloudIndex == 0
-  			CloudIndex = 0;
-		end
-
-    
-%erg(1) = CloudIndex;
-erg(1) = CloudFraction;
\ No newline at end of file
+erg = CloudFraction;
@@ -0,0 +1,140 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are 
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ *    notice, this list of conditions and the following disclaimer in the 
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its 
+ *    contributors may be used to endorse or promote products derived from 
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Syntax  [Idir Idfu CloudIndex Zenith Azimuth SunAngle CloudFraction] = 
+ *              radiationdiagnostics(time, Iglob, lat, long, long0, SkyType)
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * Version  Author  Changes                                     Date
+ * 6.1.0    hf      created                                     19oct2026
+ * 6.1.1    hf      output CloudFraction                        19oct2026
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ FUNCTION: Direct and diffuse radiation, cloud index and solar position 
+           from the global radiation on the horizontal for a whole time 
+           series. The calculation is the carlib function 
+           radiation_diagnostics, so the results are the same as with the 
+           blocks metrad_s (radiation division) and metcloud_s (cloud 
+           index, before the discretisation in octa and the interpolation
+           of the night values).
+           Compiled with OpenMP long series are calculated in parallel 
+           threads, e.g. with gcc:
+             mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" ...
+
+           INPUT
+           1. time          : vector of time in s (0 = January 1st, 0:00)
+           2. Iglob         : vector of global radiation on horizontal, W/m^2
+           3. latitude      : [-90,90], north positive
+           4. longitude     : [-180,180], west positive
+           5. longitudenull : reference longitude (timezone)
+           6. SkyType       : 1 high mountain, 2 lowland, 3 urban region,
+                              4 industrial zone, 0 no cloud index
+
+           OUTPUT (column vectors)
+           1. Idir          : direct radiation on horizontal, W/m^2
+           2. Idfu          : diffuse radiation on horizontal, W/m^2
+           3. CloudIndex    : cloud index 0..1, -1 at night
+           4. Zenith        : zenith angle of the sun, degree
+           5. Azimuth       : azimuth angle of the sun, degree (0 = south,
+                              west positive)
+           6. SunAngle      : altitude angle of the sun, degree
+           7. CloudFraction : ratio of global and clear sky radiation 0..1,
+                              -1 at night
+ */
+
+#include "mex.h"
+#include "carlib.h"
+
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    const double *time, *iglob;
+    double *diag, *out;
+    int    n, i, k, skytype;
+
+    if (nrhs != 6)
+    {
+        mexErrMsgTxt("radiationdiagnostics: 6 input arguments required "
+            "(time, Iglob, latitude, longitude, longitudenull, SkyType)");
+        return;
+    }
+    for (i = 0; i < 6; i++)
+    {
+        if (!mxIsDouble(prhs[i]) || mxIsComplex(prhs[i]) || mxIsEmpty(prhs[i]))
+        {
+            mexErrMsgTxt("radiationdiagnostics: inputs must be real numbers");
+            return;
+        }
+    }
+    if (nlhs > RAD_NDIAG)
+    {
+        mexErrMsgTxt("radiationdiagnostics: maximum 7 output arguments");
+        return;
+    }
+    n = (int)mxGetNumberOfElements(prhs[0]);
+    if ((int)mxGetNumberOfElements(prhs[1]) != n)
+    {
+        mexErrMsgTxt("radiationdiagnostics: time and Iglob must have the same length");
+        return;
+    }
+    for (i = 2; i < 6; i++)
+    {
+        if (mxGetNumberOfElements(prhs[i]) != 1)
+        {
+            mexErrMsgTxt("radiationdiagnostics: position and sky type must be scalar");
+            return;
+        }
+    }
+
+    time = mxGetPr(prhs[0]);
+    iglob = mxGetPr(prhs[1]);
+    skytype = (int)(*mxGetPr(prhs[5])+0.5);
+
+    diag = (double *)mxMalloc(n*RAD_NDIAG*sizeof(double));
+    radiation_diagnostics_batch(diag, n, time, iglob, *mxGetPr(prhs[2]),
+        *mxGetPr(prhs[3]), *mxGetPr(prhs[4]), skytype);
+
+    /* the outputs are in the order of diag */
+    for (k = 0; k < max(1, nlhs); k++)
+    {
+        plhs[k] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        out = mxGetPr(plhs[k]);
+        for (i = 0; i < n; i++)
+            out[i] = diag[i*RAD_NDIAG + k];
+    }
+    mxFree(diag);
+}
@@ -47,6 +47,10 @@
  *                  function solar_position  
  *                  corrected if(ZENITH < -9998.0 ...
  * 6.2.1    aw      unused variable xx deleted                  16jan2016
+ * 6.3.0    hf      solar geometry calculated once per time     19oct2026
+ *                  for all surfaces, surfaces in parallel threads
+ *                  (OpenMP), several sites in one call,
+ *                  no output per slope
  *
  * Copyright (c) 2000-2015 Solar-Institut Juelich, Germany
  *
@@ -65,16 +69,28 @@
            extraterrestric radiation.
             
 
+           The solar position is calculated once per time and used for all
+           surfaces. Compiled with OpenMP the surfaces are calculated in
+           parallel threads, e.g. with gcc:
+             mex CFLAGS="$CFLAGS -fopenmp" LDFLAGS="$LDFLAGS -fopenmp" ...
+            
+
            INPUT
        
-           1. month         :   [1..12]
+           1. month         :   [1..12], < 1 for the whole year
            2. latitude      :   Breitengrad ([-90,90],Nord positiv)
            3. longitude     :   Lngengrad ([-180,180],West positiv)
            4. longitudenull :   Referenzlngengrad (Zeitzone)
+           5. ClearIndex    :   clearness index
+           6. Skymodel      :   not used
+           7. Greflect      :   ground reflectance
+           latitude, longitude and longitudenull may be vectors with one
+           element per site.
 					
            OUTPUT
   
-           1. R             : matrix of ratio
+           1. R             : matrix of ratio, for several sites
+                              R(:,:,site)
 			  
 
   Berechnung des Sonnenstandes aus sunpos.c bernommen:
@@ -100,8 +116,12 @@
 #include "carlib.h"
 #include <math.h>
 #include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define SQR(x) ((x)*(x))
+#define RR_NGEO 8   /* values of the solar geometry per time */
 
 
 /******************************************************************************
@@ -220,135 +240,42 @@ void declination(double time, double latitude, double longitude, double longitud
 
 
 
-void surfrad(double TIME,double IDIR,double IDFU,double *idir_geneigt,double *idfu_geneigt, double *out_R,
-             double ZENITH,double AZIMUT,double COLANGLE,double COLAZIMUT,double COLROTATE,
-             double SKYMODEL,double GREFLECT)
-{
-
-    double time;
-    double tetatrans = -9999.0; /* incidence angle transversal coll. plane */
-    double tetalong  = -9999.0; /* incidence angle longitudinal coll. plane */
-    double costeta = 0.0;       /* incidence angle collector plane */
-    double idir_t  = 0.0;       /* direct radiation on surface */
-    double idfu_t  = 0.0;       /* diffuse radiation on surface */
-    double iextra  = 0.0;       /* extraterrestrial radiation on horizontal */
-    double R;
-
-    double as, zs, rc, zc, ac, rb;
-    double szc, czs, szs, czc, src, crc, sda, cda;
-
-    int skymodel;
-
-    skymodel    = (int)SKYMODEL;
-    time = TIME;
-    rb = 0.0;
-  
-    //     printf("ZENITH %f  AZIMUT %f  \n", ZENITH, AZIMUT);
-
-    if(ZENITH < -9998.0 || AZIMUT < -9998.0) { /* -9999 for no value */
-          printf("Error: weather data does not include sunposition. \n");
-          printf("       Use block carnot/weather/set_sun_position.\n");
-          return;
-    }
-      as = DEG2RAD * AZIMUT;
-      zs = DEG2RAD * ZENITH;
-      zc = DEG2RAD * COLANGLE;
-      ac = DEG2RAD * COLAZIMUT;
-      rc = DEG2RAD * COLROTATE;
-  
-      sda = sin(as-ac); /* difference of azimut */
-      cda = cos(as-ac); 
-      szs = sin(zs); /* sine ZENITH angle of sun */
-      czs = cos(zs); /* cosine ZENITH angle of sun */
-      szc = sin(zc); /* sine ZENITH angle of collector (inclination) */
-      czc = cos(zc); /* cosine ZENITH angle of collector (inclination) */
-      src = sin(rc); /* sine rotation angle of collector */
-      crc = cos(rc); /* cosine rotation angle of collector */
-  
-      if (czs < 1.0e-5) { /* no sun */
-          tetalong = 90.0;
-          tetatrans = 90.0;
-      } else { /* sun is there */
-          /* cos of incidence angle on surface */
-          costeta = src*sda*szs+crc*(szc*cda*szs+czc*czs);
-  
-          rb = costeta/czs; /* ratio of direct radiation */
-  
-          /* incidence angle in longitudinal collector plane
-            (direction riser - vertical on window) */
-          tetalong = acos(costeta/
-              sqrt(SQR(czc*cda*szs-szc*czs)+SQR(costeta)));
-          /* incidence angle in transversal collector plane 
-             (direction header - vertical on window) */
-          tetatrans = acos(costeta/
-              sqrt(SQR(crc*sda*szs-src*(szc*cda*szs+czc*czs))+SQR(costeta)));
-  
-          /* ---- radiation on tilted surface ----- */
-          /* extraterrestrial radiation on horizontal */
-          iextra = 1367.0 * (1.0 + 0.033*cos(1.992384990861106e-7*time)) * czs;
-  
-          /* diffuse radiation on surface depends on sky model */
-          /* from Duffie, Beckman: Solar Engineering of Thermal Processes, 1991 */
-          idfu_t = (IDFU+IDIR)*0.5*GREFLECT*(1.0-czc); /* reflected from ground */
-  
-          switch (skymodel) {
-              case 1: /* isotropic sky model */
-                  idfu_t += 0.5*IDFU*(1.0+czc); /* add to idfu_t */
-                  break;
-              case 2: /* Hay Davies sky model */
-                  idfu_t += IDFU*((1.0-IDIR/iextra)*0.5*(1.0+czc) 
-                      + rb*IDIR/iextra);        /* add to idfu_t */
-                  break;
-              default: /* no sky model */
-                  idfu_t += IDFU;
-                  break;
-          }
-          /* limited to iextra to avoid peaks at high ZENITHh angles of sun */
-          idfu_t = MIN(iextra, idfu_t);  /* diffuse radiation un surface  */
-          idir_t = MIN(iextra, IDIR*rb); /* direct radiation un surface  */
-      } /* end if csz > 1e-5, check for sunset */
-  
-  
-      /* formula (2.15.2) */
-      if (fabs(IDIR+IDFU) < DBL_EPSILON)
-        R = 0;
-      else
-        R = IDIR*rb/(IDIR+IDFU) + IDFU/(IDIR+IDFU)*(1+cos(COLANGLE*DEG2RAD))/2
-            + GREFLECT*(1-cos(COLANGLE*DEG2RAD))/2;
-      
-  
-      *idir_geneigt = idir_t;
-      *idfu_geneigt = idfu_t;
-      *out_R = R;
-      
-}
-
-
-
 /******************************************************************************
 *                                                                             *
-*  flaechenfaktor                                                             *
+*  radiationratio_times                                                       *
 *                                                                             *
-*  - calculates the zentith and the extraterrestric radiation                 *
-*  - calculates the angle of incidence (1.6.2)                                *
-*  - calculates ratio R = cos(incidence)/cos(zenith)                          *
+*  solar geometry for all times of the period (one site), calculated once     *
+*  and used for all surfaces. Only times with iextra > 0 are stored.          *
+*  Per time: weight (extraterrestrial radiation on horizontal), sine and     *
+*  cosine of zenith, sine and cosine of azimut of the sun and the factors     *
+*  of formula (2.15.2) of Duffie, Beckman:                                    *
+*    R = cdir*cos(incidence) + cdfu*(1+cos(slope))/2 + crefl*(1-cos(slope))/2 *
 *                                                                             *
-*  output: double *r      = max(R,0)                                          *
-*          double *iextra = extraterrestric radiation                         *
+*  output: number of stored times                                             *
 *                                                                             *
 ******************************************************************************/
 
-void flaechenfaktor(double time,double latitude,double longitude,double longitude0,
-        double slope,double surfaceangle,double ClearIndex, double Skymodel, 
-        double Greflect, double *r,double *out_iextra)
+int radiationratio_times(double latitude, double longitude, double longitude0,
+        double startmonat, double endmonat, double ClearIndex, double Greflect,
+        double *geo)
 {
-   double decl,altitude,azimuth,zenith,hourangle,iextra,I,idfu,idir,idir_gen,idfu_gen,R;
-   
-   declination(time,latitude,longitude,longitude0,&decl,&altitude,&zenith,
-           &azimuth,&hourangle,&iextra);
-             
+   double decl,altitude,azimuth,zenith,hourangle,iextra,I,idfu,idir,time,monat;
+   double zs, as, czs;
+   int    tag, stunde, minute, n = 0;
+
+   for (monat=startmonat;monat<=endmonat;monat++)
+     for (tag=1;tag<=28;tag+=1)
+       for (stunde=1;stunde<24;stunde+=1)
+         for (minute=0;minute<60;minute+=60)
+         {
+           time = (double)countseconds((int)99, (int)monat, (int)tag,
+                   stunde, (int)minute, (int)0);
+           declination(time,latitude,longitude,longitude0,&decl,&altitude,&zenith,
+                   &azimuth,&hourangle,&iextra);
+           if (iextra <= 0.0)
+              continue;
+
            I = ClearIndex*iextra;
-                       
            /* Diffuse Strahlung auf HORIZONTALE Flche "Idfu" ...  */
            if (ClearIndex <= 0.3)
               idfu = I * (1 - 0.2 * ClearIndex);
@@ -356,27 +283,81 @@ void flaechenfaktor(double time,double latitude,double longitude,double longitud
               idfu = I * (1.423-1.612 * ClearIndex);
            else
               idfu = I * 0.15;
-        
-        /* Direkte Strahlung auf HORIZONTALE Flche "Idir"*/
-        idir = I - idfu;
-        
-   /*     printf("iextra %f  I %f   Idfu %f  Idir %f\n",iextra,I,idfu,idir);*/
-        
-        surfrad(time,idir,idfu,&idir_gen,&idfu_gen, &R,
-             zenith,azimuth,slope,surfaceangle,0,
-             Skymodel,Greflect);
-        
-        *r = MAX((idir_gen+idfu_gen)/(idir+idfu),0.0);
-  /*      if (slope>0)
-        printf("%.0f/%.0f idir %f.1 %f.1   igen %f.1 %f.1   R %f %f\n",slope,surfaceangle,idir,idir_gen,idfu,idfu_gen,*r,R);
-  */
-  /* *r = MAX(cos_inc/cos(zenith*DEG2RAD),0);*/
-  *r = MAX(R,0.0);
-   *out_iextra = iextra;
+           /* Direkte Strahlung auf HORIZONTALE Flche "Idir"*/
+           idir = I - idfu;
+
+           zs = DEG2RAD*zenith;
+           as = DEG2RAD*azimuth;
+           czs = cos(zs);
+           geo[0] = iextra;
+           geo[1] = sin(zs);
+           geo[2] = czs;
+           geo[3] = sin(as);
+           geo[4] = cos(as);
+           if (fabs(idir+idfu) < DBL_EPSILON)
+           {  /* R = 0 */
+              geo[5] = geo[6] = geo[7] = 0.0;
+           }
+           else
+           {  /* no direct radiation on the surface without sun */
+              geo[5] = (czs < 1.0e-5)? 0.0 : idir/(idir+idfu)/czs;
+              geo[6] = 0.5*idfu/(idir+idfu);
+              geo[7] = 0.5*Greflect;
+           }
+           geo += RR_NGEO;
+           n++;
+         }
+   return n;
 }
 
 
 
+/******************************************************************************
+*                                                                             *
+*  radiationratio_surfaces                                                    *
+*                                                                             *
+*  ratio R for all slopes and surface azimut angles, averaged over the        *
+*  ntime times in geo weighted by the extraterrestric radiation.              *
+*  The surfaces are independent, with OpenMP they are calculated in           *
+*  parallel threads.                                                          *
+*                                                                             *
+******************************************************************************/
+
+void radiationratio_surfaces(const double *geo, int ntime, int max_slope,
+        int max_angle, double *R)
+{
+   int isurf;
+
+#ifdef _OPENMP
+   #pragma omp parallel for schedule(static)
+#endif
+   for (isurf=0;isurf<max_slope*max_angle;isurf++)
+   {
+      int    islope = isurf%max_slope;
+      int    iangle = isurf/max_slope;
+      double slope = DEG2RAD*90/(max_slope-1.)*islope;
+      double surfaceangle = DEG2RAD*(-180/(max_angle-1.)*iangle);
+      double szc = sin(slope), czc = cos(slope);
+      double sac = sin(surfaceangle), cac = cos(surfaceangle);
+      double sum_r = 0.0, sum_i = 0.0, costeta, r;
+      const double *g = geo;
+      int    k;
+
+      for (k=0;k<ntime;k++,g+=RR_NGEO)
+      {
+         /* cos of incidence angle on surface, no rotation */
+         costeta = szc*(g[4]*cac+g[3]*sac)*g[1] + czc*g[2];
+         r = g[5]*costeta + g[6]*(1.0+czc) + g[7]*(1.0-czc);
+         sum_r += MAX(r,0.0)*g[0];
+         sum_i += g[0];
+      }
+      if (sum_i>0.0)
+         R[isurf] = sum_r/sum_i;
+      else
+         R[isurf] = 0;
+   }
+}
+
 
 
 void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
@@ -387,27 +368,31 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
     }
     else
     {
-      double monat,time,latitude,longitude,longitudenull;   /* input */
-     
-      
-      double iextra;         /* output */
-      double sum_r,sum_i,r;
-      int    islope,iangle,tag,stunde,minute,max_angle,max_slope;
-      double slope,surfaceangle, startmonat,endmonat,
-             ClearIndex,Skymodel,Greflect;
-      double *R;
-      
+      double monat,startmonat,endmonat,ClearIndex,Greflect;
+      const double *latitude,*longitude,*longitudenull;
+      double *R, *geo;
+      int    max_angle,max_slope,nsite,isite,ntime;
+      mwSize dims[3];
+
       max_slope = 37; /*19; */  /* 0:5:90  */
-      max_angle = 37;   /* 0:5:180 */    
+      max_angle = 37;   /* 0:5:180 */
 
       monat = *mxGetPr(prhs[0]);
-      latitude = *mxGetPr(prhs[1]);
-      longitude = *mxGetPr(prhs[2]);
-      longitudenull = *mxGetPr(prhs[3]);
+      latitude = mxGetPr(prhs[1]);
+      longitude = mxGetPr(prhs[2]);
+      longitudenull = mxGetPr(prhs[3]);
       ClearIndex = *mxGetPr(prhs[4]);
-      Skymodel = *mxGetPr(prhs[5]);
+      /* Skymodel (prhs[5]) has no influence on R (formula 2.15.2) */
       Greflect = *mxGetPr(prhs[6]);
-   
+
+      nsite = (int)mxGetNumberOfElements(prhs[1]);
+      if ((int)mxGetNumberOfElements(prhs[2]) != nsite
+          || (int)mxGetNumberOfElements(prhs[3]) != nsite)
+      {
+         printf("error: latitude, longitude and longitude0 must have the same length\n");
+         return;
+      }
+
       if (monat<1.0)
       {
          startmonat = 1.0;
@@ -418,49 +403,25 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
          startmonat = monat;
          endmonat = monat;
       }
-      
-      plhs[0]=mxCreateDoubleMatrix(max_slope,max_angle,mxREAL); 
+
+      /* one matrix per site */
+      dims[0] = max_slope;
+      dims[1] = max_angle;
+      dims[2] = nsite;
+      plhs[0] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
       R = mxGetPr(plhs[0]);
 
-/*      declination(time,latitude,longitude,longitudenull,&decl,&altitude,&azimuth,&zenith,&hourangle,&iextra);*/
-   
-      for (islope=0;islope<max_slope;islope++)     /* iteration over surface slope */
-      { 
-         slope = 90/(max_slope-1.)*islope; 
-         printf("slope %.0f\n",slope);
-         for (iangle=0;iangle<max_angle;iangle++)       /* iteration over surface zenith angle */
-         {
-            surfaceangle = -180/(max_angle-1.)*iangle;
-            sum_r = 0;
-            sum_i = 0;
-            for (monat=startmonat;monat<=endmonat;monat++)
-            for (tag=1;tag<=28;tag+=1)
-              for (stunde=1;stunde<24;stunde+=1)
-                for (minute=0;minute<60;minute+=60)
-                {
-                   time = (double)countseconds((int)99, (int)monat, (int)tag,
-                           stunde, (int)minute, (int)0);
-                   
-                   flaechenfaktor(time,latitude,longitude,longitudenull,slope,
-                           surfaceangle,ClearIndex,Skymodel,Greflect,&r,&iextra);
-                   if (iextra>0.0)// && r>0)
-                   {
-/*                   if (slope>=90 && surfaceangle>-5)
-                      printf("r %f   iextra %f   sum_r %f\n",r,iextra,sum_r+r*iextra);
-  */
-                      sum_r += r*iextra;
-                      sum_i += iextra;
-                   }
-                }
-/*printf("%.0f/%.0f  %f/%f = %f\n",slope,surfaceangle,sum_r,sum_i,sum_r/sum_i);              */
-              if (sum_i>0.0)
-                R[islope+iangle*max_slope] = sum_r/sum_i;  
-              else
-                R[islope+iangle*max_slope] = 0;  
-         } /* for iangle */
-      } /* for islope */
-                   
+      /* 28 days with 23 hours per month */
+      geo = (double *)mxMalloc(RR_NGEO*12*28*23*sizeof(double));
+
+      for (isite=0;isite<nsite;isite++)
+      {
+         ntime = radiationratio_times(latitude[isite],longitude[isite],
+                 longitudenull[isite],startmonat,endmonat,ClearIndex,Greflect,geo);
+         radiationratio_surfaces(geo,ntime,max_slope,max_angle,
+                 R+isite*max_slope*max_angle);
+      }
+      mxFree(geo);
    }
-      
-}
 
+}
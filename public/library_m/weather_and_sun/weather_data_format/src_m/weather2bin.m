@@ -0,0 +1,143 @@
+function weather2bin(weather,outfile,lat,long,long0)
+% weather2bin writes weather data in the Carnot-Format into a binary file
+% for the block weather_bin. The file holds the columns of the weather
+% matrix one after the other, so the whole year is read in one go and
+% the solar position and the direct / diffuse split need not be
+% calculated during the simulation. Unknown sky temperatures (-9999) are
+% kept in the file, the block weather_bin calculates them once when the
+% file is read (carlib function sky_temperature_batch, same model as the
+% block sky_temperature).
+%
+% SYNTAX: weather2bin(weather, outfile)
+%         weather2bin(weather, outfile, lat, long, long0)
+%
+% weather     : weather matrix in the Carnot-Format (e.g. the output of
+%               try2wformat or Meteonorm2wformat) or the name of a .mat
+%               or .dat file with the weather matrix
+% outfile     : character string of the output file name (e.g.
+%               DE_TRY2010_01_averageYear.cwb)
+% lat         : [-90,90] north positive
+% long        : [-180,180] west positive
+% long0       : reference longitude (timezone), [-180,180] west positive
+%               If the position is given, unknown (-9999) values of the
+%               zenith and azimuth angle are calculated by sunangles.
+%
+% Format of the binary file (little endian, weather_bin also reads files
+% of the other byte order by the byte order marker):
+%   byte    type        content
+%   0       char[8]     'CARNOTWB'
+%   8       int32       format version (1)
+%   12      int32       number of columns
+%   16      int32       number of rows (time steps)
+%   20      int32       byte order marker 16909060 (hex 01020304)
+%   24      double      latitude  (-9999 if unknown)
+%   32      double      longitude (-9999 if unknown)
+%   40      double      reference longitude (-9999 if unknown)
+%   48      double      time step in s (0 if not equidistant)
+%   56      double      0 (reserved)
+%   64      double      the columns of the weather matrix, column by
+%                       column (first the time of all rows, then the
+%                       timevalue of all rows, ...)
+
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+%
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+%
+% Redistribution and use in source and binary forms, with or without
+% modification, are permitted provided that the following conditions are
+% met:
+%
+% 1. Redistributions of source code must retain the above copyright notice,
+%    this list of conditions and the following disclaimer.
+%
+% 2. Redistributions in binary form must reproduce the above copyright
+%    notice, this list of conditions and the following disclaimer in the
+%    documentation and/or other materials provided with the distribution.
+%
+% 3. Neither the name of the copyright holder nor the names of its
+%    contributors may be used to endorse or promote products derived from
+%    this software without specific prior written permission.
+%
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% ***********************************************************************
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+% author list:  hf -> Bernd Hafner
+%
+% version   author  changes                                     date
+% 6.1.0     hf      created                                     19oct2026
+% 6.1.1     hf      unknown sky temperatures left to weather_bin    19oct2026
+% 6.1.2     hf      byte order marker in the header                 19oct2026
+
+if nargin ~= 2 && nargin ~= 5
+    help weather2bin
+    error('Number of input arguments must be 2 or 5')
+end
+
+% ---- weather matrix -----------------------------------------------------
+if ischar(weather)
+    [~,~,ext] = fileparts(weather);
+    if strcmpi(ext,'.mat')
+        s = load(weather);
+        names = fieldnames(s);
+        weather = s.(names{1});         % first variable in the file
+    else
+        weather = txt2mat(weather);
+    end
+end
+if size(weather,2) < 8
+    error('weather2bin: weather matrix must have at least 8 columns')
+end
+
+% ---- unknown values of the derived quantities ---------------------------
+if nargin == 5
+    unknown = weather(:,3) < -9998 | weather(:,4) < -9998;
+    if any(unknown)     % solar position from carlib
+        [~,~,zenith,azimuth,~] = sunangles(weather(unknown,1),lat,long,long0);
+        weather(unknown,3) = zenith;
+        weather(unknown,4) = azimuth;
+    end
+else
+    lat = -9999;
+    long = -9999;
+    long0 = -9999;
+end
+
+% ---- time step ----------------------------------------------------------
+[nrow,ncol] = size(weather);
+dt = diff(weather(:,1));
+if nrow > 1 && all(abs(dt-dt(1)) <= 1e-6*abs(dt(1)))
+    tstep = dt(1);
+else
+    tstep = 0;
+end
+if any(dt <= 0)
+    error('weather2bin: time in column 1 must be increasing')
+end
+
+% ---- write the file -----------------------------------------------------
+fid = fopen(outfile,'w','ieee-le');
+if fid < 0
+    error(['weather2bin: cannot open file ' outfile])
+end
+fwrite(fid,'CARNOTWB','char');
+fwrite(fid,[1 ncol nrow hex2dec('01020304')],'int32');  % byte order marker
+fwrite(fid,[lat long long0 tstep 0],'double');
+fwrite(fid,weather,'double');           % Matlab stores column by column
+fclose(fid);
@@ -0,0 +1,558 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are 
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ *    notice, this list of conditions and the following disclaimer in the 
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its 
+ *    contributors may be used to endorse or promote products derived from 
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * hydraulic network: mass flows in all branches of a network of pipes,
+ * valves and pumps solved simultaneously
+ *
+ * The network is a graph of NNODES nodes and NBRANCH branches. Branch b
+ * goes from node FROMNODE(b) to node TONODE(b), a positive massflow 
+ * flows in this direction. The pressure difference of the branch is
+ *
+ *  p_from - p_to = dp(mdot) - dppump(mdot)
+ *  dp     = c + l*mdot + q*mdot*|mdot|         (pipes, valves, ...)
+ *  dppump = pc + pl*mdot + pq*mdot*|mdot|      (pump characteristic)
+ *
+ * c, l, q are the constant (static pressure), linear and quadratic 
+ * pressure drop coefficients of the branch as in the hydraulic vector,
+ * pc, pl, pq the coefficients of the pump characteristic as in pump.c.
+ * At each node (except the reference node) the sum of the massflows is 
+ * zero. The pressure of the reference node is an input.
+ *
+ * The equations are solved with Newton's method for all massflows and 
+ * pressures together (global gradient algorithm): with W = 1/(d dp/d mdot)
+ * of each branch and the incidence matrix A (node x branch) the pressure
+ * correction is the solution of the sparse, symmetric and positive 
+ * definite system
+ *
+ *  (A*W*A') * dP = A*W*f + h
+ *
+ * (f: pressure residual of the branches, h: mass residual of the nodes),
+ * which is solved by preconditioned conjugate gradients without building
+ * the matrix. The massflows follow from dmdot = W*(f - A'*dP).
+ * The iteration starts with the solution of the last major time step 
+ * (warm start), it usually converges in 1 to 3 iterations. Minor time 
+ * steps iterate on a copy and do not change the warm start. The massflows are correct 
+ * in the same time step, the one-step lag of mix_flow (OLDMDOT) and of
+ * the pump block is not needed.
+ *
+ * Branches with ID < 0 are closed (massflow 0). Near zero massflow the 
+ * derivative of the quadratic term is evaluated with |mdot| >= MDOTREG.
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ *
+ * Version  Author  Changes                                         Date
+ * 6.1.0    hf      created                                         19oct2026
+ * 6.1.1    hf      node numbers of the branches in an int DWork    19oct2026
+ * 6.1.2    hf      warm start only updated in major time steps     19oct2026
+ *
+ * parameters
+ *  index   use
+ *  0       FROMNODE: start node of the branches (1..NNODES)
+ *  1       TONODE: end node of the branches (1..NNODES)
+ *  2       REFNODE: node with the reference pressure
+ *  3       TOL: pressure tolerance in Pa (optional, default 1)
+ *  4       MAXITER: maximum number of Newton iterations (optional, default 20)
+ *
+ * structure of u (input vector)
+ *  port    use
+ *  0       hydraulic coefficients of the branches, 4 values per branch:
+ *          [ID c l q]  (ID < 0: branch closed)
+ *  1       pump characteristic of the branches, 3 values per branch:
+ *          [pc pl pq]  (zeros for branches without pump)
+ *  2       pressure at the reference node                  Pa
+ *
+ * structure of y (output vector)
+ *  port    use
+ *  0       massflow in the branches (NBRANCH)              kg/s
+ *  1       pressure at the nodes (NNODES)                  Pa
+ *  2       number of Newton iterations, max. residual      -, Pa
+ */
+
+
+#define S_FUNCTION_LEVEL 2
+#define S_FUNCTION_NAME  hydraulic_network
+
+/*
+ * Need to include simstruc.h for the definition of the SimStruct and
+ * its associated macro definitions.
+ */
+#include "simstruc.h"
+#include "carlib.h"     /* for some specific defines in Carnot */
+#include <math.h>
+
+#define FROMNODE(b) ((int_T)mxGetPr(ssGetSFcnParam(S,0))[b]-1) /* start node of branch (0-based) */
+#define TONODE(b)   ((int_T)mxGetPr(ssGetSFcnParam(S,1))[b]-1) /* end node of branch (0-based) */
+#define REFNODE     ((int_T)*mxGetPr(ssGetSFcnParam(S,2))-1)   /* reference node (0-based) */
+#define TOL         ((ssGetSFcnParamsCount(S) > 3)? *mxGetPr(ssGetSFcnParam(S,3)) : 1.0)
+#define MAXITER     ((ssGetSFcnParamsCount(S) > 4)? (int_T)*mxGetPr(ssGetSFcnParam(S,4)) : 20)
+#define NBRANCH     ((int_T)mxGetNumberOfElements(ssGetSFcnParam(S,0)))
+#define NPARAMS         3
+#define NPARAMS_TOL     4
+#define NPARAMS_MAXITER 5
+
+#define ID(b)       (*u0[4*(b)])    /* flow ID, < 0 : branch closed */
+#define CON(b)      (*u0[4*(b)+1])  /* constant pressure drop (static pressure) */
+#define LIN(b)      (*u0[4*(b)+2])  /* linear pressure drop coefficient */
+#define QUA(b)      (*u0[4*(b)+3])  /* quadratic pressure drop coefficient */
+#define NIN0        4
+#define PUCON(b)    (*u1[3*(b)])    /* pump: constant pressure */
+#define PULIN(b)    (*u1[3*(b)+1])  /* pump: slope of pressure with mdot */
+#define PUQUA(b)    (*u1[3*(b)+2])  /* pump: quadratic term of p with mdot */
+#define NIN1        3
+#define PREF        (*u2[0])        /* pressure at the reference node */
+
+#define MDOTREG     1.0e-3  /* smallest |mdot| for the derivative of the quadratic term in kg/s */
+#define DPDMMIN     1.0     /* smallest derivative d dp/d mdot in Pa/(kg/s) */
+#define MDOTTOL     1.0e-9  /* tolerance of the node mass balance in kg/s */
+#define CGTOL       1.0e-12 /* relative tolerance of the conjugate gradients */
+
+/* DWork: solution of the last major time step (warm start) and work arrays */
+#define DWORK_MDOT_NR   0   /* massflow of the branches */
+#define DWORK_PRESS_NR  1   /* pressure at the nodes */
+#define DWORK_WORK_NR   2   /* work arrays */
+#define DWORK_COUNT_NR  3   /* number of calls, calls without convergence */
+#define DWORK_NODE_NR   4   /* start and end node of the branches (0-based) */
+#define N_WORK(nn,nb)   (8*(nn)+4*(nb))
+
+/* start and end node of branch b from the node DWork */
+#define FROM(b)     node[2*(b)]
+#define TO(b)       node[2*(b)+1]
+
+
+/* number of nodes: highest node index */
+static int_T number_of_nodes(SimStruct *S)
+{
+    int_T b, nn = REFNODE+1;
+
+    for (b = 0; b < NBRANCH; b++)
+    {
+        nn = max(nn, FROMNODE(b)+1);
+        nn = max(nn, TONODE(b)+1);
+    }
+    return nn;
+}
+
+
+/* v = A*x : node sum of the branch values (inflow - outflow) */
+static void incidence_mult(const int32_T *node, real_T *v, const real_T *x, int_T nn, int_T nb)
+{
+    int_T n, b;
+
+    for (n = 0; n < nn; n++)
+        v[n] = 0.0;
+    for (b = 0; b < nb; b++)
+    {
+        v[TO(b)] += x[b];
+        v[FROM(b)] -= x[b];
+    }
+}
+
+
+/* y = (A*W*A')*x for the nodes, x of the reference node is 0 */
+static void laplace_mult(const int32_T *node, int_T ref, real_T *y, const real_T *x,
+    const real_T *w, real_T *tmp, int_T nn, int_T nb)
+{
+    int_T b;
+
+    for (b = 0; b < nb; b++)
+        tmp[b] = w[b]*(x[TO(b)] - x[FROM(b)]);
+    incidence_mult(node, y, tmp, nn, nb);
+    y[ref] = 0.0;
+}
+
+
+/* solve (A*W*A')*x = r by conjugate gradients with Jacobi preconditioner,
+ * nodes without open branch keep x = 0 */
+static void solve_network_pcg(const int32_T *node, int_T ref, real_T *x, const real_T *r,
+    const real_T *w, real_T *work, int_T nn, int_T nb)
+{
+    real_T *diag = work;
+    real_T *res  = work + nn;
+    real_T *dir  = work + 2*nn;
+    real_T *z    = work + 3*nn;
+    real_T *ad   = work + 4*nn;
+    real_T *tmp  = work + 5*nn;        /* nb values */
+    real_T rz, rzold, alpha, rr, rr0;
+    int_T  n, b, it;
+
+    for (n = 0; n < nn; n++)
+        diag[n] = 0.0;
+    for (b = 0; b < nb; b++)
+    {
+        if (TO(b) != FROM(b))
+        {
+            diag[TO(b)] += w[b];
+            diag[FROM(b)] += w[b];
+        }
+    }
+    rz = 0.0;
+    rr0 = 0.0;
+    for (n = 0; n < nn; n++)
+    {
+        x[n] = 0.0;
+        res[n] = (n == ref || diag[n] <= 0.0)? 0.0 : r[n];
+        z[n] = (diag[n] > 0.0)? res[n]/diag[n] : 0.0;
+        dir[n] = z[n];
+        rz += res[n]*z[n];
+        rr0 += res[n]*res[n];
+    }
+    if (rr0 <= 0.0)
+        return;
+
+    for (it = 0; it < 2*nn; it++)
+    {
+        laplace_mult(node, ref, ad, dir, w, tmp, nn, nb);
+        alpha = 0.0;
+        for (n = 0; n < nn; n++)
+            alpha += dir[n]*ad[n];
+        if (alpha <= 0.0)
+            break;
+        alpha = rz/alpha;
+        rr = 0.0;
+        rzold = rz;
+        rz = 0.0;
+        for (n = 0; n < nn; n++)
+        {
+            x[n] += alpha*dir[n];
+            res[n] -= alpha*ad[n];
+            z[n] = (diag[n] > 0.0)? res[n]/diag[n] : 0.0;
+            rz += res[n]*z[n];
+            rr += res[n]*res[n];
+        }
+        if (rr <= CGTOL*CGTOL*rr0)
+            break;
+        for (n = 0; n < nn; n++)
+            dir[n] = z[n] + rz/rzold*dir[n];
+    }
+}
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      int_T b;
+
+      if (NBRANCH < 1 
+          || (int_T)mxGetNumberOfElements(ssGetSFcnParam(S,1)) != NBRANCH) {
+          ssSetErrorStatus(S,"Error in hydraulic_network: FROMNODE and TONODE must have the same length >= 1");
+          return;
+      }
+      for (b = 0; b < NBRANCH; b++) {
+          if (FROMNODE(b) < 0 || TONODE(b) < 0) {
+              ssSetErrorStatus(S,"Error in hydraulic_network: node numbers must be >= 1");
+              return;
+          }
+      }
+      if (REFNODE < 0) {
+          ssSetErrorStatus(S,"Error in hydraulic_network: reference node must be >= 1");
+          return;
+      }
+      if (TOL <= 0.0 || MAXITER < 1) {
+          ssSetErrorStatus(S,"Error in hydraulic_network: tolerance must be > 0 and maximum iterations >= 1");
+          return;
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/*================*
+ * Build checking *
+ *================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *   Setup sizes of the various vectors.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T nn, nb;
+
+    if (ssGetSFcnParamsCount(S) == NPARAMS_MAXITER)   /* optional parameters */
+        ssSetNumSFcnParams(S, NPARAMS_MAXITER);
+    else if (ssGetSFcnParamsCount(S) == NPARAMS_TOL)
+        ssSetNumSFcnParams(S, NPARAMS_TOL);
+    else
+        ssSetNumSFcnParams(S, NPARAMS);
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S))
+    {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL)
+    {
+        return;
+    }
+#endif
+    nb = NBRANCH;
+    nn = number_of_nodes(S);
+    
+    if (!ssSetNumInputPorts(S, 3))
+    {
+        return;
+    }
+    ssSetInputPortWidth(S, 0, NIN0*nb);
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+    ssSetInputPortWidth(S, 1, NIN1*nb);
+    ssSetInputPortDirectFeedThrough(S, 1, 1);
+    ssSetInputPortWidth(S, 2, 1);
+    ssSetInputPortDirectFeedThrough(S, 2, 1);
+    
+    if (!ssSetNumOutputPorts(S, 3))
+    {
+        return;
+    }
+    ssSetOutputPortWidth(S, 0, nb);
+    ssSetOutputPortWidth(S, 1, nn);
+    ssSetOutputPortWidth(S, 2, 2);
+    
+    ssSetNumSampleTimes(S, 1);
+
+    ssSetNumDWork(S, 5);
+    ssSetDWorkWidth(S, DWORK_MDOT_NR, nb);
+    ssSetDWorkDataType(S, DWORK_MDOT_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_MDOT_NR, "DWORK_MDOT");
+    ssSetDWorkUsageType(S, DWORK_MDOT_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_PRESS_NR, nn);
+    ssSetDWorkDataType(S, DWORK_PRESS_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_PRESS_NR, "DWORK_PRESS");
+    ssSetDWorkUsageType(S, DWORK_PRESS_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_WORK_NR, N_WORK(nn,nb));
+    ssSetDWorkDataType(S, DWORK_WORK_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_WORK_NR, "DWORK_WORK");
+    ssSetDWorkUsageType(S, DWORK_WORK_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_COUNT_NR, 2);
+    ssSetDWorkDataType(S, DWORK_COUNT_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_COUNT_NR, "DWORK_COUNT");
+    ssSetDWorkUsageType(S, DWORK_COUNT_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_NODE_NR, 2*nb);
+    ssSetDWorkDataType(S, DWORK_NODE_NR, SS_INT32);
+    ssSetDWorkName(S, DWORK_NODE_NR, "DWORK_NODE");
+    ssSetDWorkUsageType(S, DWORK_NODE_NR, SS_DWORK_USED_AS_DWORK);
+    
+    /* specify the sim state compliance to be same as a built-in block */
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+    
+    ssSupportsMultipleExecInstances(S, true);
+    
+    ssSetOptions(S,
+            SS_OPTION_WORKS_WITH_CODE_REUSE |
+            SS_OPTION_EXCEPTION_FREE_CODE);
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Specifiy that we inherit our sample time from the driving block.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, INHERITED_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+    ssSetModelReferenceSampleTimeDefaultInheritance(S);
+}
+
+
+#define MDL_START
+/* Function: mdlStart =========================================================
+ * Abstract:
+ *    Start values of the iteration: no massflow, reference pressure.
+ *    The node numbers of the branches are converted once.
+ */
+static void mdlStart(SimStruct *S)
+{
+    real_T *mdot  = (real_T *)ssGetDWork(S, DWORK_MDOT_NR);
+    real_T *press = (real_T *)ssGetDWork(S, DWORK_PRESS_NR);
+    real_T *count = (real_T *)ssGetDWork(S, DWORK_COUNT_NR);
+    int32_T *node = (int32_T *)ssGetDWork(S, DWORK_NODE_NR);
+    int_T  n, nn = number_of_nodes(S);
+
+    for (n = 0; n < NBRANCH; n++)
+    {
+        mdot[n] = 0.0;
+        FROM(n) = (int32_T)FROMNODE(n);
+        TO(n) = (int32_T)TONODE(n);
+    }
+    for (n = 0; n < nn; n++)
+        press[n] = 0.0;
+    count[0] = 0.0;
+    count[1] = 0.0;
+}
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Newton iteration for massflows and pressures of the network.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    InputRealPtrsType u0 = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType u1 = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2 = ssGetInputPortRealSignalPtrs(S,2);
+    real_T *y0    = ssGetOutputPortRealSignal(S,0);
+    real_T *y1    = ssGetOutputPortRealSignal(S,1);
+    real_T *y2    = ssGetOutputPortRealSignal(S,2);
+    real_T *mdot0 = (real_T *)ssGetDWork(S, DWORK_MDOT_NR);
+    real_T *press0 = (real_T *)ssGetDWork(S, DWORK_PRESS_NR);
+    real_T *work  = (real_T *)ssGetDWork(S, DWORK_WORK_NR);
+    real_T *count = (real_T *)ssGetDWork(S, DWORK_COUNT_NR);
+    const int32_T *node = (const int32_T *)ssGetDWork(S, DWORK_NODE_NR);
+    int_T  nb = NBRANCH;
+    int_T  nn = number_of_nodes(S);
+    int_T  ref = REFNODE;
+    int_T  maxiter = MAXITER;
+    real_T tol = TOL;
+    real_T pref = PREF;
+    real_T *f   = work;                 /* pressure residual of the branches */
+    real_T *w   = work + nb;            /* 1/(d dp/d mdot) of the branches */
+    real_T *h   = work + 2*nb;          /* mass residual of the nodes, then right hand side */
+    real_T *dp  = work + 2*nb + nn;     /* pressure correction */
+    real_T *pcg = work + 2*nb + 2*nn;   /* work arrays of the conjugate gradients */
+    real_T *mdot  = work + 3*nb + 7*nn; /* massflows of the iteration */
+    real_T *press = work + 4*nb + 7*nn; /* pressures of the iteration */
+    real_T ab, fmax, hmax, dpdm, am;
+    int_T  n, b, iter;
+
+    /* iterate on a copy, the warm start is kept for the next major step */
+    for (b = 0; b < nb; b++)
+        mdot[b] = mdot0[b];
+    for (n = 0; n < nn; n++)
+        press[n] = press0[n];
+
+    fmax = 0.0;
+    for (iter = 0; iter <= maxiter; iter++)
+    {
+        /* residuals and derivatives of the branches */
+        fmax = 0.0;
+        for (b = 0; b < nb; b++)
+        {
+            if (ID(b) < 0.0)            /* closed branch */
+            {
+                mdot[b] = 0.0;
+                f[b] = 0.0;
+                w[b] = 0.0;
+                continue;
+            }
+            ab = fabs(mdot[b]);
+            am = max(ab, MDOTREG);
+            dpdm = (LIN(b)-PULIN(b)) + 2.0*(QUA(b)-PUQUA(b))*am;
+            w[b] = 1.0/max(dpdm, DPDMMIN);
+            f[b] = press[FROM(b)] - press[TO(b)]
+                - ((CON(b)-PUCON(b)) + (LIN(b)-PULIN(b))*mdot[b] + (QUA(b)-PUQUA(b))*mdot[b]*ab);
+            fmax = max(fmax, fabs(f[b]));
+        }
+        /* mass balance of the nodes */
+        incidence_mult(node, h, mdot, nn, nb);
+        h[ref] = 0.0;
+        hmax = 0.0;
+        for (n = 0; n < nn; n++)
+            hmax = max(hmax, fabs(h[n]));
+        if ((fmax <= tol && hmax <= MDOTTOL) || iter == maxiter)
+            break;
+
+        /* right hand side A*W*f + h and pressure correction */
+        for (b = 0; b < nb; b++)
+        {
+            if (TO(b) != FROM(b))
+            {
+                h[TO(b)] += w[b]*f[b];
+                h[FROM(b)] -= w[b]*f[b];
+            }
+        }
+        solve_network_pcg(node, ref, dp, h, w, pcg, nn, nb);
+
+        /* new massflows and pressures */
+        for (b = 0; b < nb; b++)
+            mdot[b] += w[b]*(f[b] - (dp[TO(b)] - dp[FROM(b)]));
+        for (n = 0; n < nn; n++)
+            press[n] += dp[n];
+    }
+
+    if (ssIsMajorTimeStep(S))
+    {
+        for (b = 0; b < nb; b++)
+            mdot0[b] = mdot[b];
+        for (n = 0; n < nn; n++)
+            press0[n] = press[n];
+        count[0] += 1.0;
+        if (fmax > tol)
+            count[1] += 1.0;
+    }
+
+    /* set outputs */
+    for (b = 0; b < nb; b++)
+        y0[b] = mdot[b];
+    for (n = 0; n < nn; n++)
+        y1[n] = press[n] + pref;
+    y2[0] = (real_T)iter;
+    y2[1] = fmax;
+} /* end mdlOutputs */
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    Report calls without convergence.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    real_T *count = (real_T *)ssGetDWork(S, DWORK_COUNT_NR);
+
+    if (count != NULL && count[1] > 0.0)
+        ssPrintf("hydraulic_network %s: no convergence in %.0f of %.0f calls\n",
+            ssGetPath(S), count[1], count[0]);
+}
+
+
+/*======================================================*
+ * See sfuntmpl.doc for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,215 @@
+function [v, s] = verify_hydraulic_network(varargin)
+% verification of the s-function hydraulic_network with the analytical
+% solution of a pump loop with two parallel branches: with only quadratic
+% pressure drops the massflow of the loop is 
+%   mdot = sqrt(pc/(q0 - pq + qpar)),  qpar = 1/(1/sqrt(q1)+1/sqrt(q2))^2
+% and the massflow of a parallel branch is mdot*sqrt(qpar/qi). The pump
+% pressure rises with time, after 6 s the second parallel branch is closed.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_hydraulic_network(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_hydraulic_network' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_hydraulic_network:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-4;       % max error between analytical solution and simulation in kg/s
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_hydraulic_network_mdl';
+
+% network: branch 1 from node 1 to 2 with the pump, branches 2 and 3 back
+% from node 2 to node 1, node 1 is the reference node
+q = [1e5, 2e5, 5e5];    % quadratic pressure drop coefficients in Pa/(kg/s)^2
+pq = -2e5;              % quadratic coefficient of the pump characteristic
+pc0 = 2e4;              % pump pressure at t = 0 in Pa
+dpc = 2e3;              % rise of the pump pressure in Pa/s
+tclose = 6;             % closing time of branch 3 in s
+pref = 1e5;             % pressure at the reference node in Pa
+tstep = 1;              % sample time in s
+tend = 10;              % simulation time in s
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+% hydraulic vector of the branches [ID c l q], the ID of branch 3 is the step
+add_block('simulink/Sources/Constant', [mdl '/hyd'], 'Value', ...
+    mat2str([1 0 0 q(1), 1 0 0 q(2), 0 0 0 q(3)]));
+add_block('simulink/Sources/Step', [mdl '/close'], 'Time', num2str(tclose), ...
+    'Before', '1', 'After', '-1');
+add_block('simulink/Math Operations/Gain', [mdl '/idgain'], 'Gain', ...
+    mat2str([0 0 0 0 0 0 0 0 1 0 0 0]));
+add_block('simulink/Math Operations/Sum', [mdl '/hydsum'], 'Inputs', '++');
+% pump characteristic [pc pl pq] of the branches, pc is the ramp
+add_block('simulink/Sources/Constant', [mdl '/pump'], 'Value', ...
+    mat2str([0 0 pq, 0 0 0, 0 0 0]));
+add_block('simulink/Sources/Ramp', [mdl '/pc'], 'Slope', num2str(dpc), ...
+    'Start', '0', 'InitialOutput', num2str(pc0));
+add_block('simulink/Math Operations/Gain', [mdl '/pcgain'], 'Gain', ...
+    mat2str([1 0 0 0 0 0 0 0 0]));
+add_block('simulink/Math Operations/Sum', [mdl '/pumpsum'], 'Inputs', '++');
+add_block('simulink/Sources/Constant', [mdl '/pref'], 'Value', num2str(pref));
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/network'], ...
+    'FunctionName', 'hydraulic_network', 'Parameters', '[1 2 2], [2 1 1], 1');
+add_block('simulink/Sinks/Out1', [mdl '/mdot']);
+add_block('simulink/Sinks/Out1', [mdl '/p']);
+add_block('simulink/Sinks/Terminator', [mdl '/iter']);
+add_line(mdl, 'hyd/1', 'hydsum/1');
+add_line(mdl, 'close/1', 'idgain/1');
+add_line(mdl, 'idgain/1', 'hydsum/2');
+add_line(mdl, 'pump/1', 'pumpsum/1');
+add_line(mdl, 'pc/1', 'pcgain/1');
+add_line(mdl, 'pcgain/1', 'pumpsum/2');
+add_line(mdl, 'hydsum/1', 'network/1');
+add_line(mdl, 'pumpsum/1', 'network/2');
+add_line(mdl, 'pref/1', 'network/3');
+add_line(mdl, 'network/1', 'mdot/1');
+add_line(mdl, 'network/2', 'p/1');
+add_line(mdl, 'network/3', 'iter/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % massflows of the branches, node pressures
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = (0:size(yy,1)-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+pc = pc0 + dpc*t0;
+open3 = t0 < tclose;
+qpar = q(2)*ones(size(t0));                 % only branch 2 is open
+qpar(open3) = 1/(1/sqrt(q(2))+1/sqrt(q(3)))^2;
+mloop = sqrt(pc./(q(1) - pq + qpar));
+y0 = [mloop, mloop.*sqrt(qpar/q(2)), mloop.*sqrt(qpar/q(3)).*open3];
+
+% ----------------- set reference values initial simulation ---------------
+% result of hydraulic_network at creation of the function
+y1 = [0.230924896033957,0.141458613970208,0.0894662820637487;0.242196229368811,0.148363140444651,0.0938330889241596; ...
+    0.252965661581914,0.154960215833123,0.0980054457487911;0.263294974934476,0.161287685800831,0.102007289133645; ...
+    0.273234085132896,0.167376127417392,0.105857957715503;0.282824131113476,0.173250741330234,0.109573389783242; ...
+    0.252982225420329,0.252982225420329,0;0.260768123719007,0.260768123719007,0; ...
+    0.268328179669271,0.268328179669271,0;0.275680993441977,0.275680993441977,0; ...
+    0.28284272776709,0.28284272776709,0];
+
+% current simulation
+y2 = yy(:,1:3);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in s';                   % x-axis label
+    st = 'Massflow in the pump loop';   % title
+    sy1 = 'Massflow in kg/s';           % y-axis label in the upper plot
+    sy2 = 'Max difference of the branches'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'analytical solution','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'solution vs initial simu','solution vs current simu','initial simu vs current'};
+    % x axis
+    x = t0;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,151 @@
+function [r, s] = benchmark_pipe_PressureDrop(varargin)
+% benchmark of the s-function pipe_PressureDrop
+% Compares the computing time and the results of the block in the mode 
+% of version 6.1 (properties in each call, Blasius / Nikuradse) with the
+% property cache and the Swamee-Jain and Haaland friction factors.
+% The test model is created in memory and closed without saving.
+% Syntax:   [r, s] = benchmark_pipe_PressureDrop(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : no display
+%               1 : display the table of results (default)
+% Outputs:  r - struct array with fields: name, parameters, time (s), 
+%               dpmax (max. deviation of the pressure drop from the 
+%               reference in Pa), dprel (max. relative deviation)
+%           s - text string with the result table
+%                                                                          
+% Literature:   Swamee, P.K., Jain, A.K.: Explicit equations for pipe-flow
+%               problems, J. Hydraulics Division (ASCE) 102 (5), 1976
+%               Haaland, S.E.: Simple and explicit formulas for the 
+%               friction factor in turbulent pipe flow, J. Fluids Eng. 
+%               105 (1), 1983
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 1;
+elseif nargin == 1
+    show = varargin{1};
+else  
+    error('benchmark_pipe_PressureDrop:%s',' too many input arguments')
+end
+
+% ---------- parameters: diameter, length, roughness, bends ---------------
+pipe = '0.02, 10, 4e-5, 2';
+% cases: name and additional parameters FRICTION, PROPDT
+cases = {'version 6.1 (reference)',   '0, -1'; ...
+         'cache, exact',              '0, 0'; ...
+         'cache, 0.1 K',              '0, 0.1'; ...
+         'Swamee-Jain, cache 0.1 K',  '1, 0.1'; ...
+         'Haaland, cache 0.1 K',      '2, 0.1'};
+nrep = 3;               % repetitions, the fastest run is used
+
+% ---------- create the test model ----------------------------------------
+mdl = 'benchmark_pipe_PressureDrop_mdl';
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Ramp', [mdl '/T'], 'Slope', '0.004', ...
+    'InitialOutput', '10');
+add_block('simulink/Sources/Sine Wave', [mdl '/mdot'], 'Amplitude', '0.25', ...
+    'Bias', '0.26', 'Frequency', '0.05', 'SampleTime', '0');
+add_block('simulink/Sources/Constant', [mdl '/p'], 'Value', '3e5');
+add_block('simulink/Sources/Constant', [mdl '/fluid'], 'Value', '1');
+add_block('simulink/Sources/Constant', [mdl '/mix'], 'Value', '0');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/pd'], ...
+    'FunctionName', 'pipe_PressureDrop', 'Parameters', pipe);
+add_block('simulink/Sinks/Terminator', [mdl '/lin']);
+add_block('simulink/Sinks/Terminator', [mdl '/qua']);
+add_block('simulink/Sinks/Out1', [mdl '/dp']);
+add_line(mdl, 'T/1', 'pd/1');
+add_line(mdl, 'mdot/1', 'pd/2');
+add_line(mdl, 'p/1', 'pd/3');
+add_line(mdl, 'fluid/1', 'pd/4');
+add_line(mdl, 'mix/1', 'pd/5');
+add_line(mdl, 'pd/1', 'lin/1');
+add_line(mdl, 'pd/2', 'qua/1');
+add_line(mdl, 'pd/3', 'dp/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', '0.01', ...
+    'StopTime', '2e4');
+
+% ---------- simulate all cases -------------------------------------------
+r = struct('name', cases(:,1), 'parameters', '', 'time', 0, ...
+    'dpmax', 0, 'dprel', 0);
+for n = 1:size(cases,1)
+    r(n).parameters = [pipe ', ' cases{n,2}];
+    set_param([mdl '/pd'], 'Parameters', r(n).parameters);
+    r(n).time = inf;
+    for m = 1:nrep
+        tic
+        simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+        r(n).time = min(r(n).time, toc);
+    end
+    dp = simOut.get('yout');
+    if n == 1
+        dp0 = dp;       % reference
+    end
+    r(n).dpmax = max(abs(dp-dp0));
+    r(n).dprel = max(abs(dp-dp0)./max(abs(dp0),1));
+end
+close_system(mdl, 0)    % close system, but do not save it
+
+% ------------ result table -----------------------------------------------
+s = sprintf('%-28s %10s %8s %12s %10s\n', 'case', 'time in s', 'speedup', ...
+    'max. dp in Pa', 'max. rel.');
+for n = 1:length(r)
+    s = [s, sprintf('%-28s %10.3f %8.2f %12.4g %10.3g\n', r(n).name, ...
+        r(n).time, r(1).time/r(n).time, r(n).dpmax, r(n).dprel)]; %#ok<AGROW>
+end
+if (show)
+    disp(s)
+end
+
+%% Copyright an file history
+% This file is part of the CARNOT Blockset.
+% 
+% 
+% Copyright (c) 1998-2026, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                         Date
+% 6.2.0     hf      created                                         19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
\ No newline at end of file
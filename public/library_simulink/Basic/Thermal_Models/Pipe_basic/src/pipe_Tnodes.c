@@ -49,6 +49,7 @@
  * 6.0.2    Arnold Wohlfeil SimState compiliance and                11aug2015
  *                          MultipleExecInstanes enabled
  * 6.0.3    Arnold Wohlfeil unused variables deleted                09sep2015
+ * 6.1.0    hf              analytic Jacobian (mdlJacobian)         19oct2026
  *
  * Copyright (c) 1998 Solar-Institut Juelich, Germany
  * 
@@ -85,6 +86,11 @@
  *  0       temperature                                     degree Celsius  
  *  1       node temperatures (vector)                      degree Celsius 
  *
+ * The derivative of a node only depends on the node and its two 
+ * neighbours, the analytic Jacobian in mdlJacobian is tridiagonal. 
+ * The properties are evaluated at the inlet temperature, their 
+ * derivatives are neglected.
+ *
  */
 
 
@@ -123,6 +129,9 @@
 #define PERCENTAGE (*u5[0])     /* mixture  (defined in CARNOT.h) */
 #define N_INPUT_PORTS 6
 
+/* number of nonzero elements of the Jacobian */
+#define JAC_NZ(nodes)   (6*(nodes))
+
 
 /*====================*
  * S-function methods *
@@ -170,6 +179,7 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumPWork(S, 0);
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
+    ssSetJacobianNzMax(S, JAC_NZ((int_T)NODES));
     
     ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
     ssSetSimStateVisibility(S, 1);
@@ -305,6 +315,100 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 
 
 
+#define MDL_JACOBIAN  /* Change to #undef to remove function */
+#if defined(MDL_JACOBIAN)
+  /* Function: mdlJacobian ====================================================
+   * Abstract:
+   *    Analytic Jacobian [A B; C D] as sparse matrix in compressed column 
+   *    format, (nx+ny) rows and (nx+nu) columns. The pattern is the same 
+   *    in each call, the columns of pressure, fluid ID and mixture are 
+   *    empty.
+   */
+  static void mdlJacobian(SimStruct *S)
+  {
+    real_T  *pr = ssGetJacobianPr(S);
+    int_T   *ir = ssGetJacobianIr(S);
+    int_T   *jc = ssGetJacobianJc(S);
+    real_T  *x  = ssGetContStates(S);
+    InputRealPtrsType u1 = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2 = ssGetInputPortRealSignalPtrs(S,2);
+    InputRealPtrsType u3 = ssGetInputPortRealSignalPtrs(S,3);
+    InputRealPtrsType u4 = ssGetInputPortRealSignalPtrs(S,4);
+    InputRealPtrsType u5 = ssGetInputPortRealSignalPtrs(S,5);
+
+    real_T vnode  = VNODE;
+    int_T  nodes  = (int)NODES;
+
+    real_T invcap, rho, cpf, flow, loss, cond;
+    int_T  n, col, nz;
+
+    rho = density(FLUID_ID, PERCENTAGE, TIN, PRESS);
+    cpf = heat_capacity(FLUID_ID, PERCENTAGE, TIN, PRESS);
+    invcap = 1.0/(rho*cpf + CWALL);
+    flow = cpf/vnode*invcap;                    /* flow term without massflow */
+    loss = LOSS*invcap;
+    cond = COND*invcap;
+
+    nz = 0;
+    col = 0;
+    /* columns of the states */
+    for (n = 0; n < nodes; n++)
+    {
+        jc[col++] = nz;
+        if (n > 0)                              /* node before: conduction forwards */
+        {
+            ir[nz] = n-1;
+            pr[nz++] = cond;
+        }
+        ir[nz] = n;                             /* the node itself */
+        pr[nz] = -loss - flow*MDOT;
+        if (n < nodes-1)
+            pr[nz] -= cond;
+        if (n > 0)
+            pr[nz] -= cond;
+        nz++;
+        if (n < nodes-1)                        /* next node: conduction and flow */
+        {
+            ir[nz] = n+1;
+            pr[nz++] = cond + flow*MDOT;
+        }
+        else                                    /* outlet temperature */
+        {
+            ir[nz] = nodes;
+            pr[nz++] = 1.0;
+        }
+        ir[nz] = nodes+1+n;                     /* node temperature output */
+        pr[nz++] = 1.0;
+    }
+
+    /* TAMB */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;
+        pr[nz++] = loss;
+    }
+    /* TIN */
+    jc[col++] = nz;
+    ir[nz] = 0;
+    pr[nz++] = flow*MDOT;
+    /* MDOT */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;
+        pr[nz++] = flow*(((n > 0)? T(n-1) : TIN) - T(n));
+    }
+    /* PRESS, FLUID_ID, PERCENTAGE */
+    jc[col++] = nz;
+    jc[col++] = nz;
+    jc[col++] = nz;
+    jc[col] = nz;
+  }
+#endif /* MDL_JACOBIAN */
+
+
+
 /* Function: mdlTerminate =====================================================
  * Abstract:
  *    In this function, you should perform any actions that are necessary
@@ -0,0 +1,221 @@
+function [v, s] = verify_pipe_bundle(varargin)
+% verification of the s-function pipe_bundle with the s-function 
+% pipe_Tnodes: a bundle of three different pipes is compared to three 
+% single pipes with the same parameters. Both blocks solve the same 
+% equations, the results must be equal up to rounding errors.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_pipe_bundle(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_pipe_bundle' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_pipe_bundle:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-6;       % max error between bundle and single pipes in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_pipe_bundle_mdl';
+
+% pipes: length, inner diameter, heat loss coefficient, axial conduction, 
+% capacity of the wall per length, initial temperature, number of nodes
+len = [10 20 5];
+dia = [0.02 0.05 0.03];
+uval = 2;
+lambda = [0 0.5 1];
+cwall = [100 300 50];
+tini = 20;
+nodes = [5 10 8];
+tamb = 10;              % ambient temperature in degC
+tin = [60 50 40];       % inlet temperatures in degC
+mdot = [0.02 0.05 0.01];% mass flow in kg/s
+tstep = 10;             % fixed step of the solver in s
+tend = 3600;            % simulation time in s
+nsample = 300/tstep;    % results every 5 minutes
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '4');
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'mux/1', 'y/1');
+
+% bundle with all pipes
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/bundle'], ...
+    'FunctionName', 'pipe_bundle', 'Parameters', ...
+    [mat2str(len) ',' mat2str(dia) ',' num2str(uval) ',' mat2str(lambda) ',' ...
+    mat2str(cwall) ',' num2str(tini) ',' mat2str(nodes)]);
+add_block('simulink/Sinks/Terminator', [mdl '/Tnodes']);
+add_line(mdl, 'bundle/1', 'mux/1');
+add_line(mdl, 'bundle/2', 'Tnodes/1');
+
+% single pipes, parameters per node as in the mask of pipe_Tnodes
+for p = 0:3
+    if p == 0   % inputs of the bundle
+        blk = 'bundle';
+        ip = 1:3;
+    else
+        blk = ['pipe' num2str(p)];
+        ip = p;
+        area = pi/4*dia(p)^2;
+        dh = len(p)/nodes(p);
+        add_block('simulink/User-Defined Functions/S-Function', [mdl '/' blk], ...
+            'FunctionName', 'pipe_Tnodes', 'Parameters', ...
+            sprintf('%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%d', area*dh, dh, ...
+            4*uval/dia(p), lambda(p)/dh^2, cwall(p)/area, tini, nodes(p)));
+        add_block('simulink/Sinks/Terminator', [mdl '/' blk 'T']);
+        add_line(mdl, [blk '/1'], ['mux/' num2str(p+1)]);
+        add_line(mdl, [blk '/2'], [blk 'T/1']);
+    end
+    val = {tamb*ones(size(ip)), tin(ip), mdot(ip), 1e5*ones(size(ip)), ...
+        ones(size(ip)), zeros(size(ip))};
+    for k = 1:6
+        add_block('simulink/Sources/Constant', [mdl '/' blk '_u' num2str(k)], ...
+            'Value', mat2str(val{k}));
+        add_line(mdl, [blk '_u' num2str(k) '/1'], [blk '/' num2str(k)]);
+    end
+end
+set_param(mdl, 'Solver', 'ode4', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % outlets of the bundle, outlets of the pipes
+close_system(mdl, 0)            % close system, but do not save it
+
+idx = 1:nsample:size(yy,1);     % values every 5 minutes
+t0 = (idx-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% outlet temperatures of the single pipes
+y0 = yy(idx,4:6);
+
+% ----------------- set reference values initial simulation ---------------
+% result of pipe_bundle at creation of the function
+y1 = [20,20,20;57.1481647514848,20.0401422849391,26.9386308973112; ...
+    59.2527602655305,26.2238126552956,38.5200269209013;59.2558583904933,39.5995336999779,39.318788538158; ...
+    59.2558601044554,46.7460780067817,39.3316020095096;59.2558601050721,48.5119724795108,39.3317036450314; ...
+    59.2558601050722,48.783741046051,39.3317041814868;59.2558601050722,48.81420860814,39.3317041836603; ...
+    59.2558601050722,48.8169335675579,39.3317041836676;59.2558601050722,48.8171394068652,39.3317041836676; ...
+    59.2558601050722,48.8171530476038,39.3317041836676;59.2558601050722,48.8171538619484,39.3317041836676; ...
+    59.2558601050722,48.8171539065954,39.3317041836676];
+
+% current simulation of the bundle
+y2 = yy(idx,1:3);
+
+%% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3f > allowed error %3.3f', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3f > allowed error %3.3f', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3f', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in min';                     % x-axis label
+    st = 'Outlet temperature of pipe 2';    % title
+    sy1 = 'Temperature in degC';            % y-axis label in the upper plot
+    sy2 = 'Max difference of the pipes';    % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'pipe\_Tnodes','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'Tnodes vs initial simu','Tnodes vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/60;              % time in min
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,2), y1(:,2), y2(:,2)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,263 @@
+function [v, s] = verify_pipe_plugflow2(varargin)
+% verification of the s-function pipe_plugflow: exact transport delay of
+% a step of the inlet temperature. The inlet temperature steps from 20 to 
+% 60 degC at t = 600 s, the front reaches the outlet and the centres of 
+% the nodes after the delay V*(rho*cp+cwall)/(mdot*cp) of the volume V 
+% from the inlet. Without losses and conduction the temperatures must
+% switch from 20 to 60 degC in the first time step after the delay, which 
+% is not a multiple of the time step. Compared are the outlet and all
+% node temperatures in each time step.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_pipe_plugflow2(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_pipe_plugflow2' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_pipe_plugflow2:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-9;       % max error between analytical solution and simulation in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_pipe_plugflow2_mdl';
+
+% pipe: 10 nodes of 1 l, no losses, no conduction, wall capacity 
+% 4.18e6 J/(m^3*K), initial temperature 20 degC, default number of segments
+vnode = 0.001;
+nodes = 10;
+cwall = 4.18e6;
+tini = 20;
+pipe = sprintf('%g, 1, 0, 0, %g, %g, %d', vnode, cwall, tini, nodes);
+tamb = 10;              % ambient temperature in degC
+tin = 60;               % inlet temperature in degC after the step
+tjump = 600;            % time of the step in s
+mdot = 0.01;            % mass flow in kg/s
+tstep = 60;             % sample time in s
+tend = 3600;            % simulation time in s
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Constant', [mdl '/Tamb'], 'Value', num2str(tamb));
+add_block('simulink/Sources/Step', [mdl '/Tin'], 'Time', num2str(tjump), ...
+    'Before', num2str(tini), 'After', num2str(tin));
+add_block('simulink/Sources/Constant', [mdl '/mdot'], 'Value', num2str(mdot));
+add_block('simulink/Sources/Constant', [mdl '/p'], 'Value', '1e5');
+add_block('simulink/Sources/Constant', [mdl '/fluid_id'], 'Value', '1');
+add_block('simulink/Sources/Constant', [mdl '/fluid_mix'], 'Value', '0');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/pipe'], ...
+    'FunctionName', 'pipe_plugflow', 'Parameters', pipe);
+add_block('simulink/Sinks/Out1', [mdl '/Tout']);
+add_block('simulink/Sinks/Out1', [mdl '/Tnodes']);
+add_line(mdl, 'Tamb/1', 'pipe/1');
+add_line(mdl, 'Tin/1', 'pipe/2');
+add_line(mdl, 'mdot/1', 'pipe/3');
+add_line(mdl, 'p/1', 'pipe/4');
+add_line(mdl, 'fluid_id/1', 'pipe/5');
+add_line(mdl, 'fluid_mix/1', 'pipe/6');
+add_line(mdl, 'pipe/1', 'Tout/1');
+add_line(mdl, 'pipe/2', 'Tnodes/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % outlet temperature, node temperatures
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = (0:size(yy,1)-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% the front reaches the outlet and the node centres after the delay
+cp = heat_capacity(tin, 1e5, 1, 0);
+cap = density(tin, 1e5, 1, 0)*cp + cwall;
+vpos = [nodes, (1:nodes)-0.5]*vnode;        % volume from the inlet
+y0 = tini*ones(length(t0), nodes+1);
+for n = 1:nodes+1
+    delay = vpos(n)*cap/(mdot*cp);          % transport delay of the front
+    y0(t0 >= tjump+delay,n) = tin;
+end
+
+% ----------------- set reference values initial simulation ---------------
+% result of pipe_plugflow at creation of the function
+y1 = [20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,20,20,20,20,20,20,20,20,20,20; ...
+    20,60,20,20,20,20,20,20,20,20,20; ...
+    20,60,20,20,20,20,20,20,20,20,20; ...
+    20,60,20,20,20,20,20,20,20,20,20; ...
+    20,60,60,20,20,20,20,20,20,20,20; ...
+    20,60,60,20,20,20,20,20,20,20,20; ...
+    20,60,60,20,20,20,20,20,20,20,20; ...
+    20,60,60,20,20,20,20,20,20,20,20; ...
+    20,60,60,60,20,20,20,20,20,20,20; ...
+    20,60,60,60,20,20,20,20,20,20,20; ...
+    20,60,60,60,20,20,20,20,20,20,20; ...
+    20,60,60,60,60,20,20,20,20,20,20; ...
+    20,60,60,60,60,20,20,20,20,20,20; ...
+    20,60,60,60,60,20,20,20,20,20,20; ...
+    20,60,60,60,60,60,20,20,20,20,20; ...
+    20,60,60,60,60,60,20,20,20,20,20; ...
+    20,60,60,60,60,60,20,20,20,20,20; ...
+    20,60,60,60,60,60,20,20,20,20,20; ...
+    20,60,60,60,60,60,60,20,20,20,20; ...
+    20,60,60,60,60,60,60,20,20,20,20; ...
+    20,60,60,60,60,60,60,20,20,20,20; ...
+    20,60,60,60,60,60,60,60,20,20,20; ...
+    20,60,60,60,60,60,60,60,20,20,20; ...
+    20,60,60,60,60,60,60,60,20,20,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,20; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    20,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001; ...
+    60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001,60.0000000000001];
+
+% current simulation
+y2 = yy;
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in min';                 % x-axis label
+    st = 'Outlet temperature of the pipe'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Max difference of all nodes'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'analytical solution','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'solution vs initial simu','solution vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/60;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
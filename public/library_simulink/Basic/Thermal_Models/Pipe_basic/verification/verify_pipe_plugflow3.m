@@ -0,0 +1,226 @@
+function [v, s] = verify_pipe_plugflow3(varargin)
+% verification of the s-function pipe_plugflow with axial conduction: the
+% parameter set of pipe_Tnodes (50 nodes) is used unchanged. After a step 
+% of the inlet temperature at t = 0 the outlet temperature is compared 
+% with the analytical solution of the advection-diffusion equation 
+% (Ogata and Banks) with the thermal velocity mdot*cp/(rho*cp+cwall) and
+% the diffusivity COND*VNODE^2/(rho*cp+cwall) in volume coordinates. The
+% conduction is high (Peclet number 209), so the front is smeared over 
+% several nodes. The block solves the conduction implicitly in each time 
+% step, the error is mainly the time discretisation.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_pipe_plugflow3(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   Ogata, A., Banks, R.B.: A solution of the differential 
+%               equation of longitudinal dispersion in porous media, 
+%               U.S. Geological Survey Professional Paper 411-A, 1961
+
+% all comments above appear with 'help verify_pipe_plugflow3' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_pipe_plugflow3:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1;          % max error between analytical solution and simulation in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_pipe_plugflow3_mdl';
+
+% pipe: 10 l in 50 nodes of 0.2 m, no losses, conduction 5e4 W/(m^3*K), 
+% wall capacity 4.18e6 J/(m^3*K), initial temperature 20 degC
+nodes = 50;
+vnode = 0.01/nodes;
+cond = 5e4;
+cwall = 4.18e6;
+tini = 20;
+pipe = sprintf('%g, %g, 0, %g, %g, %g, %d', vnode, 10/nodes, cond, cwall, tini, nodes);
+tamb = 10;              % ambient temperature in degC
+tin = 60;               % inlet temperature in degC (step at t = 0)
+mdot = 0.01;            % mass flow in kg/s
+tstep = 10;             % sample time in s
+tend = 3960;            % simulation time in s
+nsample = 60/tstep;     % results every minute
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Constant', [mdl '/Tamb'], 'Value', num2str(tamb));
+add_block('simulink/Sources/Constant', [mdl '/Tin'], 'Value', num2str(tin));
+add_block('simulink/Sources/Constant', [mdl '/mdot'], 'Value', num2str(mdot));
+add_block('simulink/Sources/Constant', [mdl '/p'], 'Value', '1e5');
+add_block('simulink/Sources/Constant', [mdl '/fluid_id'], 'Value', '1');
+add_block('simulink/Sources/Constant', [mdl '/fluid_mix'], 'Value', '0');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/pipe'], ...
+    'FunctionName', 'pipe_plugflow', 'Parameters', pipe);
+add_block('simulink/Sinks/Out1', [mdl '/Tout']);
+add_block('simulink/Sinks/Out1', [mdl '/Tnodes']);
+add_line(mdl, 'Tamb/1', 'pipe/1');
+add_line(mdl, 'Tin/1', 'pipe/2');
+add_line(mdl, 'mdot/1', 'pipe/3');
+add_line(mdl, 'p/1', 'pipe/4');
+add_line(mdl, 'fluid_id/1', 'pipe/5');
+add_line(mdl, 'fluid_mix/1', 'pipe/6');
+add_line(mdl, 'pipe/1', 'Tout/1');
+add_line(mdl, 'pipe/2', 'Tnodes/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % outlet temperature, node temperatures
+close_system(mdl, 0)            % close system, but do not save it
+
+idx = 1:nsample:size(yy,1);     % values every minute
+t0 = (idx-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% advection-diffusion with a step at the inlet (Ogata and Banks), in 
+% volume coordinates, at the outlet (volume V from the inlet)
+cp = heat_capacity(tin, 1e5, 1, 0);
+cap = density(tin, 1e5, 1, 0)*cp + cwall;
+u = mdot*cp/cap;                            % thermal volume flow in m^3/s
+D = cond*vnode^2/cap;                       % diffusivity in m^6/s
+V = nodes*vnode;
+t = max(t0, 1e-9);
+c = 0.5*erfc((V-u*t)./(2*sqrt(D*t))) ...
+    + 0.5*exp(u*V/D)*erfc((V+u*t)./(2*sqrt(D*t)));
+c(~isfinite(c)) = 0.5*erfc((V-u*t(~isfinite(c)))./(2*sqrt(D*t(~isfinite(c)))));
+y0 = tini + (tin-tini)*c;
+
+% ----------------- set reference values initial simulation ---------------
+% result of pipe_plugflow at creation of the function
+y1 = [20;20;20;20; ...
+    20;20;20;20; ...
+    20;20;20;20; ...
+    20;20;20.0000000000009;20.0000000000207; ...
+    20.0000000008404;20.0000000111143;20.0000002520271;20.0000021486237; ...
+    20.0000287879491;20.0001660377275;20.0013791875827;20.0056246065159; ...
+    20.0302678834306;20.0906036867815;20.3299794118436;20.7521845471095; ...
+    21.9432808363415;23.5053812524298;26.7676389258016;30.0627975932417; ...
+    35.365545747054;39.631044783993;45.0180171673836;49.304897341321; ...
+    52.7645467501334;55.2337771861915;57.0713811909888;58.2911319645928; ...
+    59.0471310603776;59.4905880895734;59.7381238586489;59.870187360945; ...
+    59.9377895796341;59.9711071322075;59.9869659161954;59.9942767863365; ...
+    59.9975492130243;59.9989747089208;59.9995802676762;59.9998316041986; ...
+    59.9999336989134;59.9999743499109;59.9999902379777;59.9999963412169; ...
+    59.9999986482206;59.9999995072347;59.9999998226211;59.9999999369003; ...
+    59.9999999778012;59.9999999922712;59.9999999973351;59.9999999990892; ...
+    59.9999999996911;59.9999999998957;59.9999999999648];
+
+% current simulation
+y2 = yy(idx,1);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in min';                 % x-axis label
+    st = 'Outlet temperature of the pipe'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Difference in K';            % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'analytical solution','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'solution vs initial simu','solution vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/60;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
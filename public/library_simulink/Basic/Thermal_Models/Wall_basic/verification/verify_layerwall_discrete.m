@@ -0,0 +1,215 @@
+function [v, s] = verify_layerwall_discrete(varargin)
+% verification of the discrete mode of the s-function layerwall 
+% (parameter TSAMPLE). With a zero-order-hold of the inputs the discrete 
+% exact state-space model gives the temperatures of the continuous node 
+% model at the sample points. The continuous model with held inputs is 
+% solved with a tight tolerance and is the reference. The boundary 
+% conditions are daily and yearly heat fluxes on both surfaces of a 
+% massive exterior wall with insulation.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_layerwall_discrete(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_layerwall_discrete' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_layerwall_discrete:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.01;       % max error between discrete and continuous model in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_layerwall_discrete_mdl';
+
+% wall: plaster, concrete, insulation, plaster (TAU, TINI, thickness, 
+% conductivity, heat capacity, density, no active layer)
+wall = ['600, 15, [0.015 0.2 0.12 0.01], [0.7 2.0 0.035 0.5], ', ...
+    '[1000 1000 1400 1000], [1400 2400 30 1200], -1'];
+tstep = 900;            % sample time in s
+tend = 28*86400;        % simulation time in s (4 weeks)
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qout'], 'Expr', ...
+    '80*sin(2*pi*u/86400)+5*sin(2*pi*u/31536000)');
+add_block('simulink/Sources/Constant', [mdl '/pact'], 'Value', '0');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qin'], 'Expr', ...
+    '-30*sin(4*pi*u/86400)-5*sin(2*pi*u/31536000)');
+add_block('simulink/Discrete/Zero-Order Hold', [mdl '/zoh_out'], ...
+    'SampleTime', num2str(tstep));
+add_block('simulink/Discrete/Zero-Order Hold', [mdl '/zoh_in'], ...
+    'SampleTime', num2str(tstep));
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/continuous'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', 0']);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/discrete'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', ' num2str(tstep)]);
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '4');
+add_block('simulink/Sinks/Terminator', [mdl '/act_continuous']);
+add_block('simulink/Sinks/Terminator', [mdl '/act_discrete']);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'qout/1');
+add_line(mdl, 't/1', 'qin/1');
+add_line(mdl, 'qout/1', 'zoh_out/1');
+add_line(mdl, 'qin/1', 'zoh_in/1');
+add_line(mdl, 'zoh_out/1', 'continuous/1');
+add_line(mdl, 'pact/1', 'continuous/2');
+add_line(mdl, 'zoh_in/1', 'continuous/3');
+add_line(mdl, 'qout/1', 'discrete/1');
+add_line(mdl, 'pact/1', 'discrete/2');
+add_line(mdl, 'qin/1', 'discrete/3');
+add_line(mdl, 'continuous/1', 'mux/1');
+add_line(mdl, 'continuous/3', 'mux/2');
+add_line(mdl, 'discrete/1', 'mux/3');
+add_line(mdl, 'discrete/3', 'mux/4');
+add_line(mdl, 'continuous/2', 'act_continuous/1');
+add_line(mdl, 'discrete/2', 'act_discrete/1');
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'ode15s', 'RelTol', '1e-8', 'AbsTol', '1e-8', ...
+    'MaxStep', num2str(tstep), 'StopTime', num2str(tend), ...
+    'OutputOption', 'SpecifiedOutputTimes', 'OutputTimes', ...
+    ['0:86400:' num2str(tend)], 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % daily values
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = (0:size(yy,1)-1)'*86400;
+
+%% ----------------- set the reference values -----------------------------
+% continuous node model: temperature of the first and the last node
+y0 = yy(:,1:2);
+
+% ----------------- set reference values initial simulation ---------------
+% result of the discrete model at creation of the function
+y1 = [15,15;13.6999289485408,29.1177212106193;13.6348352278874,31.0653574741583; ...
+    13.6368379442055,31.1210349308009;13.6492642604092,30.8827031288872;13.6632978696889,30.598919260079; ...
+    13.6775642347569,30.3084075197161;13.6918460318329,30.0172625977035;13.7061058920507,29.7265051153459; ...
+    13.7203344370647,29.4363665232602;13.7345266493741,29.1469553890776;13.7486781989202,28.8583609848623; ...
+    13.7627848729181,28.5706693736889;13.7768424882428,28.2839658897452;13.7908468788509,27.9983355026714; ...
+    13.8047938948665,27.7138628529701;13.8186794034764,27.4306322363462;13.832499290103,27.1487275801936; ...
+    13.8462494596153,26.8682324189536;13.8599258375412,26.5892298693975;13.873524371275,26.311802606002; ...
+    13.8870410312773,26.0360328364532;13.9004718122704,25.7620022772844;13.9138127344239,25.4897921296649; ...
+    13.9270598445345,25.2194830553368;13.9402092171977,24.9511551527122;13.9532569559707,24.6848879331393; ...
+    13.9661991945267,24.4207602973419;13.9790320978012,24.1588505120387];
+
+% current simulation
+y2 = yy(:,3:4);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in days';                % x-axis label
+    st = 'Surface temperatures of the wall'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Max difference of the surfaces'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'continuous model','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'continuous vs initial simu','continuous vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/86400;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
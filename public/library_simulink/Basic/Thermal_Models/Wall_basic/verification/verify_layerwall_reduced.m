@@ -0,0 +1,215 @@
+function [v, s] = verify_layerwall_reduced(varargin)
+% verification of the reduced model of the s-function layerwall 
+% (parameter MODETOL). The reduced model (dominant modes and lags for the 
+% neglected modes) is compared to the full node model with the same 
+% sample time. The boundary conditions are daily and yearly heat fluxes 
+% on both surfaces of a massive exterior wall with insulation.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_layerwall_reduced(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_layerwall_reduced' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_layerwall_reduced:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.05;       % max error between reduced and full model in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_layerwall_reduced_mdl';
+
+% wall: plaster, concrete, insulation, plaster (TAU, TINI, thickness, 
+% conductivity, heat capacity, density, no active layer, sample time)
+wall = ['600, 15, [0.015 0.2 0.12 0.01], [0.7 2.0 0.035 0.5], ', ...
+    '[1000 1000 1400 1000], [1400 2400 30 1200], -1, 900'];
+modetol = '0.01';       % recommended tolerance of the reduced model
+tstep = 900;            % sample time in s
+nweek = 7*24*3600/tstep;
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qout'], 'Expr', ...
+    '80*sin(2*pi*u/86400)+5*sin(2*pi*u/31536000)');
+add_block('simulink/Sources/Constant', [mdl '/pact'], 'Value', '0');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qin'], 'Expr', ...
+    '-30*sin(4*pi*u/86400)-5*sin(2*pi*u/31536000)');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/full'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', 0']);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/reduced'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', ' modetol]);
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '4');
+add_block('simulink/Sinks/Terminator', [mdl '/act_full']);
+add_block('simulink/Sinks/Terminator', [mdl '/act_reduced']);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'qout/1');
+add_line(mdl, 't/1', 'qin/1');
+add_line(mdl, 'qout/1', 'full/1');
+add_line(mdl, 'pact/1', 'full/2');
+add_line(mdl, 'qin/1', 'full/3');
+add_line(mdl, 'qout/1', 'reduced/1');
+add_line(mdl, 'pact/1', 'reduced/2');
+add_line(mdl, 'qin/1', 'reduced/3');
+add_line(mdl, 'full/1', 'mux/1');
+add_line(mdl, 'full/3', 'mux/2');
+add_line(mdl, 'reduced/1', 'mux/3');
+add_line(mdl, 'reduced/3', 'mux/4');
+add_line(mdl, 'full/2', 'act_full/1');
+add_line(mdl, 'reduced/2', 'act_reduced/1');
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(365*24*3600-tstep), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % one row per sample time
+close_system(mdl, 0)            % close system, but do not save it
+
+idx = 1:nweek:size(yy,1);       % weekly values
+t0 = (idx-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% full node model: temperature of the first and the last node
+y0 = yy(idx,1:2);
+
+% ----------------- set reference values initial simulation ---------------
+% result of the reduced model at creation of the function
+y1 = [15,15;13.6917133282062,30.0169441133935;13.7907141759287,27.9980170203731; ...
+    13.8869083295178,26.0357143574768;13.978899397646,24.1585320376462;14.0653532747776,22.3936940009615; ...
+    14.1450161587972,20.7667949082648;14.216732734341,19.3014289532655;14.2794629278219,18.0188476864438; ...
+    14.3322969911535,16.9376518132732;14.3744686954222,16.0735214364609;14.4053664431635,15.4389886543975; ...
+    14.4245421380889,15.0432558137075;14.4317176836267,14.892062051712;14.4267890160327,14.9876000642722; ...
+    14.4098276135797,15.3284843060985;14.3810794599412,15.9097710846976;14.3409614767994,16.7230302565413; ...
+    14.2900554774143,17.7564674856929;14.2290997288461,18.995095291811;14.1589782451966,20.4209504069052; ...
+    14.0807079671446,22.0133542886299;13.9954240137099,23.7492130119716;13.9043632201238,25.6033521901769; ...
+    13.8088462005621,27.5488820676789;13.7102581958626,29.5575874902612;13.6100289839934,31.6003370968858; ...
+    13.5096121446219,33.6475057988543;13.4104639784917,35.6694044193035;13.3140223873446,37.6367102621126; ...
+    13.2216860206672,39.5208923659289;13.1347939917047,41.2946252760033;13.0546064568929,42.9321853331018; ...
+    12.9822863403734,44.4098237322921;12.9188824686189,45.7061109412936;12.8653143597729,46.8022474834555; ...
+    12.8223588882838,47.6823365781922;12.7906390182443,48.3336146849277;12.7706147688154,48.7466366070479; ...
+    12.7625765427792,48.9154124713712;12.7666409149501,48.8374945966311;12.782748941548,48.5140129910977; ...
+    12.8106670150291,47.9496589645726;12.8499902519957,47.1526170924164;12.9001483650369,46.1344465182807; ...
+    12.9604139333556,44.9099133170062;13.0299129522287,43.4967763487918;13.1076375083043,41.9155297103647; ...
+    13.1924603969286,40.1891055182002;13.2831514694862,38.3425413342515;13.378395473702,36.4026170572944; ...
+    13.4768111281564,34.3974665460418;13.5769711544032,32.3561696062161];
+
+% current simulation of the reduced model
+y2 = yy(idx,3:4);
+
+%% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3f > allowed error %3.3f', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3f > allowed error %3.3f', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3f', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in d';                       % x-axis label
+    st = 'Temperature of the last node';    % title
+    sy1 = 'Temperature in degC';            % y-axis label in the upper plot
+    sy2 = 'Max difference of both surfaces';% y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'full model','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'full vs initial simu','full vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/86400;           % time in d
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,2), y1(:,2), y2(:,2)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,221 @@
+function [v, s] = verify_layerwall_reduced2(varargin)
+% verification of the reduced model of the s-function layerwall for daily
+% and annual dynamics: with MODETOL = 0.5 the reduced model has only the
+% slow modes and one lag per surface (4 states instead of 13 nodes for 
+% a brick wall). The daily means of the surface temperatures are compared
+% with the full node model. The boundary conditions are daily and yearly
+% heat fluxes on both surfaces, the values of every 7th day are compared.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_layerwall_reduced2(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_layerwall_reduced2' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_layerwall_reduced2:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.1;        % max error of the daily means in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_layerwall_reduced2_mdl';
+
+% wall: plaster, brick, plaster (TAU, TINI, thickness, conductivity, 
+% heat capacity, density, no active layer, sample time)
+wall = ['600, 15, [0.015 0.365 0.015], [0.7 0.45 0.5], ', ...
+    '[1000 1000 1000], [1400 800 1200], -1, 900'];
+modetol = '0.5';        % tolerance of the reduced model for daily means
+tstep = 900;            % sample time in s
+nday = 24*3600/tstep;
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qout'], 'Expr', ...
+    '80*sin(2*pi*u/86400)+5*sin(2*pi*u/31536000)');
+add_block('simulink/Sources/Constant', [mdl '/pact'], 'Value', '0');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qin'], 'Expr', ...
+    '-30*sin(4*pi*u/86400)-5*sin(2*pi*u/31536000)');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/full'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', 0']);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/reduced'], ...
+    'FunctionName', 'layerwall', 'Parameters', [wall ', ' modetol]);
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '4');
+add_block('simulink/Sinks/Terminator', [mdl '/act_full']);
+add_block('simulink/Sinks/Terminator', [mdl '/act_reduced']);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'qout/1');
+add_line(mdl, 't/1', 'qin/1');
+add_line(mdl, 'qout/1', 'full/1');
+add_line(mdl, 'pact/1', 'full/2');
+add_line(mdl, 'qin/1', 'full/3');
+add_line(mdl, 'qout/1', 'reduced/1');
+add_line(mdl, 'pact/1', 'reduced/2');
+add_line(mdl, 'qin/1', 'reduced/3');
+add_line(mdl, 'full/1', 'mux/1');
+add_line(mdl, 'full/3', 'mux/2');
+add_line(mdl, 'reduced/1', 'mux/3');
+add_line(mdl, 'reduced/3', 'mux/4');
+add_line(mdl, 'full/2', 'act_full/1');
+add_line(mdl, 'reduced/2', 'act_reduced/1');
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(365*24*3600-tstep), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % one row per sample time
+close_system(mdl, 0)            % close system, but do not save it
+
+% daily means of both surfaces, every 7th day
+ym = zeros(size(yy,1)/nday, 4);
+for n = 1:4
+    ym(:,n) = mean(reshape(yy(:,n), nday, []))';
+end
+idx = 7:7:size(ym,1);
+t0 = idx'*86400;
+
+%% ----------------- set the reference values -----------------------------
+% full node model: daily means of the first and the last node
+y0 = ym(idx,1:2);
+
+% ----------------- set reference values initial simulation ---------------
+% daily means of the reduced model at creation of the function
+y1 = [17.9245199359533,17.4669711338561;18.1759569311922,17.2062468919267;18.4204921642949,16.9526839070431; ...
+    18.6545791229555,16.7099596178217;18.8748229481614,16.4815941466373;19.0780295417056,16.2708993763151; ...
+    19.2612518887715,16.0809309193675;19.4218327971781,15.9144438038059;19.5574434334556,15.7738525181945; ...
+    19.6661170968815,15.6611959953973;19.7462777416656,15.5781080428416;19.7967628336412,15.5257936481363; ...
+    19.8168402099811,15.5050115036723;19.8062186974286,15.5160630036443;19.765052335055,15.5587878730652; ...
+    19.6939381402979,15.6325664921629;19.5939074506841,15.7363288824496;19.4664109667998,15.8685702241444; ...
+    19.3132977134258,16.0273726799052;19.1367882239529,16.2104332083694;18.9394423369754,16.4150969641393; ...
+    18.7241220720899,16.638395799823;18.4939501232984,16.8770913117556;18.2522645719672,17.1277218051268; ...
+    18.0025704761178,17.3866524974008;17.7484890381293,17.6501282319495;17.4937050880521,17.9143279374193; ...
+    17.241913644157,18.1754200430283;16.9967663257286,18.4296180461327;16.7618183952563,18.67323542619; ...
+    16.5404771980435,18.9027391087264;16.3359527469955,19.1148007039438;16.1512111692299,19.3063447768763; ...
+    15.9889316896542,19.4745934490548;15.85146777536,19.6171066848432;15.7408130043367,19.7318176781892; ...
+    15.6585721534964,19.8170628265933;15.6059379253086,19.8716058575943;15.5836736505665,19.8946557578815; ...
+    15.5921022181414,19.8858782450054;15.6311013922675,19.8454006153303;15.7001055852737,19.7738098979103; ...
+    15.7981140600501,19.6721443410684;15.9237054432923,19.541878355143;16.0750583390466,19.38490112977; ...
+    16.2499777436051,19.2034892358078;16.445926878668,19.0002736092408;16.6600639811093,18.7782013958879; ...
+    16.8892835158065,18.5404932102572;17.130261213831,18.290596428402;17.3795022828419,18.0321351921688; ...
+    17.6333920905079,17.7688578498734];
+
+% current simulation of the reduced model
+y2 = ym(idx,3:4);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in d';                   % x-axis label
+    st = 'Daily mean temperature of the last node'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Max difference of both surfaces'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'full model','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'full vs initial simu','full vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/86400;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,2), y1(:,2), y2(:,2)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,281 @@
+function [v, s] = verify_wall_envelope(varargin)
+% verification of the s-function wall_envelope with the s-function 
+% layerwall: three walls with a different number of layers (massive 
+% exterior wall, light wall, floor with an active layer) are simulated 
+% in one wall_envelope block and in three layerwall blocks. Both use the 
+% node model of the carlib function wall_nodes, so the surface 
+% temperatures must be the same. Fixed step solver ode4, the inputs are 
+% held over 10 minutes.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_wall_envelope(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_wall_envelope' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_wall_envelope:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-6;       % max error between wall_envelope and layerwall in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_wall_envelope_mdl';
+
+% walls: one row per wall, layers with thickness 0 are not used
+thick = [0.015 0.2 0.12 0.01; 0.0125 0.1 0.0125 0; 0.05 0.06 0.04 0.2];
+cond = [0.7 2.0 0.035 0.5; 0.25 0.04 0.25 0; 1.4 0.2 0.035 2.0];
+cwall = [1000 1000 1400 1000; 1000 800 1000 0; 1000 1000 1400 1000];
+rho = [1400 2400 30 1200; 900 40 900 0; 2000 1200 30 2400];
+depth = [-1; -1; 0.06];  % active layer only in the floor
+tau = 600;              % time constant of the sublayers in s
+tini = 15;              % initial temperature in degC
+nwalls = size(thick,1);
+tstep = 10;             % step size of the solver in s
+thold = 600;            % inputs are held over 10 minutes
+tend = 2*86400;         % simulation time in s
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qout'], 'Expr', ...
+    '30*sin(2*pi*u/86400)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/pact'], 'Expr', ...
+    '40*(rem(u,86400) < 21600)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/qin'], 'Expr', ...
+    '-20*sin(4*pi*u/86400)');
+inputs = {'qout', 'pact', 'qin'};
+for n = 1:3
+    add_block('simulink/Discrete/Zero-Order Hold', [mdl '/zoh_' inputs{n}], ...
+        'SampleTime', num2str(thold));
+    add_line(mdl, 't/1', [inputs{n} '/1']);
+    add_line(mdl, [inputs{n} '/1'], ['zoh_' inputs{n} '/1']);
+end
+% wall_envelope: the same heat flux on all walls, active power only in 
+% the floor
+add_block('simulink/Math Operations/Gain', [mdl '/all_qout'], 'Gain', '[1 1 1]');
+add_block('simulink/Math Operations/Gain', [mdl '/all_pact'], 'Gain', '[0 0 1]');
+add_block('simulink/Math Operations/Gain', [mdl '/all_qin'], 'Gain', '[1 1 1]');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/envelope'], ...
+    'FunctionName', 'wall_envelope', 'Parameters', ...
+    sprintf('%g, %g, %s, %s, %s, %s, %s', tau, tini, mat2str(thick), ...
+    mat2str(cond), mat2str(cwall), mat2str(rho), mat2str(depth)));
+add_block('simulink/Sinks/Terminator', [mdl '/act_envelope']);
+for n = 1:3
+    add_line(mdl, ['zoh_' inputs{n} '/1'], ['all_' inputs{n} '/1']);
+    add_line(mdl, ['all_' inputs{n} '/1'], ['envelope/' num2str(n)]);
+end
+add_line(mdl, 'envelope/2', 'act_envelope/1');
+% one layerwall block per wall
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', ...
+    num2str(2*nwalls+2));
+for w = 1:nwalls
+    used = thick(w,:) > 0;
+    wall = sprintf('wall%d', w);
+    add_block('simulink/User-Defined Functions/S-Function', [mdl '/' wall], ...
+        'FunctionName', 'layerwall', 'Parameters', ...
+        sprintf('%g, %g, %s, %s, %s, %s, %g', tau, tini, ...
+        mat2str(thick(w,used)), mat2str(cond(w,used)), ...
+        mat2str(cwall(w,used)), mat2str(rho(w,used)), depth(w)));
+    add_block('simulink/Sinks/Terminator', [mdl '/act_' wall]);
+    add_line(mdl, 'zoh_qout/1', [wall '/1']);
+    if depth(w) > 0
+        add_line(mdl, 'zoh_pact/1', [wall '/2']);
+    else
+        add_block('simulink/Sources/Constant', [mdl '/zero_' wall], 'Value', '0');
+        add_line(mdl, ['zero_' wall '/1'], [wall '/2']);
+    end
+    add_line(mdl, 'zoh_qin/1', [wall '/3']);
+    add_line(mdl, [wall '/1'], ['mux/' num2str(w)]);
+    add_line(mdl, [wall '/2'], ['act_' wall '/1']);
+    add_line(mdl, [wall '/3'], ['mux/' num2str(nwalls+w)]);
+end
+add_line(mdl, 'envelope/1', ['mux/' num2str(2*nwalls+1)]);
+add_line(mdl, 'envelope/3', ['mux/' num2str(2*nwalls+2)]);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'ode4', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % one row per step
+close_system(mdl, 0)            % close system, but do not save it
+
+idx = 1:3600/tstep:size(yy,1);  % hourly values
+t0 = (idx-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% layerwall: outside and inside surface temperatures of the walls
+y0 = yy(idx,1:2*nwalls);
+
+% ----------------- set reference values initial simulation ---------------
+% result of wall_envelope at creation of the function
+y1 = [15,15,15,15,15,15; ...
+    15.2243422830637,16.0207131594164,15.6496133881027,13.8019018395314,13.6530899180185,14.8277201058941; ...
+    15.6137215110716,18.8935971000391,16.8519932213216,10.372972979827,10.0589550515049,14.504135717789; ...
+    16.0531948349924,22.9658261465704,18.2351483468517,5.86642418666724,5.71486470551277,14.1974232881292; ...
+    16.4924669969947,27.6960937226125,19.7223885299134,1.66439765949182,2.2531807908632,14.0139339282357; ...
+    16.8902033978189,32.6667940731496,21.2508377656975,-0.948547433071316,1.07967348350588,14.0155011365072; ...
+    17.2124517819592,37.5751654786341,22.7610752099289,-1.12464694179998,3.02717826589095,14.2100745675237; ...
+    17.4336356308851,42.1948077586448,23.7279827176332,1.32151971827475,8.14658516982893,14.5526877522692; ...
+    17.5375618656365,46.3232198058265,24.2589347563138,5.8645135840967,15.6930994666449,14.9586799858203; ...
+    17.5178014249786,49.7348757394065,24.6049698566253,11.4098253236331,24.3137114060705,15.3261122415761; ...
+    17.3772823590144,52.1575391940306,24.7579224167602,16.5879560124098,32.3882362744305,15.5641106697762; ...
+    17.1271876748876,53.2825025890226,24.708016160984,20.1219638173424,38.4354004376559,15.6178736867888; ...
+    16.785391834531,52.8091858347734,24.455786342416,21.1699871994941,41.4781691657033,15.482919742035; ...
+    16.3747139121953,50.5138802851487,24.0137970613014,19.5509794565174,41.2734407153812,15.2059171407987; ...
+    15.9212252374534,46.3243438963486,23.4065283533463,15.7931978752646,38.3474260447701,14.8719781851907; ...
+    15.4527512487201,40.3787278339472,22.6691011708363,10.9924947939964,33.8297957284165,14.5817182784292; ...
+    14.9975880570411,33.0499288422591,21.8451383164239,6.51842900037022,29.1331478791325,14.4241711885151; ...
+    14.583352859198,24.9243296526823,20.9840004179047,3.64699642813265,25.5652292726999,14.4527993841575; ...
+    14.2358352531942,16.7350036624238,20.1376139913995,3.2184419270438,23.9787066043185,14.6710266026612; ...
+    13.9777294083315,9.26092164425681,19.3571006743837,5.41189042321284,24.5525235154799,15.0311758014428; ...
+    13.8272009075362,3.21248985586092,18.6894154486172,9.69722786842616,26.7629196836335,15.4471064008645; ...
+    13.7963544320398,-0.872460903079935,18.1742021440804,14.9771593789316,29.5507113995355,15.8171743768198; ...
+    13.8897846435245,-2.70034928278336,17.8410716554134,19.8814029006013,31.638274650783,16.0513718260648; ...
+    14.1034754428656,-2.24699028020038,17.7074966093307,23.1341994920805,31.9091128430064,16.0953809971653; ...
+    14.4243329149202,0.266814233442996,17.7774905898285,23.8966629771203,29.7458288263374,15.9451022741521; ...
+    14.8305815903906,4.44054725546534,18.511014926853,21.9922206113167,25.233345727319,15.6477676543591; ...
+    15.2931293171015,9.78216673177759,19.7285486900129,17.9547104049572,19.1703865866625,15.2896179626194; ...
+    15.7778390629986,15.7968570325776,21.1039691283432,12.8862100701908,12.8838338346508,14.973850026362; ...
+    16.2484748047967,22.0554738751428,22.5720910576651,8.16264778379324,7.89380063852944,14.7923943139002; ...
+    16.6699542589797,28.2286954113685,24.0758446476908,5.06602777888622,5.51777214528942,14.8009241450498; ...
+    17.011476448027,34.0832230567022,25.558795050178,4.44176673622512,6.51912068782285,15.0045841487418; ...
+    17.2491131286652,39.4473109571223,26.4973626154425,6.47291139524577,10.8940819713513,15.3571256617124; ...
+    17.3675551570351,44.161460600702,26.9997138211354,10.631695651603,17.8548586717693,15.773305603404; ...
+    17.3608634200957,48.0339809982913,27.3172931741467,15.8213862983967,26.0146061471856,16.1509234190887; ...
+    17.2322511648986,50.8192574309669,27.4421409363904,20.6703899213227,33.7265180374942,16.3989900594995; ...
+    16.9930790273982,52.2295285077606,27.3645827540086,23.8998076680048,39.4883745189179,16.4626550195234; ...
+    16.6613415703226,51.9806948200927,27.0852017387429,24.6659573447033,42.3066601803842,16.3374175807109; ...
+    16.2599462896574,49.8620148939474,26.6165817199965,22.7861024858185,41.9253061065827,16.0699400777784; ...
+    15.8150346822339,45.8114493921036,25.983207848015,18.7869341534288,38.8603205490153,15.7453345951633; ...
+    15.354491136817,39.9751770763284,25.2201986324727,13.7628540201216,34.2333464860355,15.4642187579422; ...
+    14.9066632470551,32.7324108875399,24.3711705681888,9.08207778000481,29.450665833852,15.3156295401097; ...
+    14.4992142761027,24.6745032066511,23.4854760438907,6.01935814496155,25.8150557187314,15.353032972406; ...
+    14.1579756429984,16.5384376030594,22.6150324192854,5.4137893299408,24.1752726636831,15.5798564457936; ...
+    13.9056798029484,9.10626141389349,21.8109517895155,7.44343139073729,24.7071837458434,15.9484265557742; ...
+    13.7605275553075,3.09080156982933,21.12017948611,11.5771848180296,26.8846079696653,16.372606304444; ...
+    13.7346560608794,-0.968206518630343,20.5823497256517,16.7168427736264,29.6464570150861,16.7507551794586; ...
+    13.8326899814271,-2.77568293400059,20.2270639007557,21.4912792825058,31.7136083020005,16.9928687163025; ...
+    14.0506409506969,-2.30626358449838,20.0717852850269,24.6239544455707,31.9683861473046,17.0446325299385; ...
+    14.375440702371,0.220177377992135,20.1205182763061,25.2752593970205,29.7924656817885,16.9019503002788];
+
+% current simulation
+y2 = yy(idx,2*nwalls+1:4*nwalls);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Outside surface of the massive wall'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Max difference of the surfaces'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'layerwall','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'layerwall vs initial simu','layerwall vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,877 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * stratified thermal storage with an adaptive grid of fluid cells which
+ * is refined around the thermocline and coarse in isothermal zones
+ *
+ * Syntax  [sys, x0] = storage_Tadaptive(t,x,u,flag)
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ *
+ * Version  Author  Changes                                     Date
+ * 6.2.0    hf      created, geometry from storage_Tnodes.c     19oct2026
+ * 6.2.1    hf      geometry from the carlib function           19oct2026
+ *                  storage_nodes
+ *
+ * Copyright (c) 1998-2017 Solar-Institut Juelich, Germany
+ * additional copyright by the authors
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * A sharp thermocline needs 100 and more nodes in storage_Tnodes, because
+ * the upwind scheme smears the temperature front, although most of the
+ * storage is isothermal. This model keeps the fluid in a list of cells
+ * with individual volume (bottom to top):
+ *
+ * ----- Geometry -----
+ * The geometry is set up in mdlStart in the same way as in
+ * storage_Tnodes: the storage is devided into "NODES" reference slices
+ * with volume V_NODE and loss coefficient LOSS (in W/(m^3*K)). The loss
+ * of a cell is the sum over the overlapping parts of the reference
+ * slices. Heights are calculated from the cumulated volume of the slices.
+ *
+ * ----- Fluid flow -----
+ * Each connection is a plug flow from the inlet height to the outlet
+ * height. Within one sample period the volume mdot*dt/rho is removed
+ * next to the outlet (the mean temperature of the removed fluid is the
+ * outlet temperature) and a new cell with the inlet temperature is
+ * inserted next to the inlet. There is no numerical diffusion.
+ *
+ * ----- Conduction and losses -----
+ * (rho*cp*V)_i * dT_i/dt = UA_i * (Tamb - T_i)
+ *                        + G_i,i+1 * (T_i+1 - T_i) + G_i-1,i * (T_i-1 - T_i)
+ * with G = cond / (dz_i/(2*A_i) + dz_i+1/(2*A_i+1)) is solved by a
+ * Crank-Nicolson step (tridiagonal system, solve_tridiagonal in carlib).
+ *
+ * ----- Adaptive grid -----
+ * After the step the grid is adapted:
+ *  - inversed thermoclines are mixed by merging the cells
+ *  - neighbour cells are merged if their temperature difference is below
+ *    DTSPLIT/4 and the merged cell is not bigger than one reference slice
+ *  - a cell is split in two halfs if the temperature difference to a
+ *    neighbour is above DTSPLIT and the halfs are not smaller than
+ *    VOLUME/MAXCELLS. The temperatures of the halfs are reconstructed with
+ *    a limited slope (minmod), their mean is the old cell temperature.
+ * Merging and splitting use the heat capacity weighted mean temperature,
+ * volume and energy of the cells are conserved.
+ *
+ * ----- Sensors -----
+ * The temperatures are reported at fixed relative heights (parameter
+ * SENSORS, 0 = bottom, 1 = top), interpolated between the cell centres.
+ * Controllers see the same signals whatever the actual grid is.
+ *
+ * The model is a discrete time model, the sample time TSAMPLE is a
+ * parameter.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *           Definiton of inputs and outputs
+ *
+ * structure of u (input vector)
+ *  port    index               use
+ *  0       0                   ambient temperature
+ *
+ *  1       0                   temperature of flow entering the storage
+ *  ...     1                   massflow
+ *  NCONNECT 2                  relative height of the inlet (0 = bottom, 1 = top)
+ *          3                   relative height of the outlet
+ *          4                   pressure in storage
+ *          5                   fluid_id of fluid in the storage
+ *          6                   fluid_mix of fluid in the storage
+ *
+ * structure of y, output vector
+ *  port    index               use
+ *  0       0                   internal change of energy
+ *          1                   energy lost to ambient
+ *  1       0..nsensors-1       temperatures at the sensor heights
+ *  2       0..NCONNECT-1       outlet temperature of each connection
+ *  3       0                   actual number of cells
+ *
+ */
+
+#define S_FUNCTION_NAME  storage_Tadaptive
+#define S_FUNCTION_LEVEL 2
+
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+
+/* defines for parameters */
+#define DIA             *mxGetPr(ssGetSFcnParam(S, 0))      /* storage diameter [m] */
+#define VOLUME          *mxGetPr(ssGetSFcnParam(S, 1))      /* storage volume [m^3] */
+#define STANDING  (int)(*mxGetPr(ssGetSFcnParam(S, 2))+0.5) /* = 1 for standing cylinder */
+#define ULOSS           *mxGetPr(ssGetSFcnParam(S, 3))      /* heat loss coefficient U in [W/(m^2*K)] */
+#define UBOT            *mxGetPr(ssGetSFcnParam(S, 4))      /* heat loss coefficient by the bottom U in [W/(m^2*K)] */
+#define UTOP            *mxGetPr(ssGetSFcnParam(S, 5))      /* heat loss coefficient by the top U in [W/(m^2*K)] */
+#define COND            *mxGetPr(ssGetSFcnParam(S, 6))      /* axial heat conductivity [W/(m*K)] */
+#define TINI                     ssGetSFcnParam(S, 7)       /* initial storage temperature in [C], scalar or vector of length NODES */
+#define NODES           *mxGetPr(ssGetSFcnParam(S, 8))      /* number of reference slices (coarsest grid) */
+#define NCONNECT  (int)(*mxGetPr(ssGetSFcnParam(S, 9))+0.5) /* number of connections */
+#define MAXCELLS  (int)(*mxGetPr(ssGetSFcnParam(S, 10))+0.5)/* maximum number of cells (finest grid) */
+#define DTSPLIT         *mxGetPr(ssGetSFcnParam(S, 11))     /* temperature difference for refinement [K] */
+#define SENSORS                  ssGetSFcnParam(S, 12)      /* relative sensor heights, vector */
+#define TSAMPLE         *mxGetPr(ssGetSFcnParam(S, 13))     /* sample time [s] */
+#define NPARAMS                                   14
+
+#define NSENSORS        ((int_T)mxGetNumberOfElements(SENSORS))
+
+/* defines for inputs */
+#define TAMB            (*u0[0])            /* ambient temperature is first input */
+#define T_IN            (*u1[0])            /* temperature of flow entering the storage */
+#define MDOT_IN         (*u1[1])            /* massflow */
+#define H_IN            (*u1[2])            /* relative inlet height */
+#define H_OUT           (*u1[3])            /* relative outlet height */
+#define FLUID_PRESSURE  (*u1[4])
+#define FLUID_ID        (*u1[5])
+#define FLUID_MIX       (*u1[6])
+#define N_INPUTS        7
+#define N_INPUT_PORTS   ((int_T)NCONNECT+1)
+
+#define DWORK_VREF_NR           0     /* cumulated volume at the top of the reference slices */
+#define DWORK_LOSS_NR           1     /* losses of the reference slices */
+#define DWORK_DH_NR             2     /* heigth of one reference slice */
+#define DWORK_CELLV_NR          3     /* volume of the cells */
+#define DWORK_CELLT_NR          4     /* temperature of the cells */
+#define DWORK_CELLC_NR          5     /* heat capacity rho*cp*V of the cells */
+#define DWORK_SOLVE_NR          6     /* work arrays of the tridiagonal solver */
+#define DWORK_NCELL_NR          7     /* actual number of cells */
+#define DWORK_FLUID_NR          8     /* fluid type, mixture and pressure in the storage */
+#define DWORK_ENERGY_NR         9     /* internal change of energy and losses */
+#define DWORK_TOUT_NR           10    /* outlet temperatures */
+#define N_DWORK                 11
+
+#define VREF(n)                 dwork_vref[n]         /* volume below the top of slice n */
+#define LOSS(n)                 dwork_loss[n]         /* losses of slice n in W/(m^3*K) */
+#define DH                      dwork_dh[0]           /* heigth of one slice */
+#define CELLV(i)                dwork_cellv[i]        /* volume of cell i */
+#define CELLT(i)                dwork_cellt[i]        /* temperature of cell i */
+#define CELLC(i)                dwork_cellc[i]        /* heat capacity of cell i in J/K */
+#define SUBDIAG(i)              dwork_solve[i]
+#define MAINDIAG(i)             dwork_solve[i+maxcells]
+#define SUPDIAG(i)              dwork_solve[i+2*maxcells]
+#define RHS(i)                  dwork_solve[i+3*maxcells]
+#define UA(i)                   dwork_solve[i+4*maxcells] /* loss coefficient of cell in W/K */
+#define N_SOLVE                 5
+#define NCELL                   dwork_ncell[0]
+#define FLUID                   dwork_fluid[0]
+#define MIX                     dwork_fluid[1]
+#define PRESS                   dwork_fluid[2]
+#define ENERGY                  dwork_energy[0]
+#define QLOSS                   dwork_energy[1]
+#define TOUT(n)                 dwork_tout[n]
+
+/* other defines */
+#define LIMIT_T_INVERSED    1.0e-4
+#define MERGE_FRACTION      0.25      /* merge below DTSPLIT*MERGE_FRACTION */
+
+
+/* Structure with the pointers to the cell arrays, used by the grid functions */
+typedef struct {
+    real_T *v;          /* volume of the cells */
+    real_T *t;          /* temperature of the cells */
+    int_T  *n;          /* actual number of cells */
+    int_T  max;         /* maximum number of cells */
+} CellList;
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
+{
+    int_T sizet0 = (int_T)mxGetNumberOfElements(TINI);
+    const real_T *hs = mxGetPr(SENSORS);
+    int_T n;
+
+    if (DIA < 1.0e-3) {
+        ssSetErrorStatus(S,"Diameter must be > 1 mm");
+        return;
+    }
+    if (VOLUME < 1.0e-5) {
+        ssSetErrorStatus(S,"Volume must be > 1e-5 m^3");
+        return;
+    }
+    if (STANDING != 0 && STANDING != 1) {
+        ssSetErrorStatus(S,"Position must be 0 = lying or 1 = standing");
+        return;
+    }
+    if (ULOSS < 0.0 || UBOT < 0.0 || UTOP < 0.0) {
+        ssSetErrorStatus(S,"Loss coefficients must be >= 0");
+        return;
+    }
+    if (COND < 0.0) {
+        ssSetErrorStatus(S,"Vertical heat conductivity must be >= 0");
+        return;
+    }
+    if (NODES < 1) {
+        ssSetErrorStatus(S,"Number of nodes must be >= 1");
+        return;
+    }
+    if (sizet0 > 1 && sizet0 != NODES) {
+        ssSetErrorStatus(S,"Inititial temperture must be a scalar or a vector of lenght NODES");
+        return;
+    }
+    if (NCONNECT < 1) {
+        ssSetErrorStatus(S,"Number of connections must be >= 1");
+        return;
+    }
+    if (MAXCELLS < NODES+1) {
+        ssSetErrorStatus(S,"Maximum number of cells must be > NODES");
+        return;
+    }
+    if (DTSPLIT <= 0.0) {
+        ssSetErrorStatus(S,"Temperature difference for refinement must be > 0");
+        return;
+    }
+    if (NSENSORS < 1) {
+        ssSetErrorStatus(S,"At least one sensor height must be given");
+        return;
+    }
+    for (n = 0; n < NSENSORS; n++) {
+        if (hs[n] < 0.0 || hs[n] > 1.0) {
+            ssSetErrorStatus(S,"Sensor heights must be between 0 (bottom) and 1 (top)");
+            return;
+        }
+    }
+    if (TSAMPLE <= 0.0) {
+        ssSetErrorStatus(S,"Sample time must be > 0");
+        return;
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *   Setup sizes of the various vectors.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T n;
+
+    ssSetNumSFcnParams(S, NPARAMS);
+    #if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
+    {
+        mdlCheckParameters(S);
+        if (ssGetErrorStatus(S) != NULL)
+        {
+            return;
+        }
+    }
+    else
+    {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+    #endif
+
+    ssSetNumContStates(S, 0);       /* number of continuous states */
+    ssSetNumDiscStates(S, 0);       /* cells are kept in DWork */
+
+    if (!ssSetNumInputPorts(S, N_INPUT_PORTS)) return;
+    ssSetInputPortWidth(S, 0, 1);
+    ssSetInputPortDirectFeedThrough(S, 0, 0);
+    for (n = 1; n <= NCONNECT; n++)
+    {
+        ssSetInputPortWidth(S, n, N_INPUTS);
+        ssSetInputPortDirectFeedThrough(S, n, 0);
+    }
+
+    if (!ssSetNumOutputPorts(S, 4)) return;
+    ssSetOutputPortWidth(S, 0, 2);
+    ssSetOutputPortWidth(S, 1, NSENSORS);
+    ssSetOutputPortWidth(S, 2, NCONNECT);
+    ssSetOutputPortWidth(S, 3, 1);
+
+    ssSetNumSampleTimes(S, 1);
+
+    ssSetNumDWork(S, N_DWORK);
+    ssSetDWorkWidth(S, DWORK_VREF_NR, (int)NODES+1);
+    ssSetDWorkDataType(S, DWORK_VREF_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_VREF_NR, "DWORK_VREF");
+    ssSetDWorkUsageType(S, DWORK_VREF_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_LOSS_NR, (int)NODES);
+    ssSetDWorkDataType(S, DWORK_LOSS_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_LOSS_NR, "DWORK_LOSS");
+    ssSetDWorkUsageType(S, DWORK_LOSS_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_DH_NR, 1);
+    ssSetDWorkDataType(S, DWORK_DH_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_DH_NR, "DWORK_DH");
+    ssSetDWorkUsageType(S, DWORK_DH_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_CELLV_NR, MAXCELLS);
+    ssSetDWorkDataType(S, DWORK_CELLV_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CELLV_NR, "DWORK_CELLV");
+    ssSetDWorkUsageType(S, DWORK_CELLV_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_CELLT_NR, MAXCELLS);
+    ssSetDWorkDataType(S, DWORK_CELLT_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CELLT_NR, "DWORK_CELLT");
+    ssSetDWorkUsageType(S, DWORK_CELLT_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_CELLC_NR, MAXCELLS);
+    ssSetDWorkDataType(S, DWORK_CELLC_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CELLC_NR, "DWORK_CELLC");
+    ssSetDWorkUsageType(S, DWORK_CELLC_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_SOLVE_NR, N_SOLVE*MAXCELLS);
+    ssSetDWorkDataType(S, DWORK_SOLVE_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_SOLVE_NR, "DWORK_SOLVE");
+    ssSetDWorkUsageType(S, DWORK_SOLVE_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_NCELL_NR, 1);
+    ssSetDWorkDataType(S, DWORK_NCELL_NR, SS_INT32);
+    ssSetDWorkName(S, DWORK_NCELL_NR, "DWORK_NCELL");
+    ssSetDWorkUsageType(S, DWORK_NCELL_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_FLUID_NR, 3);
+    ssSetDWorkDataType(S, DWORK_FLUID_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_FLUID_NR, "DWORK_FLUID");
+    ssSetDWorkUsageType(S, DWORK_FLUID_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_ENERGY_NR, 2);
+    ssSetDWorkDataType(S, DWORK_ENERGY_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_ENERGY_NR, "DWORK_ENERGY");
+    ssSetDWorkUsageType(S, DWORK_ENERGY_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_TOUT_NR, NCONNECT);
+    ssSetDWorkDataType(S, DWORK_TOUT_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_TOUT_NR, "DWORK_TOUT");
+    ssSetDWorkUsageType(S, DWORK_TOUT_NR, SS_DWORK_USED_AS_DSTATE);
+
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+    ssSupportsMultipleExecInstances(S, true);
+} /* end mdlInitializeSizes */
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Discrete sample time TSAMPLE.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, TSAMPLE);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Geometry of the reference slices, same as in storage_Tnodes.c
+   *    (carlib function storage_nodes)
+   */
+static void mdlStart(SimStruct *S)
+{
+    real_T *dwork_vref = (real_T *)ssGetDWork(S, DWORK_VREF_NR);
+    real_T *dwork_loss = (real_T *)ssGetDWork(S, DWORK_LOSS_NR);
+    real_T *dwork_dh   = (real_T *)ssGetDWork(S, DWORK_DH_NR);
+    real_T *dwork_fluid = (real_T *)ssGetDWork(S, DWORK_FLUID_NR);
+
+    int_T  nodes = (int_T)NODES;/* numer of slices */
+    int_T  n;
+
+    FLUID = 0.0;                /* no fluid in the storage at the beginning */
+    MIX = 0.0;
+    PRESS = 1.0e5;
+
+    /* height, volume (stored in VREF(1..nodes)) and loss of the slices */
+    DH = storage_nodes(VOLUME, DIA, ULOSS, UBOT, UTOP, nodes, STANDING, 
+        &VREF(1), dwork_loss);
+    VREF(0) = 0.0;
+    for (n = 0; n < nodes; n++)
+        VREF(n+1) += VREF(n);               /* volume below the top of slice n */
+    VREF(nodes) = VOLUME;                   /* avoid rounding errors */
+} /* end mdlStart */
+#endif /*  MDL_START */
+
+
+#define MDL_INITIALIZE_CONDITIONS
+/* Function: mdlInitializeConditions ========================================
+ * Abstract:
+ *    The cells are initialised with the reference slices.
+ */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+static void mdlInitializeConditions(SimStruct *S)
+{
+    real_T *dwork_vref   = (real_T *)ssGetDWork(S, DWORK_VREF_NR);
+    real_T *dwork_cellv  = (real_T *)ssGetDWork(S, DWORK_CELLV_NR);
+    real_T *dwork_cellt  = (real_T *)ssGetDWork(S, DWORK_CELLT_NR);
+    int32_T *dwork_ncell = (int32_T *)ssGetDWork(S, DWORK_NCELL_NR);
+    real_T *dwork_energy = (real_T *)ssGetDWork(S, DWORK_ENERGY_NR);
+    real_T *dwork_tout   = (real_T *)ssGetDWork(S, DWORK_TOUT_NR);
+    const real_T *t0 = mxGetPr(TINI);
+    int_T sizet0 = (int_T)mxGetNumberOfElements(TINI);
+    int_T nodes = (int_T)NODES;
+    int_T n;
+
+    NCELL = (int32_T)nodes;
+    for (n = 0; n < nodes; n++)
+    {
+        CELLV(n) = VREF(n+1) - VREF(n);
+        CELLT(n) = (sizet0 == 1)? t0[0] : t0[n];
+    }
+    for (n = 0; n < NCONNECT; n++)
+        TOUT(n) = CELLT(0);
+    ENERGY = 0.0;
+    QLOSS = 0.0;
+} /* end mdlInitializeConditions */
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+
+
+/**********************************************************************
+ *                    functions on the list of cells
+ *********************************************************************/
+
+/* height (m) of the volume position vpos (m^3, measured from the bottom) */
+static real_T volume2height(const real_T *vref, int_T nodes, real_T dh, real_T vpos)
+{
+    int_T n = 0;
+
+    while (n < nodes-1 && vref[n+1] < vpos)
+        n++;
+    return dh*((real_T)n + (vpos-vref[n])/(vref[n+1]-vref[n]));
+}
+
+/* volume position (m^3) of the relative height hrel (0 = bottom, 1 = top) */
+static real_T height2volume(const real_T *vref, int_T nodes, real_T hrel)
+{
+    real_T h = min(max(hrel, 0.0), 1.0)*(real_T)nodes;
+    int_T  n = min((int_T)h, nodes-1);
+
+    return vref[n] + (h-(real_T)n)*(vref[n+1]-vref[n]);
+}
+
+/* merge cell i and i+1 to one cell with the capacity weighted mean temperature */
+static void merge_cells(CellList *c, real_T *cap, int_T i)
+{
+    int_T k;
+
+    c->t[i] = (cap[i]*c->t[i] + cap[i+1]*c->t[i+1])/(cap[i]+cap[i+1]);
+    c->v[i] += c->v[i+1];
+    cap[i] += cap[i+1];
+    for (k = i+1; k < *c->n-1; k++)
+    {
+        c->v[k] = c->v[k+1];
+        c->t[k] = c->t[k+1];
+        cap[k] = cap[k+1];
+    }
+    (*c->n)--;
+}
+
+/* insert an empty cell at index i */
+static void open_cell(CellList *c, real_T *cap, int_T i)
+{
+    int_T k;
+
+    for (k = *c->n; k > i; k--)
+    {
+        c->v[k] = c->v[k-1];
+        c->t[k] = c->t[k-1];
+        cap[k] = cap[k-1];
+    }
+    (*c->n)++;
+}
+
+/* merge the pair of neighbour cells with the smallest temperature difference */
+static void merge_closest(CellList *c, real_T *cap)
+{
+    int_T i, imin = 0;
+    real_T dt, dtmin = -1.0;
+
+    for (i = 0; i < *c->n-1; i++)
+    {
+        dt = fabs(c->t[i+1]-c->t[i]);
+        if (dtmin < 0.0 || dt < dtmin)
+        {
+            dtmin = dt;
+            imin = i;
+        }
+    }
+    merge_cells(c, cap, imin);
+}
+
+/* make sure that there is a cell border at the volume position vpos,
+ * returns the index of the cell above the border */
+static int_T cut_at(CellList *c, real_T *cap, real_T vpos)
+{
+    int_T i = 0;
+    real_T vbot = 0.0, frac;
+
+    while (i < *c->n && vbot + c->v[i] <= vpos*(1.0+1.0e-12))
+    {
+        vbot += c->v[i];
+        i++;
+    }
+    if (i >= *c->n || vpos - vbot <= 1.0e-12*c->v[i])
+        return i;                   /* already a border */
+
+    if (*c->n >= c->max)            /* no space left: coarsen the grid first */
+    {
+        merge_closest(c, cap);
+        return cut_at(c, cap, vpos);
+    }
+    frac = (vpos-vbot)/c->v[i];
+    open_cell(c, cap, i);           /* cell i+1 is a copy of cell i */
+    c->v[i] = frac*c->v[i+1];
+    c->v[i+1] -= c->v[i];
+    cap[i] = frac*cap[i+1];
+    cap[i+1] -= cap[i];
+    return i+1;
+}
+
+/* remove the fluid between the volume positions va < vb,
+ * returns the mean temperature of the removed fluid */
+static real_T remove_volume(CellList *c, real_T *cap, real_T va, real_T vb)
+{
+    int_T ia, ib, k, nrem;
+    real_T e = 0.0, sc = 0.0;
+
+    ia = cut_at(c, cap, va);
+    ib = cut_at(c, cap, vb);
+    for (k = ia; k < ib; k++)
+    {
+        e  += cap[k]*c->t[k];
+        sc += cap[k];
+    }
+    nrem = ib-ia;
+    for (k = ia; k < *c->n-nrem; k++)
+    {
+        c->v[k] = c->v[k+nrem];
+        c->t[k] = c->t[k+nrem];
+        cap[k] = cap[k+nrem];
+    }
+    *c->n -= nrem;
+    return (sc > 0.0)? e/sc : c->t[min(ia, *c->n-1)];
+}
+
+/* insert a new cell with volume dv and temperature t at volume position vpos */
+static void insert_volume(CellList *c, real_T *cap, real_T vpos, real_T dv, real_T t, real_T rhocp)
+{
+    int_T i;
+
+    while (*c->n >= c->max-1)       /* space for the cut and the new cell */
+        merge_closest(c, cap);
+    i = cut_at(c, cap, vpos);
+    open_cell(c, cap, i);
+    c->v[i] = dv;
+    c->t[i] = t;
+    cap[i] = rhocp*dv;
+}
+
+
+/* Function: mdlOutputs =======================================================
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T *q    = ssGetOutputPortRealSignal(S,0);
+    real_T *y    = ssGetOutputPortRealSignal(S,1);
+    real_T *yout = ssGetOutputPortRealSignal(S,2);
+    real_T *ycel = ssGetOutputPortRealSignal(S,3);
+    real_T *dwork_vref   = (real_T *)ssGetDWork(S, DWORK_VREF_NR);
+    real_T *dwork_cellv  = (real_T *)ssGetDWork(S, DWORK_CELLV_NR);
+    real_T *dwork_cellt  = (real_T *)ssGetDWork(S, DWORK_CELLT_NR);
+    int32_T *dwork_ncell = (int32_T *)ssGetDWork(S, DWORK_NCELL_NR);
+    real_T *dwork_energy = (real_T *)ssGetDWork(S, DWORK_ENERGY_NR);
+    real_T *dwork_tout   = (real_T *)ssGetDWork(S, DWORK_TOUT_NR);
+    const real_T *hs = mxGetPr(SENSORS);
+    int_T  nodes = (int_T)NODES;
+    int_T  ncell = (int_T)NCELL;
+    real_T vs, vbot, vc_lo, vc_hi;
+    int_T  n, i;
+
+    /* temperature at the sensor: interpolated between the cell centres */
+    for (n = 0; n < NSENSORS; n++)
+    {
+        vs = height2volume(&VREF(0), nodes, hs[n]);
+        vbot = 0.0;
+        vc_lo = 0.5*CELLV(0);                       /* centre of cell 0 */
+        for (i = 0; i < ncell-1; i++)
+        {
+            vc_hi = vbot + CELLV(i) + 0.5*CELLV(i+1);   /* centre of cell i+1 */
+            if (vc_hi >= vs)
+                break;
+            vbot += CELLV(i);
+            vc_lo = vc_hi;
+        }
+        if (i == ncell-1 || vs <= vc_lo)            /* above the top or below the bottom centre */
+            y[n] = CELLT(i);
+        else
+            y[n] = CELLT(i) + (CELLT(i+1)-CELLT(i))*(vs-vc_lo)/(vc_hi-vc_lo);
+    }
+
+    for (n = 0; n < NCONNECT; n++)
+        yout[n] = TOUT(n);
+
+    q[0] = ENERGY;              /* internal change of energy */
+    q[1] = QLOSS;               /* thermal losses */
+    ycel[0] = (real_T)ncell;
+} /* end mdlOutputs */
+
+
+
+#define MDL_UPDATE
+/* Function: mdlUpdate ======================================================
+ * Abstract:
+ *    1. plug flow of all connections, 2. Crank-Nicolson step for losses
+ *    and conduction, 3. mixing of inversed layers and grid adaption.
+ */
+static void mdlUpdate(SimStruct *S, int_T tid)
+{
+    real_T *dwork_vref   = (real_T *)ssGetDWork(S, DWORK_VREF_NR);
+    real_T *dwork_loss   = (real_T *)ssGetDWork(S, DWORK_LOSS_NR);
+    real_T *dwork_dh     = (real_T *)ssGetDWork(S, DWORK_DH_NR);
+    real_T *dwork_cellv  = (real_T *)ssGetDWork(S, DWORK_CELLV_NR);
+    real_T *dwork_cellt  = (real_T *)ssGetDWork(S, DWORK_CELLT_NR);
+    real_T *dwork_cellc  = (real_T *)ssGetDWork(S, DWORK_CELLC_NR);
+    real_T *dwork_solve  = (real_T *)ssGetDWork(S, DWORK_SOLVE_NR);
+    int32_T *dwork_ncell = (int32_T *)ssGetDWork(S, DWORK_NCELL_NR);
+    real_T *dwork_fluid  = (real_T *)ssGetDWork(S, DWORK_FLUID_NR);
+    real_T *dwork_energy = (real_T *)ssGetDWork(S, DWORK_ENERGY_NR);
+    real_T *dwork_tout   = (real_T *)ssGetDWork(S, DWORK_TOUT_NR);
+    InputRealPtrsType u0 = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType u1;
+
+    real_T dt    = TSAMPLE;
+    real_T vol   = VOLUME;
+    real_T cond  = COND;
+    real_T dh;
+    real_T dtsplit = DTSPLIT;
+    int_T  nodes = (int_T)NODES;
+    int_T  maxcells = MAXCELLS;
+    real_T vmin  = vol/(real_T)maxcells;      /* smallest cell */
+    real_T vmax  = vol/(real_T)nodes;         /* biggest cell = reference slice */
+    real_T rhocp, e0, e1, vin, vout, dv, vbot, vtop, ov, z0, z1, a, gb, g, qloss, slope, sl, sr;
+    int_T  ncell, n, nc, i, k, changed;
+    CellList c;
+
+    dh = DH;
+    ncell = (int_T)NCELL;
+    c.v = &CELLV(0);
+    c.t = &CELLT(0);
+    c.n = &ncell;
+    c.max = maxcells;
+
+    /* fluid is set by the first connection with a fluid */
+    if (FLUID < 1.0)
+    {
+        for (nc = 1; nc <= NCONNECT && FLUID < 1.0; nc++)
+        {
+            u1 = ssGetInputPortRealSignalPtrs(S,nc);
+            if (FLUID_ID > 0.0)
+            {
+                FLUID = FLUID_ID;
+                MIX   = FLUID_MIX;
+                PRESS = FLUID_PRESSURE;
+            }
+        }
+        if (FLUID < 1.0)
+            return;                 /* no fluid yet */
+    }
+
+    /* heat capacity of the cells, constant during the sample period */
+    e0 = 0.0;
+    for (i = 0; i < ncell; i++)
+    {
+        CELLC(i) = CELLV(i)*density(FLUID, MIX, CELLT(i), PRESS)
+            *heat_capacity(FLUID, MIX, CELLT(i), PRESS);
+        e0 += CELLC(i)*CELLT(i);
+    }
+
+    /*******************************
+     * 1. plug flow                *
+     *******************************/
+    for (nc = 1; nc <= NCONNECT; nc++)
+    {
+        u1 = ssGetInputPortRealSignalPtrs(S,nc);
+        TOUT(nc-1) = T_IN;
+        if (MDOT_IN <= NO_MASSFLOW)
+            continue;
+
+        rhocp = density(FLUID, MIX, T_IN, PRESS)*heat_capacity(FLUID, MIX, T_IN, PRESS);
+        dv = MDOT_IN*dt/density(FLUID, MIX, T_IN, PRESS);
+        vin = height2volume(&VREF(0), nodes, H_IN);
+        vout = height2volume(&VREF(0), nodes, H_OUT);
+
+        if (fabs(vin-vout) < vmin)          /* inlet next to outlet: bypass */
+            continue;
+
+        if (dv > fabs(vin-vout))            /* volume between inlet and outlet is flushed */
+        {
+            e1 = fabs(vin-vout);
+            TOUT(nc-1) = remove_volume(&c, &CELLC(0), min(vin,vout), max(vin,vout));
+            TOUT(nc-1) = (e1*TOUT(nc-1) + (dv-e1)*T_IN)/dv;
+            insert_volume(&c, &CELLC(0), min(vin,vout), e1, T_IN, rhocp);
+        }
+        else if (vin > vout)                /* flow downwards */
+        {
+            TOUT(nc-1) = remove_volume(&c, &CELLC(0), vout, vout+dv);
+            insert_volume(&c, &CELLC(0), vin-dv, dv, T_IN, rhocp);
+        }
+        else                                /* flow upwards */
+        {
+            TOUT(nc-1) = remove_volume(&c, &CELLC(0), vout-dv, vout);
+            insert_volume(&c, &CELLC(0), vin, dv, T_IN, rhocp);
+        }
+    }
+
+    /*****************************************
+     * 2. losses and conduction              *
+     *****************************************/
+    /* loss coefficient of each cell from the overlapping reference slices */
+    vbot = 0.0;
+    n = 0;
+    for (i = 0; i < ncell; i++)
+    {
+        vtop = vbot + CELLV(i);
+        UA(i) = 0.0;
+        while (n < nodes-1 && VREF(n+1) <= vbot)
+            n++;
+        for (k = n; k < nodes && VREF(k) < vtop; k++)
+        {
+            ov = min(vtop, VREF(k+1)) - max(vbot, VREF(k));
+            if (ov > 0.0)
+                UA(i) += LOSS(k)*ov;
+        }
+        /* height and mean cross section of the cell */
+        z0 = volume2height(&VREF(0), nodes, dh, vbot);
+        z1 = volume2height(&VREF(0), nodes, dh, vtop);
+        RHS(i) = (z1 > z0)? 0.5*(z1-z0)/(CELLV(i)/(z1-z0)) : 0.0; /* dz/(2*A) */
+        vbot = vtop;
+    }
+
+    /* Crank-Nicolson: (C/dt + 0.5*K) * Tnew = (C/dt - 0.5*K) * T + UA*Tamb */
+    qloss = 0.0;
+    for (i = 0; i < ncell; i++)
+    {
+        SUPDIAG(i) = (i < ncell-1 && RHS(i)+RHS(i+1) > 0.0)?
+            cond/(RHS(i)+RHS(i+1)) : 0.0;    /* conductance to the cell above in W/K */
+    }
+    for (i = 0; i < ncell; i++)
+    {
+        qloss += UA(i)*(TAMB-CELLT(i));
+        a = CELLC(i)/dt;
+        g = SUPDIAG(i);                      /* to the cell above */
+        gb = (i > 0)? SUPDIAG(i-1) : 0.0;   /* to the cell below */
+        MAINDIAG(i) = a + 0.5*(UA(i)+g+gb);
+        RHS(i) = a*CELLT(i) + UA(i)*(TAMB-0.5*CELLT(i));
+        if (i < ncell-1)
+            RHS(i) += 0.5*g*(CELLT(i+1)-CELLT(i));
+        if (i > 0)
+        {
+            RHS(i) += 0.5*gb*(CELLT(i-1)-CELLT(i));
+            SUBDIAG(i) = -0.5*gb;
+        }
+    }
+    for (i = 0; i < ncell; i++)
+        SUPDIAG(i) *= -0.5;
+    solve_tridiagonal(&CELLT(0), &SUBDIAG(0), &MAINDIAG(0), &SUPDIAG(0), &RHS(0), ncell);
+    for (i = 0; i < ncell; i++)
+        qloss += UA(i)*(TAMB-CELLT(i));
+    QLOSS += 0.5*dt*qloss;
+
+    /*****************************************
+     * 3. inversed layers and grid adaption  *
+     *****************************************/
+    do {
+        changed = 0;
+        for (i = 0; i < ncell-1; i++)
+        {
+            if (CELLT(i)-LIMIT_T_INVERSED > CELLT(i+1))     /* inversed thermocline */
+            {
+                merge_cells(&c, &CELLC(0), i);
+                changed = 1;
+            }
+        }
+    } while (changed);
+
+    /* coarsen in isothermal zones */
+    for (i = 0; i < ncell-1; i++)
+    {
+        if (fabs(CELLT(i+1)-CELLT(i)) < MERGE_FRACTION*dtsplit
+            && CELLV(i)+CELLV(i+1) <= vmax*(1.0+1.0e-9))
+            merge_cells(&c, &CELLC(0), i);
+    }
+
+    /* refine at steep gradients */
+    for (i = 0; i < ncell && ncell < maxcells; i++)
+    {
+        sl = (i > 0)? CELLT(i)-CELLT(i-1) : 0.0;
+        sr = (i < ncell-1)? CELLT(i+1)-CELLT(i) : 0.0;
+        if (max(fabs(sl), fabs(sr)) > dtsplit && CELLV(i) >= 2.0*vmin)
+        {
+            /* minmod limited slope, the mean of both halfs is the old temperature */
+            slope = (sl*sr > 0.0)? ((fabs(sl) < fabs(sr))? sl : sr) : 0.0;
+            open_cell(&c, &CELLC(0), i);
+            CELLV(i) = 0.5*CELLV(i+1);
+            CELLV(i+1) = CELLV(i);
+            CELLC(i) = 0.5*CELLC(i+1);
+            CELLC(i+1) = CELLC(i);
+            CELLT(i) = CELLT(i+1) - 0.25*slope;
+            CELLT(i+1) += 0.25*slope;
+            i++;                    /* skip the new upper half */
+        }
+    }
+    NCELL = (int32_T)ncell;
+
+    /* energy balance */
+    e1 = 0.0;
+    for (i = 0; i < ncell; i++)
+        e1 += CELLC(i)*CELLT(i);
+    ENERGY += e1-e0;
+} /* end mdlUpdate */
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,194 @@
+function [v, s] = verify_storage_Tadaptive(varargin)
+% verification of the s-function storage_Tadaptive: a lying cylinder 
+% without losses and conduction is charged from the top, the time when the
+% thermocline passes each sensor is compared to the analytical plug flow.
+% The sensor heights depend on the volume below the height in the lying 
+% cylinder (geometry of the carlib function storage_nodes).
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_storage_Tadaptive(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_storage_Tadaptive' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_storage_Tadaptive:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+tstep = 60;             % sample time in s
+max_error = 1.5*tstep;  % max error of the arrival time in s
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_storage_Tadaptive_mdl';
+
+% lying storage: diameter 0.8 m, 1 m^3, no losses, no conduction, 20 degC,
+% 10 reference slices, 1 connection, 200 cells, split at 1 K
+dia = 0.8;
+vol = 1;
+sensors = 0.1:0.1:0.9;  % relative sensor heights
+storage = sprintf('%g, %g, 0, 0, 0, 0, 0, 20, 10, 1, 200, 1, %s, %g', ...
+    dia, vol, mat2str(sensors), tstep);
+tin = 60;               % inlet temperature in degC
+mdot = 0.1;             % mass flow in kg/s, inlet top, outlet bottom
+tend = 12000;           % simulation time in s
+tmid = 40;              % temperature of the thermocline in degC
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Constant', [mdl '/Tamb'], 'Value', '20');
+add_block('simulink/Sources/Constant', [mdl '/inflow'], 'Value', ...
+    mat2str([tin mdot 1 0 1e5 1 0]));
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/storage'], ...
+    'FunctionName', 'storage_Tadaptive', 'Parameters', storage);
+add_block('simulink/Sinks/Terminator', [mdl '/energy']);
+add_block('simulink/Sinks/Out1', [mdl '/Tsensor']);
+add_block('simulink/Sinks/Terminator', [mdl '/Tout']);
+add_block('simulink/Sinks/Terminator', [mdl '/ncell']);
+add_line(mdl, 'Tamb/1', 'storage/1');
+add_line(mdl, 'inflow/1', 'storage/2');
+add_line(mdl, 'storage/1', 'energy/1');
+add_line(mdl, 'storage/2', 'Tsensor/1');
+add_line(mdl, 'storage/3', 'Tout/1');
+add_line(mdl, 'storage/4', 'ncell/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % sensor temperatures
+close_system(mdl, 0)            % close system, but do not save it
+
+%% ----------------- set the reference values -----------------------------
+% analytical arrival time: volume above the sensor divided by volume flow
+c = 1-2*sensors;
+vbelow = vol*(acos(c) - c.*sqrt(1-c.^2))/pi;    % segment of the circle
+y0 = density(tin, 1e5, 1, 0)*(vol-vbelow)/mdot;
+
+% ----------------- set reference values initial simulation ---------------
+% result of storage_Tadaptive at creation of the function
+y1 = [9262.65039325848, 8382.77324359373, 7301.92131418756, 6110.19966895585, 4866.80635262404, ...
+    3623.41303629224, 2431.69139106052, 1350.83946165435, 462.713331631717];
+
+% current simulation: first sample above tmid, linear interpolation
+t0 = (0:size(yy,1)-1)'*tstep;
+y2 = zeros(size(sensors));
+for n = 1:length(sensors)
+    k = find(yy(:,n) >= tmid, 1);
+    y2(n) = t0(k) - tstep*(yy(k,n)-tmid)/(yy(k,n)-yy(k-1,n));
+end
+
+%% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.1f s > allowed error %3.1f s', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.1f s > allowed error %3.1f s', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.1f s', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'relative height of the sensor';   % x-axis label
+    st = 'Arrival of the thermocline';      % title
+    sy1 = 'Time in s';                      % y-axis label in the upper plot
+    sy2 = 'Difference in s';                % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'analytical solution','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'solution vs initial simu','solution vs current simu','initial simu vs current'};
+    % x axis
+    x = sensors';
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0', y1', y2'];
+    %   ye - matrix with error values for each y-value
+    ye = [ye1', ye2', ye3'];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
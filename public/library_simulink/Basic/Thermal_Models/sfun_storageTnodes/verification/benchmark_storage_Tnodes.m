@@ -0,0 +1,192 @@
+function [r, s] = benchmark_storage_Tnodes(varargin)
+% benchmark of the s-function storage_Tnodes
+% one year with a daily charge (1 kg/s from 8 to 16 h) at the top and a 
+% discharge (1.5 kg/s from 18 to 22 h) at the bottom of a 10 m^3 storage
+% with 50 nodes. Compares the computing time, the number of steps and 
+% the temperatures at the bottom, in the middle and at the top of the 
+% continuous model and of the discrete mode (parameter TSAMPLE). The
+% continuous model with the solver ode15s and tight tolerances is the 
+% reference.
+% The test model is created in memory and closed without saving.
+% Syntax:   [r, s] = benchmark_storage_Tnodes(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : no display
+%               1 : display the table of results (default)
+% Outputs:  r - struct array with fields: name, parameters, time (s), 
+%               steps (number of time steps), tmax (max. deviation of
+%               the hourly temperatures from the reference in K), tlast 
+%               (top temperature after one year)
+%           s - text string with the result table
+%                                                                          
+% Literature:   --
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 1;
+elseif nargin == 1
+    show = varargin{1};
+else  
+    error('benchmark_storage_Tnodes:%s',' too many input arguments')
+end
+
+% ---------- parameters: diameter, volume, standing, loss coefficients, --
+% ---------- conductivity, initial temperature, nodes, connections -------
+nodes = 50;
+storage = sprintf('2, 10, 1, 0.4, 0.4, 0.4, 0.6, 20, %d, 1', nodes);
+tend = 365*86400;       % one year
+% cases: name, parameter TSAMPLE, solver settings
+cases = {'continuous, ode15s (reference)', '', ...
+            {'Solver', 'ode15s', 'RelTol', '1e-6', 'AbsTol', '1e-6'}; ...
+         'continuous, ode15s',  '', ...
+            {'Solver', 'ode15s', 'RelTol', '1e-3', 'AbsTol', 'auto'}; ...
+         'continuous, ode45',   '', ...
+            {'Solver', 'ode45', 'RelTol', '1e-3', 'AbsTol', 'auto'}; ...
+         'discrete, 60 s',      ', 60', ...
+            {'Solver', 'FixedStepDiscrete', 'FixedStep', '60'}; ...
+         'discrete, 300 s',     ', 300', ...
+            {'Solver', 'FixedStepDiscrete', 'FixedStep', '300'}};
+nrep = 3;               % repetitions, the fastest run is used
+
+% connection vector: K*[Thot; mdot charge; mdot discharge] + b
+% charge enters at the top node and flows down, discharge enters at the
+% bottom node with 10 degC and flows up
+K = zeros(5*nodes+3, 3);
+K(nodes, 1) = 1;                    % inlet temperature of the top node
+K(nodes+1, 3) = 1;                  % discharge enters at the bottom
+K(2*nodes, 2) = 1;                  % charge enters at the top
+K(2*nodes+(1:nodes-1), 3) = 1;      % inner massflow upwards
+K(3*nodes+(1:nodes-1), 2) = 1;      % inner massflow downwards
+b = zeros(5*nodes+3, 1);
+b(1) = 10;                          % inlet temperature of the bottom node
+b(5*nodes+(1:3)) = [1e5; 1; 0];     % pressure, fluid ID, fluid mix
+
+% ---------- create the test model ----------------------------------------
+mdl = 'benchmark_storage_Tnodes_mdl';
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/Thot'], 'Expr', ...
+    '70+10*sin(2*pi*u/31536000)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/charge'], 'Expr', ...
+    '(rem(u,86400) >= 28800)*(rem(u,86400) < 57600)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/discharge'], 'Expr', ...
+    '1.5*(rem(u,86400) >= 64800)*(rem(u,86400) < 79200)');
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '3');
+add_block('simulink/Math Operations/Gain', [mdl '/K'], 'Gain', 'K', ...
+    'Multiplication', 'Matrix(K*u)');
+add_block('simulink/Sources/Constant', [mdl '/b'], 'Value', 'b');
+add_block('simulink/Math Operations/Sum', [mdl '/sum'], 'Inputs', '++');
+add_block('simulink/Sources/Constant', [mdl '/Tamb'], 'Value', '15');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/storage'], ...
+    'FunctionName', 'storage_Tnodes', 'Parameters', storage);
+add_block('simulink/Sinks/Terminator', [mdl '/energy']);
+add_block('simulink/Signal Routing/Selector', [mdl '/select'], ...
+    'InputPortWidth', num2str(nodes), 'Indices', mat2str([1 nodes/2 nodes]));
+add_block('simulink/Sinks/Out1', [mdl '/T']);
+add_line(mdl, 't/1', 'Thot/1');
+add_line(mdl, 't/1', 'charge/1');
+add_line(mdl, 't/1', 'discharge/1');
+add_line(mdl, 'Thot/1', 'mux/1');
+add_line(mdl, 'charge/1', 'mux/2');
+add_line(mdl, 'discharge/1', 'mux/3');
+add_line(mdl, 'mux/1', 'K/1');
+add_line(mdl, 'K/1', 'sum/1');
+add_line(mdl, 'b/1', 'sum/2');
+add_line(mdl, 'Tamb/1', 'storage/1');
+add_line(mdl, 'sum/1', 'storage/2');
+add_line(mdl, 'storage/1', 'energy/1');
+add_line(mdl, 'storage/2', 'select/1');
+add_line(mdl, 'select/1', 'T/1');
+set_param(mdl, 'StopTime', num2str(tend), 'SaveFormat', 'Array');
+
+% ---------- simulate all cases -------------------------------------------
+th = (0:3600:tend)';    % hourly values for the comparison
+r = struct('name', cases(:,1), 'parameters', '', 'time', 0, ...
+    'steps', 0, 'tmax', 0, 'tlast', 0);
+for n = 1:size(cases,1)
+    r(n).parameters = [storage cases{n,2}];
+    set_param([mdl '/storage'], 'Parameters', r(n).parameters);
+    set_param(mdl, cases{n,3}{:});
+    r(n).time = inf;
+    for m = 1:nrep
+        tic
+        simOut = sim(mdl, 'SrcWorkspace', 'current', 'SaveTime', 'on', ...
+            'TimeSaveName', 'tout', 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+        r(n).time = min(r(n).time, toc);
+    end
+    tout = simOut.get('tout');
+    [tout, iu] = unique(tout, 'last');
+    tnode = simOut.get('yout');
+    tnode = interp1(tout, tnode(iu,:), th);
+    if n == 1
+        tnode0 = tnode;     % reference
+    end
+    r(n).steps = length(tout)-1;
+    r(n).tmax = max(max(abs(tnode-tnode0)));
+    r(n).tlast = tnode(end,end);
+end
+close_system(mdl, 0)    % close system, but do not save it
+
+% ------------ result table -----------------------------------------------
+s = sprintf('%-32s %10s %8s %10s %12s %12s\n', 'case', 'time in s', 'speedup', ...
+    'steps', 'max. dT in K', 'Ttop 1 a');
+for n = 1:length(r)
+    s = [s, sprintf('%-32s %10.3f %8.2f %10d %12.4f %12.3f\n', r(n).name, ...
+        r(n).time, r(1).time/r(n).time, r(n).steps, r(n).tmax, r(n).tlast)]; %#ok<AGROW>
+end
+if (show)
+    disp(s)
+end
+
+%% Copyright an file history
+% This file is part of the CARNOT Blockset.
+% 
+% 
+% Copyright (c) 1998-2026, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                         Date
+% 6.1.0     hf      created                                         19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
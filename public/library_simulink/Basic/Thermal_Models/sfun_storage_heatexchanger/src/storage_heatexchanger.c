@@ -56,6 +56,13 @@
  *                  MultipleInstancesExec activated
  * 6.2.2    aw      implicit casts replaced by explicit casts,  10sep2015
  *                  unused variables deleted
+ * 6.2.3    hf      optional UA table for theoretical models    19oct2026
+ * 6.2.4    hf      bug fix: power from the energy balance when 19oct2026
+ *                  the outlet reaches the node temperature
+ *                  (was 0 W for NTU > 25)
+ * 6.2.5    hf      UA table: direct calculation outside the grid   19oct2026
+ *                  and for boiling water, table pressure from
+ *                  the grid
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  *                    D E S C R I P T I O N
@@ -96,6 +103,49 @@
  * WARNING : a stratified heat exchanger or pipe doesn't work with inlet 
  * and outlet in the same node.
  *
+ * ----- UA table for the theoretical models ------
+ * The heat transfer of the theoretical models (portID 201, 202, 301, 302)
+ * needs the fluid properties and the Nusselt correlations for each node 
+ * at each time step. With the optional parameter UATABLE the heat 
+ * transfer UA of one node is calculated in mdlStart on a grid of 
+ * (mdot, Tfluid, Tstorage) and interpolated (trilinear) during the 
+ * simulation (about 5 times faster for the theoretical models):
+ *  UATABLE = 0                 correlations are evaluated at each step 
+ *                              (reference mode, same as without UATABLE)
+ *  UATABLE = 1                 table with default grid: mdot 0..2 kg/s, 
+ *                              temperatures 0..100 degree C, 21 points
+ *  UATABLE = [mdotmax, tmin, tmax, n_mdot, n_temp]  user defined grid
+ * The massflow grid is quadratic (dense at small massflows) since UA is
+ * steep at low Reynolds numbers. The table is calculated for 3 bar or for
+ * the vapour pressure at the highest grid temperature if this is higher 
+ * (liquid water in the whole grid), the pressure dependency of liquid 
+ * water is neglected. Outside the grid and when the water boils at the 
+ * actual pressure (temperature above the saturation temperature) UA is 
+ * calculated directly, so the table only changes results inside the grid.
+ * The maximum interpolation error of the heat flow UA*(Tfluid-Tstorage), 
+ * checked in the centres of the grid cells and relative to the maximum 
+ * heat flow at the same massflow, is printed at start. Cells where the
+ * correlation is not continuous (UA <= 0 in a corner) are not checked.
+ * The largest errors are found at small massflows close to the laminar 
+ * range where the correlation changes sign, use UATABLE = 0 as reference 
+ * to check the results of a system simulation (see 
+ * verify_sfun_storage_heatexchanger4.m).
+ *
+ * ----- Power of a node ------
+ * In each node the storage temperature is constant, the fluid temperature
+ * in the heat exchanger follows the exponential solution
+ *  Thx_out = Tnode + (Thx_in - Tnode) * exp(-NTU),  NTU = UA/(mdot*cp)
+ * The power is calculated with the logarithmic mean temperature 
+ * difference. When the outlet temperature reaches the node temperature
+ * within 1e-10 K (NTU > 25, small massflow in a big heat exchanger) the
+ * logarithm cannot be evaluated and the power is taken from the energy 
+ * balance of the fluid, which is the same for the exponential solution:
+ *  Qdot = mdot * cp * (Thx_in - Thx_out) = (1 - exp(-NTU)) * mdot * cp * (Thx_in - Tnode)
+ * Up to version 6.2.3 the power was set to 0 in this case and the fluid
+ * left the node with the inlet temperature. This is a bug fix, not a new
+ * model: all other cases give the same results as version 6.2.2 (see
+ * verify_sfun_storage_heatexchanger3.m).
+ *
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  *           Definiton of inputs and outputs 
@@ -151,6 +201,19 @@
 
 #define NPARAMS     11                              /* longest parameter list */
 
+/* optional: UA table for the theoretical models (see description) */
+#define UATABLE     ssGetSFcnParam(S,11)
+#define NPARAMS_UATABLE 12
+#define N_UATABLE   ((ssGetSFcnParamsCount(S) > NPARAMS)? (int_T)mxGetNumberOfElements(UATABLE) : 0)
+#define USE_UATABLE (N_UATABLE > 0 && mxGetPr(UATABLE)[0] > 0.0)
+#define UATAB_MDOT_DEFAULT  2.0     /* default grid: maximum massflow in kg/s */
+#define UATAB_TMIN_DEFAULT  0.0     /* default grid: minimum temperature */
+#define UATAB_TMAX_DEFAULT  100.0   /* default grid: maximum temperature */
+#define UATAB_N_DEFAULT     21      /* default grid: number of points */
+#define UATAB_PRESS         3.0e5   /* minimum pressure for the table, water is liquid up to 133 degree C */
+#define UATAB_PRESS_FACTOR  1.2     /* table pressure above the vapour pressure at the maximum temperature */
+#define UATAB_WARN_ERROR    0.2     /* warn if the interpolation error is above 20 % */
+
 /* defines for inputs              port   index             */
 #define TS(n)    (*u0[n])       /*  0     0..nodes-1     temperatures of storage nodes   degree C */
 #define T_IN     (*u1[0])       /*  1     0              inlet temperature               degree C */
@@ -163,8 +226,21 @@
 
 #define DWORK_TS_OLD_NR             0 /* old storage node temperature */
 #define DWORK_A_HX_NR               1 /* heat exchanger surface per node (only used for the theoretical models) */
+#define DWORK_UATAB_NR              2 /* UA table of one node */
+#define DWORK_UAGRID_NR             3 /* grid of the UA table and counters */
 #define TS_OLD(n)                   dwork_ts_old[n]
 #define A_HX                        dwork_a_hx[0]
+#define UATAB(im,itf,its)           dwork_uatab[((im)*NTEMP+(itf))*NTEMP+(its)]
+#define MDOTMAX                     dwork_uagrid[0]     /* maximum massflow of the grid */
+#define TMIN                        dwork_uagrid[1]     /* minimum temperature of the grid */
+#define DTEMP                       dwork_uagrid[2]     /* temperature step of the grid */
+#define NMDOT                       ((int_T)dwork_uagrid[3])
+#define NTEMP                       ((int_T)dwork_uagrid[4])
+#define TMAX                        dwork_uagrid[5]     /* maximum temperature of the grid */
+#define PTAB                        dwork_uagrid[6]     /* pressure of the table */
+#define PLAST                       dwork_uagrid[7]     /* pressure of the last call */
+#define TBOIL                       dwork_uagrid[8]     /* saturation temperature at PLAST */
+#define N_UAGRID                    9
 
 
 /* Calculate the power of the heat exchanger (logarithmic difference) */
@@ -206,6 +282,8 @@ real_T calculate_power_for_heatex(double mdot, double cphx, double *thx,
             logthx = (logthx < 0.0)? log(-logthx) : log(logthx);
             qhx = heatex*(*thx-thxn)/logthx; /* heat transfer in W */
             /* printf("T different: thxn %f  thx %f  t_store %f  qhx %f  mdot  %f\n", thxn,*thx,t_store,qhx,mdot); */
+        } else if (fabs(*thx-t_store) > 1.0e-10) { /* outlet reached node temperature (NTU > 25) */
+            qhx = mdot*cphx*(*thx-thxn);    /* energy balance of the fluid */
         } else { /* else temperatures are equal */
             qhx = 0.0;
             thxn = *thx;
@@ -220,6 +298,78 @@ real_T calculate_power_for_heatex(double mdot, double cphx, double *thx,
     *thx = thxn;            /* put value of thxn in thx as info of node temperature */
     return qhx;
 } /* end calculate_power_for_heatex */
+
+
+/* Heat transfer UA of one node for the theoretical models (portID 201, 202, 301, 302) */
+static real_T ua_theoretical(SimStruct *S, real_T mdot, real_T tin, real_T ts, real_T press, real_T ahx)
+{
+    int_T  port_id = (int_T)PORT_ID;    /* portID */
+    real_T dpipe   = DIA_PIPE;          /* outer diameter of heat exchanger pipe       m        */
+    real_T swall   = S_WALL;            /* wall thickness                              m        */
+    real_T conwall = COND_WALL;         /* conductivity  heat exch. material           W/(m*K) */
+    real_T dfin    = DIA_FIN;           /* total diameter of pipe with fins            m        */
+    real_T sfin    = S_WALL_FIN;        /* wallthickness fin                           m        */
+    real_T xnfin   = N_FIN;             /* number of fins per meter                    1/m      */
+    real_T v, re, pr, nu_in, nuss, u_out, u_in, m;
+
+    /* heat transfer calculation */
+    /* from Wagner: Waermeuebertragung, Vogel-Verlag, 1991 */
+    v = mdot/density(1.0,0.0,tin,press)*4.0/(PI*square(dpipe-2.0*swall));
+    re = reynolds(1.0,0.0,tin,press,v,dpipe-2.0*swall);
+    pr = prandtl(1.0, 0.0, (tin+ts)*0.5, press);
+    nu_in = 0.0235*(pow(re,0.8)-230)*pow(pr,0.48); /* equation from Wagner */
+    nuss = 0.5 * pow(grashof(1.0, 0.0, tin, ts, press, dpipe*PI/2)*pr,0.25); /* nusselt for water */
+    u_out = (nuss*thermal_conductivity(1.0,0.0,ts,press))
+        /(dpipe*PI/2);            /* outer heat transfer in W/(m^2*K) */
+    u_in = (nu_in*thermal_conductivity(1.0,0.0,tin,press))/dpipe; /* inner heat transfer in W/(m^2*K) */
+
+    if (port_id == 202 || port_id == 302)       /* finned tube, see Wagner 1991: page 83 */
+    {
+        m = sqrt(2.0*u_out/(conwall*sfin));
+        u_out = u_out*(1.0 - sfin*xnfin)      /* heat transfer remaining from the pipe */
+            + sfin*xnfin * m * conwall          /* + heat transfer of the fin */
+            *tanh(m*0.5*(dfin-dpipe));
+    }
+    return ahx/(1/u_out + swall/conwall + 1/u_in);
+} /* end ua_theoretical */
+
+
+/* massflow of grid point im (quadratic grid, dense at small massflows) */
+static real_T uatab_mdot(real_T mdotmax, int_T nmdot, real_T xm)
+{
+    xm /= (real_T)(nmdot-1);
+    return mdotmax*xm*xm;
+}
+
+
+/* trilinear interpolation in the UA table, returns -1 outside the grid or 
+ * when the water boils at the actual pressure (above TBOIL) */
+static real_T uatab_interpolate(SimStruct *S, real_T mdot, real_T tin, real_T ts)
+{
+    real_T *dwork_uatab  = (real_T *)ssGetDWork(S, DWORK_UATAB_NR);
+    real_T *dwork_uagrid = (real_T *)ssGetDWork(S, DWORK_UAGRID_NR);
+    real_T xm, xf, xs, fm, ff, fs, ua0, ua1;
+    int_T  im, itf, its;
+
+    xm = sqrt(max(mdot, 0.0)/MDOTMAX)*(real_T)(NMDOT-1);
+    xf = (tin-TMIN)/DTEMP;
+    xs = (ts-TMIN)/DTEMP;
+    if (xm > (real_T)(NMDOT-1) || xf < 0.0 || xf > (real_T)(NTEMP-1)
+        || xs < 0.0 || xs > (real_T)(NTEMP-1) || tin >= TBOIL || ts >= TBOIL)
+        return -1.0;
+    im  = min((int_T)xm, NMDOT-2);
+    itf = min((int_T)xf, NTEMP-2);
+    its = min((int_T)xs, NTEMP-2);
+    fm = xm-(real_T)im;
+    ff = xf-(real_T)itf;
+    fs = xs-(real_T)its;
+
+    ua0 = (1.0-ff)*((1.0-fs)*UATAB(im,itf,its) + fs*UATAB(im,itf,its+1))
+        + ff*((1.0-fs)*UATAB(im,itf+1,its) + fs*UATAB(im,itf+1,its+1));
+    ua1 = (1.0-ff)*((1.0-fs)*UATAB(im+1,itf,its) + fs*UATAB(im+1,itf,its+1))
+        + ff*((1.0-fs)*UATAB(im+1,itf+1,its) + fs*UATAB(im+1,itf+1,its+1));
+    return (1.0-fm)*ua0 + fm*ua1;
+} /* end uatab_interpolate */
       
        
 
@@ -261,6 +411,27 @@ real_T calculate_power_for_heatex(double mdot, double cphx, double *thx,
                 return;
             }
         }
+        /* optional UA table */
+        if (N_UATABLE > 0)
+        {
+            const real_T *uatab = mxGetPr(UATABLE);
+            if (N_UATABLE != 1 && N_UATABLE != 5) 
+            {
+                ssSetErrorStatus(S,"storage_heatexchanger: UATABLE must be 0, 1 or [mdotmax tmin tmax n_mdot n_temp]");
+                return;
+            }
+            if (N_UATABLE == 5 && (uatab[0] <= 0.0 || uatab[2] <= uatab[1] 
+                || uatab[3] < 2.0 || uatab[4] < 2.0)) 
+            {
+                ssSetErrorStatus(S,"storage_heatexchanger: UATABLE needs mdotmax > 0, tmax > tmin and at least 2 grid points");
+                return;
+            }
+            if (N_UATABLE == 5 && uatab[2] >= TEMPKRIT) 
+            {
+                ssSetErrorStatus(S,"storage_heatexchanger: UATABLE needs tmax below the critical temperature of water");
+                return;
+            }
+        }
         
   }
 #endif /* MDL_CHECK_PARAMETERS */
@@ -273,7 +444,12 @@ real_T calculate_power_for_heatex(double mdot, double cphx, double *thx,
  */
 static void mdlInitializeSizes(SimStruct *S)
 {
-    ssSetNumSFcnParams(S, NPARAMS);
+    int_T ntab = 1;
+
+    if (ssGetSFcnParamsCount(S) == NPARAMS_UATABLE)  /* UA table is optional */
+        ssSetNumSFcnParams(S, NPARAMS_UATABLE);
+    else
+        ssSetNumSFcnParams(S, NPARAMS);
 #if defined(MATLAB_MEX_FILE)
     if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
     {
@@ -312,7 +488,16 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumIWork(S, 0);
     ssSetNumPWork(S, 0);
     
-    ssSetNumDWork(S, 2);
+    if (USE_UATABLE)
+    {
+        if (N_UATABLE == 5)
+            ntab = (int_T)(mxGetPr(UATABLE)[3]+0.5)*(int_T)(mxGetPr(UATABLE)[4]+0.5)
+                *(int_T)(mxGetPr(UATABLE)[4]+0.5);
+        else
+            ntab = UATAB_N_DEFAULT*UATAB_N_DEFAULT*UATAB_N_DEFAULT;
+    }
+
+    ssSetNumDWork(S, 4);
     ssSetDWorkWidth(S, 0, (int)(NODES+0.5));
     ssSetDWorkDataType(S, 0, SS_DOUBLE);
     ssSetDWorkName(S, 0, "DWORK_TS_OLD");
@@ -321,6 +506,14 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetDWorkDataType(S, 1, SS_DOUBLE);
     ssSetDWorkName(S, 1, "DWORK_A_HX");
     ssSetDWorkUsageType(S, 1, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, 2, ntab);
+    ssSetDWorkDataType(S, 2, SS_DOUBLE);
+    ssSetDWorkName(S, 2, "DWORK_UATAB");
+    ssSetDWorkUsageType(S, 2, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, 3, N_UAGRID);
+    ssSetDWorkDataType(S, 3, SS_DOUBLE);
+    ssSetDWorkName(S, 3, "DWORK_UAGRID");
+    ssSetDWorkUsageType(S, 3, SS_DWORK_USED_AS_DWORK);
     
     
     ssSetNumModes(S, 0);
@@ -360,11 +553,14 @@ static void mdlInitializeSampleTimes(SimStruct *S)
   {
     real_T *dwork_ts_old     = (real_T *)ssGetDWork(S, DWORK_TS_OLD_NR);
     real_T *dwork_a_hx       = (real_T *)ssGetDWork(S, DWORK_A_HX_NR);
+    real_T *dwork_uatab      = (real_T *)ssGetDWork(S, DWORK_UATAB_NR);
+    real_T *dwork_uagrid     = (real_T *)ssGetDWork(S, DWORK_UAGRID_NR);
     int_T  port_id = (int_T)PORT_ID;        /* portID           */
     int_T  nodes  = (int_T)NODES;           /* number of nodes  */
     int_T  nstart = (int_T)START_NODE-1;    /* start node       */
     int_T  nend   = (int_T)END_NODE-1;      /* end node         */
-    int_T  n;
+    int_T  n, im, itf, its, nskip;
+    real_T ua, uaref, err, errmax, qmax, mdot, tf, ts;
 
     switch (port_id)
     { 
@@ -382,6 +578,87 @@ static void mdlInitializeSampleTimes(SimStruct *S)
 
     for (n = 0; n < nodes; n++)
         TS_OLD(n) = -10.0;
+
+    /* UA table for the theoretical models */
+    for (n = 0; n < N_UAGRID; n++)
+        dwork_uagrid[n] = 0.0;
+    if (USE_UATABLE && port_id != 201 && port_id != 202 && port_id != 301 && port_id != 302)
+    {
+        ssPrintf("storage_heatexchanger: UATABLE is only used for the theoretical models (portID 201, 202, 301, 302)\n");
+    }
+    else if (USE_UATABLE)
+    {
+        if (N_UATABLE == 5)
+        {
+            MDOTMAX = mxGetPr(UATABLE)[0];
+            TMIN = mxGetPr(UATABLE)[1];
+            dwork_uagrid[3] = floor(mxGetPr(UATABLE)[3]+0.5);
+            dwork_uagrid[4] = floor(mxGetPr(UATABLE)[4]+0.5);
+            TMAX = mxGetPr(UATABLE)[2];
+        }
+        else
+        {
+            MDOTMAX = UATAB_MDOT_DEFAULT;
+            TMIN = UATAB_TMIN_DEFAULT;
+            dwork_uagrid[3] = (real_T)UATAB_N_DEFAULT;
+            dwork_uagrid[4] = (real_T)UATAB_N_DEFAULT;
+            TMAX = UATAB_TMAX_DEFAULT;
+        }
+        DTEMP = (TMAX-TMIN)/(real_T)(NTEMP-1);
+        /* liquid water in the whole grid, the check of the interpolation 
+         * error below uses the same pressure */
+        PTAB = max(UATAB_PRESS, UATAB_PRESS_FACTOR*vapourpressure(1.0, 0.0, TMAX, UATAB_PRESS));
+        PLAST = PTAB;
+        TBOIL = saturationtemperature(1.0, 0.0, 0.0, PTAB);
+
+        /* UA <= 0 means no heat transfer (see mdlOutputs), the table is limited to 0 
+         * so the interpolation does not see the pole of the correlation at low
+         * Reynolds numbers */
+        for (im = 0; im < NMDOT; im++)
+            for (itf = 0; itf < NTEMP; itf++)
+                for (its = 0; its < NTEMP; its++)
+                    UATAB(im,itf,its) = max(0.0, ua_theoretical(S, uatab_mdot(MDOTMAX, NMDOT, (real_T)im),
+                        TMIN+DTEMP*(real_T)itf, TMIN+DTEMP*(real_T)its, PTAB, A_HX));
+
+        /* interpolation error in the centres of the grid cells: error of the heat 
+         * flow UA*(Tfluid-Tstorage) relative to the maximum heat flow at the same
+         * massflow (UA itself has a cusp at Tfluid = Tstorage where the heat flow 
+         * is zero). Cells with UA = 0 in a corner are not checked, there the
+         * correlation is not continuous (Reynolds number too low, Grashof number
+         * <= 0 around the density maximum of water). */
+        errmax = 0.0;
+        nskip = 0;
+        for (im = 0; im < NMDOT-1; im++)
+        {
+            err = 0.0;
+            qmax = 0.0;
+            for (itf = 0; itf < NTEMP-1; itf++)
+                for (its = 0; its < NTEMP-1; its++)
+                {
+                    if (UATAB(im,itf,its) <= 0.0 || UATAB(im,itf,its+1) <= 0.0 
+                        || UATAB(im,itf+1,its) <= 0.0 || UATAB(im,itf+1,its+1) <= 0.0
+                        || UATAB(im+1,itf,its) <= 0.0 || UATAB(im+1,itf,its+1) <= 0.0 
+                        || UATAB(im+1,itf+1,its) <= 0.0 || UATAB(im+1,itf+1,its+1) <= 0.0)
+                    {
+                        nskip++;
+                        continue;
+                    }
+                    mdot = uatab_mdot(MDOTMAX, NMDOT, (real_T)im+0.5);
+                    tf = TMIN+DTEMP*((real_T)itf+0.5);
+                    ts = TMIN+DTEMP*((real_T)its+0.5);
+                    uaref = max(0.0, ua_theoretical(S, mdot, tf, ts, PTAB, A_HX));
+                    ua = uatab_interpolate(S, mdot, tf, ts);
+                    err = max(err, fabs((ua-uaref)*(tf-ts)));
+                    qmax = max(qmax, fabs(uaref*(tf-ts)));
+                }
+            if (qmax > 0.0)
+                errmax = max(errmax, err/qmax);
+        }
+        ssPrintf("storage_heatexchanger: UA table %d x %d x %d, maximum interpolation error of heat flow %.2f %% "
+            "(%d of %d cells not checked)\n", NMDOT, NTEMP, NTEMP, 100.0*errmax, nskip, (NMDOT-1)*(NTEMP-1)*(NTEMP-1));
+        if (errmax > UATAB_WARN_ERROR)
+            ssWarning(S, "storage_heatexchanger: interpolation error of UA table is high, use a finer grid");
+    }
     
   } /* end mdl_start */
 #endif /*  MDL_START */
@@ -436,10 +713,12 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     InputRealPtrsType    u1  = ssGetInputPortRealSignalPtrs(S,1);
     real_T *dwork_ts_old     = (real_T *)ssGetDWork(S, DWORK_TS_OLD_NR);
     real_T *dwork_a_hx       = (real_T *)ssGetDWork(S, DWORK_A_HX_NR);
+    real_T *dwork_uagrid     = (real_T *)ssGetDWork(S, DWORK_UAGRID_NR);
     
-    real_T dpipe, swall, lpipe, conwall, dfin, sfin, uac, uam, uat, re, pr;
-    real_T xnfin, heatex, xnodes, tin, cp, nuss, m, v, nu_in, u_in, u_out;
+    real_T uac, uam, uat;
+    real_T heatex, xnodes, tin, cp;
     int_T  inc, n;
+    int_T  usetable = (NMDOT > 0);          /* UA table is available */
 
     int_T  port_id = (int_T)PORT_ID;        /* portID           */
     int_T  nodes   = (int_T)NODES;          /* number of nodes  */
@@ -457,6 +736,11 @@ static void mdlOutputs(SimStruct *S, int_T tid)
         qdot[n] = 0.0;
     }
     tin = T_IN;                             /* heat exchanger temperature at inlet */
+    if (usetable && PRESS != PLAST)         /* saturation temperature for the UA table */
+    {
+        PLAST = PRESS;
+        TBOIL = (PRESS < PRESSKRIT)? saturationtemperature(1.0, 0.0, 0.0, PRESS) : TEMPKRIT;
+    }
     
     for (n = nstart; n != nend+inc; n+=inc)
     {
@@ -471,33 +755,9 @@ static void mdlOutputs(SimStruct *S, int_T tid)
                 case 201: case 301: case 202: case 302:
                     /*  smooth tube heat exchanger (theoretical model) portID = 201, = 301 stratified charging */
                     /*  finned tube heat exchanger (theoretical model) portID = 202, = 302 stratified charging */
-                    dpipe   = DIA_PIPE;         /* outer diameter of heat exchanger pipe       m        */
-                    swall   = S_WALL;           /* wall thickness                              m        */
-                    lpipe   = LENGTH;           /* length of pipe                              m        */
-                    conwall = COND_WALL;        /* conductivity  heat exch. material           W/(m*K) */
-                    dfin    = DIA_FIN;          /* total diameter of pipe with fins            m        */
-                    sfin    = S_WALL_FIN;       /* wallthickness fin                           m        */
-                    xnfin   = N_FIN;            /* number of fins per meter                    1/m      */
-
-                    /* heat transfer calculation */
-                    /* from Wagner: Waermeuebertragung, Vogel-Verlag, 1991 */
-                    v = MDOT/density(1.0,0.0,tin,PRESS)*4.0/(PI*square(dpipe-2.0*swall));
-                    re = reynolds(1.0,0.0,tin,PRESS,v,dpipe-2.0*swall);
-                    pr = prandtl(1.0, 0.0, (tin+TS(n))*0.5, PRESS);
-                    nu_in = 0.0235*(pow(re,0.8)-230)*pow(pr,0.48); /* equation from Wagner */
-                    nuss = 0.5 * pow(grashof(1.0, 0.0, tin, TS(n), PRESS, dpipe*PI/2)*pr,0.25); /* nusselt for water */
-                    u_out = (nuss*thermal_conductivity(1.0,0.0,TS(n),PRESS))
-                        /(dpipe*PI/2);            /* outer heat transfer in W/(m^2*K) */
-                    u_in = (nu_in*thermal_conductivity(1.0,0.0,tin,PRESS))/dpipe; /* inner heat transfer in W/(m^2*K) */
-
-                    if (port_id == 202 || port_id == 302)       /* finned tube, see Wagner 1991: page 83 */
-                    {
-                        m = sqrt(2.0*u_out/(conwall*sfin));
-                        u_out = u_out*(1.0 - sfin*xnfin)      /* heat transfer remaining from the pipe */
-                            + sfin*xnfin * m * conwall          /* + heat transfer of the fin */
-                            *tanh(m*0.5*(dfin-dpipe));
-                    }
-                    heatex = A_HX/(1/u_out + swall/conwall + 1/u_in);
+                    heatex = (usetable)? uatab_interpolate(S, MDOT, tin, TS(n)) : -1.0;
+                    if (heatex < 0.0)   /* no table, outside the grid or boiling water */
+                        heatex = ua_theoretical(S, MDOT, tin, TS(n), PRESS, A_HX);
                     break;
 
                 case 203: case 303:     /* portID = 203, = 303 for stratified charging */
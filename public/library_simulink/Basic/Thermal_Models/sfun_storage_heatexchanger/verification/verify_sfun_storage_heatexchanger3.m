@@ -0,0 +1,255 @@
+function [v, s] = verify_sfun_storage_heatexchanger3(varargin)
+% verification of the power of the s-function storage_heatexchanger: the
+% heat exchanger runs through 8 nodes of a stratified storage with a 
+% massflow from 0 to 1 kg/s. The power and the outlet temperature are 
+% compared with
+%  - the exponential solution in each node (UA from data fit, portID 203 
+%    and 204), including small massflows where the outlet reaches the 
+%    node temperature (NTU > 25)
+%  - the results of version 6.2.2 of storage_heatexchanger (portID 201, 
+%    203, 204) which must be the same except in the range NTU > 25, where
+%    version 6.2.2 returned no power.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_sfun_storage_heatexchanger3(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_sfun_storage_heatexchanger3' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_sfun_storage_heatexchanger3:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-6;       % max error between simulation and reference in W or K
+max_simu_error = 1e-7;  % max error between initial and current simu
+max_base_error = 1e-9;  % max error between version 6.2.2 and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_sfun_storage_heatexchanger3_mdl';
+
+mdot = [0 1e-4 3e-4 1e-3 3e-3 0.01 0.03 0.1 0.3 1]';  % massflow in kg/s
+tstore = 20:3:47;           % temperatures of the storage nodes in degC
+tin = 70;                   % inlet temperature in degC
+cp = 4181;                  % heat capacity of WATER_CONSTANT (fluid ID 7)
+nstart = 9;                 % inlet node
+nend = 2;                   % outlet node
+uac = [500 102.7];          % UA parameters portID 203 and 204 (EN 12977)
+uam = [0 0.226];
+uat = [0 0.55];
+% portID, nodes, start, end, 7 parameters of the heat transfer
+param = {sprintf('203, 10, %d, %d, %g, 0, 0, 0, 0, 0, 0', nstart, nend, uac(1)), ...
+    sprintf('201, 10, %d, %d, 0.0213, 0.0015, 18, 50, 0.05, 0.0005, 100', nstart, nend), ...
+    sprintf('204, 10, %d, %d, %g, %g, %g, 0, 0, 0, 0', nstart, nend, uac(2), uam(2), uat(2))};
+fluid = [7 1 7];            % WATER_CONSTANT for the exponential solution
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Constant', [mdl '/Ts'], 'Value', mat2str(tstore'));
+for k = 1:3
+    hx = sprintf('%s/hx%d', mdl, k);
+    add_block('simulink/Sources/Constant', sprintf('%s/u%d', mdl, k), ...
+        'Value', sprintf('[%g 0 1e5 %d 0]', tin, fluid(k)));
+    add_block('simulink/User-Defined Functions/S-Function', hx, ...
+        'FunctionName', 'storage_heatexchanger', 'Parameters', param{k});
+    add_block('simulink/Sinks/Out1', sprintf('%s/q%d', mdl, k));
+    add_block('simulink/Sinks/Out1', sprintf('%s/thx%d', mdl, k));
+    add_line(mdl, 'Ts/1', sprintf('hx%d/1', k));
+    add_line(mdl, sprintf('u%d/1', k), sprintf('hx%d/2', k));
+    add_line(mdl, sprintf('hx%d/1', k), sprintf('q%d/1', k));
+    add_line(mdl, sprintf('hx%d/2', k), sprintf('thx%d/1', k));
+end
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', '1', ...
+    'StopTime', '0', 'SaveFormat', 'Array');
+% power of the heat exchangers and outlet temperature (node nend)
+y2 = zeros(length(mdot), 6);
+for n = 1:length(mdot)
+    set_param([mdl '/u1'], 'Value', sprintf('[%g %g 1e5 %d 0]', tin, mdot(n), fluid(1)));
+    set_param([mdl '/u2'], 'Value', sprintf('[%g %g 1e5 %d 0]', tin, mdot(n), fluid(2)));
+    set_param([mdl '/u3'], 'Value', sprintf('[%g %g 1e5 %d 0]', tin, mdot(n), fluid(3)));
+    simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+    yy = simOut.get('yout');
+    yy = reshape(yy(end,:), 10, 6);     % columns: q, thx of each block
+    y2(n,:) = [sum(yy(:,[1 3 5])), yy(nend,[2 4 6])];
+end
+close_system(mdl, 0)            % close system, but do not save it
+
+%% ----------------- set the reference values -----------------------------
+% ----------------- results of version 6.2.2 ------------------------------
+% power of portID 203, 201, 204 in W and their outlet temperature in degC
+y6 = [0,0,0,23,70,70; ...
+    0,0,0,70,70,70; ...
+    0,0,58.9518197227538,70,70,23.0002234530088; ...
+    196.506995956957,0,196.205142157094,23.000000966133,70,23.0721975228192; ...
+    589.261294218405,0,580.393556865967,23.020705236514,70,23.7276921895905; ...
+    1928.79902573604,1430.35739036801,1836.38547537828,23.8675191165741,35.8069914471482,26.0778408185056; ...
+    5269.87498102471,4899.00574015325,4811.95775559993,27.9855299288471,30.9554061764545,31.6363090520615; ...
+    11315.8710934177,12886.0427933581,11095.4107680123,42.9350129313137,39.1947749088088,43.4623038315899; ...
+    15374.0356579707,22912.5575870644,19041.0469884564,57.7429357745589,51.750688812026,54.8193837292064; ...
+    17311.9106603824,31122.0946333838,29189.4753223346,65.8593851565696,62.5675836538855,63.0185421376861];
+% version 6.2.2 returned no power when the outlet reached the node 
+% temperature within 1e-10 K (NTU > 25), these cases are not compared
+y6ok = true(size(y6));
+y6ok([2 3], [1 4]) = false;     % portID 203 at 0.1 and 0.3 g/s
+y6ok(2, [3 6]) = false;         % portID 204 at 0.1 g/s
+
+% exponential solution of the fluid temperature in each node, the storage
+% temperature is constant in the node: Tout = Ts + (Tin-Ts)*exp(-NTU)
+y0 = zeros(length(mdot), 6);
+for n = 1:length(mdot)
+    for k = 1:2
+        t = tin;
+        q = 0;
+        for m = nstart:-1:nend
+            ua = uac(k)*mdot(n)^uam(k)*((tstore(m)+t)/2)^uat(k)/(nstart-nend+1);
+            if ua == 0              % no heat transfer
+                ntu = 0;
+            else                    % NTU is Inf for mdot = 0
+                ntu = ua/(mdot(n)*cp);
+            end
+            tout = tstore(m) + (t-tstore(m))*exp(-ntu);
+            q = q + mdot(n)*cp*(t-tout);
+            t = tout;
+        end
+        y0(n,[2*k-1, 2*k+2]) = [q, t];
+    end
+end
+% the theoretical model (portID 201) has no analytical solution, it is 
+% only checked against version 6.2.2 and the initial simulation
+y0(:,[2 5]) = y6(:,[2 5]);
+
+% ----------------- set reference values initial simulation ---------------
+% result of storage_heatexchanger version 6.2.4
+y1 = [0,0,0,23,70,70; ...
+    19.6507,0,19.650700031493,23,70,23.0000000006547; ...
+    58.9521,0,58.9518197227538,23,70,23.0002234530088; ...
+    196.506995956957,0,196.205142157094,23.000000966133,70,23.0721975228192; ...
+    589.261294218405,0,580.393556865967,23.020705236514,70,23.7276921895905; ...
+    1928.79902573604,1430.35739036801,1836.38547537828,23.8675191165741,35.8069914471482,26.0778408185056; ...
+    5269.87498102471,4899.00574015325,4811.95775559993,27.9855299288471,30.9554061764545,31.6363090520615; ...
+    11315.8710934177,12886.0427933581,11095.4107680123,42.9350129313137,39.1947749088088,43.4623038315899; ...
+    15374.0356579707,22912.5575870644,19041.0469884564,57.7429357745589,51.750688812026,54.8193837292064; ...
+    17311.9106603824,31122.0946333838,29189.4753223346,65.8593851565696,62.5675836538855,63.0185421376861];
+e6 = max(abs(y6(y6ok)-y2(y6ok)));
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+elseif e6 > max_base_error
+    v = false;
+    s = sprintf('verification %s with version 6.2.2 FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e6, max_base_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    disp(['Error to version 6.2.2 = ', num2str(e6)])
+    sx = 'massflow in kg/s';            % x-axis label
+    st = 'storage heat exchanger, portID 203'; % title
+    sy1 = 'power in W';                 % y-axis label in the upper plot
+    sy2 = 'Difference in W';            % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'exponential solution','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'solution vs initial simu','solution vs current simu','initial simu vs current'};
+    % x axis
+    x = mdot;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,201 @@
+function [v, s] = verify_sfun_storage_heatexchanger4(varargin)
+% verification of the UA table of the s-function storage_heatexchanger 
+% (parameter UATABLE = 1) with the direct calculation of the heat 
+% transfer (UATABLE = 0) for the theoretical models (portID 201 and 202).
+% The heat exchanger runs through 8 nodes of a stratified storage. 
+% Compared is the power for massflows from 0.05 to 3 kg/s and inlet 
+% temperatures from 70 to 150 degC. A massflow of 3 kg/s is outside the 
+% default grid (0..2 kg/s), 120 degC at 1 bar is boiling water and 150 
+% degC at 5 bar is outside the default grid (0..100 degC), in these cases
+% UA is calculated directly.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_sfun_storage_heatexchanger4(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_sfun_storage_heatexchanger4' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_sfun_storage_heatexchanger4:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.005;      % max relative error between table and direct calculation
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_sfun_storage_heatexchanger4_mdl';
+
+mdot = [0.05 0.2 0.6 3]';   % massflow in kg/s
+tin = [70 95 120 150];      % inlet temperature in degC
+press = [1e5 1e5 1e5 5e5];  % pressure in Pa
+tstore = 20:3:47;           % temperatures of the storage nodes in degC
+% portID, nodes, start, end, 7 parameters of the heat transfer, UATABLE
+port = [201 201 202 202];
+uatable = [0 1 0 1];
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Constant', [mdl '/Ts'], 'Value', mat2str(tstore'));
+add_block('simulink/Sources/Constant', [mdl '/u'], 'Value', '[70 0 1e5 1 0]');
+for k = 1:4
+    hx = sprintf('%s/hx%d', mdl, k);
+    add_block('simulink/User-Defined Functions/S-Function', hx, ...
+        'FunctionName', 'storage_heatexchanger', 'Parameters', ...
+        sprintf('%d, 10, 9, 2, 0.0213, 0.0015, 18, 50, 0.05, 0.0005, 100, %d', ...
+        port(k), uatable(k)));
+    add_block('simulink/Sinks/Out1', sprintf('%s/q%d', mdl, k));
+    add_block('simulink/Sinks/Terminator', sprintf('%s/thx%d', mdl, k));
+    add_line(mdl, 'Ts/1', sprintf('hx%d/1', k));
+    add_line(mdl, 'u/1', sprintf('hx%d/2', k));
+    add_line(mdl, sprintf('hx%d/1', k), sprintf('q%d/1', k));
+    add_line(mdl, sprintf('hx%d/2', k), sprintf('thx%d/1', k));
+end
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', '1', ...
+    'StopTime', '0', 'SaveFormat', 'Array');
+% power of the heat exchangers: direct and table for each portID
+yy = zeros(length(tin)*length(mdot), 4);
+for c = 1:length(tin)
+    for n = 1:length(mdot)
+        set_param([mdl '/u'], 'Value', sprintf('[%g %g %g 1 0]', tin(c), mdot(n), press(c)));
+        simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+        yq = simOut.get('yout');
+        yq = reshape(yq(end,:), 10, 4);  % columns: q of each block
+        yy((c-1)*length(mdot)+n,:) = sum(yq);
+    end
+end
+close_system(mdl, 0)            % close system, but do not save it
+
+%% ----------------- set the reference values -----------------------------
+% direct calculation of UA (UATABLE = 0), portID 201 and 202
+y0 = yy(:,[1 3]);
+
+% ----------------- set reference values initial simulation ---------------
+% result of the UA table at creation of the function
+y1 = [7628.50232573043,8298.63157369789;19207.3566261174,24493.6837376694; ...
+    28217.8760749447,41259.1141093691;34699.855748756,56188.9302296515; ...
+    12711.1267579236,13486.1757913059;34904.7515404927,42382.113372622; ...
+    54863.0743896472,76021.2445912817;70670.7591649124,108907.967637848; ...
+    12127.9197467834,12795.2458497415;39680.1664390639,45599.2212118583; ...
+    81962.1720127533,100277.349661856;207440.845162989,243249.759171879; ...
+    24309.4131097302,25245.5536115599;73252.8955127058,84387.2049364096; ...
+    125850.999007737,163491.103929324;172861.870900565,250460.875118281];
+
+% current simulation: UA table (UATABLE = 1)
+y2 = yy(:,[2 4]);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'relative'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'case';                        % x-axis label
+    st = 'Power of the heat exchanger'; % title
+    sy1 = 'Power in W';                 % y-axis label in the upper plot
+    sy2 = 'Relative difference';        % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'direct calculation','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'direct vs initial simu','direct vs current simu','initial simu vs current'};
+    % x axis
+    x = (1:size(y0,1))';
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
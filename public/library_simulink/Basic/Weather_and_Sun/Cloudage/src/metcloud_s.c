@@ -45,6 +45,10 @@
  *                      SimStateCompliance and
  *                      SupportsMultipleExecInstances added
  * 6.1.2    hf          corrected mx (not m) in line 387        18sep2015
+ * 6.1.3    hf          declination, solar time and extraterr.  19oct2026
+ *                      radiation from one call of solar_ephemeris
+ * 6.2.0    hf          calculation in radiation_diagnostics    19oct2026
+ *                      of carlib
  *
  * Copyright (c) 1999 Solar-Institut Juelich, Germany
  * 
@@ -241,155 +245,18 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     real_T *y1 = ssGetOutputPortRealSignal(S,0);
     real_T *dwork    = (real_T *)ssGetDWork(S, 0);
     real_T time = TIME;
-
-    real_T I, ClearIndex, delta, woz, HourAngle, coszenit,
-           Iextra, IextraDay, day, 
-           dimness, Idirclear, Idfuclear, Iclear, Taudir, Taudfu,
-           latitude, Trs, Tab, Tms,
-           zenith, sunangle, CloudFraction, a, b;
     real_T mx,bx,dx;
+    real_T diag[RAD_NDIAG];
+    int    skytype = (int)(SKYTYPE+0.5);
 
-    int    SunHour;
-     
-    I = IGLOB;
-    a = 0.75; /* Parameter fr Berechnung von "CloudIndex"*/
-    b = 3.2;  /* Parameter fr Berechnung von "CloudIndex"*/
+    /* solar position and cloud index in the carlib function, 
+     * sky types other than 2, 3, 4 are high mountain */
+    radiation_diagnostics(diag, time, IGLOB, LATITUDE, LONGITUDE, LONGITUDENULL,
+        max(1, skytype));
 
-    latitude = DEG2RAD*LATITUDE;
-    
-    /* Besetzen diverser Variablen mit Default-Werten:*/
-    SunHour = 0;	    /* Kennung fr Tagesstunden; "0" = NACHTstunden*/
-    ClearIndex = -1.0;    /* Erkennungsmarke fr NACHT-Interpolation    */
-    CLOUDINDEX = 0.0;
-    day = ceil(TIME/86400.);
-    
-       /* Tgliche Deklination der Sonne "DeclDay" (nach Meli,1988,S.32):*/
-       //DeclDay = DeclDayAmpl * cos(2*PI*(day+10)/365);
-       //DeclDay = solar_declination(double time);
-       
-    /* Tagesmittelwert der extraterrestrischen Strahlung "IextraDay", die senkrecht*/
-    /* auf eine zur Sonne orientierten Flche fllt */
-    IextraDay = extraterrestrial_radiation(time);
-       
-       /* ------------------------------------------------------------------------------- 
-    	* 	"Decl"			Deklination der Sonne
-    	*	"HourAngle" 	Stundenwinkel der Sonne 
-    	*	"zenit"			Zenithwinkel 
-        *	"SunAngle"		Sonnenhhenwinkel
-    	* 	"azimut"			Azimutwinkel 
-    	*	"Iextra"			Extraterrestrische Strahlung auf HORIZONTALE Flche
-        *	"SunHour"		Tag-/Nachterkennung rkennung
-        *"dimness"		Trbungsfaktor der Atmosphre
-        * 	"Idirclear"		direkte Strahlung auf der Erdoberflche fr KLAREN Himmel 
-    	* 	"Idfuclear"		diffuse Strahlung auf der Erdoberflche fr KLAREN Himmel 
-       /* -------------------------------------------------------------------------------*/ 
-
-    /* solar time 0 .. 24*3600 s */
-    woz = solar_time(time, LONGITUDENULL, LONGITUDE);      /* solar time from carlib */
-
-    /* determine solar hour angle in radian (noon = 0,  6 a.m. = -PI) */
-    HourAngle = (woz - 43200.0)*7.272205216643040e-5;
-
-    /* declination of the sun */
-    delta = solar_declination(time); 
-
-    /* solar zenith angle in degrees (0 = zenith position, 90 = horizont) */
-    coszenit = sin(latitude)*sin(delta) + cos(latitude)*cos(delta)*cos(HourAngle);
-    zenith  =  acos(coszenit)*RAD2DEG;   
-    
-        
-    /* Sonnenhhenwinkel "SunAngle":*/
-    sunangle = 90.0 - zenith;
-    if (sunangle < 0.01)
-        sunangle = 0.01; /* da sonst Warnung "log(0)" (s.u.), falls SunAngle = 0.*/
-        
-    /* Auf eine HORIZONTALE (= der Erdoberflche parallelen) Flche unter dem  */
-    /* Winkel "zenit" treffende extraterrestrische Strahlung "Iextra":         */
-    Iextra = IextraDay * coszenit;
-        
-    /* Kennung fr Tagesstunden "SunHour":      */
-    if (Iextra > 0.0)
-        SunHour = 1;
-    else
-        SunHour = 0;
-        
-        /* Spline-Interpolation der Zwischenwerte der Transmissionsfaktoren "TauXY": */
-        /*        Trs = interp1(SunAngleRef,TauRS,sunangle,'cubic');
-        Tab = interp1(SunAngleRef,TauAB,sunangle,'cubic');
-        Tms = interp1(SunAngleRef,TauMS,sunangle,'cubic');  
-        */      
-    /*
-     * Anstelle der Interpolation mit interp1 und gegebenen Vektoren, stehen hier
-     * Funktionen, die aus den Vektoren TauRS, ... mit Hilfe von Origin ermittelt wurden.
-     * Die Fehler liegen maximal bei 0.1 %
-     */
-    Trs = 0.0101  + 0.4225*(1-exp(-sunangle/15.83705)) + 0.47249*(1+exp(-sunangle/1.56203));
-    Tab = 0.01001 + 0.18336*(1-exp(-sunangle/10.72578)) + 0.71278*(1+exp(-sunangle/0.00125));
-    
-    switch ((int)(SKYTYPE+0.5))
+    if (diag[2] >= 0.0)   /* day */
     {
-        case 1: default:            /* high mountain */
-            Tms = 0.01 + 0.41882*(1-exp(-sunangle/9.86609)) 
-                + 0.56058*(1+exp(-sunangle/0.02186));
-            break;
-        case 2:                     /* lowland */
-            Tms = 0.01 + 0.66679*(1-exp(-sunangle/13.71293)) 
-                + 0.23729*(1+exp(-sunangle/0.02186));
-            break;
-
-        case 3:                     /* urban region */
-            Tms = 0.01026 + 0.41079*(1-exp(-sunangle/32.42557)) 
-                + 0.44058*(1+exp(-sunangle/8.46267));
-            break;
-
-        case 4:                     /* industrial zone */
-            Tms = -0.00021 + 0.38332*(1-exp(-sunangle/24.10493)) 
-                + 0.38343*(1+exp(-sunangle/24.25446));
-            break;
-    }
-    
-    /* Trbungsfaktor "dimness" (nach Meli, 1993, S.38ff):  */
-    dimness = 1.0 + ( (log(Tms) + log(Tab)) / log(Trs) );
-        
-    /* KLARER Himmel: Transmissionsfaktor "Taudir" und DIREKTstrahlung "Idirclear" */
-    /* auf eine zur Einfallsrichtung senkrechte Flche (nach Kasten/Meli,1993,S.38ff):*/
-    Taudir = exp( -dimness/(0.9 + 9.4 * coszenit) );
-    Idirclear = Iextra * Taudir;
-    
-    /* KLARER Himmel: Transmissionsfaktor "Taudfu" und DIFFUSstrahlung "Idfuclear" */
-    /* auf eine zur Einfallsrichtung senkrechte Flche                             */
-    /*(nach Liu/Jordan bzw. nach Duffie/Beckman,1991,S.75):                        */
-    Taudfu = 0.2710 - 0.2939 * Taudir; 
-    Idfuclear	= Iextra * Taudfu;
-    
-    /* KLARER Himmel: Globalstrahlung auf HORIZONTALE "Iclear":                    */
-    Iclear= Idirclear + Idfuclear;
-    
-    /* Unterdrckung von nchtlichen Offset-Werten in "I":                         */
-    if (SunHour == 0 && I > 0.0)
-       I = 0.0;
-       	
-
-   	
-	/* ------------------------------------------------------------------------------- 
-	  	"ClearIndex"	Klarheitsindex der Atmosphre (TAG)
-	 	"CloudIndex"	Bedeckungsgrad des Himmels (TAG)
-	 	"Idir"			direkte Strahlung auf der Erdoberflche
-	 	"Idfu"			diffuse Strahlung auf der Erdoberflche
-	 ------------------------------------------------------------------------------- */
-
-    if (SunHour == 1)
-    {
-       CloudFraction = I/Iclear;
-
-       if (CloudFraction > 1.0)       /*ggfs. Korrektur, damit "CloudIndex" <= 1 bleibt:*/
-    		CloudFraction = 1.0;
-
-       CLOUDINDEX = pow(( 1.0/a * (1.0 - CloudFraction) ),(1.0/b));
-       
-       if (CLOUDINDEX > 1.0)
-          CLOUDINDEX = 1.0;
-
+       CLOUDINDEX = diag[2];
     }
     else      /* Nachtwerte : Interpolation durch Gerade durch die letzten beiden Werte */
     {
@@ -40,6 +40,10 @@
  * 4.1.0    hf          using carlib functions for solar position   02dec2008
  * 5.1.0    hf          changed unknown global-diffuse correlation  01jun2012
  *                      to the Orgill and Hollands Model (1977) 
+ * 6.1.0    hf          declination, solar time and extraterr.  19oct2026
+ *                      radiation from one call of solar_ephemeris
+ * 6.2.0    hf          calculation in radiation_diagnostics    19oct2026
+ *                      of carlib
  *
  * Copyright (c) 1999 Solar-Institut Juelich, Germany
  * 
@@ -227,128 +231,27 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     InputRealPtrsType u1Ptrs = ssGetInputPortRealSignalPtrs(S,0);
     real_T *y1 = ssGetOutputPortRealSignal(S,0);
     real_T time = TIME;
-    
-    real_T Iglobal, SunHour, ClearIndex, 
-           delta, woz, HourAngle, coszenit,
-           latitude, Iextra, IextraDay;
-     
-    Iglobal = IGLOB;
-  
-    /* Besetzen diverser Variablen mit Default-Werten:*/
-    SunHour = 0;	/* Kennung fr Tagesstunden; "0" = NACHTstunden*/
-    ClearIndex = -1; /* Erkennungsmarke fr NACHT-Interpolation    */
-    
-    IDFU = 0;	/* Default: "0" = NACHT */
-    
-    latitude = DEG2RAD*LATITUDE;
-    
-    
-    SUNANGLE = 0;
-    ZENITH = 0;
-    AZIMUTH = 0;
-    
-    
-    if (Iglobal<0)       /* wenn negative Einstrahlung, dann Einstrahlungen = 0*/
+    real_T diag[RAD_NDIAG];
+
+    if (IGLOB < 0)      /* wenn negative Einstrahlung, dann Einstrahlungen = 0*/
     {
-       IDIR = 0;
-       IDFU = 0;
+        IDIR = 0;
+        IDFU = 0;
+        SUNANGLE = 0;
+        ZENITH = 0;
+        AZIMUTH = 0;
     }
     else
     {
-       /* ------------------------------------------------------------------------------- 
-    	* 	"Decl"			Deklination der Sonne
-    	*	"HourAngle" 	Stundenwinkel der Sonne 
-    	*	"zenit"			Zenithwinkel 
-        *	"SunAngle"		Sonnenhhenwinkel
-    	* 	"azimut"			Azimutwinkel 
-    	*	"Iextra"			Extraterrestrische Strahlung auf HORIZONTALE Flche
-        *	"SunHour"		Tag-/Nachterkennung rkennung
-        *"dimness"		Trbungsfaktor der Atmosphre
-        * 	"Idirclear"		direkte Strahlung auf der Erdoberflche fr KLAREN Himmel 
-    	* 	"Idfuclear"		diffuse Strahlung auf der Erdoberflche fr KLAREN Himmel 
-       /* -------------------------------------------------------------------------------*/ 
-
-        /* solar time 0 .. 24*3600 s */
-        woz = solar_time(time, LONGITUDENULL, LONGITUDE);      /* solar time from carlib */
-
-        /* determine solar hour angle in radian (noon = 0,  6 a.m. = -PI) */
-        HourAngle = (woz - 43200.0)*7.272205216643040e-5;
-
-        /* declination of the sun */
-        delta = solar_declination(time); 
-
-        /* solar zenith angle in degrees (0 = zenith position, 90 = horizont) */
-        coszenit = sin(latitude)*sin(delta) + cos(latitude)*cos(delta)*cos(HourAngle);
-        ZENITH  =  acos(coszenit)*RAD2DEG;   
-    
-        /* solar azimuth angle */
-        if (ZENITH != 0.0 && ZENITH != 180.0)  /* zenith angle not 0 and not 180 */ 
-        {
-           AZIMUTH = RAD2DEG*acos((sin(latitude)*coszenit 
-              -sin(delta))/(cos(latitude)*sin(acos(coszenit))));
-           if (HourAngle < 0)
-              AZIMUTH = -AZIMUTH;
-        }
-        else
-           AZIMUTH = 0.0;
-        
-        /* Sonnenhhenwinkel "SunAngle":*/
-        SUNANGLE = 90 - ZENITH;
-        if (SUNANGLE < .01)
-           SUNANGLE = .01; /* da sonst Warnung "log(0)" (s.u.), falls SunAngle = 0.*/
-        
-        /* Auf eine HORIZONTALE (= der Erdoberflche parallelen) Flche unter dem  */
-        IextraDay = extraterrestrial_radiation(time);
-        /* Winkel "zenit" treffende extraterrestrische Strahlung "Iextra":         */
-        Iextra = IextraDay * coszenit;
-        
-        /* Kennung fr Tagesstunden "SunHour":      */
-        if (Iextra > 0.0)
-           SunHour = 1;
-        else
-           SunHour = 0;
-        
-        /* Unterdrckung von nchtlichen Offset-Werten in "Iglobal":                         */
-        if (SunHour == 0 && Iglobal > 0.0)
-           Iglobal = 0.0;
-       	
-        /* ------------------------------------------------------------------------------- 
-         * 	"ClearIndex"	Klarheitsindex der Atmosphre (TAG)
-         * 	"Idir"			direkte Strahlung auf der Erdoberflche
-         * 	"Idfu"			diffuse Strahlung auf der Erdoberflche
-         * ------------------------------------------------------------------------------- */
-        
-        IDFU = 0.0;
-        if (SunHour == 1)
-        {
-           ClearIndex = Iglobal/Iextra;
-           
-           if (ClearIndex > 1.0)           /* ggfs. Korrektur, damit "ClearIndex" <= 1 bleibt:*/
-              ClearIndex = 1.0;
-
-           
-           /* Diffuse Strahlung auf HORIZONTALE Flche "Idfu" ...  */ /* unknown model */
-           /* if (ClearIndex <= 0.3)
-            *  IDFU = Iglobal * (1 - 0.2 * ClearIndex);
-            * else if (ClearIndex <= 0.79)
-            *  IDFU = Iglobal * (1.423-1.612 * ClearIndex);
-            * else
-            *  IDFU = Iglobal * 0.15;
-            */
-
-           /* diffuse radiation on horizontal surface
-            *  Orgill & Hollands correlation from Duffie, Beckmann Solar Engineering 2006 */
-            if (ClearIndex <= 0.35)
-                IDFU = Iglobal * (1 - 0.249 * ClearIndex);
-            else if (ClearIndex <= 0.75)
-                IDFU = Iglobal * (1.557 - 1.84 * ClearIndex);
-            else
-                IDFU = Iglobal * 0.177;
-        }
-        
-        /* Direkte Strahlung auf HORIZONTALE Flche "Idir"*/
-        IDIR = Iglobal - IDFU;
-    
+        /* solar position and diffuse radiation on horizontal surface with the
+         * Orgill & Hollands correlation from Duffie, Beckmann Solar Engineering 2006
+         * in the carlib function, no cloud index (skytype 0) */
+        radiation_diagnostics(diag, time, IGLOB, LATITUDE, LONGITUDE, LONGITUDENULL, 0);
+        IDIR = diag[0];
+        IDFU = diag[1];
+        ZENITH = diag[3];
+        AZIMUTH = diag[4];
+        SUNANGLE = diag[5];
     } /* else if Iglobal>=0*/
 
 } /* end mdloutputs */
@@ -0,0 +1,565 @@
+/***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * borehole field with g-function and load aggregation
+ *
+ * Author list
+ *  hf -> Bernd Hafner
+ *
+ * Version  Author  Changes                                     Date
+ * 6.1.0    hf      created                                     19oct2026
+ * 6.1.1    hf      sign of the image terms in the finite       19oct2026
+ *                  line source (isothermal ground surface)
+ *
+ ***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+
+
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Field of NBORE boreholes with U-tubes of the same length, connected in
+ * parallel. The ground is not discretised, the temperature at the
+ * borehole wall is calculated from the load history and the g-function
+ * of the field (response factors):
+ *
+ *   Tb(t) = Tground + sum_v (q_v - q_v+1) * g(tau_v) / (2*pi*cond)
+ *
+ *  symbol      used for                                        unit
+ *  q_v         heat to the ground per borehole length in       W/m
+ *              aggregation cell v
+ *  tau_v       age of the end of cell v                        s
+ *  g           g-function of the field                         -
+ *  cond        heat conductivity of the ground                 W/(m*K)
+ *
+ * g-function
+ * The g-function is the finite line source of Claesson and Javed for all
+ * pairs of boreholes (same length and buried depth), averaged over the
+ * field. It is calculated once in mdlStart at the times tau_v of the
+ * aggregation cells. Pairs with the same distance are only calculated
+ * once, so regular fields are cheap even with many boreholes.
+ *
+ * load aggregation
+ * The load history is aggregated with the method of Claesson and Javed:
+ * NCELLS cells of one time step, NCELLS cells of 2 time steps, of 4 time
+ * steps and so on, until the cells cover HORIZON (100 years). In each
+ * time step the load moves from one cell to the next older cell by
+ * 1/(width of the cell). The effort per time step is proportional to the
+ * number of cells (about 90 for hourly steps and NCELLS = 5), not to the
+ * number of time steps simulated.
+ *
+ * borehole
+ * The short term response comes from a resistance-capacity model of the
+ * borehole: one node for the filling (grout, pipes and fluid, capacity
+ * CBORE per length) in the middle of the borehole resistance RB. The
+ * fluid passes the node with the effectiveness of a pipe with
+ * NTU = 2/(w*RB), w = mdot*cp/(NBORE*HBORE). The node temperature is
+ * calculated implicitly together with the load of the time step, so the
+ * model is stable for all time steps and massflows.
+ *
+ * The block is discrete with the sample time TSAMPLE (typical 3600 s).
+ * The outputs are the results of the last time step.
+ *
+ * parameters
+ *  index   use                                                 units
+ *  0       position of the boreholes (NBORE x 2: x, y)          m
+ *  1       length of the boreholes                             m
+ *  2       buried depth (top of borehole below surface)        m
+ *  3       radius of the boreholes                             m
+ *  4       heat conductivity of the ground                     W/(m*K)
+ *  5       heat capacity of the ground                         J/(m^3*K)
+ *  6       undisturbed ground temperature                      C
+ *  7       borehole thermal resistance (fluid to wall)         m*K/W
+ *  8       heat capacity of the borehole filling and fluid     J/(m*K)
+ *          per borehole length
+ *  9       sample time                                         s
+ *  10      cells per aggregation level (optional, default 5)
+ *
+ * structure of u (input vector)
+ *  index   use                                                 units
+ *  0       inlet temperature                                   C
+ *  1       massflow of the field                               kg/s
+ *  2       pressure                                            Pa
+ *  3       fluid ID (defined in CARNOT.h)
+ *  4       mixture  (defined in CARNOT.h)
+ *
+ * structure of y (output vector)
+ *  index   use                                                 units
+ *  0       outlet temperature                                  C
+ *  1       temperature of the borehole filling                 C
+ *  2       mean temperature at the borehole wall               C
+ *  3       heat to the ground (positive for injection)         W
+ *
+ * Literature:
+ * Claesson, J., Javed, S.: An analytical method to calculate borehole
+ *      fluid temperatures for time-scales from minutes to decades,
+ *      ASHRAE Transactions 117(2), 2011
+ * Claesson, J., Javed, S.: A load-aggregation method to calculate
+ *      extraction temperatures of borehole heat exchangers, ASHRAE
+ *      Transactions 118(1), 2012
+ * Cimmino, M., Bernier, M.: A semi-analytical method to generate
+ *      g-functions for geothermal bore fields, Int. J. Heat Mass
+ *      Transfer 70, 2014
+ */
+
+#define S_FUNCTION_NAME     borefield
+#define S_FUNCTION_LEVEL    2
+
+#include <stdlib.h>
+#include <math.h>
+#include "simstruc.h"
+#include "carlib.h"
+
+#define S_XY            ssGetSFcnParam(S,0)                 /* positions of the boreholes [m] */
+#define HBORE           (*mxGetPr(ssGetSFcnParam(S,1)))     /* length of the boreholes [m] */
+#define DBURY           (*mxGetPr(ssGetSFcnParam(S,2)))     /* buried depth [m] */
+#define RBORE           (*mxGetPr(ssGetSFcnParam(S,3)))     /* radius of the boreholes [m] */
+#define COND            (*mxGetPr(ssGetSFcnParam(S,4)))     /* conductivity of the ground [W/(m*K)] */
+#define CAPG            (*mxGetPr(ssGetSFcnParam(S,5)))     /* heat capacity of the ground [J/(m^3*K)] */
+#define TGROUND         (*mxGetPr(ssGetSFcnParam(S,6)))     /* undisturbed ground temperature [C] */
+#define RB              (*mxGetPr(ssGetSFcnParam(S,7)))     /* borehole resistance [m*K/W] */
+#define CBORE           (*mxGetPr(ssGetSFcnParam(S,8)))     /* capacity of the filling [J/(m*K)] */
+#define TSAMPLE         (*mxGetPr(ssGetSFcnParam(S,9)))     /* sample time [s] */
+#define NPARAMS                         10
+#define NPARAMS_NCELLS                  11  /* with optional cells per level */
+#define NCELLS          ((ssGetSFcnParamsCount(S) >= NPARAMS_NCELLS)? \
+                         (int_T)(*mxGetPr(ssGetSFcnParam(S,10))) : 5)
+
+#define NBORE           ((int_T)mxGetM(S_XY))               /* number of boreholes */
+#define XBORE(i)        mxGetPr(S_XY)[i]
+#define YBORE(i)        mxGetPr(S_XY)[NBORE+(i)]
+
+#define TIN             u[0]        /* inlet temperature */
+#define MDOT            u[1]        /* massflow */
+#define PRESS           u[2]        /* pressure */
+#define FLUID_ID        u[3]        /* fluid ID */
+#define PERCENTAGE      u[4]        /* mixture */
+
+#define TFILL           x[0]        /* temperature of the borehole filling */
+#define TOUT            x[1]        /* outlet temperature */
+#define TWALL           x[2]        /* temperature at the borehole wall */
+#define QTOTAL          x[3]        /* heat to the ground */
+
+#define DWORK_QAGG_NO   0           /* aggregated loads per length [W/m] */
+#define DWORK_GRESP_NO  1           /* g(tau_v)/(2*pi*cond) [m*K/W] */
+#define DWORK_DIST_NO   2           /* distances of the borehole pairs (scratch) */
+
+#define HORIZON         (100.0*365.0*86400.0) /* time covered by the load cells [s] */
+#define NQUAD           100         /* intervals of the line source integral */
+#define WIDTH(v)        ldexp(1.0, (int)((v)/ncells)) /* time steps in cell v */
+
+
+/* Function: borefield_ncells =================================================
+ * Abstract:
+ *    Number of aggregation cells to cover HORIZON.
+ */
+static int_T borefield_ncells(SimStruct *S)
+{
+    int_T  ncells = NCELLS;
+    int_T  lev = 0;
+    double steps = 0.0;
+
+    while (steps*TSAMPLE < HORIZON && lev < 40)
+    {
+        steps += ncells*ldexp(1.0, (int)lev);
+        lev++;
+    }
+    return lev*ncells;
+}
+
+
+/* integrated error function ierf(x) = x*erf(x) - (1-exp(-x^2))/sqrt(pi) */
+static double borefield_ierf(double x)
+{
+    return x*erf(x) - (1.0-exp(-x*x))/sqrt(PI);
+}
+
+
+/* Function: borehole_fls =====================================================
+ * Abstract:
+ *    Finite line source response between two boreholes of length h and
+ *    buried depth dbury at distance d (Claesson and Javed, 2011):
+ *      1/(2h) * integral from a to inf of exp(-d^2*s^2)/s^2 * D(s) ds
+ *      D(s) = 2*ierf(h*s) + 2*ierf((2*dbury+h)*s) - ierf(2*(dbury+h)*s)
+ *             - ierf(2*dbury*s)
+ *    with a = 1/sqrt(4*alpha*t). The last three terms are the mirror
+ *    image (negative source above the ground surface), they let the
+ *    response level off at the steady state for long times. The integral
+ *    is calculated with Gauss-Legendre in ln(s).
+ */
+static double borefield_fls(double d, double h, double dbury, double a)
+{
+    static const double xg[4] = {-0.8611363115940526, -0.3399810435848563,
+                                  0.3399810435848563,  0.8611363115940526};
+    static const double wg[4] = { 0.3478548451374538,  0.6521451548625461,
+                                  0.6521451548625461,  0.3478548451374538};
+    double ua = log(a), du, u, s, ds, sum = 0.0;
+    int    k, i;
+
+    du = (log(a + 10.0/d) - ua)/(double)NQUAD;  /* exp(-d^2*s^2) < exp(-100) above */
+    for (k = 0; k < NQUAD; k++)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            u = ua + du*((double)k + 0.5 + 0.5*xg[i]);
+            s = exp(u);
+            ds = 2.0*borefield_ierf(h*s) + 2.0*borefield_ierf((2.0*dbury+h)*s)
+                - borefield_ierf(2.0*(dbury+h)*s) - borefield_ierf(2.0*dbury*s);
+            sum += wg[i]*exp(-d*d*s*s)/s*ds;   /* ds/s^2 * ds/du = 1/s */
+        }
+    }
+    return 0.25*du*sum/h;
+}
+
+
+static int borefield_compare(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+
+/* Function: borefield_gfunction ==============================================
+ * Abstract:
+ *    g-function of the field at the times tau[0..n-1]: mean over all
+ *    boreholes of the line source responses of all boreholes. dist is
+ *    scratch for the NBORE*(NBORE-1)/2 distances.
+ */
+static void borefield_gfunction(SimStruct *S, const double *tau, int_T n,
+    double *g, double *dist)
+{
+    int_T  nb = NBORE, npair = 0, i, j, k;
+    double alpha = COND/CAPG, h = HBORE, dbury = DBURY, rb = RBORE;
+    double a, sum, d, cnt;
+
+    for (i = 0; i < nb; i++)
+    {
+        for (j = i+1; j < nb; j++)
+        {
+            dist[npair++] = max(rb, sqrt(square(XBORE(i)-XBORE(j))
+                + square(YBORE(i)-YBORE(j))));
+        }
+    }
+    qsort(dist, (size_t)npair, sizeof(double), borefield_compare);
+
+    for (k = 0; k < n; k++)
+    {
+        a = 1.0/sqrt(4.0*alpha*tau[k]);
+        sum = (double)nb*borefield_fls(rb, h, dbury, a);    /* each borehole itself */
+        for (i = 0; i < npair; i += (int_T)cnt)
+        {   /* pairs with the same distance */
+            d = dist[i];
+            for (j = i+1; j < npair && dist[j]-d <= 1.0e-9*d; j++)
+                ;
+            cnt = (double)(j-i);
+            sum += 2.0*cnt*borefield_fls(d, h, dbury, a);
+        }
+        g[k] = sum/(double)nb;
+    }
+}
+
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
+{
+    if (NBORE < 1 || mxGetN(S_XY) != 2)
+    {
+        ssSetErrorStatus(S, "Error in borefield: positions of the boreholes must be a matrix with 2 columns (x, y)");
+        return;
+    }
+    if (HBORE <= 0.0 || RBORE <= 0.0 || DBURY < 0.0)
+    {
+        ssSetErrorStatus(S, "Error in borefield: length and radius of the boreholes must be > 0, buried depth >= 0");
+        return;
+    }
+    if (COND <= 0.0 || CAPG <= 0.0 || RB <= 0.0 || CBORE < 0.0)
+    {
+        ssSetErrorStatus(S, "Error in borefield: conductivity, heat capacity and borehole resistance must be > 0");
+        return;
+    }
+    if (TSAMPLE <= 0.0)
+    {
+        ssSetErrorStatus(S, "Error in borefield: sample time must be > 0");
+        return;
+    }
+    if (NCELLS < 1)
+    {
+        ssSetErrorStatus(S, "Error in borefield: cells per aggregation level must be >= 1");
+        return;
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *   Setup sizes of the various vectors.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T ncell;
+
+    if (ssGetSFcnParamsCount(S) == NPARAMS_NCELLS)
+    {
+        ssSetNumSFcnParams(S, NPARAMS_NCELLS);
+    }
+    else
+    {
+        ssSetNumSFcnParams(S, NPARAMS);
+    }
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
+    {
+        mdlCheckParameters(S);
+        if (ssGetErrorStatus(S) != NULL)
+        {
+            return;
+        }
+    }
+    else
+    {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+#endif
+
+    ncell = borefield_ncells(S);
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 4);
+
+    if (!ssSetNumInputPorts(S, 1))
+    {
+        return;
+    }
+    ssSetInputPortWidth(S, 0, 5);
+    ssSetInputPortDirectFeedThrough(S, 0, 0);
+    ssSetInputPortRequiredContiguous(S, 0, true); /*direct input signal access*/
+
+    if (!ssSetNumOutputPorts(S, 1))
+    {
+        return;
+    }
+    ssSetOutputPortWidth(S, 0, 4);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetNumDWork(S, 3);
+    ssSetDWorkWidth(S, DWORK_QAGG_NO, ncell);
+    ssSetDWorkDataType(S, DWORK_QAGG_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_QAGG_NO, "DWORK_QAGG");
+    ssSetDWorkUsageType(S, DWORK_QAGG_NO, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_GRESP_NO, ncell);
+    ssSetDWorkDataType(S, DWORK_GRESP_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_GRESP_NO, "DWORK_GRESP");
+    ssSetDWorkUsageType(S, DWORK_GRESP_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_DIST_NO, max(1, NBORE*(NBORE-1)/2));
+    ssSetDWorkDataType(S, DWORK_DIST_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_DIST_NO, "DWORK_DIST");
+    ssSetDWorkUsageType(S, DWORK_DIST_NO, SS_DWORK_USED_AS_SCRATCH);
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSupportsMultipleExecInstances(S, true);
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Discrete model with the sample time TSAMPLE.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, TSAMPLE);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+
+#define MDL_START
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    g-function of the field at the end of each aggregation cell.
+   */
+static void mdlStart(SimStruct *S)
+{
+    real_T *gresp = (real_T *)ssGetDWork(S, DWORK_GRESP_NO);
+    real_T *dist  = (real_T *)ssGetDWork(S, DWORK_DIST_NO);
+    int_T  ncell  = (int_T)ssGetDWorkWidth(S, DWORK_GRESP_NO);
+    int_T  ncells = NCELLS;
+    double tau = 0.0;
+    int_T  v;
+
+    /* use gresp for the times first */
+    for (v = 0; v < ncell; v++)
+    {
+        tau += WIDTH(v)*TSAMPLE;
+        gresp[v] = tau;
+    }
+    borefield_gfunction(S, gresp, ncell, gresp, dist);
+    for (v = 0; v < ncell; v++)
+    {
+        gresp[v] /= 2.0*PI*COND;
+    }
+}
+#endif /*  MDL_START */
+
+
+
+/* Function: mdlInitializeConditions ========================================
+ * Abstract:
+ *    Undisturbed ground, no load history.
+ */
+#define MDL_INITIALIZE_CONDITIONS
+static void mdlInitializeConditions(SimStruct *S)
+{
+    real_T *x    = ssGetRealDiscStates(S);
+    real_T *qagg = (real_T *)ssGetDWork(S, DWORK_QAGG_NO);
+    int_T  ncell = (int_T)ssGetDWorkWidth(S, DWORK_QAGG_NO);
+    int_T  v;
+
+    TFILL = TGROUND;
+    TOUT = TGROUND;
+    TWALL = TGROUND;
+    QTOTAL = 0.0;
+    for (v = 0; v < ncell; v++)
+    {
+        qagg[v] = 0.0;
+    }
+}
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Results of the last time step.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T *y = ssGetOutputPortRealSignal(S, 0);
+    real_T *x = ssGetRealDiscStates(S);
+
+    y[0] = TOUT;
+    y[1] = TFILL;
+    y[2] = TWALL;
+    y[3] = QTOTAL;
+}
+
+
+
+#define MDL_UPDATE
+/* Function: mdlUpdate ======================================================
+ * Abstract:
+ *    Move the load history to the older cells, then calculate the
+ *    filling temperature and the load of the new time step implicitly:
+ *      Tb = Tground + B + G0*q0
+ *      CBORE/dt*(Tf - Tf_old) = w*eps*(Tin - Tf) - (Tf - Tb)/(RB/2)
+ *    B is the response of the history, G0 the response of one time step.
+ */
+static void mdlUpdate(SimStruct *S, int_T tid)
+{
+    real_T       *x     = ssGetRealDiscStates(S);
+    const real_T *u     = ssGetInputPortRealSignal(S, 0);
+    real_T       *qagg  = (real_T *)ssGetDWork(S, DWORK_QAGG_NO);
+    real_T       *gresp = (real_T *)ssGetDWork(S, DWORK_GRESP_NO);
+    int_T        ncell  = (int_T)ssGetDWorkWidth(S, DWORK_QAGG_NO);
+    int_T        ncells = NCELLS;
+
+    double cp, w, eps, hist, rwall, cdt, q0;
+    int_T  v;
+
+    /* load aggregation: part of each cell moves to the next older cell */
+    for (v = ncell-1; v > 0; v--)
+    {
+        qagg[v] += (qagg[v-1]-qagg[v])/WIDTH(v);
+    }
+    /* response of the history, qagg[0] is the new load */
+    hist = (ncell > 1)? -qagg[1]*gresp[0] : 0.0;
+    for (v = 1; v < ncell; v++)
+    {
+        hist += (qagg[v] - ((v < ncell-1)? qagg[v+1] : 0.0))*gresp[v];
+    }
+
+    /* fluid: effectiveness of the pipe to the filling node */
+    if (MDOT > 0.0)
+    {
+        cp = heat_capacity(FLUID_ID, PERCENTAGE, TIN, PRESS);
+        w = MDOT*cp/((double)NBORE*HBORE);      /* W/(m*K) per borehole length */
+        eps = 1.0 - exp(-2.0/(w*RB));
+    }
+    else
+    {
+        w = 0.0;
+        eps = 0.0;
+    }
+
+    /* filling node: implicit Euler, wall temperature from the history */
+    rwall = 0.5*RB + gresp[0];                  /* filling to undisturbed ground */
+    cdt = CBORE/TSAMPLE;
+    TFILL = (cdt*TFILL + w*eps*TIN + (TGROUND+hist)/rwall)
+        / (cdt + w*eps + 1.0/rwall);
+    q0 = (TFILL - TGROUND - hist)/rwall;
+    qagg[0] = q0;
+
+    TWALL = TGROUND + hist + gresp[0]*q0;
+    TOUT = (MDOT > 0.0)? TIN - eps*(TIN - TFILL) : TFILL;
+    QTOTAL = q0*HBORE*(double)NBORE;
+}
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
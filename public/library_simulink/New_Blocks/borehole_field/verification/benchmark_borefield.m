@@ -0,0 +1,153 @@
+function [r, s] = benchmark_borefield(varargin)
+% benchmark of the s-function borefield
+% 30 years with hourly time steps for a field of 50 boreholes (10 x 5, 
+% distance 6 m, length 150 m). Compares the computing time and the outlet
+% temperature for different numbers of cells per aggregation level 
+% (parameter NCELLS). The case with 20 cells is the reference.
+% The test model is created in memory and closed without saving.
+% Syntax:   [r, s] = benchmark_borefield(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : no display
+%               1 : display the table of results (default)
+% Outputs:  r - struct array with fields: name, parameters, time (s), 
+%               tmax (max. deviation of the outlet temperature from the 
+%               reference in K), tlast (outlet temperature after 30 years)
+%           s - text string with the result table
+%                                                                          
+% Literature:   Claesson, J., Javed, S.: A load-aggregation method to 
+%               calculate extraction temperatures of borehole heat 
+%               exchangers, ASHRAE Transactions 118(1), 2012
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 1;
+elseif nargin == 1
+    show = varargin{1};
+else  
+    error('benchmark_borefield:%s',' too many input arguments')
+end
+
+% ---------- parameters: positions, length, buried depth, radius, --------
+% ---------- ground, borehole resistance and capacity, sample time -------
+[px, py] = meshgrid(0:6:54, 0:6:24);
+field = sprintf('%s, 150, 4, 0.075, 2, 2.2e6, 10, 0.1, 8000, 3600', ...
+    mat2str([px(:) py(:)]));
+% cases: name and parameter NCELLS
+cases = {'20 cells per level (reference)', '20'; ...
+         '2 cells per level',              '2'; ...
+         '5 cells per level (default)',    '5'; ...
+         '10 cells per level',             '10'};
+nrep = 3;               % repetitions, the fastest run is used
+
+% ---------- create the test model ----------------------------------------
+mdl = 'benchmark_borefield_mdl';
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/Tin'], 'Expr', ...
+    '5+20*cos(2*pi*u/31536000)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/mdot'], 'Expr', ...
+    '4*(rem(u,86400) < 43200)');
+add_block('simulink/Sources/Constant', [mdl '/fluid'], 'Value', '[2e5 1 0]');
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '3');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/field'], ...
+    'FunctionName', 'borefield', 'Parameters', field);
+add_block('simulink/Signal Routing/Demux', [mdl '/demux'], 'Outputs', '[1 3]');
+add_block('simulink/Sinks/Terminator', [mdl '/rest']);
+add_block('simulink/Sinks/Out1', [mdl '/Tout']);
+add_line(mdl, 't/1', 'Tin/1');
+add_line(mdl, 't/1', 'mdot/1');
+add_line(mdl, 'Tin/1', 'mux/1');
+add_line(mdl, 'mdot/1', 'mux/2');
+add_line(mdl, 'fluid/1', 'mux/3');
+add_line(mdl, 'mux/1', 'field/1');
+add_line(mdl, 'field/1', 'demux/1');
+add_line(mdl, 'demux/1', 'Tout/1');
+add_line(mdl, 'demux/2', 'rest/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', '3600', ...
+    'StopTime', num2str(30*365*86400), 'SaveFormat', 'Array');
+
+% ---------- simulate all cases -------------------------------------------
+r = struct('name', cases(:,1), 'parameters', '', 'time', 0, ...
+    'tmax', 0, 'tlast', 0);
+for n = 1:size(cases,1)
+    r(n).parameters = [field ', ' cases{n,2}];
+    set_param([mdl '/field'], 'Parameters', r(n).parameters);
+    r(n).time = inf;
+    for m = 1:nrep
+        tic
+        simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+        r(n).time = min(r(n).time, toc);
+    end
+    tout = simOut.get('yout');
+    if n == 1
+        tout0 = tout;   % reference
+    end
+    r(n).tmax = max(abs(tout-tout0));
+    r(n).tlast = tout(end);
+end
+close_system(mdl, 0)    % close system, but do not save it
+
+% ------------ result table -----------------------------------------------
+s = sprintf('%-32s %10s %8s %12s %12s\n', 'case', 'time in s', 'speedup', ...
+    'max. dT in K', 'Tout 30 a');
+for n = 1:length(r)
+    s = [s, sprintf('%-32s %10.3f %8.2f %12.4f %12.3f\n', r(n).name, ...
+        r(n).time, r(1).time/r(n).time, r(n).tmax, r(n).tlast)]; %#ok<AGROW>
+end
+if (show)
+    disp(s)
+end
+
+%% Copyright an file history
+% This file is part of the CARNOT Blockset.
+% 
+% 
+% Copyright (c) 1998-2026, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                         Date
+% 6.1.0     hf      created                                         19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -0,0 +1,246 @@
+function [v, s] = verify_borefield(varargin)
+% verification of the s-function borefield: the temperature at the 
+% borehole wall is compared with the exact superposition of the loads 
+% of the simulation with the finite line source in its original form: 
+% point sources along the borehole and their mirror image above the 
+% ground surface, averaged over the receiving borehole (Eskilson, Zeng 
+% et al.), integrated here with the matlab function integral. It does
+% not use the ierf form of the block (Claesson and Javed), so the 
+% reference checks the g-function of the block and its load aggregation.
+% Three
+% boreholes in a row, one year with a sample time of 6 hours, the inlet 
+% temperature varies over the year, the flow is off every 4th step.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_borefield(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   Claesson, J., Javed, S.: An analytical method to calculate
+%               borehole fluid temperatures for time-scales from minutes 
+%               to decades, ASHRAE Transactions 117(2), 2011
+%               Zeng, H.Y., Diao, N.R., Fang, Z.H.: A finite line-source 
+%               model for boreholes in geothermal heat exchangers, Heat 
+%               Transfer Asian Research 31(7), 2002
+
+% all comments above appear with 'help verify_borefield' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% 6.1.1     hf      reference by the original finite line       19oct2026
+%                   source (Zeng), not the ierf form of the block
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_borefield:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.05;       % max error between superposition and simulation in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_borefield_mdl';
+
+xy = [0 0; 6 0; 12 0];  % position of the boreholes in m
+hbore = 100;            % length of the boreholes in m
+dbury = 2;              % buried depth in m
+rbore = 0.06;           % radius of the boreholes in m
+cond = 2;               % conductivity of the ground in W/(m*K)
+capg = 2.2e6;           % heat capacity of the ground in J/(m^3*K)
+tground = 10;           % undisturbed ground temperature in degC
+tstep = 6*3600;         % sample time in s
+tend = 365*86400;       % simulation time in s
+nbore = size(xy,1);
+field = sprintf('%s, %g, %g, %g, %g, %g, %g, 0.1, 8000, %g', mat2str(xy), ...
+    hbore, dbury, rbore, cond, capg, tground, tstep);
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/Tin'], 'Expr', ...
+    '10+15*sin(2*pi*u/31536000)');
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/mdot'], 'Expr', ...
+    ['0.5*(rem(floor(u/' num2str(tstep) '+0.5),4) < 3)']);
+add_block('simulink/Sources/Constant', [mdl '/fluid'], 'Value', '[2e5 1 0]');
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '3');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/field'], ...
+    'FunctionName', 'borefield', 'Parameters', field);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'Tin/1');
+add_line(mdl, 't/1', 'mdot/1');
+add_line(mdl, 'Tin/1', 'mux/1');
+add_line(mdl, 'mdot/1', 'mux/2');
+add_line(mdl, 'fluid/1', 'mux/3');
+add_line(mdl, 'mux/1', 'field/1');
+add_line(mdl, 'field/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % Tout, Tfill, Twall, heat to the ground
+close_system(mdl, 0)            % close system, but do not save it
+
+idx = 1:7*86400/tstep:size(yy,1);   % weekly values
+t0 = (idx-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% finite line source between two boreholes at distance d (Zeng et al.
+% 2002): the double integral over the depth of the source and of the 
+% receiving borehole depends only on the difference v of the depths 
+% (source) or on their sum (mirror image), so it is one integral with the
+% weight of the length where this difference or sum occurs
+fpt = @(d, v, s4) erfc(sqrt(d^2+v.^2)/s4)./sqrt(d^2+v.^2);
+fls = @(d, s4) (2*integral(@(v) (hbore-v).*fpt(d, v, s4), 0, hbore, ...
+    'RelTol', 1e-8) - integral(@(v) (hbore-abs(v-2*dbury-hbore)) ...
+    .*fpt(d, v, s4), 2*dbury, 2*dbury+2*hbore, 'RelTol', 1e-8, ...
+    'Waypoints', 2*dbury+hbore))/(2*hbore);
+dist = rbore*ones(nbore);
+for i = 1:nbore
+    for j = 1:nbore
+        if i ~= j
+            dist(i,j) = sqrt(sum((xy(i,:)-xy(j,:)).^2));
+        end
+    end
+end
+[d, ~, id] = unique(dist(:));   % each distance only once
+nstep = size(yy,1)-1;
+G = zeros(nstep,1);             % response of one time step load in K/(W/m)
+for n = 1:nstep
+    s4 = sqrt(4*cond/capg*n*tstep);
+    g = arrayfun(@(x) fls(x, s4), d);
+    G(n) = sum(g(id))/nbore/(2*pi*cond);
+end
+% exact superposition of the loads per borehole length of the simulation
+q = yy(:,4)/(nbore*hbore);
+tb = conv(diff(q), G);
+y0 = [tground; tground + tb(1:nstep)];
+y0 = y0(idx);
+
+% ----------------- set reference values initial simulation ---------------
+% result of borefield at creation of the function
+y1 = [10;10.3930774626579;10.937167222618;11.5136516425587; ...
+    12.0962328056315;12.6688192999775;13.2189801107388;13.7361290692891; ...
+    14.2110059063993;14.6354556795259;15.0023428717148;15.305549916021; ...
+    15.5400139196024;15.7017708433699;15.7879924946819;15.7970109788927; ...
+    15.7283290920129;15.5826162742919;15.3616899466164;15.0684821126398; ...
+    14.7069912783557;14.2822200328251;13.8000989937298;13.2673981887841; ...
+    12.6916272697078;12.0809262017465;11.4439482105767;10.7897367835696; ...
+    10.1275984150157;9.46697257986733;8.81730016875605;8.18789139046409; ...
+    7.58779402595988;7.83903016565881;7.51853372070329;7.18885993651491; ...
+    6.8881222258211;6.62972003498729;6.42058363855149;6.26521148085774; ...
+    6.1666470351937;6.12671259728679;6.14616138868903;6.22478212047032; ...
+    6.3614591124795;6.55421082739902;6.80022624263353;6.53040186598703; ...
+    6.90010692470846;7.3705951673466;7.90273785858428;8.4791652037528; ...
+    9.08762984092342];
+
+% current simulation
+y2 = yy(idx,3);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in days';                % x-axis label
+    st = 'Temperature at the borehole wall'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Difference in K';            % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'superposition','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'superposition vs initial simu','superposition vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/86400;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -55,6 +55,15 @@
  *                          #ifndef check
  *                          GRAV renamed to C_GRAVITATION as
  *                          in carlib.h
+ * 6.2.0    hf              level 2 S-function                      19oct2026
+ *                          node coefficients calculated once in
+ *                          mdlStart, fluid temperatures from the
+ *                          exact solution of each pipe segment
+ *                          (energy state removed)
+ *                          bottom boundary is T below storage
+ *                          analytic sparse Jacobian (mdlJacobian)
+ *                          optional parameter TSAMPLE: discrete
+ *                          ADI model
  *
  *
  * Copyright (c) 1998 Solar-Institut Juelich, Germany
@@ -62,8 +71,6 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  *  D E S C R I P T I O N
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * modified from mex file for multi-input, multi-output state-space system.
- *         
  * The storage is devided into ZNODES nodes in z-direction and RNODES nodes
  * in radial direction. The energy-balance for every node is:
  *
@@ -80,6 +87,19 @@
  *  T           temperature                                     K
  *  t           time                                            s
  *
+ * The conductances between the nodes only depend on the parameters and
+ * are calculated once in mdlStart.
+ *
+ * The U-tube runs down and up in the inner column (borehole). The fluid
+ * temperature after each pipe segment is the exact solution of
+ *   mdot*cp*dTfluid = U*dA*(Tnode - Tfluid)
+ * and the node receives mdot*cp*(Tfluid_in - Tfluid_out) of the segment,
+ * so the outlet temperature and the energy to the ground are consistent.
+ * Version 6.1.0 gave the node U*A*(Tfluid_in - Tnode) and recovered the 
+ * outlet temperature from an extra energy state. With equal temperatures 
+ * outside and below the storage both versions agree within 0.03 K (see 
+ * verify_ut_stor2_continuous.m).
+ *
  * Because we need to know the temperature at fixed places inside the
  * storage, a number of measurement points (M_PTS) is placed at
  * equidistant locations inside the storage, no matter how many nodes
@@ -88,29 +108,50 @@
  * The output vector y[] starts with the top-temperature (y[0]) and
  * ends with the bottom-temperature (y[M_PTS]).
  *
+ * Jacobian
+ * The conduction between the nodes gives a matrix with five diagonals,
+ * the fluid couples all nodes of the borehole column with pipe.
+ * mdlJacobian returns this pattern as sparse matrix. The columns of
+ * inlet temperature, massflow and pressure and the rows of the outlet
+ * temperature and the pressure outputs are calculated by difference
+ * quotients, since the fluid properties enter there.
+ *
+ * Discrete mode (optional parameter TSAMPLE > 0)
+ * The node temperatures are discrete states and are advanced with the
+ * alternating direction implicit method of Peaceman-Rachford: the first
+ * half step is implicit in radial direction, the second half step is
+ * implicit in axial direction. Each half step solves one tridiagonal
+ * system per slice or column. The method is unconditionally stable, so
+ * TSAMPLE is only limited by the accuracy needed (e.g. 3600 s). The heat
+ * transfer to the fluid is implicit for the node temperature and explicit
+ * for the fluid temperature.
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Definiton of inputs and outputs 
+ * Definiton of inputs and outputs
  *
  * structure of u (input vector)
  *  index       use                                     units
  *  0           ambient temperature                     degree centigrade
  *  1           heat transfer coefficient from ambient  W/(m^2*K)
  *  2           radiation on top surface                W/m^2
- *  3           inlet temperature heat exchanger        degree centigrade
- *  4           massflow in heat exchanger              kg/s
- *  5           pressure                                Pa
- *  6           fluid ID (defined in CARNOT.h)
- *  7           mixture  (defined in CARNOT.h)
- *  8           diameter at inlet                       m   
- *  9           T outside storage (top layer)           degree centigrade
+ *  3           flow ID
+ *  4           inlet temperature heat exchanger        degree centigrade
+ *  5           massflow in heat exchanger              kg/s
+ *  6           pressure                                Pa
+ *  7           fluid ID (defined in CARNOT.h)
+ *  8           mixture  (defined in CARNOT.h)
+ *  9           diameter at inlet                       m
+ *  10          constant pressure drop                  Pa
+ *  11          linear pressure drop                    Pa/(kg/s)
+ *  12          quadratic pressure drop                 Pa/(kg/s)^2
+ *  13          T outside storage (top layer)           degree centigrade
  *  ...
- *  9+ZNODES-1 T outside storage (bottom layer )        degree centigrade
- *  9+ZNODES   T below storage                          degree centigrade
+ *  13+ZNODES-1 T outside storage (bottom layer )       degree centigrade
+ *  13+ZNODES   T below storage                         degree centigrade
  *
  *
  * structure of y (output vector): all temperatures (T) in degree centigrade
- *  index       use                                         
+ *  index       use
  *  0           T 0.(top) measurement point, central column
  *  1           T 1. measurement point (MP), central column
  *  ...
@@ -140,25 +181,27 @@
  *  4       diameter of pipe                        m
  *  5       diameter of hole                        m
  *  6       depth of hole                           m
- *  7       heat cap. hole filling                  J/(m^3*K) 
+ *  7       heat cap. hole filling                  J/(m^3*K)
  *  8       heat cond. hole filling                 W/(m*K)
- *  9       heat cond. between pipes                W/(m*K)
+ *  9       roughness of pipe                       m
  *  10      initial storage temperature             degree centigrade
- *  11      number of radial nodes 
- *  12      number of axial nodes 
+ *  11      number of radial nodes
+ *  12      number of axial nodes
  *  13      number of temperature measurement points
- *  
+ *  14      sample time (optional, 0 continuous)    s
+ *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * structure of the temperature-array (state-space vector x)
  * 0.slice            = top slice (row)
  * 0.radial_position  = inner column
- *  
- *  temperature(slice, radial_pos, angular_pos)
+ *
+ *  temperature(slice, radial_pos)
  *   = x(RNODES*slice + radial_pos)
  */
 
 
 #define S_FUNCTION_NAME ut_stor2
+#define S_FUNCTION_LEVEL 2
 
 #include "simstruc.h"
 #include "tmwtypes.h"
@@ -168,30 +211,33 @@
 #ifndef PI
     #define PI       3.14159265358979
 #endif
-#ifndef C_GRAVITATION 
+#ifndef C_GRAVITATION
     #define C_GRAVITATION      9.81
 #endif
 
-#define D_STORE     *mxGetPr(ssGetArg(S,0))  /* storage diameter [m] */
-#define H_STORE     *mxGetPr(ssGetArg(S,1))  /* storage depth    [m] */
-#define CAP_EARTH   *mxGetPr(ssGetArg(S,2))  /* heat capacity of earth [J/(kg*K)] */
-#define COND_EARTH  *mxGetPr(ssGetArg(S,3))  /* heat conductivity of earth [W/(m*K)] */
-#define D_PIPE      *mxGetPr(ssGetArg(S,4))  /* diameter of pipe [m] */
-#define D_HOLE      *mxGetPr(ssGetArg(S,5))  /* diameter of hole [m] */
-#define H_HOLE      *mxGetPr(ssGetArg(S,6))  /* depth of hole    [m] */
-#define CAP_HOLE    *mxGetPr(ssGetArg(S,7))  /* heat cap. hole filling [J/(kg*K)] */
-#define COND_HOLE   *mxGetPr(ssGetArg(S,8))  /* heat cond. hole filling  [W/(m*K)] */
-#define ROUGH       *mxGetPr(ssGetArg(S,9))  /* roughness of pipe in m */
-#define T0          *mxGetPr(ssGetArg(S,10)) /* initial storage temperature in [C]	*/
-#define RNODES      *mxGetPr(ssGetArg(S,11)) /* number of radial nodes */
-#define ZNODES      *mxGetPr(ssGetArg(S,12)) /* number of axial nodes */
-#define M_PTS       *mxGetPr(ssGetArg(S,13)) /* number of temperature measurement points */
+#define D_STORE     *mxGetPr(ssGetSFcnParam(S,0))  /* storage diameter [m] */
+#define H_STORE     *mxGetPr(ssGetSFcnParam(S,1))  /* storage depth    [m] */
+#define CAP_EARTH   *mxGetPr(ssGetSFcnParam(S,2))  /* heat capacity of earth [J/(kg*K)] */
+#define COND_EARTH  *mxGetPr(ssGetSFcnParam(S,3))  /* heat conductivity of earth [W/(m*K)] */
+#define D_PIPE      *mxGetPr(ssGetSFcnParam(S,4))  /* diameter of pipe [m] */
+#define D_HOLE      *mxGetPr(ssGetSFcnParam(S,5))  /* diameter of hole [m] */
+#define H_HOLE      *mxGetPr(ssGetSFcnParam(S,6))  /* depth of hole    [m] */
+#define CAP_HOLE    *mxGetPr(ssGetSFcnParam(S,7))  /* heat cap. hole filling [J/(kg*K)] */
+#define COND_HOLE   *mxGetPr(ssGetSFcnParam(S,8))  /* heat cond. hole filling  [W/(m*K)] */
+#define ROUGH       *mxGetPr(ssGetSFcnParam(S,9))  /* roughness of pipe in m */
+#define T0          *mxGetPr(ssGetSFcnParam(S,10)) /* initial storage temperature in [C]	*/
+#define RNODES      *mxGetPr(ssGetSFcnParam(S,11)) /* number of radial nodes */
+#define ZNODES      *mxGetPr(ssGetSFcnParam(S,12)) /* number of axial nodes */
+#define M_PTS       *mxGetPr(ssGetSFcnParam(S,13)) /* number of temperature measurement points */
 #define N_PARAMETER                     14   /* number of parameters */
- 
+#define N_PARAMETER_TSAMPLE             15   /* with optional sample time */
+#define TSAMPLE     ((ssGetSFcnParamsCount(S) >= N_PARAMETER_TSAMPLE)? \
+                     *mxGetPr(ssGetSFcnParam(S,14)) : 0.0) /* sample time [s], 0 continuous */
+
 #define T_TOP       u[0]       /* temperature above earth (ambient or building) */
 #define U_TOP       u[1]       /* heat transfer coefficient from ambient */
 #define I_TOP       u[2]       /* radiation on top surface (by sun) W/m^2 */
-#define FLOW_ID     u[3]       /* inlet temperature heat exchanger */
+#define FLOW_ID     u[3]       /* flow ID */
 #define TFLUIDIN    u[4]       /* inlet temperature heat exchanger */
 #define MDOT        u[5]       /* massflow in heat exchanger */
 #define PRESS       u[6]       /* pressure */
@@ -202,27 +248,36 @@
 #define DPLIN       u[11]      /* linear term in pressure drop */
 #define DPQUA       u[12]      /* quadratic term in pressure drop */
 #define TBOUND      u[nz+13]   /* temperature at slice boundary */
-
-#define TFLUID      RWork      /* fluid temperature in pipe is stored in RWork */
-#define TCOND_H     RWork[2*znodes+1] /* temperature conductivity borehole */
-#define TCOND_E     RWork[2*znodes+2] /* temperature conductivity earth */
-#define OLDTIME     RWork[2*znodes+3]
-#define OLDENERGY   RWork[2*znodes+4]
-
-#define TIME        ssGetT(S)
+#define TBELOW      u[znodes+13] /* temperature below storage */
+#define NINPUTS     (znodes+14)  /* width of the input vector */
 
 #define TP          x[rnodes*nz+nr]     /* node temperature */
-#define TEAST       x[rnodes*nz+nr]     /* T back in angular direction */
-#define TWEST       x[rnodes*nz+nr]     /* T forwards in angular direction */
 #define TUP         x[rnodes*(nz-1)+nr] /* T one slice up */
 #define TDOWN       x[rnodes*(nz+1)+nr] /* T one slice down */
 #define TIN         x[rnodes*nz+nr-1]   /* T one node inwards */
 #define TOUT        x[rnodes*nz+nr+1]   /* T one node outwards */
 #define DTDT        dx[rnodes*nz+nr]    /* dT/dt */
 
-#define ENERGY      x[rnodes*znodes] /* energy input by heat exchanger */
-#define DEDT        dx[rnodes*znodes]
+#define DWORK_COEF_NO       0   /* conductances of the radial columns */
+#define DWORK_TFLUID_NO     1   /* fluid temperatures along the pipe */
+#define DWORK_WORK_NO       2   /* scratch for ADI steps and Jacobian */
+#define DWORK_JROW_NO       3   /* row indices of one Jacobian column */
 
+/* conductances per radial column nr, divided by the heat capacity */
+#define LI(nr)      coef[nr]            /* to the node inwards */
+#define LO(nr)      coef[rnodes+(nr)]   /* to the node outwards */
+#define LU(nr)      coef[2*rnodes+(nr)] /* to the nodes up and down */
+#define KTOP(nr)    coef[3*rnodes+(nr)] /* conduction part of the top surface */
+#define INVCAP(nr)  coef[4*rnodes+(nr)] /* 1/(heat capacity) */
+#define HEATEX      coef[5*rnodes]      /* heat transfer pipe to node in W/K */
+#define VCAP_HOLE   coef[5*rnodes+1]    /* heat capacity of one borehole node */
+#define CTOP(nr)    (U_TOP*invdz*INVCAP(nr)+KTOP(nr)) /* top surface */
+
+/* size of the Jacobian column buffer and the scratch vector */
+#define JAC_BUF(r,z,m)      (3*(m)+(z)+(r)+10)
+#define WORK_SIZE(r,z,m)    ((r)*(z)+4*((r)+(z))+8*(z)+20+JAC_BUF(r,z,m))
+/* number of nonzero elements of the Jacobian (upper limit) */
+#define JAC_NZ(r,z,m,p)     (5*(r)*(z)+(p)*(p)+3*(m)+5*(p)+4*(r)+3*((p)+5)+20+(z))
 
 
 
@@ -240,7 +295,7 @@ double diameterchange(double dpipe, double dinlet)
 	{
         k = square(1.0-square(dpipe/MAX(dinlet, 0.001)));
 	}
-    else 
+    else
 	{
         k = 0.0;
 	}
@@ -248,114 +303,352 @@ double diameterchange(double dpipe, double dinlet)
 }
 
 
+/* number of axial nodes with pipe */
+static int_T ut_stor2_pipenodes(SimStruct *S)
+{
+    double dz = H_STORE/ZNODES;
+    return min((int_T)ZNODES, (int_T)(H_HOLE/dz+0.5));
+}
 
-/*
- * mdlInitializeSizes - initialize the sizes array
- *
- * The sizes array is used by SIMULINK to determine the S-function block's
- * characteristics (number of inputs, outputs, states, etc.).
- */
 
-static void mdlInitializeSizes(SimStruct *S)
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
 {
-    ssSetNumSFcnParams(S, N_PARAMETER);  /* Number of expected parameters */
-    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
-        /* Return if number of expected != number of actual parameters */
+    if (RNODES < 1.0 || ZNODES < 1.0 || M_PTS < 1.0)
+    {
+        ssSetErrorStatus(S, "Error in ground storage: number of nodes and measurement points must be >= 1");
+        return;
+    }
+    if (D_STORE <= 0.0 || H_STORE <= 0.0 || D_PIPE <= 0.0 || D_HOLE <= 0.0
+        || D_HOLE >= D_STORE)
+    {
+        ssSetErrorStatus(S, "Error in ground storage: diameters and depth must be > 0, diameter of hole < storage diameter");
+        return;
+    }
+    if (CAP_EARTH <= 0.0 || COND_EARTH <= 0.0 || CAP_HOLE <= 0.0 || COND_HOLE <= 0.0)
+    {
+        ssSetErrorStatus(S, "Error in ground storage: heat capacities and conductivities must be > 0");
+        return;
+    }
+    if (ut_stor2_pipenodes(S) < 1)
+    {
+        ssSetErrorStatus(S, "Error in ground storage: depth of hole must be at least half the height of an axial node");
+        return;
+    }
+    if (TSAMPLE < 0.0)
+    {
+        ssSetErrorStatus(S, "Error in ground storage: sample time must be >= 0");
         return;
     }
-    ssSetNumContStates(S, (int_T)RNODES*(int_T)ZNODES+1); /* number of continuous states */
-    ssSetNumDiscStates(S, 0);      /* number of discrete states */
-    ssSetNumInputs(S, (int_T)ZNODES+14);  /* number of inputs */
-    ssSetNumOutputs(S, 3*(int_T)M_PTS+5); /* number of outputs */
-    ssSetDirectFeedThrough(S, 1);  /* direct feedthrough flag */
-    ssSetNumSampleTimes(S, 1);     /* number of sample times */
-    ssSetNumRWork(S, 2*(int_T)ZNODES+5);  /* number of real work vector elements */
-    ssSetNumIWork(S, 0);        /* number of integer work vector elements */
-    ssSetNumPWork(S, 0);        /* number of pointer work vector elements */
 }
+#endif /* MDL_CHECK_PARAMETERS */
 
 
-/*
- * mdlInitializeSampleTimes - initialize the sample times array
- *
- * This function is used to specify the sample time(s) for your S-function.
- * If your S-function is continuous, you must specify a sample time of 0.0.
- * Sample times must be registered in ascending order.
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *   Setup sizes of the various vectors.
  */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T rnodes, znodes, mpoints, pipenodes;
 
+    if (ssGetSFcnParamsCount(S) == N_PARAMETER_TSAMPLE)
+    {
+        ssSetNumSFcnParams(S, N_PARAMETER_TSAMPLE);
+    }
+    else
+    {
+        ssSetNumSFcnParams(S, N_PARAMETER);
+    }
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
+    {
+        mdlCheckParameters(S);
+        if (ssGetErrorStatus(S) != NULL)
+        {
+            return;
+        }
+    }
+    else
+    {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+#endif
+
+    rnodes = (int_T)RNODES;
+    znodes = (int_T)ZNODES;
+    mpoints = (int_T)M_PTS;
+    pipenodes = ut_stor2_pipenodes(S);
+
+    ssSetNumContStates(S, (TSAMPLE > 0.0)? 0 : rnodes*znodes);
+    ssSetNumDiscStates(S, (TSAMPLE > 0.0)? rnodes*znodes : 0);
+
+    if (!ssSetNumInputPorts(S, 1))
+    {
+        return;
+    }
+    ssSetInputPortWidth(S, 0, NINPUTS);
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+    ssSetInputPortRequiredContiguous(S, 0, true); /*direct input signal access*/
+
+    if (!ssSetNumOutputPorts(S, 1))
+    {
+        return;
+    }
+    ssSetOutputPortWidth(S, 0, 3*mpoints+5);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetNumDWork(S, 4);
+    ssSetDWorkWidth(S, DWORK_COEF_NO, 5*rnodes+2);
+    ssSetDWorkDataType(S, DWORK_COEF_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_COEF_NO, "DWORK_COEF");
+    ssSetDWorkUsageType(S, DWORK_COEF_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_TFLUID_NO, 2*znodes+1);
+    ssSetDWorkDataType(S, DWORK_TFLUID_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_TFLUID_NO, "DWORK_TFLUID");
+    ssSetDWorkUsageType(S, DWORK_TFLUID_NO, SS_DWORK_USED_AS_SCRATCH);
+    ssSetDWorkWidth(S, DWORK_WORK_NO, WORK_SIZE(rnodes, znodes, mpoints));
+    ssSetDWorkDataType(S, DWORK_WORK_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_WORK_NO, "DWORK_WORK");
+    ssSetDWorkUsageType(S, DWORK_WORK_NO, SS_DWORK_USED_AS_SCRATCH);
+    ssSetDWorkWidth(S, DWORK_JROW_NO, JAC_BUF(rnodes, znodes, mpoints));
+    ssSetDWorkDataType(S, DWORK_JROW_NO, SS_INT32);
+    ssSetDWorkName(S, DWORK_JROW_NO, "DWORK_JROW");
+    ssSetDWorkUsageType(S, DWORK_JROW_NO, SS_DWORK_USED_AS_SCRATCH);
+
+    if (TSAMPLE <= 0.0)
+    {
+        ssSetJacobianNzMax(S, JAC_NZ(rnodes, znodes, mpoints, pipenodes));
+    }
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSupportsMultipleExecInstances(S, true);
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Continuous model or discrete model with the sample time TSAMPLE.
+ */
 static void mdlInitializeSampleTimes(SimStruct *S)
 {
-    ssSetSampleTimeEvent(S, 0, 0.0);
-    ssSetOffsetTimeEvent(S, 0, 0.0);
+    if (TSAMPLE > 0.0)
+    {
+        ssSetSampleTime(S, 0, TSAMPLE);
+    }
+    else
+    {
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    }
+    ssSetOffsetTime(S, 0, 0.0);
 }
 
 
-/*
- * mdlInitializeConditions - initialize the states
- *
- * In this function, you should initialize the continuous and discrete
- * states for your S-function block.  The initial states are placed
- * in the x0 variable.  You can also perIWork any other initialization
- * activities that your S-function may require.
- */
 
-static void mdlInitializeConditions(real_T *x0, SimStruct *S)
+#define MDL_START
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Conductances between the nodes of each radial column. They only
+   *    depend on the parameters.
+   */
+static void mdlStart(SimStruct *S)
+{
+    real_T *coef   = (real_T *)ssGetDWork(S, DWORK_COEF_NO);
+    double dstore  = D_STORE;     /* storage diameter [m] */
+    double hstore  = H_STORE;     /* storage depth    [m] */
+    double cap_e   = CAP_EARTH;   /* heat capacity of earth [J/(kg*K)] */
+    double cond_e  = COND_EARTH;  /* heat conductivity of earth [W/(m*K)] */
+    double cap_h   = CAP_HOLE;    /* heat cap. hole filling [J/(kg*K)] */
+    double cond_h  = COND_HOLE;   /* heat cond. hole filling  [W/(m*K)] */
+    double dpipe   = D_PIPE;      /* pipe diameter */
+    double dhole   = D_HOLE;      /* diameter of hole */
+    int    rnodes  = (int)RNODES; /* numer of radial nodes */
+    int    znodes  = (int)ZNODES; /* numer of axial nodes */
+
+    double dz, dz2, dr, rp, ro, ri, rh, drno, drni, roo, uhx, Apipe;
+    int    nr;
+
+    dz = hstore/(double)znodes;     /* height of one node */
+    dz2 = dz*dz;
+    rh = 0.5*dhole;                 /* radius of hole */
+
+    /* inner column (borehole), boundary at borehole wall */
+    /* radius of temperature point */
+    rp = rh*0.5;
+    /* radius of outer node boundary */
+    ro = rh;
+    /* radius of next outer node boundary */
+    roo = rh + (0.5*dstore-rh)*square(1.0/(double)rnodes);
+    /* radial distance between nodes (outwards) */
+    drno = 0.5*(roo+ro) - rp;
+
+    LI(0) = 0.0;
+    LO(0) = 0.5*(cond_h+cond_e) / (rp*drno*cap_h); /* ro = dr */
+    LU(0) = cond_h/(cap_h*dz2);
+    KTOP(0) = 4.0*cond_h/(dz2*cap_h);
+    INVCAP(0) = 1.0/cap_h;
+
+    /* outer columns */
+    for (nr = 1; nr < rnodes; nr++)
+    {
+        /* radial distance between nodes (inwards) = outwards from last step */
+        drni = drno;
+        /* radius of inner node boundary = outer from last step */
+        ri = ro;
+        /* radius of outer node boundary = next outer from last step */
+        ro = roo;
+        /* radius of next outer node boundary */
+        roo = rh + (0.5*dstore-rh)*square((double)(nr+2)/(double)rnodes);
+        /* radius of temperature point */
+        rp = 0.5*(ri+ro);
+        /* radial distance between boundaries */
+        dr = ro - ri;
+        /* radial distance between nodes (outwards) */
+        drno = 0.5*(roo+ro) - rp;
+
+        LI(nr) = cond_e*ri/(rp*drni*dr*cap_e);
+        LO(nr) = cond_e*ro/(rp*drno*dr*cap_e);
+        LU(nr) = cond_e/(cap_e*dz2);
+        KTOP(nr) = 4.0*cond_e/(dz2*cap_e);
+        INVCAP(nr) = 1.0/cap_e;
+    }
+
+    /* equations from:
+       Wagner: Waermeuebertragung, Vogel-Verlag, 1991 */
+    /* nuss = 4 for laminar flow in pipes */
+    /* heat transfer in W/(m^2*K) = (nuss*co)/dpipe; */
+    uhx = 30; /* approximate value */
+    Apipe = dz*PI*dpipe; /* pipe surface for heat transfer */
+    /* distance from pipe to temperature node is (2*(rh/2)^2)^0.5 */
+    HEATEX = 1.0/(1.0/(uhx*Apipe) + (rh*rh)/(2.0*cond_h));
+    VCAP_HOLE = PI*rh*rh*dz*cap_h;
+}
+#endif /*  MDL_START */
+
+
+
+/* Function: mdlInitializeConditions ========================================
+ * Abstract:
+ *    Initialize the node temperatures with T0.
+ */
+#define MDL_INITIALIZE_CONDITIONS
+static void mdlInitializeConditions(SimStruct *S)
 {
+    real_T *x0 = (TSAMPLE > 0.0)? ssGetRealDiscStates(S) : ssGetContStates(S);
     double t0 = T0;             /* initial temperature */
-    double cap_e = CAP_EARTH;    /* heat capacity of earth [J/(kg*K)] */
-    double cond_e = COND_EARTH;  /* heat conductivity of earth [W/(m*K)] */
-    double cap_h = CAP_HOLE;     /* heat cap. hole filling [J/(kg*K)] */
-    double cond_h = COND_HOLE;   /* heat cond. hole filling  [W/(m*K)] */
-    int    rnodes = (int)RNODES;  /* numer of radial nodes */
-    int    znodes = (int)ZNODES;  /* numer of axial nodes */
+    int    n, nx = (int)RNODES*(int)ZNODES;
 
-    double *RWork = ssGetRWork(S);  /* temperatures in heat exchanger */
-    int    n;
-    
-    for (n = 0; n < rnodes*znodes; n++) 
+    for (n = 0; n < nx; n++)
+    {
         x0[n] = t0;     /* state-vector is initialized with T0 */
+    }
+}
 
-    for (n = 0; n <= 2*znodes; n++)
-        TFLUID[n] = t0; /* Tfluid (RWork) is initialized with T0 */
 
-    TCOND_H = cond_h/cap_h;
-    TCOND_E = cond_e/cap_e;
 
-    OLDTIME = TIME;
-    OLDENERGY = 0.0;
+/* Function: ut_stor2_fluid ===================================================
+ * Abstract:
+ *    Fluid temperatures tf[] along the pipe for the borehole column x0[]
+ *    (temperatures of the inner column, one per slice). The pipe goes
+ *    down and up again. If src is not NULL, the heat from each segment is
+ *    added to src[nz] in K/s. If ksrc is not NULL, ksrc[nz] receives the
+ *    part of the heat that is proportional to the node temperature in 1/s
+ *    (the rest is the fluid part). Returns exp(-U*A/(mdot*cp)) of one
+ *    segment, 0 without massflow.
+ */
+static double ut_stor2_fluid(SimStruct *S, const double *x0, double tin,
+    double mdot, double cp, double *tf, double *src, double *ksrc)
+{
+    real_T *coef = (real_T *)ssGetDWork(S, DWORK_COEF_NO);
+    int    rnodes = (int)RNODES;
+    int    pipenodes = ut_stor2_pipenodes(S);
+    double ex, g;
+    int    i, nz;
+
+    tf[0] = tin;
+    if (mdot <= 0.0)
+    {   /* fluid at rest has the temperature of the nodes */
+        for (i = 0; i <= 2*(pipenodes-1); i++)
+        {
+            tf[i+1] = x0[(i >= pipenodes)? 2*pipenodes-i-1 : i];
+        }
+        tf[2*pipenodes-1] = x0[0];
+        return 0.0;
+    }
+
+    /* following equation is derived from
+        mdot * cp * dThx = U * dA * (Tnode - Thx)
+       replace (Tnode-Thx) by teta, than dThx is -dteta
+        mdot * cp * dteta = - U * dA * teta
+        dteta / teta = - U * dA / (mdot * cp)
+       integrate from inlet position to outlet position
+        ln(teta(out)/teta(in)) = - U * A / (mdot * cp)
+       exponentiate and solve for teta(out)
+         teta(out) = teta(in) * exp(-U*A/(mdot*cp))
+       replace teta by (Tnode - Thx) and solve for
+       Thx(out), the outlet temperature of the
+       heat exchanger in one node
+         Thx(out) = Tnode(out) +
+            ((Thx(in) - Tnode(in)) * exp(-U*A/(mdot*cp))
+       Tnode(in) and Tnode(out) are the same since nodes
+       are fully mixed.
+    */
+    ex = exp(-HEATEX/(mdot*cp));
+    g = mdot*cp/VCAP_HOLE;
+    for (i = 0; i <= 2*(pipenodes-1); i++)
+    {
+        nz = (i >= pipenodes)? 2*pipenodes-i-1 : i;
+        /* new heat exchanger temperature for next node */
+        tf[i+1] = x0[nz] + (tf[i]-x0[nz])*ex;
+        if (src != NULL)
+        {
+            src[nz] += g*(tf[i]-tf[i+1]);
+        }
+        if (ksrc != NULL)
+        {
+            ksrc[nz] += g*(1.0-ex);
+        }
+    } /* for i */
+    return ex;
 }
 
 
-/*
- * mdlOutputs - compute the outputs
- *
- * In this function, you compute the outputs of your S-function
- * block.  The outputs are placed in the y variable.
+/* Function: ut_stor2_hydraulics ==============================================
+ * Abstract:
+ *    Outlet temperature, pressure and pressure drop coefficients (the last
+ *    five outputs) for the fluid temperatures tf[].
  */
-static void mdlOutputs(real_T *y, const real_T *x, const real_T *u, 
-                       SimStruct *S, int_T tid)
+static void ut_stor2_hydraulics(SimStruct *S, const double *tf, const double *u,
+    double *yh)
 {
     double dpipe  = D_PIPE;       /* pipe diameter */
     double h_hole = H_HOLE;       /* depth of hole */
     double hstore = H_STORE;      /* depth of hole */
     double rough  = ROUGH;
-    double time   = TIME;
     double dpcon = 0.0;
     double dplin = 0.0;
     double dpqua = 0.0;
-
-    int    rnodes = (int)RNODES;  /* numer of radial nodes */
     int    znodes = (int)ZNODES;  /* numer of axial nodes */
-    int    mpoints = (int)M_PTS;  /* numer of measurement points */
 
-    double *RWork = ssGetRWork(S);  /* temperatures in heat exchanger */
+    double p, dz, rho, vis, v, re, fh, dirz, k, leq, tmean, flimit, hh;
+    int    nz, pipenodes;
 
-    double p, interval_size, dz, rho, vis, v, re, fh, dirz, k, leq,
-        tmean, flimit, hh;
-    int    i, nz, nr, na, pipenodes;
-    
     dz = hstore/(double)znodes;      /* height of one node */
-    pipenodes = min(znodes, (int)(h_hole/dz+0.5)); /* nodes with pipe */
+    pipenodes = ut_stor2_pipenodes(S); /* nodes with pipe */
     flimit = 0.1*pow(rough/dpipe,0.22); /* lowest value of fh */
 
     /* average pipe temperature and static pressure */
@@ -363,11 +656,11 @@ static void mdlOutputs(real_T *y, const real_T *x, const real_T *u,
     dirz = dz * C_GRAVITATION ; /* positive for downwards flow */
     p = PRESS;
     for (nz = 0; nz < 2*pipenodes; nz++) {
-        tmean += TFLUID[nz];
+        tmean += tf[nz];
         if (FLOW_ID > 10000.0) {
             if (nz == pipenodes)
                 dirz = - dirz; /* negative for upwards flow */
-            hh = dirz * density(FLUID_ID, PERCENTAGE, TFLUID[nz], p);
+            hh = dirz * density(FLUID_ID, PERCENTAGE, tf[nz], p);
             p += hh;
             dpcon -= hh;
         }
@@ -414,9 +707,51 @@ static void mdlOutputs(real_T *y, const real_T *x, const real_T *u,
         }
     } /* end if mdot */
 
+    yh[0] = tf[2*pipenodes-1];
+    yh[1] = p;
+    yh[2] = dpcon + DPCON;
+    yh[3] = dplin + DPLIN;
+    yh[4] = dpqua + DPQUA;
+}
+
+
+/* Function: ut_stor2_column ==================================================
+ * Abstract:
+ *    Copy the inner column (borehole) of the node temperatures to x0[].
+ */
+static void ut_stor2_column(const double *x, int rnodes, int znodes, double *x0)
+{
+    int nz;
+    for (nz = 0; nz < znodes; nz++)
+    {
+        x0[nz] = x[rnodes*nz];
+    }
+}
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Temperatures of the measurement points, outlet temperature and
+ *    pressures.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T       *y  = ssGetOutputPortRealSignal(S, 0);
+    const real_T *u  = ssGetInputPortRealSignal(S, 0);
+    const real_T *x  = (TSAMPLE > 0.0)? ssGetRealDiscStates(S) : ssGetContStates(S);
+    real_T       *tf = (real_T *)ssGetDWork(S, DWORK_TFLUID_NO);
+    real_T       *x0 = (real_T *)ssGetDWork(S, DWORK_WORK_NO);
+
+    int    rnodes = (int)RNODES;  /* numer of radial nodes */
+    int    znodes = (int)ZNODES;  /* numer of axial nodes */
+    int    mpoints = (int)M_PTS;  /* numer of measurement points */
+
+    double interval_size, cp;
+    int    i, nz, nr;
+
     /* set temperature of every measurement-point from bottom (0) to top */
     interval_size = (double)znodes/(double)mpoints; /* nodes in measurement point */
-    na = 0;
     for(i = 0; i < mpoints; i++) {
         nz = (int)((double)i*interval_size+0.5);
         nr = 0;
@@ -428,214 +763,471 @@ static void mdlOutputs(real_T *y, const real_T *x, const real_T *u,
     }
 
     /* temperatures and pressures */
-    if (MDOT > 0.0 && time > OLDTIME){
-        TFLUID[2*pipenodes-1] = TFLUIDIN-(ENERGY-OLDENERGY)/(time-OLDTIME);
-        OLDENERGY = ENERGY;
-    }
-    y[3*mpoints]   = TFLUID[2*pipenodes-1];
-    y[3*mpoints+1] = p;
-    y[3*mpoints+2] = dpcon + DPCON;
-    y[3*mpoints+3] = dplin + DPLIN;
-    y[3*mpoints+4] = dpqua + DPQUA;
-
-    OLDTIME = time;
+    ut_stor2_column(x, rnodes, znodes, x0);
+    cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+    ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, NULL, NULL);
+    ut_stor2_hydraulics(S, tf, u, &y[3*mpoints]);
 } /* end mdlOutputs */
 
 
-/*
- * mdlUpdate - perIWork action at major integration time step
- *
- * This function is called once for every major integration time step.
- * Discrete states are typically updated here, but this function is useful
- * for perIWorking any tasks that should only take place once per integration
- * step.
- */
-
-static void mdlUpdate(real_T *x, const real_T *u, SimStruct *S, int_T tid)
-{
-}    /* nothing to do here */
-
 
-/*
- * mdlDerivatives - compute the derivatives
- *
- * In this function, you compute the S-function block's derivatives.
- * The derivatives are placed in the dx variable.
- *
+/* Function: ut_stor2_conduction ==============================================
+ * Abstract:
+ *    dT/dt of all nodes by conduction and the boundaries.
  */
-
-static void mdlDerivatives(real_T *dx, const real_T *x, const real_T *u, 
-                           SimStruct *S, int_T tid)
+static void ut_stor2_conduction(SimStruct *S, const double *x, const double *u,
+    double *dx)
 {
-    /* get model parameters with ssGetParam(S), see define at top of file */
-    double dstore = D_STORE;     /* storage diameter [m] */
-    double hstore = H_STORE;     /* storage depth    [m] */
-    double cap_e = CAP_EARTH;    /* heat capacity of earth [J/(kg*K)] */
-    double cond_e = COND_EARTH;  /* heat conductivity of earth [W/(m*K)] */
-    double cap_h = CAP_HOLE;     /* heat cap. hole filling [J/(kg*K)] */
-    double cond_h = COND_HOLE;   /* heat cond. hole filling  [W/(m*K)] */
-    double dpipe  = D_PIPE;      /* pipe diameter */
-    double h_hole = H_HOLE;      /* depth of hole */
-    double dhole = D_HOLE;       /* diameter of hole */
+    real_T *coef = (real_T *)ssGetDWork(S, DWORK_COEF_NO);
     int    rnodes = (int)RNODES; /* numer of radial nodes */
     int    znodes = (int)ZNODES; /* numer of axial nodes */
+    double invdz = (double)znodes/H_STORE;
+    int    nz, nr;
 
-    double *RWork = ssGetRWork(S);  /* temperatures in heat exchanger */
+    for (nz = 0; nz < znodes; nz++)
+    {
+        for (nr = 0; nr < rnodes; nr++)
+        {
+            DTDT = (nr > 0)? LI(nr)*(TIN-TP) : 0.0;
+            if (nr < rnodes-1)
+                DTDT += LO(nr)*(TOUT-TP);
+            else
+                DTDT += LO(nr)*(TBOUND-TP);
 
-    double lu, lo, li, dz, dr, rp, ro, ri, rh, cp, heatex;
-    double drno, drni, roo, uhx, Apipe, dz2;
-    int    i, nz, nr, na, pipenodes;
+            if (nz > 0)
+                DTDT += LU(nr)*(TUP-TP);
+            else
+                DTDT += CTOP(nr)*(T_TOP-TP) + I_TOP*INVCAP(nr);
 
-    na = 0;
-    dz = hstore/(double)znodes;     /* height of one node */
-    dz2 = dz*dz;
-    rh = 0.5*dhole;                 /* radius of hole */
-    pipenodes = min(znodes, (int)(h_hole/dz+0.5)); /* nodes with pipe */
-    Apipe = dz*PI*dpipe; /* pipe surface for heat transfer */
+            if (nz < znodes-1)
+                DTDT += LU(nr)*(TDOWN-TP);
+            else
+                DTDT += LU(nr)*(TBELOW-TP);
+        } /* end for nr */
+    } /* end for nz */
+}
 
-    TFLUID[0] = TFLUIDIN;
-    cp = heat_capacity (FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
 
-    /* START OF MAIN CALCULATION LOOP */
+#define MDL_DERIVATIVES
+/* Function: mdlDerivatives =================================================
+ * Abstract:
+ *    Conduction between the nodes and heat from the fluid to the inner
+ *    column.
+ */
+static void mdlDerivatives(SimStruct *S)
+{
+    real_T       *dx = ssGetdX(S);
+    const real_T *x  = ssGetContStates(S);
+    const real_T *u  = ssGetInputPortRealSignal(S, 0);
+    real_T       *tf = (real_T *)ssGetDWork(S, DWORK_TFLUID_NO);
+    real_T       *x0 = (real_T *)ssGetDWork(S, DWORK_WORK_NO);
+    real_T       *src;
+    int    rnodes = (int)RNODES; /* numer of radial nodes */
+    int    znodes = (int)ZNODES; /* numer of axial nodes */
+    double cp;
+    int    nz;
 
-    /* inner column (borehole), boundary at borehole wall */
-    /* radius of temperature point */
-    rp = rh*0.5;
-    /* radius of outer node boundary */
-    ro = rh;
-    /* radius of next outer node boundary */
-    roo = rh + (0.5*dstore-rh)*square(1.0/(double)rnodes);
-    /* radial distance between nodes (outwards) */
-    drno = 0.5*(roo+ro) - rp;
+    if (TSAMPLE > 0.0)          /* discrete model */
+    {
+        return;
+    }
 
-    lu = TCOND_H/dz2;
-    lo = 0.5*(cond_h+cond_e) / (rp*drno*cap_h); /* ro = dr */
+    src = x0 + znodes;
+    ut_stor2_conduction(S, x, u, dx);
 
-    nr = 0; 
-    for (nz = 0; nz < znodes; nz++) 
+    /* convective heat transfer */
+    ut_stor2_column(x, rnodes, znodes, x0);
+    for (nz = 0; nz < znodes; nz++)
     {
-        DTDT = lo*(TOUT-TP);
+        src[nz] = 0.0;
+    }
+    cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+    ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, src, NULL);
+    for (nz = 0; nz < znodes; nz++)
+    {
+        dx[rnodes*nz] += src[nz];
+    }
+} /* mdlDerivatives()... */
 
-        if (nz > 0)
-            DTDT += lu*(TUP-TP);
-        else
-            DTDT += ((U_TOP/dz+4.0*cond_h/dz2)*
-                (T_TOP-TP)+I_TOP)/cap_h;
 
-        if (nz < znodes-1)
-            DTDT += lu*(TDOWN-TP);
-        else
-            DTDT += lu*(TBOUND-TP);
-    } /* end for nr */
 
-    /* outer columns */
-    lu = TCOND_E/dz2;
-    for (nr = 1; nr < rnodes; nr++) 
+/* Function: ut_stor2_jaccolumn ===============================================
+ * Abstract:
+ *    Sort the n entries of one Jacobian column by row, add entries of the
+ *    same row and store them in ir, pr starting at nz. Returns the new nz.
+ */
+static int_T ut_stor2_jaccolumn(int32_T *row, real_T *val, int_T n,
+    int_T *ir, real_T *pr, int_T nz)
+{
+    int_T   i, j, r;
+    real_T  v;
+
+    for (i = 1; i < n; i++)     /* insertion sort, columns are short */
     {
-        /* radial distance between nodes (inwards) = outwards from last step */
-        drni = drno;
-        /* radius of inner node boundary = outer from last step */
-        ri = ro;
-        /* radius of outer node boundary = next outer from last step */
-        ro = roo;
-        /* radius of next outer node boundary */
-        roo = rh + (0.5*dstore-rh)*square((double)(nr+2)/(double)rnodes);
-        /* radius of temperature point */
-        rp = 0.5*(ri+ro);
-        /* radial distance between boundaries */
-        dr = ro - ri;
-        /* radial distance between nodes (outwards) */
-        drno = 0.5*(roo+ro) - rp;
+        r = row[i];
+        v = val[i];
+        for (j = i; j > 0 && row[j-1] > r; j--)
+        {
+            row[j] = row[j-1];
+            val[j] = val[j-1];
+        }
+        row[j] = r;
+        val[j] = v;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (i > 0 && row[i] == row[i-1])
+        {
+            pr[nz-1] += val[i];
+        }
+        else
+        {
+            ir[nz] = row[i];
+            pr[nz++] = val[i];
+        }
+    }
+    return nz;
+}
 
-        lo = TCOND_E*ro/(rp*drno*dr);
-        li = TCOND_E*ri/(rp*drni*dr);
 
-        for (nz = 0; nz < znodes; nz++) 
+/* step of the difference quotients, away from zero */
+#define FD_STEP(v)  (((v) > 0.0)? 1.0e-7*max(1.0, (v)) : -1.0e-7*max(1.0, -(v)))
+/* add an entry to the column buffer */
+#define JADD(r,v)   {row[n] = (int32_T)(r); val[n++] = (v);}
+
+
+#define MDL_JACOBIAN  /* Change to #undef to remove function */
+#if defined(MDL_JACOBIAN)
+  /* Function: mdlJacobian ====================================================
+   * Abstract:
+   *    Jacobian [A B; C D] as sparse matrix in compressed column format,
+   *    (nx+ny) rows and (nx+nu) columns. The conduction part of A and B
+   *    and the temperature outputs are analytic, the fluid part of A is
+   *    the derivative of the segment solutions. The columns of inlet
+   *    temperature, massflow and pressure and the rows of outlet
+   *    temperature and pressures are difference quotients. The columns
+   *    of flow ID, fluid ID and mixture are empty. The pattern is the
+   *    same in each call.
+   */
+  static void mdlJacobian(SimStruct *S)
+  {
+    real_T  *pr   = ssGetJacobianPr(S);
+    int_T   *ir   = ssGetJacobianIr(S);
+    int_T   *jc   = ssGetJacobianJc(S);
+    real_T  *x    = ssGetContStates(S);
+    const real_T *uin = ssGetInputPortRealSignal(S, 0);
+    real_T  *coef = (real_T *)ssGetDWork(S, DWORK_COEF_NO);
+    real_T  *tf   = (real_T *)ssGetDWork(S, DWORK_TFLUID_NO);
+    real_T  *work = (real_T *)ssGetDWork(S, DWORK_WORK_NO);
+    int32_T *row  = (int32_T *)ssGetDWork(S, DWORK_JROW_NO);
+
+    int    rnodes = (int)RNODES;  /* numer of radial nodes */
+    int    znodes = (int)ZNODES;  /* numer of axial nodes */
+    int    mpoints = (int)M_PTS;  /* numer of measurement points */
+    int    pipenodes = ut_stor2_pipenodes(S);
+    int    nx = rnodes*znodes;
+    int    nr1 = (int)(0.7071*rnodes);
+    double invdz = (double)znodes/H_STORE;
+    double interval_size = (double)znodes/(double)mpoints;
+
+    real_T *u, *x0, *src0, *src1, *dsrc, *dtf, *yh0, *yh1, *val;
+    double cp, ex, g, h, diag;
+    int_T  i, k, n, nz, nr, col, nnz, seg;
+    /* inputs with difference quotients for the fluid and hydraulic rows */
+    static const int_T fdin[] = {4, 5, 6, 9, 10, 11, 12};
+
+    u    = work;                    /* copy of the inputs, NINPUTS */
+    x0   = u + NINPUTS;             /* inner column, znodes */
+    src0 = x0 + znodes;             /* heat from the fluid, znodes */
+    src1 = src0 + znodes;           /* perturbed heat from the fluid */
+    dsrc = src1 + znodes;           /* derivative of the heat */
+    dtf  = dsrc + znodes;           /* derivative of tf, 2*znodes+1 */
+    yh0  = dtf + 2*znodes+1;        /* hydraulic outputs, 5 */
+    yh1  = yh0 + 5;                 /* perturbed hydraulic outputs, 5 */
+    val  = yh1 + 5;                 /* values of one column */
+
+    for (i = 0; i < NINPUTS; i++)
+    {
+        u[i] = uin[i];
+    }
+    ut_stor2_column(x, rnodes, znodes, x0);
+    for (nz = 0; nz < znodes; nz++)
+    {
+        src0[nz] = 0.0;
+    }
+    cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+    ex = ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, src0, NULL);
+    g = (MDOT > 0.0)? MDOT*cp/VCAP_HOLE : 0.0;
+    ut_stor2_hydraulics(S, tf, u, yh0);
+
+    nnz = 0;
+    col = 0;
+    /* columns of the states */
+    for (nz = 0; nz < znodes; nz++)
+    {
+        for (nr = 0; nr < rnodes; nr++)
         {
-            DTDT = li*(TIN-TP);
+            jc[col++] = nnz;
+            n = 0;
+            /* conduction */
+            diag = -(LI(nr) + LO(nr) + LU(nr)) - ((nz > 0)? LU(nr) : CTOP(nr));
+            JADD(rnodes*nz+nr, diag);
+            if (nr > 0)
+                JADD(rnodes*nz+nr-1, LO(nr-1));
             if (nr < rnodes-1)
-                DTDT += lo*(TOUT-TP);
-            else
-                DTDT += lo*(TBOUND-TP);
-
+                JADD(rnodes*nz+nr+1, LI(nr+1));
             if (nz > 0)
-                DTDT += lu*(TUP-TP);
-            else
-                DTDT += ((U_TOP/dz+4.0*cond_e/dz2)*
-                    (T_TOP-TP)+I_TOP)/cap_e;
-
+                JADD(rnodes*(nz-1)+nr, LU(nr));
             if (nz < znodes-1)
-                DTDT += lu*(TDOWN-TP);
-            else
-                DTDT += lu*(TBOUND-TP);
-        } /* end for nz */
-    } /* end for nr */
+                JADD(rnodes*(nz+1)+nr, LU(nr));
+
+            /* temperatures of the measurement points */
+            for (i = 0; i < mpoints; i++)
+            {
+                if ((int)((double)i*interval_size+0.5) == nz)
+                {
+                    if (nr == 0)
+                        JADD(nx+i, 1.0);
+                    if (nr == nr1)
+                        JADD(nx+i+mpoints, 1.0);
+                    if (nr == rnodes-1)
+                        JADD(nx+i+2*mpoints, 1.0);
+                }
+            }
+
+            if (nr == 0 && nz < pipenodes)
+            {   /* fluid: d(tf)/d(x0[nz]) along the pipe */
+                for (k = 0; k < znodes; k++)
+                {
+                    dsrc[k] = 0.0;
+                }
+                dtf[0] = 0.0;
+                for (i = 0; i <= 2*(pipenodes-1); i++)
+                {
+                    seg = (i >= pipenodes)? 2*pipenodes-i-1 : i;
+                    dtf[i+1] = ex*dtf[i] + ((seg == nz)? 1.0-ex : 0.0);
+                    dsrc[seg] += g*(dtf[i]-dtf[i+1]);
+                }
+                for (k = 0; k < pipenodes; k++)
+                {
+                    JADD(rnodes*k, dsrc[k]);
+                }
+
+                /* outlet temperature and pressures */
+                h = FD_STEP(x0[nz]);
+                x0[nz] += h;
+                ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, NULL, NULL);
+                ut_stor2_hydraulics(S, tf, u, yh1);
+                x0[nz] -= h;
+                for (k = 0; k < 5; k++)
+                {
+                    JADD(nx+3*mpoints+k, (yh1[k]-yh0[k])/h);
+                }
+            }
+            nnz = ut_stor2_jaccolumn(row, val, n, ir, pr, nnz);
+        }
+    }
 
-    /* convective heat transfer */
-    DEDT = 0.0; /* energy balance */
-    nr = 0;
-    if (MDOT == 0.0) {
-        nz = 0;
-        TFLUID[2*pipenodes-1] = TP;
-    } else {
-        for (i = 0; i <= 2*(pipenodes-1); i++) 
+    /* columns of the inputs */
+    for (i = 0; i < NINPUTS; i++)
+    {
+        jc[col++] = nnz;
+        n = 0;
+        if (i == 0)                 /* T_TOP */
         {
-            nz = (i >= pipenodes)? 2*pipenodes-i-1 : i;
-        
-            /* equations from: 
-               Wagner: Waermeuebertragung, Vogel-Verlag, 1991 */
-            /* nuss = 4 for laminar flow in pipes */
-            /* heat transfer in W/(m^2*K) = (nuss*co)/dpipe; */
-            uhx = 30; /* approximate value */
-        
-            /* following equation is derived from
-                mdot * cp * dThx = U * dA * (Tnode - Thx)
-               replace (Tnode-Thx) by teta, than dThx is -dteta
-                mdot * cp * dteta = - U * dA * teta
-                dteta / teta = - U * dA / (mdot * cp)
-               integrate from inlet position to outlet position
-                ln(teta(out)/teta(in)) = - U * A / (mdot * cp)
-               exponentiate and solve for teta(out)
-                 teta(out) = teta(in) * exp(-U*A/(mdot*cp))
-               replace teta by (Tnode - Thx) and solve for 
-               Thx(out), the outlet temperature of the 
-               heat exchanger in one node
-                 Thx(out) = Tnode(out) +
-                    ((Thx(in) - Tnode(in)) * exp(-U*A/(mdot*cp))
-               Tnode(in) and Tnode(out) are the same since nodes
-               are fully mixed. Remember that in the following
-               equation Tnode must refer to one node upwars in
-               flowdirection.
-            */
-        
-            /* distance from pipe to temperature node is (2*(rh/2)^2)^0.5 */
-            heatex = 1.0/(1.0/(uhx*Apipe) + (rh*rh)/(2.0*cond_h));
-            DTDT += heatex*(TFLUID[i]-TP)/(PI*rh*rh*dz*cap_h);
-            DEDT += heatex*(TFLUID[i]-TP)/(MDOT*cp);
-        
-            /* new heat exchanger temperature for next node */
-            TFLUID[i+1] = TP + (TFLUID[i]-TP)*exp(-heatex/(MDOT*cp));
-        
-        } /* for i */
-    } /* end if mdot */
-} /* mdlDerivatives()... */
+            for (nr = 0; nr < rnodes; nr++)
+                JADD(nr, CTOP(nr));
+        }
+        else if (i == 1)            /* U_TOP */
+        {
+            for (nr = 0; nr < rnodes; nr++)
+                JADD(nr, invdz*INVCAP(nr)*(T_TOP-x[nr]));
+        }
+        else if (i == 2)            /* I_TOP */
+        {
+            for (nr = 0; nr < rnodes; nr++)
+                JADD(nr, INVCAP(nr));
+        }
+        else if (i >= 13 && i < 13+znodes)  /* T outside slice */
+        {
+            JADD(rnodes*(i-13)+rnodes-1, LO(rnodes-1));
+        }
+        else if (i == 13+znodes)    /* T below storage */
+        {
+            for (nr = 0; nr < rnodes; nr++)
+                JADD(rnodes*(znodes-1)+nr, LU(nr));
+        }
+        else
+        {
+            for (k = 0; k < (int_T)(sizeof(fdin)/sizeof(fdin[0])); k++)
+            {
+                if (fdin[k] == i)
+                {
+                    h = FD_STEP(u[i]);
+                    u[i] += h;
+                    if (i <= 6)     /* heat to the ground changes */
+                    {
+                        for (nz = 0; nz < znodes; nz++)
+                        {
+                            src1[nz] = 0.0;
+                        }
+                        cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+                        ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, src1, NULL);
+                        for (nz = 0; nz < pipenodes; nz++)
+                        {
+                            JADD(rnodes*nz, (src1[nz]-src0[nz])/h);
+                        }
+                    }
+                    else
+                    {
+                        cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+                        ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, NULL, NULL);
+                    }
+                    ut_stor2_hydraulics(S, tf, u, yh1);
+                    for (nz = 0; nz < 5; nz++)
+                    {
+                        JADD(nx+3*mpoints+nz, (yh1[nz]-yh0[nz])/h);
+                    }
+                    u[i] -= h;
+                }
+            }
+        }
+        nnz = ut_stor2_jaccolumn(row, val, n, ir, pr, nnz);
+    }
+    jc[col] = nnz;
+  }
+#endif /* MDL_JACOBIAN */
 
 
 
-/*
- * mdlTerminate - called when the simulation is terminated.
- *
- * In this function, you should perIWork any actions that are necessary
- * at the termination of a simulation.  For example, if memory was allocated
- * in mdlInitializeConditions, this is the place to free it.
+#define MDL_UPDATE
+/* Function: mdlUpdate ======================================================
+ * Abstract:
+ *    discrete model: one ADI step (Peaceman-Rachford) of TSAMPLE
+ *      (1 - h*Ar)*T* = (1 + h*Az)*T(k) + h*b
+ *      (1 - h*Az)*T(k+1) = (1 + h*Ar)*T* + h*b
+ *    with h = TSAMPLE/2, Ar the radial and Az the axial conduction. The
+ *    heat transfer to the fluid is split into a part proportional to the
+ *    node temperature (half in Ar, half in Az) and the fluid part in b.
  */
+static void mdlUpdate(SimStruct *S, int_T tid)
+{
+    real_T       *x    = ssGetRealDiscStates(S);
+    const real_T *u    = ssGetInputPortRealSignal(S, 0);
+    real_T       *coef = (real_T *)ssGetDWork(S, DWORK_COEF_NO);
+    real_T       *tf   = (real_T *)ssGetDWork(S, DWORK_TFLUID_NO);
+    real_T       *work = (real_T *)ssGetDWork(S, DWORK_WORK_NO);
+
+    int    rnodes = (int)RNODES;  /* numer of radial nodes */
+    int    znodes = (int)ZNODES;  /* numer of axial nodes */
+    double invdz = (double)znodes/H_STORE;
+    double h = 0.5*TSAMPLE;
+
+    real_T *ts, *x0, *kf, *q, *a, *b, *c, *d, *sol;
+    double cp, az, ar, bsrc;
+    int    nz, nr, nmax = max(rnodes, znodes);
+
+    if (TSAMPLE <= 0.0)         /* continuous model */
+    {
+        return;
+    }
+
+    ts  = work;                 /* temperatures after the first half step */
+    x0  = ts + rnodes*znodes;   /* inner column */
+    kf  = x0 + znodes;          /* fluid coupling proportional to the node */
+    q   = kf + znodes;          /* heat from the fluid */
+    a   = q + znodes;           /* tridiagonal system */
+    b   = a + nmax;
+    c   = b + nmax;
+    d   = c + nmax;
+    sol = d + nmax;
+
+    /* fluid coupling from the temperatures at the beginning of the step */
+    ut_stor2_column(x, rnodes, znodes, x0);
+    for (nz = 0; nz < znodes; nz++)
+    {
+        q[nz] = 0.0;
+        kf[nz] = 0.0;
+    }
+    cp = heat_capacity(FLUID_ID, PERCENTAGE, TFLUIDIN, PRESS);
+    ut_stor2_fluid(S, x0, TFLUIDIN, MDOT, cp, tf, q, kf);
+    for (nz = 0; nz < znodes; nz++)
+    {   /* q = kf*(Tfluid - Tnode): keep the fluid part */
+        q[nz] += kf[nz]*x0[nz];
+    }
+
+    /* first half step: implicit in radial direction, one system per slice */
+    for (nz = 0; nz < znodes; nz++)
+    {
+        for (nr = 0; nr < rnodes; nr++)
+        {
+            /* explicit axial part */
+            az = (nz > 0)? LU(nr)*(TUP-TP) : CTOP(nr)*(T_TOP-TP) + I_TOP*INVCAP(nr);
+            az += (nz < znodes-1)? LU(nr)*(TDOWN-TP) : LU(nr)*(TBELOW-TP);
+            bsrc = (nr == rnodes-1)? LO(nr)*TBOUND : 0.0;
+            if (nr == 0)
+            {
+                az += q[nz] - 0.5*kf[nz]*TP;
+            }
+            a[nr] = -h*LI(nr);
+            c[nr] = -h*LO(nr);
+            b[nr] = 1.0 + h*(LI(nr) + LO(nr) + ((nr == 0)? 0.5*kf[nz] : 0.0));
+            d[nr] = TP + h*(az + bsrc);
+        }
+        solve_tridiagonal(sol, a, b, c, d, rnodes);
+        for (nr = 0; nr < rnodes; nr++)
+        {
+            ts[rnodes*nz+nr] = sol[nr];
+        }
+    }
+
+    /* second half step: implicit in axial direction, one system per column */
+    for (nr = 0; nr < rnodes; nr++)
+    {
+        for (nz = 0; nz < znodes; nz++)
+        {
+            /* explicit radial part */
+            ar = (nr > 0)? LI(nr)*(ts[rnodes*nz+nr-1]-ts[rnodes*nz+nr]) : 0.0;
+            ar += (nr < rnodes-1)? LO(nr)*(ts[rnodes*nz+nr+1]-ts[rnodes*nz+nr])
+                : LO(nr)*(TBOUND-ts[rnodes*nz+nr]);
+            bsrc = (nz == 0)? CTOP(nr)*T_TOP + I_TOP*INVCAP(nr) : 0.0;
+            if (nz == znodes-1)
+            {
+                bsrc += LU(nr)*TBELOW;
+            }
+            if (nr == 0)
+            {
+                ar += q[nz] - 0.5*kf[nz]*ts[rnodes*nz];
+            }
+            a[nz] = -h*LU(nr);
+            c[nz] = -h*LU(nr);
+            b[nz] = 1.0 + h*(LU(nr) + ((nz > 0)? LU(nr) : CTOP(nr))
+                + ((nr == 0)? 0.5*kf[nz] : 0.0));
+            d[nz] = ts[rnodes*nz+nr] + h*(ar + bsrc);
+        }
+        a[0] = 0.0;
+        c[znodes-1] = 0.0;
+        solve_tridiagonal(sol, a, b, c, d, znodes);
+        for (nz = 0; nz < znodes; nz++)
+        {
+            TP = sol[nz];
+        }
+    }
+}
+
 
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
 static void mdlTerminate(SimStruct *S)
-{}       /* NOP */
+{
+}
+
 
 #ifdef	MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
 #include "simulink.c"      /* MEX-file interface mechanism */
 #else
 #include "cg_sfun.h"       /* Code generation registration function */
 #endif
-
@@ -0,0 +1,226 @@
+function [v, s] = verify_ut_stor2(varargin)
+% verification of the discrete ADI mode of the s-function ut_stor2 
+% (parameter TSAMPLE) with the continuous model: the borehole is loaded 
+% with 0.3 kg/s of water at 35 degC for 12 hours every day, the 
+% continuous model with the same hourly inputs is solved with ode15s 
+% and a tight tolerance and is the reference. Compared are the outlet 
+% temperature and three measurement points in the central column.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_ut_stor2(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_ut_stor2' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_ut_stor2:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.3;        % max error between ADI and continuous model in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_ut_stor2_mdl';
+
+% storage: diameter 20 m, depth 30 m, earth 2.4e6 J/(m^3*K) and 
+% 2 W/(m*K), pipe 32 mm, hole 0.15 m and 28 m deep, filling 2e6 J/(m^3*K)
+% and 1.5 W/(m*K), roughness 1e-5 m, 10 degC, 8 radial and 10 axial 
+% nodes, 5 measurement points
+znodes = 10;
+mpts = 5;
+stor = sprintf('20, 30, 2.4e6, 2.0, 0.032, 0.15, 28, 2.0e6, 1.5, 1e-5, 10, 8, %d, %d', ...
+    znodes, mpts);
+tstep = 3600;           % sample time of the ADI model in s
+tend = 10*86400;        % simulation time in s
+tout = 6*3600;          % results every 6 hours
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+% inputs: Tamb, U to ambient, radiation, flow ID, Tinlet
+add_block('simulink/Sources/Constant', [mdl '/u1'], 'Value', '[10 8 0 20001 35]');
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/mdot'], 'Expr', ...
+    '0.3*(rem(u,86400) < 43200)');
+add_block('simulink/Discrete/Zero-Order Hold', [mdl '/zoh'], ...
+    'SampleTime', num2str(tstep));
+% pressure, fluid ID, mixture, diameter, pressure drop coefficients, 
+% T outside the storage and below the storage
+add_block('simulink/Sources/Constant', [mdl '/u2'], 'Value', ...
+    mat2str([2e5 1 0 0.02 100 10 1 10*ones(1,znodes+1)]));
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '3');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/continuous'], ...
+    'FunctionName', 'ut_stor2', 'Parameters', stor);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/adi'], ...
+    'FunctionName', 'ut_stor2', 'Parameters', [stor ', ' num2str(tstep)]);
+add_block('simulink/Signal Routing/Mux', [mdl '/out'], 'Inputs', '2');
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'mdot/1');
+add_line(mdl, 'mdot/1', 'zoh/1');
+add_line(mdl, 'u1/1', 'mux/1');
+add_line(mdl, 'zoh/1', 'mux/2');
+add_line(mdl, 'u2/1', 'mux/3');
+add_line(mdl, 'mux/1', 'continuous/1');
+add_line(mdl, 'mux/1', 'adi/1');
+add_line(mdl, 'continuous/1', 'out/1');
+add_line(mdl, 'adi/1', 'out/2');
+add_line(mdl, 'out/1', 'y/1');
+set_param(mdl, 'Solver', 'ode15s', 'RelTol', '1e-8', 'AbsTol', '1e-8', ...
+    'MaxStep', num2str(tstep/6), 'StopTime', num2str(tend), ...
+    'OutputOption', 'SpecifiedOutputTimes', 'OutputTimes', ...
+    ['0:' num2str(tout) ':' num2str(tend)], 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % values every 6 hours
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = (0:size(yy,1)-1)'*tout;
+ny = size(yy,2)/2;              % outputs of one block
+% outlet temperature, measurement points 1, 3 and 5 of the central column
+col = [3*mpts+1, 1, 3, 5];
+
+%% ----------------- set the reference values -----------------------------
+% continuous model
+y0 = yy(:,col);
+
+% ----------------- set reference values initial simulation ---------------
+% result of the ADI model at creation of the function
+y1 = [32.1576391532393,10,10,10;33.5798860741566,18.6601966953672,22.7363184397493,22.7285881371201; ...
+    20.1656978684079,20.1656978684079,24.442760616041,24.4304465873226;14.111778489621,14.111778489621,16.2769244815211,16.2535522242648; ...
+    32.714559465577,13.1750352624981,15.0042682067918,14.9758060493786;33.791741520481,20.2250697121954,24.6195143603752,24.598458815502; ...
+    21.2196972011489,21.2196972011489,25.6561128595445,25.6330851629018;15.2275451210476,15.2275451210476,17.9173314150567,17.8755729179428; ...
+    32.8639689473133,14.0565859680589,16.3467752908034,16.3007020450059;33.8500792532601,20.6685127069943,25.1379817028164,25.1095674055539; ...
+    21.5264476723957,21.5264476723957,26.0022262283543,25.9737090749032;15.5626740477813,15.5626740477813,18.4052350634713,18.3544947713881; ...
+    32.9106235789677,14.331515689853,16.766536663512,16.7119391274382;33.8695446032041,20.8136604403752,25.3113569174889,25.2792774592936; ...
+    21.6329253330218,21.6329253330218,26.1280180611804,26.0966332535506;15.6866261579287,15.6866261579287,18.59868962867,18.5430030234609; ...
+    32.9307889628042,14.4404182124729,16.9488045520152,16.8891920734939;33.8788651774534,20.8758503093927,25.3949204511467,25.3604860415907; ...
+    21.6825174786329,21.6825174786329,26.1955774406409,26.1621747210915;15.7490679278942,15.7490679278942,18.7128630847712,18.6534259198412; ...
+    32.9436255851444,14.4994724520795,17.0656162550869,17.0019371624045;33.8852776319862,20.9121272787659,25.4528836933055,25.4164049184971; ...
+    21.7134480270548,21.7134480270548,26.2457794205642,26.2105235450686;15.7902066721199,15.7902066721199,18.8021780924383,18.7391654192634; ...
+    32.9540076891581,14.5401935077097,17.1606592001469,17.0929921096342;33.8906367261794,20.9381732380289,25.5016532352826,25.4631183029817; ...
+    21.7364119876319,21.7364119876319,26.289156915312,26.2520042656662;15.8215325451175,15.8215325451175,18.8808007341946,18.8140954787047; ...
+    32.9632264347877,14.5718214238575,17.2454540377212,17.1736443575096;33.895444695895,20.9587439681546,25.5456402642566,25.5049584941881; ...
+    21.7547931259787,21.7547931259787,26.3286171229445,26.2894795352331;15.8468579400992,15.8468579400992,18.952761606735,18.8821944819721; ...
+    32.9716670387897,14.597590878036,17.3234029092161,17.2472650605328;33.8998600162924,20.9756155046614,25.586216725744,25.5432933082822; ...
+    21.7699506626141,21.7699506626141,26.3651249579475,26.3239180747628;15.8678299359571,15.8678299359571,19.0194939273607,18.9449113334623; ...
+    32.9794796120822,14.6190046830424,17.3958106268174,17.3151827718045;33.9039505913168,20.9896787811914,25.6239596822812,25.5787147220197; ...
+    21.7826195379518,21.7826195379518,26.399128801251,26.3557833829169;15.8853989952061,15.8853989952061,19.0817266722453,19.0030049850819; ...
+    32.9867482085907,14.6369808479054,17.4633992712952,17.3781532050648];
+
+% current simulation
+y2 = yy(:,ny+col);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Outlet temperature of the U-tube'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Max difference of outlet and storage'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'continuous model','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'continuous vs initial simu','continuous vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
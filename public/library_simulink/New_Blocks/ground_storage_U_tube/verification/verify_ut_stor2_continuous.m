@@ -0,0 +1,226 @@
+function [v, s] = verify_ut_stor2_continuous(varargin)
+% verification of the continuous model of the s-function ut_stor2 
+% (level 2 version 6.2.0) with the level 1 version 6.1.0: the borehole 
+% is loaded with 0.3 kg/s of water at 35 degC for 12 hours every day 
+% (the input data of verify_ut_stor2). The reference are the results 
+% of version 6.1.0 in the same model (ode4, step 60 s). The temperature
+% outside and below the storage are the same, so the changed bottom 
+% boundary (T below storage instead of T outside the lowest slice) has 
+% no effect. The remaining difference comes from the heat transfer to 
+% the nodes, which is now mdot*cp*(Tin-Tout) of each pipe segment 
+% (version 6.1.0: U*A*(Tin-Tnode) with the segment inlet temperature).
+% The outputs at the times when the massflow switches are not compared,
+% version 6.1.0 returned the outlet temperature one step late.
+% Compared are the outlet temperature, three measurement points in the
+% central column and the middle measurement point at d/4 and d/2.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_ut_stor2_continuous(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_ut_stor2_continuous' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_ut_stor2_continuous:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 0.03;       % max error between version 6.1.0 and simulation in K
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_ut_stor2_continuous_mdl';
+
+% storage: diameter 20 m, depth 30 m, earth 2.4e6 J/(m^3*K) and 
+% 2 W/(m*K), pipe 32 mm, hole 0.15 m and 28 m deep, filling 2e6 J/(m^3*K)
+% and 1.5 W/(m*K), roughness 1e-5 m, 10 degC, 8 radial and 10 axial 
+% nodes, 5 measurement points
+znodes = 10;
+mpts = 5;
+stor = sprintf('20, 30, 2.4e6, 2.0, 0.032, 0.15, 28, 2.0e6, 1.5, 1e-5, 10, 8, %d, %d', ...
+    znodes, mpts);
+tstep = 60;             % fixed step of the solver in s
+tend = 10*86400;        % simulation time in s
+tout = 6*3600;          % results every 6 hours
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+% inputs: Tamb, U to ambient, radiation, flow ID, Tinlet
+add_block('simulink/Sources/Constant', [mdl '/u1'], 'Value', '[10 8 0 20001 35]');
+add_block('simulink/Sources/Clock', [mdl '/t']);
+add_block('simulink/User-Defined Functions/Fcn', [mdl '/mdot'], 'Expr', ...
+    '0.3*(rem(u,86400) < 43200)');
+add_block('simulink/Discrete/Zero-Order Hold', [mdl '/zoh'], 'SampleTime', '3600');
+% pressure, fluid ID, mixture, diameter, pressure drop coefficients, 
+% T outside the storage and below the storage
+add_block('simulink/Sources/Constant', [mdl '/u2'], 'Value', ...
+    mat2str([2e5 1 0 0.02 100 10 1 10*ones(1,znodes+1)]));
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '3');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/stor'], ...
+    'FunctionName', 'ut_stor2', 'Parameters', stor);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 't/1', 'mdot/1');
+add_line(mdl, 'mdot/1', 'zoh/1');
+add_line(mdl, 'u1/1', 'mux/1');
+add_line(mdl, 'zoh/1', 'mux/2');
+add_line(mdl, 'u2/1', 'mux/3');
+add_line(mdl, 'mux/1', 'stor/1');
+add_line(mdl, 'stor/1', 'y/1');
+set_param(mdl, 'Solver', 'ode4', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'Decimation', num2str(tout/tstep), ...
+    'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % values every 6 hours
+close_system(mdl, 0)            % close system, but do not save it
+
+% the massflow switches at 0 and 12 h, compare the values at 6 and 18 h
+idx = 2:2:size(yy,1);
+t0 = (idx-1)'*tout;
+% outlet temperature, measurement points 1, 3 and 5 of the central column,
+% measurement point 3 at d/4 and d/2
+col = [3*mpts+1, 1, 3, 5, mpts+3, 2*mpts+3];
+
+%% ----------------- set the reference values -----------------------------
+% result of ut_stor2 version 6.1.0 (level 1 s-function)
+y0 = [33.5852066117724,18.6855744591483,22.7843885890839,22.7767122546854,10.0000000000644,10;14.1288974365044,14.1288974443635,16.3009630228063,16.2776052998474,10.0000000182646,10; ...
+    33.7959490173636,20.2488816143307,24.6573057391339,24.6363188304876,10.0000002059109,10.0000000000016;15.2457073532511,15.2457073605553,17.9412410395827,17.8994932944984,10.0000009143434,10.0000000000155; ...
+    33.853955734098,20.6917849498747,25.1727176833212,25.1443863013937,10.0000027034821,10.000000000079;15.5810482829552,15.5810482900976,18.4287861949302,18.3780521886527,10.0000063283616,10.0000000002827; ...
+    33.8733167543313,20.8367501314305,25.3451299285189,25.3131405899712,10.0000127147877,10.0000000008063;15.7050528576804,15.7050528647663,18.6220599488323,18.5663778503697,10.0000229321508,10.000000001962; ...
+    33.8825981906419,20.8988752968871,25.4283317818389,25.3939913093224,10.0000381666897,10.0000000042431;15.7675179850914,15.7675179921508,18.7361563849074,18.6767230533336,10.0000596961201,10.0000000083772; ...
+    33.8889905671638,20.9351257689432,25.4861089675482,25.4497268626821,10.0000888670331,10.0000000153826;15.8086737477768,15.8086737548196,18.8254357132569,18.7624264806852,10.0001270742306,10.000000026626; ...
+    33.8943355936194,20.9611579574267,25.5347477583467,25.4963120473746,10.0001757429887,10.0000000438805;15.8400137045058,15.8400137115362,18.9040373469643,18.8373351585965,10.0002363130071,10.000000069384; ...
+    33.8991317992901,20.9817196165104,25.5786252005182,25.5380453026183,10.0003102249796,10.0000001058961;15.865350801128,15.8653508081486,18.9759823959051,18.9054179244076,10.0003989084628,10.0000001567529; ...
+    33.9035365661118,20.998584207682,25.6191031851888,25.5762844498267,10.000503772004,10.0000002259203;15.8863324309176,15.88633243793,19.0427009538596,18.9681205554631,10.0006261942037,10.0000003180436; ...
+    33.9076174352721,21.0126417717726,25.6567554464969,25.6116181291698,10.0007675167136,10.000000438495;15.903909385996,15.9039093930016,19.1049209883073,19.0262010035081,10.0009290378588,10.0000005934165];
+
+% ----------------- set reference values initial simulation ---------------
+% result of ut_stor2 version 6.2.0
+y1 = [33.5825643873839,18.6645961603314,22.7610157333972,22.75334112609,10.0000000000642,10;14.1192764442255,14.1192764442255,16.2899467136393,16.2666237173471,10.000000018225,10; ...
+    33.7933531770717,20.2264195400118,24.6344535939232,24.6134612351692,10.000000205499,10.0000000000016;15.2343906023768,15.2343906023768,17.9290001775781,17.8872990936671,10.0000009125791,10.0000000000155; ...
+    33.8514266384722,20.6692449022245,25.1504937620966,25.1221466942609,10.0000026983994,10.0000000000789;15.5694543805978,15.5694543805978,18.416575359926,18.3658868375735,10.0000063167189,10.0000000002822; ...
+    33.8708211842608,20.8142650229526,25.323216396457,25.2912042738648,10.0000126918288,10.0000000008048;15.6933989658816,15.6933989658816,18.609908415029,18.5542700798584,10.0000228914204,10.0000000019584; ...
+    33.880118054643,20.8764203104218,25.4065610705166,25.3721935372315,10.0000380998892,10.0000000042353;15.7558269107464,15.7558269107464,18.7240033896185,18.6646138097601,10.0000595930069,10.0000000083621; ...
+    33.8865187001746,20.912679920232,25.4644153309246,25.4280032716126,10.0000887153476,10.0000000153552;15.7969472940753,15.7969472940753,18.8132516049116,18.7502873303176,10.0001268596571,10.0000000265791; ...
+    33.8918693671796,20.9387127132174,25.513107139742,25.4746390705832,10.0001754491349,10.000000043804;15.8282549525657,15.8282549525657,18.8918133361884,18.8251579323195,10.0002359214101,10.0000000692642; ...
+    33.8966701881064,20.9592724978019,25.5570281905905,25.5164136314101,10.0003097151235,10.0000001057146;15.8535641781017,15.8535641781017,18.963717919367,18.893202349,10.0003982578171,10.0000001564863; ...
+    33.9010790787275,20.9761349192533,25.5975452424962,25.5546895071988,10.000502956069,10.0000002255388;15.8745223970619,15.8745223970619,19.0303980356192,18.9558687927795,10.0006251865721,10.0000003175101; ...
+    33.9051637608557,20.9901906508158,25.6352336802327,25.5900569539159,10.0007662891352,10.000000437764;15.8920798694833,15.8920798694833,19.0925822404987,19.0139157341451,10.0009275603176,10.0000005924332];
+
+% current simulation
+y2 = yy(idx,col);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Outlet temperature of the U-tube'; % title
+    sy1 = 'Temperature in degC';        % y-axis label in the upper plot
+    sy2 = 'Difference in K';            % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'version 6.1.0','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'version 6.1.0 vs initial simu','version 6.1.0 vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -69,6 +69,7 @@
  * 6.1.1	aw				added SimState compilance and			24jul2015
  *							multiple instances
  * 6.1.2    aw              unused function mdlUpdate deleted       10sep2015
+ * 6.2.0    hf              analytic Jacobian (mdlJacobian)         19oct2026
  *
  *
  *
@@ -126,6 +127,10 @@
  *  0       collector outlet temperature        degree Celsius
  *  1       average temperature                 degree Celsius
  *  2 0.N-1 node temperatures                   degree Celsius
+ *
+ * The derivative of a node depends on the node and the node before, the
+ * analytic Jacobian in mdlJacobian is bidiagonal. The derivative of the 
+ * heat capacity is neglected.
  */
 
 /*
@@ -179,6 +184,9 @@
 #define PERCENTAGE (*u3[2])  /* mixture  (defined in carlib.h) */
 #define NINPUT3         3
 
+/* number of nonzero elements of the Jacobian */
+#define JAC_NZ(nodes)   (9*(nodes)+1)
+
 
 #define MDL_CHECK_PARAMETERS
 #if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
@@ -260,6 +268,7 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumPWork(S, 0);
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
+    ssSetJacobianNzMax(S, JAC_NZ(nodes));
 	
 	ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
     ssSetSimStateVisibility(S, 1);
@@ -396,6 +405,128 @@ static void mdlDerivatives(SimStruct *S)
     }
 }
 
+
+#define MDL_JACOBIAN
+/*
+ * mdlJacobian - analytic Jacobian [A B; C D]
+ *
+ * Sparse matrix in compressed column format with (nx+ny) rows and (nx+nu)
+ * columns. The pattern is the same in each call, the columns of global 
+ * radiation, pressure, fluid ID and mixture are empty.
+ */
+static void mdlJacobian(SimStruct *S)
+{
+    real_T            *pr = ssGetJacobianPr(S);
+    int_T             *ir = ssGetJacobianIr(S);
+    int_T             *jc = ssGetJacobianJc(S);
+    real_T            *x  = ssGetContStates(S);
+    InputRealPtrsType u0  = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType u1  = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2  = ssGetInputPortRealSignalPtrs(S,2);
+    InputRealPtrsType u3  = ssGetInputPortRealSignalPtrs(S,3);
+    real_T ulin = ULIN;
+    real_T uqua = UQUA;
+    real_T usky = USKY;
+    real_T uwind = UWIND;
+    real_T tenter, wind, cpa, flow, asegment, invcap, tt, dloss;
+    int_T  nodes = (int_T)NODES;
+    int_T  n, col, nz;
+
+    asegment = A_COLL/nodes;    // collector surface per node in m
+    invcap = 1.0/C_COLL;        // reciprocal valuue of thermal capacity in m/W
+    wind = uwind * VWIND;       // wind loss coeff * wind velocity
+
+    /* cp also without massflow: derivative for the start of the flow */
+    tt = 0.5*(TIN+T(nodes-1));
+    cpa = heat_capacity(FLUID_ID, PERCENTAGE, tt, PRESS)/asegment;
+    flow = (MDOT > NO_MASSFLOW)? MDOT*cpa : 0.0;
+
+    nz = 0;
+    col = 0;
+    /* columns of the states */
+    tenter = (MDOT > NO_MASSFLOW)? TIN : T(0);
+    for (n = 0; n < nodes; n++)
+    {
+        tt = 0.5*(T(n)+tenter)-TAMB;
+        dloss = 0.5*(ulin+wind+2.0*uqua*tt+usky);   /* losses by d(tavg)/dT */
+        jc[col++] = nz;
+        ir[nz] = n;                             /* the node itself */
+        pr[nz++] = (MDOT > NO_MASSFLOW || n > 0)? (-dloss-flow)*invcap : -2.0*dloss*invcap;
+        if (n < nodes-1)                        /* next node: entering temperature */
+        {
+            tt = 0.5*(T(n+1)+T(n))-TAMB;
+            ir[nz] = n+1;
+            pr[nz++] = (-0.5*(ulin+wind+2.0*uqua*tt+usky)+flow)*invcap;
+        }
+        else                                    /* outlet temperature */
+        {
+            ir[nz] = nodes;
+            pr[nz++] = 1.0;
+        }
+        ir[nz] = nodes+1;                       /* average temperature */
+        pr[nz++] = 1.0/(real_T)nodes;
+        ir[nz] = nodes+2+n;                     /* node temperature */
+        pr[nz++] = 1.0;
+        tenter = T(n);
+    }
+
+    /* QSOLAR */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;
+        pr[nz++] = invcap;
+    }
+    /* IGLB */
+    jc[col++] = nz;
+    /* TAMB */
+    jc[col++] = nz;
+    tenter = (MDOT > NO_MASSFLOW)? TIN : T(0);
+    for (n = 0; n < nodes; n++)
+    {
+        tt = 0.5*(T(n)+tenter)-TAMB;
+        ir[nz] = n;
+        pr[nz++] = (ulin+wind+2.0*uqua*tt)*invcap;
+        tenter = T(n);
+    }
+    /* VWIND */
+    jc[col++] = nz;
+    tenter = (MDOT > NO_MASSFLOW)? TIN : T(0);
+    for (n = 0; n < nodes; n++)
+    {
+        tt = 0.5*(T(n)+tenter)-TAMB;
+        ir[nz] = n;
+        pr[nz++] = -uwind*tt*invcap;
+        tenter = T(n);
+    }
+    /* TSKY */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;
+        pr[nz++] = usky*invcap;
+    }
+    /* TIN */
+    jc[col++] = nz;
+    tt = 0.5*(T(0)+TIN)-TAMB;
+    ir[nz] = 0;
+    pr[nz++] = (MDOT > NO_MASSFLOW)? (-0.5*(ulin+wind+2.0*uqua*tt+usky)+flow)*invcap : 0.0;
+    /* MDOT */
+    jc[col++] = nz;
+    tenter = TIN;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;
+        pr[nz++] = cpa*(tenter-T(n))*invcap;
+        tenter = T(n);
+    }
+    /* PRESS, FLUID_ID, PERCENTAGE */
+    jc[col++] = nz;
+    jc[col++] = nz;
+    jc[col++] = nz;
+    jc[col] = nz;
+}
+
 /*
  * mdlTerminate - called when the simulation is terminated.
  *
@@ -0,0 +1,247 @@
+function [v, s] = verify_surfrad_multi(varargin)
+% verification of the s-function surfrad_multi with the s-function 
+% surfrad: four surfaces (south 45 degree, east and west wall, roof to 
+% the north with rotation) are calculated in one surfrad_multi block and
+% in four surfrad blocks with the Perez sky model. The weather is a clear
+% day at latitude 50 degree with the declination 10 degree. Compared are
+% the direct and the diffuse radiation on the surfaces.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_surfrad_multi(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_surfrad_multi' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_surfrad_multi:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-6;       % max error between surfrad_multi and surfrad in W/m^2
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_surfrad_multi_mdl';
+
+% surfaces: inclination, azimuth (0 = south, east negative), rotation
+planes = [45 0 0; 90 -90 0; 90 90 0; 30 180 10];
+skymodel = 3;           % Perez
+rground = 0.2;          % ground reflectance
+nplanes = size(planes,1);
+tstep = 3600;           % sample time in s
+tend = 86400;           % simulation time in s
+
+% weather data vector: sun angles of the day, direct normal and diffuse
+% radiation of a clear day, constant values for the other entries
+t = (0:tstep:tend)';
+phi = 50*pi/180;        % latitude
+decl = 10*pi/180;       % declination of the sun
+omega = (t/3600-12)*15*pi/180;              % hour angle
+cosz = sin(phi)*sin(decl) + cos(phi)*cos(decl)*cos(omega);
+zenith = acos(cosz);
+cosa = min(1, max(-1, (cosz*sin(phi)-sin(decl))./(sin(zenith)*cos(phi))));
+azimuth = acos(cosa);
+azimuth(omega < 0) = -azimuth(omega < 0);
+day = cosz > 0;
+wdata = zeros(length(t), 19);
+wdata(:,1) = t;                             % time of From Workspace
+wdata(:,2) = t;
+wdata(:,3) = zenith*180/pi;
+wdata(:,4) = azimuth*180/pi;
+wdata(day,5) = 800*cosz(day).^0.3;          % direct normal radiation
+wdata(day,6) = 150*cosz(day);               % diffuse radiation on horizontal
+wdata(:,7:14) = repmat([15 0 60 0 0.3 1e5 2 180], length(t), 1);
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/From Workspace', [mdl '/weather'], ...
+    'VariableName', 'wdata');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/multi'], ...
+    'FunctionName', 'surfrad_multi', 'Parameters', ...
+    sprintf('%g, %g, %s', skymodel, rground, mat2str(planes)));
+add_line(mdl, 'weather/1', 'multi/1');
+for n = 1:3
+    add_block('simulink/Sinks/Terminator', [mdl '/angle' num2str(n)]);
+    add_line(mdl, ['multi/' num2str(n)], ['angle' num2str(n) '/1']);
+end
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', ...
+    num2str(2*nplanes+2));
+for p = 1:nplanes
+    surf = sprintf('surfrad%d', p);
+    add_block('simulink/Sources/Constant', [mdl '/plane' num2str(p)], ...
+        'Value', mat2str(planes(p,:)));
+    add_block('simulink/User-Defined Functions/S-Function', [mdl '/' surf], ...
+        'FunctionName', 'surfrad', 'Parameters', ...
+        sprintf('%g, %g', skymodel, rground));
+    add_line(mdl, 'weather/1', [surf '/1']);
+    add_line(mdl, ['plane' num2str(p) '/1'], [surf '/2']);
+    for n = 1:16
+        add_block('simulink/Sinks/Terminator', [mdl '/' surf '_' num2str(n)]);
+        add_line(mdl, [surf '/' num2str(n)], [surf '_' num2str(n) '/1']);
+    end
+    add_line(mdl, [surf '/17'], ['mux/' num2str(p)]);
+    add_line(mdl, [surf '/18'], ['mux/' num2str(nplanes+p)]);
+end
+add_line(mdl, 'multi/4', ['mux/' num2str(2*nplanes+1)]);
+add_line(mdl, 'multi/5', ['mux/' num2str(2*nplanes+2)]);
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SrcWorkspace', 'current', 'SaveOutput', 'on', ...
+    'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % hourly values
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = (0:size(yy,1)-1)'*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% surfrad: direct and diffuse radiation on the surfaces
+y0 = yy(:,1:2*nplanes);
+
+% ----------------- set reference values initial simulation ---------------
+% result of surfrad_multi at creation of the function
+y1 = [0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    6.61048743851307,430.148789360876,0,148.254328692428,20.3571404874349,64.2988799928629,22.3476798721829,32.5337105356749; ...
+    149.51718906874,528.62891806677,0,209.608154702677,54.9519704616009,109.398813365007,47.377146175481,57.8067031552125; ...
+    318.259282714755,536.785341400073,0,252.206612129833,90.6416991761989,134.780937425531,71.6032273075711,75.9725787556398; ...
+    481.742432785263,473.257771210612,0,277.567108256883,122.581204728711,148.588978844765,91.2571707399639,88.4589328548266; ...
+    616.557432638885,351.075595077718,0,285.026498362887,147.962128005533,149.203792853997,105.218622323201,95.0314519677837; ...
+    704.961933747699,186.634817110265,0,274.838176512661,164.358637258992,137.295461132776,113.287646716181,96.3359131411965; ...
+    735.716342200348,2.75561056009564e-11,2.75561056009564e-11,248.753569032456,170.039746036185,115.878194600278,115.878194600278,93.62140078498; ...
+    704.961933747699,0,186.634817110265,210.020584751884,164.358664698037,113.287652696426,137.295477131205,87.9980809726608; ...
+    616.557432638885,0,351.075595077718,163.099223745758,147.962176946464,105.218633267708,149.203842505779,79.7555494321148; ...
+    481.742432785263,0,473.257771210612,113.206409182045,122.581263973127,91.2571847324313,148.589074947722,68.5477847307014; ...
+    318.259282714755,0,536.785341400073,65.7830194649809,90.6417535517543,71.6032417516646,134.781085955402,54.0311656760336; ...
+    149.51718906874,0,528.62891806677,26.0172581340382,54.9520025972173,47.3771580986126,109.39901222954,36.266779504122; ...
+    6.61048743851307,0,430.148789360876,0,20.3571548348828,22.3477036644065,64.2989512497347,18.0748908619434; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0; ...
+    0,0,0,0,0,0,0,0];
+
+% current simulation
+y2 = yy(:,2*nplanes+1:4*nplanes);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Direct radiation on the south surface'; % title
+    sy1 = 'Radiation in W/m^2';         % y-axis label in the upper plot
+    sy2 = 'Max difference of the surfaces'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'surfrad','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'surfrad vs initial simu','surfrad vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
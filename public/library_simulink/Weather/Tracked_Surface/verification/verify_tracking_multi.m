@@ -0,0 +1,244 @@
+function [v, s] = verify_tracking_multi(varargin)
+% verification of the s-function tracking_multi with the s-function 
+% tracking: five trackers (horizontal and inclined single axis, vertical
+% axis, two axis, fixed surface) are calculated in one tracking_multi 
+% block and in five tracking blocks. A sixth tracker is the horizontal 
+% single axis tracker with backtracking, its reference is the rotation of
+% the first tracker turned back by the formula of Lorenzo et al.
+% The weather is a clear day at latitude 50 degree with the declination 
+% 10 degree. The test model is created in memory and closed without 
+% saving.
+% Syntax:   [v, s] = verify_tracking_multi(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   /1/  Lorenzo, Narvarte, Munoz: Tracking and back-tracking,
+%                   Progress in Photovoltaics 19 (2011), p. 747-753
+
+% all comments above appear with 'help verify_tracking_multi' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_tracking_multi:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-7;       % max error between tracking_multi and tracking in degree
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_tracking_multi_mdl';
+
+% trackers: type, inclination, azimuth, rotation, maximum rotation, 
+% ground coverage ratio
+trackers = [1  0  0 0 90 0; ...
+            1 30  0 0 90 0; ...
+            2 45  0 0 90 0; ...
+            3  0  0 0 90 0; ...
+            4 45 20 0 90 0; ...
+            1  0  0 0 90 0.4];
+nsingle = 5;            % trackers which are compared with the block tracking
+ntrack = size(trackers,1);
+tracktime = 900;        % tracking time in s
+tend = 86400;           % simulation time in s
+
+% sun angles of a clear day in hourly values
+t = (0:3600:tend)';
+phi = 50*pi/180;        % latitude
+decl = 10*pi/180;       % declination of the sun
+omega = (t/3600-12)*15*pi/180;              % hour angle
+cosz = sin(phi)*sin(decl) + cos(phi)*cos(decl)*cos(omega);
+zenith = acos(cosz);
+cosa = min(1, max(-1, (cosz*sin(phi)-sin(decl))./(sin(zenith)*cos(phi))));
+azimuth = acos(cosa);
+azimuth(omega < 0) = -azimuth(omega < 0);
+sdata = [t, zenith*180/pi, azimuth*180/pi];
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/Sources/From Workspace', [mdl '/sun'], ...
+    'VariableName', 'sdata');
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', ...
+    num2str(nsingle+3));
+for p = 1:nsingle
+    track = sprintf('tracking%d', p);
+    add_block('simulink/User-Defined Functions/S-Function', [mdl '/' track], ...
+        'FunctionName', 'tracking', 'Parameters', ...
+        sprintf('%g, %g, %g, %g, %g', trackers(p,1), tracktime, trackers(p,2:4)));
+    add_line(mdl, 'sun/1', [track '/1']);
+    add_line(mdl, [track '/1'], ['mux/' num2str(p)]);
+end
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/multi'], ...
+    'FunctionName', 'tracking_multi', 'Parameters', ...
+    sprintf('%g, %s', tracktime, mat2str(trackers)));
+add_line(mdl, 'sun/1', 'multi/1');
+for n = 1:3
+    add_line(mdl, ['multi/' num2str(n)], ['mux/' num2str(nsingle+n)]);
+end
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tracktime), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SrcWorkspace', 'current', 'SaveOutput', 'on', ...
+    'OutputSaveName', 'yout');
+yy = simOut.get('yout');
+close_system(mdl, 0)            % close system, but do not save it
+
+yy = yy(1:4:end,:);             % hourly values
+t0 = (0:size(yy,1)-1)'*3600;
+
+%% ----------------- set the reference values -----------------------------
+% tracking: inclination, azimuth and rotation of each tracker
+ys = yy(:,1:3*nsingle);
+% backtracking of the first tracker /1/
+rot = abs(ys(:,3));
+cb = cosd(rot)/trackers(6,6);
+bt = rot;
+k = cb < 1;
+bt(k) = rot(k) - acosd(cb(k));
+bt = sign(ys(:,3)).*bt;
+y0 = [ys(:,1:3:end), ys(:,1), ys(:,2:3:end), ys(:,2), ys(:,3:3:end), bt];
+
+% ----------------- set reference values initial simulation ---------------
+% result of tracking_multi at creation of the function
+y1 = [0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,84.7082738249865,45,0,0,0,-99.3196912950421,-99.3196912950421,20,0,-84.6378992037918,-90,0,0,0,-8.14844930389707; ...
+    0,30,45,75.1370846910306,45,0,0,0,-87.8481111444133,-87.8481111444133,20,0,-75.1270606527866,-76.0294982957519,0,0,0,-25.0450798363754; ...
+    0,30,45,65.6474071664815,45,0,0,0,-75.7713491206676,-75.7713491206676,20,0,-64.9698911717386,-62.0239224285629,0,0,0,-64.9698911717386; ...
+    0,30,45,56.7000694866831,45,0,0,0,-62.2715975122758,-62.2715975122758,20,0,-53.4210586500597,-47.8392973328456,0,0,0,-53.4210586500597; ...
+    0,30,45,48.9209672793083,45,0,0,0,-46.4010094167124,-46.4010094167124,20,0,-39.7184881743558,-33.3653907154531,0,0,0,-39.7184881743558; ...
+    0,30,45,43.1794310628295,45,0,0,0,-27.3998589391196,-27.3998589391196,20,0,-23.3567883939843,-18.608289070259,0,0,0,-23.3567883939843; ...
+    0,30,45,40.4714994058999,45,0,0,0,-5.61079494901967,-5.61079494901967,20,0,-4.76855832272048,-3.69827169536622,0,0,0,-4.76855832272048; ...
+    0,30,45,41.4144982176997,45,0,0,0,16.832384847059,16.832384847059,20,0,14.3283093031865,11.2153961049881,0,0,0,14.3283093031865; ...
+    0,30,45,45.7662979412894,45,0,0,0,37.3132172252016,37.3132172252016,20,0,31.9066851866396,26.036468157311,0,0,0,31.9066851866396; ...
+    0,30,45,52.6434390768863,45,0,0,0,54.6632355136522,54.6632355136522,20,0,46.9008919677201,40.6444805819768,0,0,0,46.9008919677201; ...
+    0,30,45,61.0908585086989,45,0,0,0,69.2260954125832,69.2260954125832,20,0,59.4323411041922,54.9627046097522,0,0,0,59.4323411041922; ...
+    0,30,45,70.3697154600309,45,0,0,0,81.9073586365289,81.9073586365289,20,0,70.1875660951026,69.038380156946,0,0,0,38.1127312805444; ...
+    0,30,45,79.9495148594806,45,0,0,0,93.5936066443207,93.5936066443207,20,0,79.9301188012079,83.0221786663596,0,0,0,15.8505757555952; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0; ...
+    0,30,45,0,45,0,0,0,0,0,20,0,0,0,0,0,0,0];
+
+% current simulation
+y2 = yy(:,3*nsingle+1:end);
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Rotation of the tracker with backtracking'; % title
+    sy1 = 'Angle in degree';            % y-axis label in the upper plot
+    sy2 = 'Max difference of the angles'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'tracking','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'tracking vs initial simu','tracking vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,18), y1(:,18), y2(:,18)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
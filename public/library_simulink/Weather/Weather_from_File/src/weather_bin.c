@@ -0,0 +1,503 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This s-function reads weather data from a binary file written by the
+ * m-function weather2bin and gives the selected columns at the
+ * simulation time.
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ * Version  Author  Changes                                         Date
+ * 6.1.0    hf      created                                         19oct2026
+ * 6.1.1    hf      unknown sky temperatures from carlib function   19oct2026
+ *                  sky_temperature_batch
+ * 6.1.2    hf      byte order marker of the file is checked,       19oct2026
+ *                  data of the other byte order is swapped
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * The file contains the weather matrix in the Carnot-Format column by
+ * column (format see weather2bin.m). Solar position, direct and diffuse
+ * radiation are already in the file, so no solar calculation is done 
+ * during the simulation. The file is read once in mdlStart (one fread for
+ * the whole data, about 1.3 MB for an hourly year), the memory is 
+ * released in mdlTerminate.
+ * weather2bin writes the int32 0x01020304 as byte order marker (byte 20
+ * of the header). When the marker is read in reversed order, the file 
+ * was written on a host of the other byte order and all header values 
+ * and data are swapped after reading. Files without marker are rejected.
+ * Unknown sky temperatures (-9999 in column 8) are calculated for all 
+ * rows after reading the file with the carlib function 
+ * sky_temperature_batch (Berdahl / Martin with humidity, Unsworth 
+ * without humidity, no cos-term, same as metsky_s). The sky temperature
+ * is calculated once per row, all blocks on the weather bus use this 
+ * value and need no own sky temperature model.
+ *
+ * The values are linear interpolated between the rows, the timevalue
+ * (column 2) is taken from the row before. For equidistant data the
+ * row is found directly from the time, otherwise by bisection. When the
+ * simulation time exceeds the time in the file, the data is repeated
+ * from the beginning (period = last time - first time + time step), as
+ * in the block readfile.
+ *
+ * parameters
+ * index    use                                             units
+ * 0        name of the binary weather file (string)
+ * 1        columns of the weather matrix for the output    -
+ *          (1 = time, 3 = zenith, 5 = direct normal, ...,
+ *          see weather2bin or the Carnot weather format)
+ *
+ * structure of the output vector
+ * index    use
+ * 0..n-1   values of the columns given in parameter 1 at the
+ *          simulation time
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ */
+
+#define S_FUNCTION_NAME weather_bin
+#define S_FUNCTION_LEVEL 2
+
+#include "tmwtypes.h"
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILENAME        ssGetSFcnParam(S, 0)            /* name of the file */
+#define S_COLUMNS       ssGetSFcnParam(S, 1)            /* columns for the output */
+#define NCOLUMNS        ((int_T)mxGetNumberOfElements(S_COLUMNS))
+#define COLUMN(i)       ((int_T)(mxGetPr(S_COLUMNS)[i]+0.5))
+#define NPARAMS         2
+
+#define TIME            ssGetT(S)
+
+#define HEADER_SIZE     64          /* bytes before the data */
+#define BYTE_ORDER_MARK 0x01020304  /* int32 at byte 20 of the header */
+#define COL_TIMEVALUE   2           /* column of the timevalue YYYYMMDDHHMM */
+#define COL_TAMB        7           /* column of the ambient temperature */
+#define COL_TSKY        8           /* column of the sky temperature */
+#define COL_HUM         9           /* column of the relative humidity */
+#define COL_CLOUD       11          /* column of the cloud index */
+
+#define PWORK_DATA_NO   0           /* weather data, column by column */
+#define DWORK_SIZE_NO   0           /* number of rows and columns in the file */
+#define NROW            dwsize[0]
+#define NCOL            dwsize[1]
+#define DWORK_TIME_NO   1           /* first time, time step and period */
+#define TFIRST          dwtime[0]
+#define TSTEP           dwtime[1]
+#define TPERIOD         dwtime[2]
+
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      int_T i;
+
+      if (!mxIsChar(FILENAME)) {
+          ssSetErrorStatus(S,"Error in weather_bin: file name must be a string");
+          return;
+      }
+      if (NCOLUMNS < 1) {
+          ssSetErrorStatus(S,"Error in weather_bin: at least one column must be selected");
+          return;
+      }
+      for (i = 0; i < NCOLUMNS; i++) {
+          if (COLUMN(i) < 1) {
+              ssSetErrorStatus(S,"Error in weather_bin: column numbers must be >= 1");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, NPARAMS);  /* Number of expected parameters */
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S)) {
+        mdlCheckParameters(S);
+        if(ssGetErrorStatus(S) != NULL) return;
+    } else {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#endif
+    /* the file is read in mdlStart */
+    ssSetSFcnParamTunable(S, 0, SS_PRM_NOT_TUNABLE);
+    ssSetSFcnParamTunable(S, 1, SS_PRM_NOT_TUNABLE);
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, 0)) return;
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, NCOLUMNS);
+
+    ssSetNumDWork(S, 2);
+    ssSetDWorkWidth(S, DWORK_SIZE_NO, 2);
+    ssSetDWorkDataType(S, DWORK_SIZE_NO, SS_INT32);
+    ssSetDWorkName(S, DWORK_SIZE_NO, "DWORK_SIZE");
+    ssSetDWorkUsageType(S, DWORK_SIZE_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_TIME_NO, 3);
+    ssSetDWorkDataType(S, DWORK_TIME_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_TIME_NO, "DWORK_TIME");
+    ssSetDWorkUsageType(S, DWORK_TIME_NO, SS_DWORK_USED_AS_DWORK);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 1);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+
+    ssSupportsMultipleExecInstances(S, true);
+
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    This function is used to specify the sample time(s) for your
+ *    S-function. You must register the same number of sample times as
+ *    specified in ssSetNumSampleTimes.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+/* reverse the byte order of n values of size bytes */
+static void weather_bin_swap(void *values, size_t n, size_t size)
+{
+    unsigned char *b = (unsigned char *)values;
+    unsigned char c;
+    size_t i, k;
+
+    for (i = 0; i < n; i++, b += size) {
+        for (k = 0; k < size/2; k++) {
+            c = b[k];
+            b[k] = b[size-1-k];
+            b[size-1-k] = c;
+        }
+    }
+}
+
+
+/* read an int32 from the header, swapped if the file has the other byte
+ * order */
+static int_T weather_bin_int32(const unsigned char *b, int_T swap)
+{
+    int32_T v;
+
+    memcpy(&v, b, sizeof(int32_T));
+    if (swap)
+        weather_bin_swap(&v, 1, sizeof(int32_T));
+    return (int_T)v;
+}
+
+
+/* read a double from the header, swapped if the file has the other byte
+ * order */
+static real_T weather_bin_double(const unsigned char *b, int_T swap)
+{
+    real_T v;
+
+    memcpy(&v, b, sizeof(real_T));
+    if (swap)
+        weather_bin_swap(&v, 1, sizeof(real_T));
+    return v;
+}
+
+
+/* unknown sky temperatures of the data, returns 0 if there is not enough 
+ * memory */
+static int_T weather_bin_skytemperature(real_T *data, int_T nrow)
+{
+    real_T *tsky = data + (COL_TSKY-1)*nrow;
+    const real_T *tamb  = data + (COL_TAMB-1)*nrow;
+    const real_T *cloud = data + (COL_CLOUD-1)*nrow;
+    real_T *tcalc;
+    int_T  i, unknown = 0;
+
+    for (i = 0; i < nrow; i++)
+        if (tsky[i] < -9998.0)
+            unknown++;
+    if (unknown == 0)
+        return 1;
+
+    tcalc = (real_T *)malloc((size_t)nrow*sizeof(real_T));
+    if (tcalc == NULL)
+        return 0;
+    sky_temperature_batch(tcalc, (int)nrow, tamb, data + (COL_HUM-1)*nrow, 
+        cloud, data, 0);
+    for (i = 0; i < nrow; i++)
+        if (tsky[i] < -9998.0 && tamb[i] > -9998.0 && cloud[i] >= 0.0)
+            tsky[i] = tcalc[i];
+    free(tcalc);
+    return 1;
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Read header and data of the file.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      int32_T *dwsize = (int32_T *)ssGetDWork(S, DWORK_SIZE_NO);
+      real_T  *dwtime = (real_T *)ssGetDWork(S, DWORK_TIME_NO);
+      unsigned char header[HEADER_SIZE];
+      real_T  *data, tstep;
+      char    *name;
+      FILE    *datei;
+      int_T   name_length, nrow, ncol, i, swap;
+      size_t  nval;
+
+      ssGetPWork(S)[PWORK_DATA_NO] = NULL;
+
+      name_length = (int_T)(mxGetM(FILENAME)*mxGetN(FILENAME)+1);
+      name = (char *)mxCalloc(name_length, sizeof(char));
+      mxGetString(FILENAME, name, name_length);
+      datei = fopen(name, "rb");
+      mxFree(name);
+      if (datei == NULL) {
+          ssSetErrorStatus(S,"Error in weather_bin: cannot open the weather file");
+          return;
+      }
+
+      if (fread(header, 1, HEADER_SIZE, datei) != HEADER_SIZE
+          || memcmp(header, "CARNOTWB", 8) != 0) {
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: file is not a binary weather file (see weather2bin)");
+          return;
+      }
+      /* byte order of the file from the marker */
+      if (weather_bin_int32(header+20, 0) == BYTE_ORDER_MARK)
+          swap = 0;
+      else if (weather_bin_int32(header+20, 1) == BYTE_ORDER_MARK)
+          swap = 1;
+      else {
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: no byte order marker in the weather file, write it again with weather2bin");
+          return;
+      }
+      if (weather_bin_int32(header+8, swap) != 1) {
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: file is not a binary weather file of version 1 (see weather2bin)");
+          return;
+      }
+      ncol = weather_bin_int32(header+12, swap);
+      nrow = weather_bin_int32(header+16, swap);
+      tstep = weather_bin_double(header+48, swap);
+      if (ncol < 1 || nrow < 2) {
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: weather file needs at least 2 rows");
+          return;
+      }
+      for (i = 0; i < NCOLUMNS; i++) {
+          if (COLUMN(i) > ncol) {
+              fclose(datei);
+              ssSetErrorStatus(S,"Error in weather_bin: column number larger than the number of columns in the file");
+              return;
+          }
+      }
+
+      nval = (size_t)nrow*(size_t)ncol;
+      data = (real_T *)malloc(nval*sizeof(real_T));
+      if (data == NULL) {
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: not enough memory for the weather data");
+          return;
+      }
+      if (fread(data, sizeof(real_T), nval, datei) != nval) {
+          free(data);
+          fclose(datei);
+          ssSetErrorStatus(S,"Error in weather_bin: weather file is too short");
+          return;
+      }
+      fclose(datei);
+      if (swap)
+          weather_bin_swap(data, nval, sizeof(real_T));
+
+      /* sky temperature once for all rows, if it is unknown in the file */
+      if (ncol >= COL_CLOUD && !weather_bin_skytemperature(data, nrow)) {
+          free(data);
+          ssSetErrorStatus(S,"Error in weather_bin: not enough memory for the weather data");
+          return;
+      }
+
+      ssGetPWork(S)[PWORK_DATA_NO] = data;
+      NROW = (int32_T)nrow;
+      NCOL = (int32_T)ncol;
+      TFIRST = data[0];
+      TSTEP = tstep;
+      if (tstep <= 0.0)       /* not equidistant: last step for the period */
+          tstep = data[nrow-1] - data[nrow-2];
+      TPERIOD = data[nrow-1] - data[0] + tstep;
+  }
+#endif /*  MDL_START */
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Row before the simulation time and linear interpolation to the
+ *    next row.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T  *y = ssGetOutputPortRealSignal(S, 0);
+    const int32_T *dwsize = (const int32_T *)ssGetDWork(S, DWORK_SIZE_NO);
+    const real_T  *dwtime = (const real_T *)ssGetDWork(S, DWORK_TIME_NO);
+    const real_T  *data = (const real_T *)ssGetPWork(S)[PWORK_DATA_NO];
+    int_T   nrow = (int_T)NROW;
+    int_T   k, k1, lo, hi, mid, i, c;
+    real_T  t, w, t1;
+
+    if (data == NULL)
+        return;
+
+    /* time in the period of the file */
+    t = TFIRST + fmod(TIME - TFIRST, TPERIOD);
+    if (t < TFIRST)
+        t += TPERIOD;
+
+    if (t >= data[nrow-1])  /* between last row and first row of next period */
+    {
+        k = nrow-1;
+        k1 = 0;
+        t1 = TFIRST + TPERIOD;
+    }
+    else
+    {
+        if (TSTEP > 0.0)    /* equidistant */
+        {
+            k = (int_T)((t - TFIRST)/TSTEP);
+            if (k < 0)
+                k = 0;
+            if (k > nrow-2)
+                k = nrow-2;
+        }
+        else                /* bisection: data[lo] <= t < data[hi] */
+        {
+            lo = 0;
+            hi = nrow-1;
+            while (hi - lo > 1)
+            {
+                mid = (lo + hi)/2;
+                if (data[mid] <= t)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            k = lo;
+        }
+        k1 = k+1;
+        t1 = data[k1];
+    }
+    w = (t - data[k])/(t1 - data[k]);
+
+    for (i = 0; i < NCOLUMNS; i++)
+    {
+        c = (COLUMN(i)-1)*nrow;
+        if (COLUMN(i) == 1)             /* time in the period of the file */
+            y[i] = t;
+        else if (COLUMN(i) == COL_TIMEVALUE)
+            y[i] = data[c+k];
+        else
+            y[i] = data[c+k] + w*(data[c+k1] - data[c+k]);
+    }
+}
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    Release the memory of the weather data.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    if (ssGetPWork(S) != NULL && ssGetPWork(S)[PWORK_DATA_NO] != NULL)
+    {
+        free(ssGetPWork(S)[PWORK_DATA_NO]);
+        ssGetPWork(S)[PWORK_DATA_NO] = NULL;
+    }
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
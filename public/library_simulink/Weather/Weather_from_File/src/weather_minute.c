@@ -0,0 +1,387 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This s-function adds a minute variability to hourly weather data, e.g.
+ * the test reference years (TRY) read by weather_bin or the blocks
+ * "Weather from File" which interpolate the hourly values linearly.
+ * Short time steps for control dynamics need the fast changes of the
+ * radiation when clouds pass the sun.
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ * Version  Author  Changes                                         Date
+ * 6.1.0    hf      created                                         19oct2026
+ * 6.1.1    hf      direct radiation at most clear sky, mean        19oct2026
+ *                  durations of the periods and hourly means for
+ *                  interpolated input documented
+ * 6.1.2    hf      hourly means kept for linear interpolated       19oct2026
+ *                  input: factors scaled with the slope of the
+ *                  first minute
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * The sun is covered or not, the state changes from minute to minute as
+ * a Markov chain (carlib function weather_variability). The probability
+ * of sun is the fraction of the direct normal radiation of the clear sky
+ * direct radiation (Meinel: 1367 * 0.7^(AM^0.678)) at the beginning of
+ * the hour. When the sun is not covered, the direct radiation is
+ * increased so the mean of the hour is unchanged, but at most to the
+ * clear sky value. When the sun is covered the direct radiation is 0 or,
+ * if the sunny minutes are limited by the clear sky value, the remainder
+ * of the hour. The sun / cover state changes with the time constant TAU,
+ * the mean duration of the sunny periods is TAU/(1-fsun), of the covered
+ * periods TAU/fsun (fsun: probability of sun). The diffuse radiation and
+ * the ambient temperature get correlated random fluctuations with mean 0
+ * in the hour.
+ * The output is the input weather data vector multiplied with the
+ * factors of the current minute (direct and diffuse radiation, also on
+ * the surface, if known) and the ambient temperature plus its deviation.
+ * The block should be placed before the blocks for the radiation on
+ * surfaces.
+ * The factors have the mean 1 in each hour, so the hourly means of the
+ * input are kept exactly if the input is constant in the hour (e.g.
+ * weather_bin data held for the hour). With linear interpolated input 
+ * (blocks "Weather from File") the mean would differ by the correlation
+ * of the factors with the slope of the input. The slope of the hour is 
+ * known after the first minute, so the factors of the minutes 1 to 59 
+ * are scaled so that the hourly mean of the output is the mean of the
+ * interpolated input (exact for input which is linear in the hour). The
+ * deviation of the temperature has the mean 0 and needs no scaling.
+ *
+ * The random numbers of an hour only depend on the seed and the number
+ * of the hour, so the same seed always gives the same weather. The
+ * factors of the current hour (3*60 values) are the only memory, the
+ * calculation needs about 1 s per minute of weather data.
+ *
+ * parameters
+ * index    use                                             units
+ * 0        seed of the random numbers (integer >= 0)       -
+ * 1        time constant of the sun / cover changes        min
+ * 2        standard deviation of the ambient temperature   K
+ *
+ * structure of the input vector
+ * port index   use
+ * 0    0..17   weather data vector (index see surfrad)
+ *
+ * structure of the output vector
+ * port index   use
+ * 0    0..17   weather data vector with the minute variability
+ *
+ * sample time: 60 s
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  L I T E R A T U R E
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * /1/  Meinel, Meinel: Applied Solar Energy, Addison Wesley, 1976
+ */
+
+#define S_FUNCTION_NAME weather_minute
+#define S_FUNCTION_LEVEL 2
+
+#include "tmwtypes.h"
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+
+#define SEED        (*mxGetPr(ssGetSFcnParam(S, 0))) /* seed of the random numbers */
+#define TAU         (*mxGetPr(ssGetSFcnParam(S, 1))) /* time constant of sun and cloud periods */
+#define SIGMA_T     (*mxGetPr(ssGetSFcnParam(S, 2))) /* variation of ambient temperature */
+#define NPARAMS     3
+
+#define TIME        ssGetT(S)
+
+#define WEATHER_WIDTH   18      /* width of the weather data vector */
+#define W_ZENITH        1       /* index in the weather data vector */
+#define W_IDIR_N        3
+#define W_IDFU_H        4
+#define W_TAMB          5
+#define W_IDIR_S        16
+#define W_IDFU_S        17
+
+#define NMINUTE         60      /* minutes per hour */
+#define DWORK_HOUR_NO   0       /* hour of the factors */
+#define DWORK_FACTOR_NO 1       /* factors fdir, fdfu and dtamb of the hour */
+#define DWORK_SCALE_NO  2       /* radiation of the first minute and scaling of the factors */
+#define NSCALE          4       /* radiation values with scaled factors */
+
+static const int_T scale_index[NSCALE] = {W_IDIR_N, W_IDFU_H, W_IDIR_S, W_IDFU_S};
+
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      /* */
+      {
+          if (SEED < 0.0 || SEED > 4294967295.0) {
+              ssSetErrorStatus(S,"Error in weather_minute: seed must be an integer 0 .. 2^32-1");
+              return;
+          }
+      }
+      /* */
+      {
+          if (TAU < 1.0) {
+              ssSetErrorStatus(S,"Error in weather_minute: time constant of sunny and covered periods must be >= 1 min");
+              return;
+          }
+      }
+      /* */
+      {
+          if (SIGMA_T < 0.0) {
+              ssSetErrorStatus(S,"Error in weather_minute: standard deviation of temperature must be >= 0");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, NPARAMS);  /* Number of expected parameters */
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S)) {
+        mdlCheckParameters(S);
+        if(ssGetErrorStatus(S) != NULL) return;
+    } else {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#endif
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, WEATHER_WIDTH);
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+    ssSetInputPortRequiredContiguous(S, 0, true); /*direct input signal access*/
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, WEATHER_WIDTH);
+
+    ssSetNumDWork(S, 3);
+    ssSetDWorkWidth(S, DWORK_HOUR_NO, 1);
+    ssSetDWorkDataType(S, DWORK_HOUR_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_HOUR_NO, "DWORK_HOUR");
+    ssSetDWorkUsageType(S, DWORK_HOUR_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_FACTOR_NO, 3*NMINUTE);
+    ssSetDWorkDataType(S, DWORK_FACTOR_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_FACTOR_NO, "DWORK_FACTOR");
+    ssSetDWorkUsageType(S, DWORK_FACTOR_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_SCALE_NO, 2*NSCALE);
+    ssSetDWorkDataType(S, DWORK_SCALE_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_SCALE_NO, "DWORK_SCALE");
+    ssSetDWorkUsageType(S, DWORK_SCALE_NO, SS_DWORK_USED_AS_DWORK);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+
+    ssSupportsMultipleExecInstances(S, true);
+
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    One minute, so every minute and the beginning of every hour is a
+ *    time step.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, 60.0);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    No factors calculated yet.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      real_T *hour = (real_T *)ssGetDWork(S, DWORK_HOUR_NO);
+      real_T *scale = (real_T *)ssGetDWork(S, DWORK_SCALE_NO);
+      int_T  k;
+
+      hour[0] = -1.0e300;
+      for (k = 0; k < NSCALE; k++)
+      {
+          scale[k] = -1.0e300;      /* no input of minute 0 */
+          scale[NSCALE+k] = 1.0;    /* no scaling */
+      }
+  }
+#endif /*  MDL_START */
+
+
+
+/* scaling of the factors f of the minutes 1..n-1 for an input which is 
+ * linear in the hour: u0 at minute 0, u1 at minute 1. The sum of the 
+ * output u*f over the hour is the sum of the input. */
+static real_T weather_minute_scale(const real_T *f, real_T u0, real_T u1)
+{
+    real_T du = u1 - u0;
+    real_T sumu, sumf;
+    int_T  m;
+
+    if (du == 0.0 || u0 < 0.0 || u1 < 0.0)  /* held or missing input */
+        return 1.0;
+    sumu = (real_T)NMINUTE*u0 + du*0.5*(real_T)(NMINUTE*(NMINUTE-1));
+    sumf = 0.0;
+    for (m = 1; m < NMINUTE; m++)
+        sumf += (u0 + du*(real_T)m)*f[m];
+    return (sumf > 0.0)? max(0.0, sumu - u0*f[0])/sumf : 1.0;
+}
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    New factors at the beginning of an hour, after the first minute the
+ *    scaling for interpolated input, then the weather data of the minute.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    const real_T *u0 = ssGetInputPortRealSignal(S, 0);
+    real_T *y0 = ssGetOutputPortRealSignal(S, 0);
+    real_T *hour = (real_T *)ssGetDWork(S, DWORK_HOUR_NO);
+    real_T *fdir = (real_T *)ssGetDWork(S, DWORK_FACTOR_NO);
+    real_T *fdfu = fdir + NMINUTE;
+    real_T *dtamb = fdir + 2*NMINUTE;
+    real_T *ufirst = (real_T *)ssGetDWork(S, DWORK_SCALE_NO);  /* radiation of minute 0 */
+    real_T *scale = ufirst + NSCALE;                            /* scaling of minutes 1..59 */
+    real_T time = TIME;
+    real_T h, cz, idirclear, fsun;
+    int_T  i, k, m;
+
+    h = floor(time/3600.0);
+    if (h != hour[0])       /* new hour: factors of the minutes */
+    {
+        hour[0] = h;
+        fsun = 1.0;
+        cz = cos(DEG2RAD*u0[W_ZENITH]);
+        if (u0[W_ZENITH] > -9998.0 && cz > 0.01)
+        {                   /* clear sky direct radiation by Meinel /1/ */
+            idirclear = 1367.0*pow(0.7, pow(1.0/cz, 0.678));
+            fsun = min(1.0, max(0.0, u0[W_IDIR_N])/idirclear);
+        }
+        weather_variability(fdir, fdfu, dtamb, NMINUTE, (unsigned int)SEED,
+            (long)h, fsun, TAU, SIGMA_T);
+    }
+
+    m = (int_T)floor((time - 3600.0*h)/60.0);
+    m = max(0, min(NMINUTE-1, m));
+
+    if (m == 0)             /* first minute: keep the input for the scaling */
+    {
+        for (k = 0; k < NSCALE; k++)
+        {
+            ufirst[k] = u0[scale_index[k]];
+            scale[k] = 1.0;
+        }
+    }
+    else if (m == 1 && ufirst[0] > -1.0e300)
+    {                       /* slope of the hour known: scaling of the factors */
+        for (k = 0; k < NSCALE; k++)
+            scale[k] = weather_minute_scale((k == 0 || k == 2)? fdir : fdfu,
+                ufirst[k], u0[scale_index[k]]);
+        ufirst[0] = -1.0e300;
+    }
+
+    for (i = 0; i < WEATHER_WIDTH; i++)
+        y0[i] = u0[i];
+    if (u0[W_IDIR_N] >= 0.0)
+        y0[W_IDIR_N] = u0[W_IDIR_N]*fdir[m]*scale[0];
+    if (u0[W_IDFU_H] >= 0.0)
+        y0[W_IDFU_H] = u0[W_IDFU_H]*fdfu[m]*scale[1];
+    if (u0[W_IDIR_S] >= 0.0)
+        y0[W_IDIR_S] = u0[W_IDIR_S]*fdir[m]*scale[2];
+    if (u0[W_IDFU_S] >= 0.0)
+        y0[W_IDFU_S] = u0[W_IDFU_S]*fdfu[m]*scale[3];
+    if (u0[W_TAMB] > -9998.0)
+        y0[W_TAMB] = u0[W_TAMB] + dtamb[m];
+} // end mdlOutputs
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was
+ *    allocated in mdlStart, this is the place to free it.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
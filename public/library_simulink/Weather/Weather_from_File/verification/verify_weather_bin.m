@@ -0,0 +1,247 @@
+function [v, s] = verify_weather_bin(varargin)
+% verification of the s-function weather_bin: a synthetic weather matrix
+% of two days is written by weather2bin into a binary file and read by
+% weather_bin during three days, so the data is repeated after the end of
+% the file. The reference values are calculated by linear interpolation 
+% in the weather matrix, the timevalue is the value of the previous row.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_weather_bin(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_weather_bin' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_weather_bin:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-7;       % max error between weather_bin and weather matrix
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_weather_bin_mdl';
+
+columns = [1 2 3 5 7 8];    % columns of the weather matrix in the output
+tstep = 1800;               % sample time in s
+tend = 3*86400;             % simulation time in s
+
+% weather matrix of two days in hourly values
+t = (0:47)'*3600;
+h = mod(t/3600, 24);
+d = floor(t/86400);
+weather = zeros(length(t), 17);
+weather(:,1) = t;
+weather(:,2) = 201401010000 + d*10000 + h*100;      % timevalue
+weather(:,3) = 90 - 60*sin(pi*h/24);                % zenith angle
+weather(:,4) = -180 + 15*h;                         % azimuth angle
+weather(:,5) = max(0, 800*sin(2*pi*(h-6)/24));      % direct radiation
+weather(:,6) = max(0, 150*sin(2*pi*(h-6)/24));      % diffuse radiation
+weather(:,7) = 10 + 5*sin(2*pi*(h-9)/24) + 2*d;     % ambient temperature
+weather(:,8) = weather(:,7) - 20;                   % sky temperature
+weather(:,9:14) = repmat([70 0 0.5 1e5 3 270], length(t), 1);
+
+fname = [tempname '.cwb'];
+weather2bin(weather, fname);
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/weather'], ...
+    'FunctionName', 'weather_bin', 'Parameters', ...
+    sprintf('''%s'', %s', fname, mat2str(columns)));
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'weather/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', num2str(tstep), ...
+    'StopTime', num2str(tend), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SaveOutput', 'on', 'OutputSaveName', 'yout');
+yy = simOut.get('yout');
+close_system(mdl, 0)            % close system, but do not save it
+delete(fname)
+
+yy = yy(1:3:end,:);             % values every 1.5 hours
+t0 = (0:size(yy,1)-1)'*3*tstep;
+
+%% ----------------- set the reference values -----------------------------
+% the file is repeated after the last row plus one time step, between the
+% last row and the end of the period is interpolated to the first row
+period = t(end) - t(1) + 3600;
+tp = mod(t0, period);
+wx = [weather; weather(1,:)];
+wx(end,1) = period;
+y0 = zeros(length(t0), length(columns));
+y0(:,1) = tp;
+y0(:,2) = weather(floor(tp/3600)+1, 2);
+for n = 3:length(columns)
+    y0(:,n) = interp1(wx(:,1), wx(:,columns(n)), tp);
+end
+
+% ----------------- set reference values initial simulation ---------------
+% result of weather_bin at creation of the function
+y1 = [0,201401010000,90,0,6.46446609406726,-13.5355339059327; ...
+    5400,201401010100,78.3196428803228,0,5.42012192481623,-14.5798780751838; ...
+    10800,201401010300,67.0389940580946,0,5,-15; ...
+    16200,201401010400,56.7371571297384,0,5.42012192481623,-14.5798780751838; ...
+    21600,201401010600,47.5735931288072,0,6.46446609406726,-13.5355339059327; ...
+    27000,201401010700,40.2186376777298,303.527618041008,8.1029523872437,-11.8970476127563; ...
+    32400,201401010900,34.5672280493228,565.685424949238,10,-10; ...
+    37800,201401011000,31.2788793701136,732.780492029403,11.8970476127563,-8.1029523872437; ...
+    43200,201401011200,30,800,13.5355339059327,-6.46446609406726; ...
+    48600,201401011300,31.2788793701136,732.780492029403,14.5798780751838,-5.42012192481623; ...
+    54000,201401011500,34.5672280493228,565.685424949238,15,-5; ...
+    59400,201401011600,40.2186376777298,303.527618041008,14.5798780751838,-5.42012192481623; ...
+    64800,201401011800,47.5735931288071,9.79717439317883e-14,13.5355339059327,-6.46446609406726; ...
+    70200,201401011900,56.7371571297384,0,11.8970476127563,-8.1029523872437; ...
+    75600,201401012100,67.0389940580946,0,10,-10; ...
+    81000,201401012200,78.3196428803228,0,8.1029523872437,-11.8970476127563; ...
+    86400,201401020000,90,0,8.46446609406726,-11.5355339059327; ...
+    91800,201401020100,78.3196428803228,0,7.42012192481623,-12.5798780751838; ...
+    97200,201401020300,67.0389940580946,0,7,-13; ...
+    102600,201401020400,56.7371571297384,0,7.42012192481623,-12.5798780751838; ...
+    108000,201401020600,47.5735931288072,0,8.46446609406726,-11.5355339059327; ...
+    113400,201401020700,40.2186376777298,303.527618041008,10.1029523872437,-9.8970476127563; ...
+    118800,201401020900,34.5672280493228,565.685424949238,12,-8; ...
+    124200,201401021000,31.2788793701136,732.780492029403,13.8970476127563,-6.1029523872437; ...
+    129600,201401021200,30,800,15.5355339059327,-4.46446609406726; ...
+    135000,201401021300,31.2788793701136,732.780492029403,16.5798780751838,-3.42012192481623; ...
+    140400,201401021500,34.5672280493228,565.685424949238,17,-3; ...
+    145800,201401021600,40.2186376777298,303.527618041008,16.5798780751838,-3.42012192481623; ...
+    151200,201401021800,47.5735931288071,9.79717439317883e-14,15.5355339059327,-4.46446609406726; ...
+    156600,201401021900,56.7371571297384,0,13.8970476127563,-6.1029523872437; ...
+    162000,201401022100,67.0389940580946,0,12,-8; ...
+    167400,201401022200,78.3196428803228,0,10.1029523872437,-9.8970476127563; ...
+    0,201401010000,90,0,6.46446609406726,-13.5355339059327; ...
+    5400,201401010100,78.3196428803228,0,5.42012192481623,-14.5798780751838; ...
+    10800,201401010300,67.0389940580946,0,5,-15; ...
+    16200,201401010400,56.7371571297384,0,5.42012192481623,-14.5798780751838; ...
+    21600,201401010600,47.5735931288072,0,6.46446609406726,-13.5355339059327; ...
+    27000,201401010700,40.2186376777298,303.527618041008,8.1029523872437,-11.8970476127563; ...
+    32400,201401010900,34.5672280493228,565.685424949238,10,-10; ...
+    37800,201401011000,31.2788793701136,732.780492029403,11.8970476127563,-8.1029523872437; ...
+    43200,201401011200,30,800,13.5355339059327,-6.46446609406726; ...
+    48600,201401011300,31.2788793701136,732.780492029403,14.5798780751838,-5.42012192481623; ...
+    54000,201401011500,34.5672280493228,565.685424949238,15,-5; ...
+    59400,201401011600,40.2186376777298,303.527618041008,14.5798780751838,-5.42012192481623; ...
+    64800,201401011800,47.5735931288071,9.79717439317883e-14,13.5355339059327,-6.46446609406726; ...
+    70200,201401011900,56.7371571297384,0,11.8970476127563,-8.1029523872437; ...
+    75600,201401012100,67.0389940580946,0,10,-10; ...
+    81000,201401012200,78.3196428803228,0,8.1029523872437,-11.8970476127563; ...
+    86400,201401020000,90,0,8.46446609406726,-11.5355339059327];
+
+% current simulation
+y2 = yy;
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Ambient temperature from weather_bin'; % title
+    sy1 = 'Temperature in C';          % y-axis label in the upper plot
+    sy2 = 'Max difference of the columns'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'weather matrix','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'matrix vs initial simu','matrix vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,5), y1(:,5), y2(:,5)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -0,0 +1,271 @@
+function [v, s] = verify_weather_minute(varargin)
+% verification of the s-function weather_minute: the minute values of 
+% two days of hourly weather data must have the hourly mean of the input,
+% for input held constant in the hour and for linear interpolated input
+% (mean of the interpolated minute values). Compared are the hourly means
+% of the direct normal radiation, the diffuse horizontal radiation, the 
+% ambient temperature and the direct and diffuse radiation on the 
+% surface. The first day is partly cloudy, the second day is near clear
+% sky, so the direct radiation of the sunny minutes is limited to clear
+% sky.
+% The random numbers only depend on the seed, so the initial and the 
+% current simulation must give the same minute values.
+% The test model is created in memory and closed without saving.
+% Syntax:   [v, s] = verify_weather_minute(show)
+% 
+% Inputs    show - optional flag for display 
+%               0 : show results only if verification fails
+%               1 : show results allways
+% Outputs:  v - true if verification passed, false otherwise
+%           s - text string with verification result
+%                                                                          
+% Literature:   --
+
+% all comments above appear with 'help verify_weather_minute' 
+% ***********************************************************************
+% This file is part of the CARNOT Blockset.
+% Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+% Additional Copyright for this file see list auf authors.
+% All rights reserved.
+% 
+% Redistribution and use in source and binary forms, with or without 
+% modification, are permitted provided that the following conditions are 
+% met:
+% 
+% 1. Redistributions of source code must retain the above copyright notice, 
+%    this list of conditions and the following disclaimer.
+% 
+% 2. Redistributions in binary form must reproduce the above copyright 
+%    notice, this list of conditions and the following disclaimer in the 
+%    documentation and/or other materials provided with the distribution.
+% 
+% 3. Neither the name of the copyright holder nor the names of its 
+%    contributors may be used to endorse or promote products derived from 
+%    this software without specific prior written permission.
+% 
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+% ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+% LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+% CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+% SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+% INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+% CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+% ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+% THE POSSIBILITY OF SUCH DAMAGE.
+% $Revision$
+% $Author$
+% $Date$
+% $HeadURL$
+% **********************************************************************
+% D O C U M E N T A T I O N
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+% 
+% author list:      hf -> Bernd Hafner
+%
+% version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+%
+% Version   Author  Changes                                     Date
+% 6.1.0     hf      created                                     19oct2026
+% 6.1.1     hf      linear interpolated input                   19oct2026
+% * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+% ---- check input arguments ----------------------------------------------
+if nargin == 0
+    show = 0;
+elseif nargin == 1
+    show = varargin{1};
+else
+    error('verify_weather_minute:%s',' too many input arguments')
+end
+
+%% ---------- set your specific model or function parameters here
+% ----- set error tolerances ----------------------------------------------
+max_error = 1e-7;       % max error of the hourly means
+max_simu_error = 1e-7;  % max error between initial and current simu
+
+% ---------- set model file or function name ------------------------------
+functionname = 'verify_weather_minute_mdl';
+
+seed = 7;               % seed of the random numbers
+tau = 10;               % time constant of the sun / cover changes in min
+sigmat = 0.5;           % standard deviation of the ambient temperature in K
+nhour = 48;             % number of hours
+columns = [4 5 6 17 18];    % compared columns of the weather data vector
+
+% hourly weather data vector, the first column is the time
+t = (0:nhour)'*3600;
+th = mod(t, 86400);
+d = floor(t/86400);
+phi = 50*pi/180;        % latitude
+decl = 10*pi/180;       % declination of the sun
+omega = (th/3600-12)*15*pi/180;             % hour angle
+cosz = sin(phi)*sin(decl) + cos(phi)*cos(decl)*cos(omega);
+day = cosz > 0;
+idirmax = 400 + 350*(d >= 1);               % second day near clear sky
+wdata = zeros(length(t), 19);
+wdata(:,1) = t;                             % time of From Workspace
+wdata(:,2) = t;
+wdata(:,3) = acos(cosz)*180/pi;             % zenith angle
+wdata(day,5) = idirmax(day).*cosz(day).^0.3;    % direct normal radiation
+wdata(day,6) = 150*cosz(day);               % diffuse radiation on horizontal
+wdata(:,7) = 10 + 5*sin(2*pi*(th/3600-9)/24);   % ambient temperature
+wdata(:,8) = wdata(:,7) - 20;               % sky temperature
+wdata(:,9:14) = repmat([70 0 0.5 1e5 3 270], length(t), 1);
+wdata(:,18) = 0.8*wdata(:,5);               % direct radiation on surface
+wdata(:,19) = 0.9*wdata(:,6);               % diffuse radiation on surface
+
+%% -------------- create and simulate the model ---------------------------
+mdl = functionname;
+if bdIsLoaded(mdl)
+    close_system(mdl, 0)
+end
+new_system(mdl);
+% input held in the hour and linear interpolated input
+add_block('simulink/Sources/From Workspace', [mdl '/weather'], ...
+    'VariableName', 'wdata', 'Interpolate', 'off');
+add_block('simulink/Sources/From Workspace', [mdl '/weather_i'], ...
+    'VariableName', 'wdata', 'Interpolate', 'on');
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/minute'], ...
+    'FunctionName', 'weather_minute', 'Parameters', ...
+    sprintf('%g, %g, %g', seed, tau, sigmat));
+add_block('simulink/User-Defined Functions/S-Function', [mdl '/minute_i'], ...
+    'FunctionName', 'weather_minute', 'Parameters', ...
+    sprintf('%g, %g, %g', seed, tau, sigmat));
+add_line(mdl, 'weather/1', 'minute/1');
+add_line(mdl, 'weather_i/1', 'minute_i/1');
+add_block('simulink/Signal Routing/Mux', [mdl '/mux'], 'Inputs', '2');
+add_block('simulink/Sinks/Out1', [mdl '/y']);
+add_line(mdl, 'minute/1', 'mux/1');
+add_line(mdl, 'minute_i/1', 'mux/2');
+add_line(mdl, 'mux/1', 'y/1');
+set_param(mdl, 'Solver', 'FixedStepDiscrete', 'FixedStep', '60', ...
+    'StopTime', num2str(nhour*3600-60), 'SaveFormat', 'Array');
+simOut = sim(mdl, 'SrcWorkspace', 'current', 'SaveOutput', 'on', ...
+    'OutputSaveName', 'yout');
+yy = simOut.get('yout');        % minute values, held and interpolated input
+close_system(mdl, 0)            % close system, but do not save it
+
+t0 = t(1:nhour);
+
+%% ----------------- set the reference values -----------------------------
+% hourly values of the input and hourly means of the interpolated input
+tm = (0:60*nhour-1)'*60;
+wi = interp1(t, wdata(:,2:end), tm);
+y0 = zeros(nhour, 2*length(columns));
+y0(:,1:length(columns)) = wdata(1:nhour, columns+1);
+for n = 1:length(columns)
+    y0(:,length(columns)+n) = mean(reshape(wi(:,columns(n)), 60, nhour))';
+end
+
+% ----------------- set reference values initial simulation ---------------
+% hourly means of weather_minute at creation of the function
+y1 = [0,0,6.46446609406726,0,0,0,0,6.07379114684745,0,0; ...
+    0,0,5.66987298107781,0,0,0,0,5.42428444242059,0,0; ...
+    0,0,5.17037086855466,0,0,0,0,5.08660519151529,0,0; ...
+    0,0,5,0,0,0,0,5.08376567703937,0,0; ...
+    0,0,5.17037086855466,0,0,0,0,5.41595940721188,0,0; ...
+    0,0,5.66987298107781,0,0,107.37619641442,9.81038884001232,6.06054792829762,85.9009571315356,8.82934995601108; ...
+    218.392263893734,19.9533332339234,6.46446609406726,174.713811114988,17.957999910531,247.630458304646,32.0364009937352,6.97360359781753,198.104366643717,28.8327608943617; ...
+    277.859777949826,44.5290642708288,7.5,222.287822359861,40.076157843746,295.969972235825,55.7886909310231,8.09290318078964,236.77597778866,50.2098218379208; ...
+    314.694071412874,67.4299998508851,8.7059047744874,251.755257130299,60.6869998657965,327.040867464283,77.0988604619824,9.34216826036442,261.632693971427,69.3889744157841; ...
+    339.806198975062,87.0954790598966,10,271.844959180049,78.3859311539069,348.009806308206,94.5146567497982,10.636263485877,278.407845046565,85.0631910748184; ...
+    356.491502025525,102.18533198851,11.2940952255126,285.193201620419,91.9667987896592,361.222001460779,106.84922205842,11.8869984063022,288.977601168624,96.1642998525783; ...
+    366.112856809094,111.671210096802,12.5,292.890285447275,100.504089087122,367.661839241401,113.261976145899,13.0091375037503,294.129471393121,101.935778531309; ...
+    369.26332955277,114.906666467847,13.5355339059327,295.410663642216,103.415999821062,367.714347120463,113.31590041875,13.9262088531526,294.17147769637,101.984310376875; ...
+    366.112856809094,111.671210096802,14.3301270189222,292.890285447275,100.504089087122,361.382357373839,107.007320026892,14.5757155575794,289.105885899071,96.3065880242027; ...
+    356.491502025525,102.18533198851,14.8296291314453,285.193201620419,91.9667987896592,348.28789469238,94.7661542986084,14.9133948084847,278.630315753904,85.2895388687476; ...
+    339.806198975062,87.0954790598966,15,271.844959180049,78.385931153907,327.459402923653,77.4266184487993,14.9162343229606,261.967522338922,69.6839566039194; ...
+    314.694071412874,67.429999850885,14.8296291314453,251.755257130299,60.6869998657965,296.583877126876,56.1703731906908,14.5840405927881,237.2671017015,50.5533358716217; ...
+    277.859777949827,44.5290642708288,14.3301270189222,222.287822359861,40.0761578437459,248.621583538915,32.445996511017,13.9394520717024,198.897266831132,29.2013968599153; ...
+    218.392263893735,19.9533332339234,13.5355339059327,174.713811114988,17.957999910531,111.016067479315,10.142944393911,13.0263964021825,88.812853983452,9.12864995451993; ...
+    0,0,12.5,0,0,0,0,11.9070968192104,0,0; ...
+    0,0,11.2940952255126,0,0,0,0,10.6578317396356,0,0; ...
+    0,0,10,0,0,0,0,9.36373651412297,0,0; ...
+    0,0,8.7059047744874,0,0,0,0,8.11300159369776,0,0; ...
+    0,0,7.5,0,0,0,0,6.99086249624974,0,0; ...
+    0,0,6.46446609406726,0,0,0,0,6.07379114684744,0,0; ...
+    0,0,5.66987298107781,0,0,0,0,5.42428444242059,0,0; ...
+    0,0,5.17037086855466,0,0,0,0,5.08660519151529,0,0; ...
+    0,0,5,0,0,0,0,5.08376567703937,0,0; ...
+    0,0,5.17037086855466,0,0,0,0,5.41595940721187,0,0; ...
+    0,0,5.66987298107781,0,0,201.330368277037,9.81038884001232,6.06054792829762,161.064294621629,8.82934995601108; ...
+    409.485494800752,19.9533332339234,6.46446609406726,327.588395840601,17.957999910531,464.307109321212,32.0364009937352,6.97360359781753,371.445687456969,28.8327608943617; ...
+    520.987083655924,44.5290642708288,7.5,416.789666924739,40.0761578437459,554.943697942171,55.7886909310231,8.09290318078964,443.954958353737,50.2098218379208; ...
+    590.051383899139,67.429999850885,8.7059047744874,472.041107119311,60.6869998657965,613.201626495531,77.0988604619824,9.34216826036443,490.561301196425,69.3889744157842; ...
+    637.136623078242,87.0954790598965,10,509.709298462593,78.3859311539068,652.518386827887,94.5146567497982,10.636263485877,522.014709462309,85.0631910748184; ...
+    668.421566297859,102.18533198851,11.2940952255126,534.737253038286,91.9667987896592,677.291252738962,106.84922205842,11.8869984063022,541.833002191169,96.1642998525783; ...
+    686.461606517051,111.671210096802,12.5,549.16928521364,100.504089087122,689.365948577628,113.261976145899,13.0091375037503,551.492758862102,101.935778531309; ...
+    692.368742911443,114.906666467847,13.5355339059327,553.894994329155,103.415999821062,689.464400850867,113.31590041875,13.9262088531526,551.571520680694,101.984310376875; ...
+    686.461606517051,111.671210096802,14.3301270189222,549.16928521364,100.504089087122,677.591920075948,107.007320026892,14.5757155575794,542.073536060759,96.3065880242027; ...
+    668.421566297859,102.18533198851,14.8296291314453,534.737253038286,91.9667987896592,653.039802548213,94.7661542986085,14.9133948084847,522.431842038571,85.2895388687476; ...
+    637.136623078242,87.0954790598966,15,509.709298462593,78.3859311539068,613.986380481849,77.4266184487992,14.9162343229606,491.189104385479,69.6839566039193; ...
+    590.051383899139,67.429999850885,14.8296291314453,472.041107119311,60.6869998657966,556.094769612892,56.1703731906907,14.5840405927881,444.875815690313,50.5533358716217; ...
+    520.987083655925,44.5290642708289,14.3301270189222,416.789666924739,40.076157843746,466.165469135465,32.445996511017,13.9394520717024,372.932375308372,29.2013968599153; ...
+    409.485494800752,19.9533332339234,13.5355339059327,327.588395840601,17.957999910531,208.155126523716,10.142944393911,13.0263964021825,166.524101218973,9.12864995451993; ...
+    0,0,12.5,0,0,0,0,11.9070968192104,0,0; ...
+    0,0,11.2940952255126,0,0,0,0,10.6578317396356,0,0; ...
+    0,0,10,0,0,0,0,9.36373651412297,0,0; ...
+    0,0,8.7059047744874,0,0,0,0,8.11300159369776,0,0; ...
+    0,0,7.5,0,0,0,0,6.99086249624974,0,0];
+
+% current simulation: hourly means of the minute values
+y2 = zeros(nhour, 2*length(columns));
+for n = 1:length(columns)
+    y2(:,n) = mean(reshape(yy(:,columns(n)), 60, nhour))';
+    y2(:,length(columns)+n) = mean(reshape(yy(:,18+columns(n)), 60, nhour))';
+end
+
+% -------- calculate the errors -------------------------------------------
+%   r    - 'relative' error or 'absolute' error
+%   s    - 'sum' - e is the sum of the individual errors of ysim 
+%          'mean' - e is the mean of the individual errors of ysim
+%          'max' - e is the maximum of the individual errors of ysim
+r = 'absolute'; 
+s = 'max';
+
+% error between reference and initial simu 
+[e1, ye1] = calculate_verification_error(y0, y1, r, s);
+% error between reference and current simu
+[e2, ye2] = calculate_verification_error(y0, y2, r, s);
+% error between initial and current simu
+[e3, ye3] = calculate_verification_error(y1, y2, r, s);
+
+% ------------- decide if verification is ok --------------------------------
+if e2 > max_error
+    v = false;
+    s = sprintf('verification %s with reference FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e2, max_error);
+    show = true;
+elseif e3 > max_simu_error
+    v = false;
+    s = sprintf('verification %s with 1st calculation FAILED: error %3.3g > allowed error %3.3g', ...
+        functionname, e3, max_simu_error);
+    show = true;
+else
+    v = true;
+    s = sprintf('%s OK: error %3.3g', functionname, e2);
+end
+
+% ------------ diplay and plot options if required ------------------------
+if (show)
+    disp(s)
+    disp(['Initial error = ', num2str(e1)])
+    sx = 'time in h';                   % x-axis label
+    st = 'Hourly mean of the direct normal radiation'; % title
+    sy1 = 'Radiation in W/m^2';         % y-axis label in the upper plot
+    sy2 = 'Max difference of the means'; % y-axis label in the lower plot
+    % upper legend
+    sleg1 = {'hourly input','initial simulation','current simulation'};
+    % lower legend
+    sleg2 = {'input vs initial simu','input vs current simu','initial simu vs current'};
+    % x axis
+    x = t0/3600;
+    %   y - matrix with y-values (reference values and result of the function call)
+    y = [y0(:,1), y1(:,1), y2(:,1)];
+    %   ye - matrix with error values for each y-value
+    ye = [max(ye1,[],2), max(ye2,[],2), max(ye3,[],2)];
+    sz = strrep(s,'_',' ');
+    display_verification_error(x, y, ye, st, sx, sy1, sleg1, sy2, sleg2, sz)
+end
@@ -57,6 +57,7 @@
  *                  power to heating circuit as new output
  * 6.0.0    aw      SimstateCompiliance and                     11aug2015
  *                  MultipleInstancesExec activated
+ * 6.1.0    hf      analytic Jacobian (mdlJacobian)             19oct2026
  *
  * Copyright by the authors and (c) 1998 Solar-Institut Juelich, Germany
  *
@@ -96,6 +97,11 @@
  *  0       outlet temperature                              degree Celsius
  *  1       mean temperature                                degree Celsius
  *  2       power to the heating circuit                    W
+ *
+ * The derivative of a node depends on the node, the node before and on
+ * the last node (losses with the mean temperature). mdlJacobian gives 
+ * this sparse pattern analytically, the derivatives of the properties 
+ * are neglected.
  */
  
 /*
@@ -128,6 +134,9 @@
 #define POWER       rwork[0]
 #define TMEAN       rwork[1]
 
+/* number of nonzero elements of the Jacobian */
+#define JAC_NZ(nodes)   (7*(nodes)+1)
+
 
 #define MDL_CHECK_PARAMETERS
 #if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
@@ -217,6 +226,7 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumPWork(S, 0);
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
+    ssSetJacobianNzMax(S, JAC_NZ((int_T)NODES));
     
     ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
     ssSetSimStateVisibility(S, 1);
@@ -321,6 +331,90 @@ static void mdlDerivatives(SimStruct *S)
 }
 
 
+#define MDL_JACOBIAN
+/* Function: mdlJacobian ======================================================
+ * Abstract:
+ *      Analytic Jacobian [A B; C D] as sparse matrix in compressed column 
+ *      format, (nx+ny) rows and (nx+nu) columns. The pattern is the same 
+ *      in each call, the columns of pressure, fluid ID and mixture are 
+ *      empty.
+ */
+static void mdlJacobian(SimStruct *S)
+{
+    real_T   *pr    = ssGetJacobianPr(S);
+    int_T    *ir    = ssGetJacobianIr(S);
+    int_T    *jc    = ssGetJacobianJc(S);
+    real_T   *x     = ssGetContStates(S);
+
+    InputRealPtrsType u1 = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2 = ssGetInputPortRealSignalPtrs(S,2);
+    InputRealPtrsType u3 = ssGetInputPortRealSignalPtrs(S,3);
+    InputRealPtrsType u4 = ssGetInputPortRealSignalPtrs(S,4);
+
+    int      nodes = (int)NODES;
+    real_T   tmean, cp, mdotcp, invmass, dloss, tenter;
+    int      n, col, nz;
+
+    tmean   = (TIN+x[nodes-1])*0.5;
+    cp      = heat_capacity(FLUID_ID, PERCENTAGE, tmean, PRESS);
+    invmass = nodes/(cp*density(FLUID_ID, PERCENTAGE, tmean, PRESS)*VOL);
+    mdotcp  = cp*MDOT;
+    dloss   = -0.5*ULOSS/nodes*invmass;     /* losses by the mean temperature */
+
+    nz = 0;
+    col = 0;
+    /* columns of the states */
+    for (n = 0; n < nodes-1; n++)
+    {
+        jc[col++] = nz;
+        ir[nz] = n;     pr[nz++] = -mdotcp*invmass;
+        ir[nz] = n+1;   pr[nz++] = mdotcp*invmass;
+    }
+    /* last node: losses of all nodes and outputs */
+    jc[col++] = nz;
+    for (n = 0; n < nodes-1; n++)
+    {
+        ir[nz] = n;     pr[nz++] = dloss;
+    }
+    ir[nz] = nodes-1;   pr[nz++] = dloss - mdotcp*invmass;
+    ir[nz] = nodes;     pr[nz++] = 1.0;     /* outlet temperature */
+    ir[nz] = nodes+1;   pr[nz++] = 0.5;     /* mean temperature */
+    ir[nz] = nodes+2;   pr[nz++] = mdotcp;  /* power */
+
+    /* TAMB */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;     pr[nz++] = -2.0*dloss;
+    }
+    /* TIN */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;     pr[nz++] = (n == 0)? dloss + mdotcp*invmass : dloss;
+    }
+    /* MDOT */
+    jc[col++] = nz;
+    tenter = TIN;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;     pr[nz++] = cp*(tenter-x[n])*invmass;
+        tenter = x[n];
+    }
+    /* PRESS, FLUID_ID, PERCENTAGE */
+    jc[col++] = nz;
+    jc[col++] = nz;
+    jc[col++] = nz;
+    /* PNOM */
+    jc[col++] = nz;
+    for (n = 0; n < nodes; n++)
+    {
+        ir[nz] = n;     pr[nz++] = invmass/nodes;
+    }
+    jc[col] = nz;
+}
+
+
 /* Function: mdlTerminate =====================================================
  * Abstract:
  *    No termination needed, but we are required to have this routine.
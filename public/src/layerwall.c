@@ -35,6 +35,16 @@
  * 6.2.2	aw		unused parameter deleted					01jul2016
  *					SPLint warnings checked
  * 6.2.3    hf      NODES replaced by NDNODE                    02jul2016
+ * 6.3.0    hf      optional parameter TSAMPLE: discrete exact  19oct2026
+ *                  state-space model, geometry moved to mdlStart
+ * 6.4.0    hf      optional parameter MODETOL: reduced model   19oct2026
+ *                  with the dominant modes of the wall
+ * 6.4.1    hf      node geometry moved to carlib (wall_nodes)  19oct2026
+ * 6.4.2    hf      reduced model: lags with the full static    19oct2026
+ *                  gain matrix of the neglected modes,
+ *                  TSAMPLE and MODETOL not tunable
+ * 6.4.3    hf      layer parameters not tunable, MODETOL for   19oct2026
+ *                  daily means and for surface temperatures
  *
  ***********************************************************************
  * This file is part of the CARNOT Blockset.
@@ -110,6 +120,58 @@
  *
  * structure of u (input vector): see defines below
  *
+ * Discrete mode (optional parameter TSAMPLE > 0)
+ * The matrices of the node model do not change during the simulation. 
+ * With a zero-order-hold of the inputs over one sample time ts the 
+ * solution is x(k+1) = PHI*x(k) + GAMMA*u(k) with PHI = exp(A*ts) and
+ * GAMMA = A^-1*(PHI-I)*B. A = C^-1*K (C capacities, K conduction) is 
+ * transformed to the symmetric tridiagonal matrix C^1/2*A*C^-1/2 and 
+ * the exponential is calculated from its eigenvalues in mdlStart. The 
+ * temperatures at the sample points are the same as for the continuous
+ * model, but the wall has no continuous states for the solver.
+ *
+ * Reduced model (optional parameter MODETOL > 0)
+ * In the coordinates of the eigenvectors (modes) the node model is 
+ * decoupled: dxi(k)/dt = lambda(k)*xi(k) + sum_j V(j,k)*u(j). Only the 
+ * temperatures of the port nodes (first, last and active nodes) are
+ * outputs, T(i) = sum_k V(i,k)*xi(k). The modes are chosen by their 
+ * contribution to the static response of the port nodes; modes are 
+ * added until the neglected part is below MODETOL. The choice is made 
+ * in mdlInitializeSizes, since the number of modes is the number of 
+ * states, and repeated in mdlStart (same result) to store the modes. 
+ * TSAMPLE, MODETOL and the layer parameters (which give the nodes in 
+ * mdlStart) are therefore not tunable.
+ * The neglected (fast) modes are replaced by one first order lag per 
+ * port node i with the input sum_j G(i,j)*u(j), G(i,j) = sum over the
+ * neglected modes k of V(i,k)*V(j,k)/|lambda(k)|. So the static response
+ * of the neglected modes to all inputs (also the cross responses, e.g.
+ * of the surface temperature to the power of an active layer) is kept.
+ * Two year simulations of five walls (exterior walls massive, light and
+ * brick, floor heating, concrete ceiling with active layer, 6 .. 14 
+ * nodes with TAU = 600 s) with heat transfer to the ambient (with sun) 
+ * and to the room and a sample time of 300 s gave these maximum 
+ * deviations of the port temperatures and of their daily means from the
+ * full model (the states include the 2 or 3 lags):
+ *      MODETOL     states      max. deviation  daily means
+ *      0.5         4 .. 7      3.3 K           0.06 K
+ *      0.2         4 .. 10     2.5 K           0.013 K
+ *      0.1         4 .. 12     1.3 K           0.002 K
+ *      0.02        6 .. 15     0.10 K          below 0.001 K
+ *      0.01        7 .. 15     0.04 K          below 0.001 K
+ * With TAU = 30 s (17 .. 26 nodes) MODETOL = 0.5 keeps the same 4 .. 7
+ * states and daily means (0.06 K), MODETOL = 0.01 keeps 9 .. 27 states.
+ * The lags keep the static response, so the daily and annual dynamics
+ * (energy balances, room temperatures with daily time steps) only need
+ * the slow modes: MODETOL = 0.5 is recommended for them, the walls have
+ * 4 to 7 states. The surface temperatures within 
+ * the day depend on the fast modes at the surface (up to 3 K for the 
+ * brick wall with 4 states); for hourly surface temperatures (comfort, 
+ * control of active layers) MODETOL = 0.01 is recommended, the walls 
+ * with an active layer then keep nearly all modes. 
+ * verify_layerwall_reduced.m compares the surface temperatures with 
+ * MODETOL = 0.01, verify_layerwall_reduced2.m the daily means with 
+ * MODETOL = 0.5. The reduced model can be continuous or discrete.
+ *
  * Literature: 
  * Feist, W.: Thermische Gebaeudesimulation, Dissertation Uni Kassel, 
  *              Mller 2004
@@ -124,6 +186,7 @@
 #include <math.h>
 #include <float.h>
 #include "simstruc.h"
+#include "carlib.h"
 
 /*
  *   Defines for easy access to the parameters
@@ -138,6 +201,12 @@
 #define S_RHO                ssGetSFcnParam(S,5)  				/* density [kg/m^3] */
 #define S_DEPTH              ssGetSFcnParam(S,6)  				/* depth of active layers [m] */
 #define NPARAMS                               7
+#define NPARAMS_TSAMPLE                       8      /* with optional sample time */
+#define TSAMPLE             ((ssGetSFcnParamsCount(S) >= NPARAMS_TSAMPLE)? \
+                             *mxGetPr(ssGetSFcnParam(S,7)) : 0.0) /* sample time [s], 0 continuous */
+#define NPARAMS_MODETOL                       9      /* with optional tolerance of reduced model */
+#define MODETOL             ((ssGetSFcnParamsCount(S) >= NPARAMS_MODETOL)? \
+                             *mxGetPr(ssGetSFcnParam(S,8)) : 0.0) /* tolerance of the modes, 0 full model */
 
 #define NDNODE              mxGetN(S_DNODE)      
 #define NCOND               mxGetN(S_COND)
@@ -148,12 +217,23 @@
 #define Q_OUTSIDE           (*u0[0])    /* power per surface outside node */
 #define POWER_PER_NODE(n)   (*u1[n])    /* power per node */
 #define Q_INSIDE            (*u2[0])    /* power per surface inside node */
+#define VMODE(i,k)          vmode[(k)*(2+NUMACTIVE)+(i)]  /* temperature of port i in mode k */
+#define LAGTAU(i)           lag[i]                        /* time constant of the lag of port i */
+#define LAGPHI(i)           lag[2+NUMACTIVE+(i)]          /* exp(-ts/tau) of the lag of port i */
+#define LAGGAIN(i,j)        lag[(2+(j))*(2+NUMACTIVE)+(i)] /* static gain of the lag of port i for input j */
 
 #define DWORK_NONODES_NO            0     			  /* number of overall cells */
 #define DWORK_ACTIVE_NO             1     			  /* number of active layers */
 #define DWORK_CAP_NO                2     			  /* thermal capacity of layers */
 #define DWORK_COND_NO               3     			  /* thermal conductivity of layers */
 #define DWORK_NUMACTIVE_NO          4     			  /* number of active layers */
+#define DWORK_PHI_NO                5                 /* discrete transition matrix */
+#define DWORK_GAMMA_NO              6                 /* discrete input matrix */
+#define DWORK_EIGVEC_NO             7                 /* eigenvectors (scratch in mdlStart) */
+#define DWORK_VMODE_NO              8                 /* port temperatures of the modes */
+#define DWORK_LAMBDA_NO             9                 /* eigenvalues of the modes */
+#define DWORK_XI0_NO                10                /* initial values of the modes */
+#define DWORK_LAG_NO                11                /* time constant, exp(-ts/tau) and gains of the lags */
 
 #define NONODES               dwork_nocells[0]        /* number of overall cells */
 #define ACTIVE(n)             dwork_active[n]         /* number of active layers */
@@ -166,8 +246,8 @@
 #define MAXNODES                    ((uint16_T)20)            /* maximum number of layers */
 #define MAX_LAYERS                  ((uint16_T)10)            /* Layers per Layer */
 #define MAX_L                       ((uint16_T)(MAXNODES*MAX_LAYERS+2)) /* has to be at least MAXNODES * MAX_LAYERS !!! */
-#define DMAX_ACTIVE_LAYER_TO_NODE   0.00999 			      /* maximum distance from active layer to node in m *
-														       * if bigger, an additional node is added          */
+#define MAX_DNODES   ((uint16_T)((NDNODE*MAX_LAYERS+1+NDEPTH < MAX_L)? \
+                        NDNODE*MAX_LAYERS+1+NDEPTH : MAX_L))  /* upper limit of NONODES */
 
 #define MDL_CHECK_PARAMETERS
 #if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
@@ -274,17 +354,279 @@ static void mdlCheckParameters(SimStruct *S)
             return;
         }
     }
+    
+    /* Check 9th parameter: sample time (optional) */
+    if (TSAMPLE < 0.0)
+	{
+        ssSetErrorStatus(S,"Error in wall: sample time must be >= 0 s (0 for the continuous model).");
+        return;
+    }
+    /* Check 10th parameter: tolerance of the reduced model (optional) */
+    if (MODETOL < 0.0)
+	{
+        ssSetErrorStatus(S,"Error in wall: tolerance of the reduced model must be >= 0 (0 for the full model).");
+        return;
+    }
 }
 #endif /* MDL_CHECK_PARAMETERS */
  
 
+/* Function: layerwall_geometry ==============================================
+ * Abstract:
+ *    Calculate the nodes, capacities and conductivities of the wall 
+ *    (carlib function wall_nodes).
+ *    The results are stored in the DWork vectors (mdlStart) or in local 
+ *    arrays (mdlInitializeSizes of the reduced model).
+ */
+static void layerwall_geometry(SimStruct *S, uint16_T *dwork_nocells, 
+    uint16_T *dwork_active, real_T *dwork_cap, real_T *dwork_cond, 
+    uint16_T *dwork_numactive)
+{
+    real_T work[3*(MAX_L+2)];
+    int_T  act[MAXNODES], nonodes, i;
+
+	/* no active layer if depth of active layer < 0*/
+    if (mxGetPr(S_DEPTH)[0] < 0.0)
+	{
+        NUMACTIVE = 0;
+	}
+	else
+	{
+		NUMACTIVE = (uint16_T)NDEPTH;
+	}
+
+    nonodes = wall_nodes(mxGetPr(S_DNODE), mxGetPr(S_COND), mxGetPr(S_CWALL), 
+        mxGetPr(S_RHO), (int)NDNODE, mxGetPr(S_DEPTH), (int)NUMACTIVE, TAU, 
+        MAX_LAYERS, MAX_L-1, dwork_cap, dwork_cond, act, work);
+    if (nonodes < 0)
+    {
+        ssSetErrorStatus(S, "Error in wall: number of layers exeeded due to active layers!");
+        return;
+    }
+    NONODES = (uint16_T)nonodes;
+    for (i = 0; i < NUMACTIVE; i++)
+    {
+        ACTIVE(i) = (uint16_T)act[i];
+    }
+}
+
+
+/* Function: layerwall_modes =================================================
+ * Abstract:
+ *    Modal decomposition of the node model and selection of the dominant
+ *    modes for the reduced model. The port nodes are the first node, the
+ *    last node and the active nodes (in this order). Each mode has the 
+ *    weight V(i,k)^2/|lambda(k)| in the static response of port node i 
+ *    to its own input (the cross responses are bounded by these weights).
+ *    Modes with eigenvalue 0 are always kept, the other modes are added 
+ *    in the order of their relative weight until the neglected part is 
+ *    below MODETOL for every port node.
+ *    The neglected modes of port node i are replaced by a first order lag
+ *    with the static gains G(i,j) = sum V(i,k)*V(j,k)/|lambda(k)| for 
+ *    the inputs j and the mean time constant 
+ *    sum V(i,k)^2/lambda(k)^2 / G(i,i).
+ *    Returns the number of modes or -1 if the eigenvalues did not converge.
+ *    If lam is not NULL, the eigenvalues, the port values of the 
+ *    eigenvectors, the initial modal states and the time constants and 
+ *    gains of the lags are stored.
+ */
+static int_T layerwall_modes(SimStruct *S, uint16_T *dwork_nocells, 
+    uint16_T *dwork_active, real_T *dwork_cap, real_T *dwork_cond, 
+    uint16_T *dwork_numactive, real_T *lam, real_T *vmode, real_T *xi0, 
+    real_T *lag)
+{
+    real_T tol = MODETOL;
+    real_T d[MAX_L],            /* diagonal, eigenvalues after eigen_tridiagonal */
+           e[MAX_L],            /* off-diagonal */
+           sc[MAX_L],           /* square root of capacity */
+           dc[MAX_L],           /* 1/|lambda|, 0 for eigenvalue 0 */
+           z[(MAXNODES+3)*MAX_L], /* port rows of the eigenvectors and C^1/2*V */
+           wsum[MAXNODES+2],    /* total weight per port node */
+           wneg[MAXNODES+2],    /* weight of neglected modes */
+           lmax, w, wbest, emax;
+    uint16_T node[MAXNODES+2];  /* port nodes */
+    uint8_T  keep[MAX_L];
+    uint16_T nn = NONODES, m = 2+NUMACTIVE, i, j, k, r;
+    int_T    kbest;
+
+    /* symmetric matrix C^1/2 * A * C^-1/2 */
+    for (i = 0; i < nn; i++)
+    {
+        sc[i] = sqrt(CAP(i));
+        d[i] = 0.0;
+        if (i > 0)
+        {
+            d[i] -= CONDLEFT(i)/CAP(i);
+        }
+        if (i < nn-1)
+        {
+            d[i] -= CONDRIGHT(i)/CAP(i);
+            e[i] = CONDRIGHT(i)/sqrt(CAP(i)*CAP(i+1));
+        }
+    }
+
+    /* only the rows of the port nodes are needed, the last row gives the 
+     * modal states of a wall with uniform temperature */
+    node[0] = 0;
+    node[1] = nn-1;
+    for (i = 0; i < NUMACTIVE; i++)
+    {
+        node[2+i] = ACTIVE(i);
+    }
+    for (i = 0; i < m; i++)
+    {
+        for (k = 0; k < nn; k++)
+        {
+            z[i*nn+k] = (k == node[i])? 1.0 : 0.0;
+        }
+    }
+    for (k = 0; k < nn; k++)
+    {
+        z[m*nn+k] = sc[k];
+    }
+    if (eigen_tridiagonal(d, e, z, (int)m+1, (int)nn) != 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < m; i++)     /* temperature of port node i in mode k */
+    {
+        for (k = 0; k < nn; k++)
+        {
+            z[i*nn+k] /= sc[node[i]];
+        }
+    }
+
+    lmax = 0.0;
+    for (k = 0; k < nn; k++)
+    {
+        lmax = max(lmax, fabs(d[k]));
+    }
+    r = 0;
+    for (k = 0; k < nn; k++)
+    {
+        keep[k] = (uint8_T)(fabs(d[k]) <= 1.0e-12*lmax);
+        dc[k] = (keep[k])? 0.0 : 1.0/fabs(d[k]);
+        r += keep[k];
+    }
+    for (i = 0; i < m; i++)
+    {
+        wsum[i] = 0.0;
+        for (k = 0; k < nn; k++)
+        {
+            wsum[i] += z[i*nn+k]*z[i*nn+k]*dc[k];
+        }
+        wneg[i] = wsum[i];
+    }
+
+    /* add the dominant modes until the tolerance is reached */
+    while (r < nn)
+    {
+        emax = 0.0;
+        for (i = 0; i < m; i++)
+        {
+            if (wsum[i] > 0.0)
+            {
+                emax = max(emax, wneg[i]/wsum[i]);
+            }
+        }
+        if (emax <= tol)
+        {
+            break;
+        }
+        kbest = -1;
+        wbest = -1.0;
+        for (k = 0; k < nn; k++)
+        {
+            if (!keep[k])
+            {
+                w = 0.0;
+                for (i = 0; i < m; i++)
+                {
+                    if (wsum[i] > 0.0)
+                    {
+                        w = max(w, z[i*nn+k]*z[i*nn+k]*dc[k]/wsum[i]);
+                    }
+                }
+                if (w > wbest)
+                {
+                    wbest = w;
+                    kbest = (int_T)k;
+                }
+            }
+        }
+        keep[kbest] = 1;
+        r++;
+        for (i = 0; i < m; i++)
+        {
+            wneg[i] -= z[i*nn+kbest]*z[i*nn+kbest]*dc[kbest];
+        }
+    }
+
+    if (lam != NULL)
+    {
+        j = 0;
+        for (k = 0; k < nn; k++)
+        {
+            if (keep[k])
+            {
+                lam[j] = d[k];
+                xi0[j] = TINI*z[m*nn+k];
+                for (i = 0; i < m; i++)
+                {
+                    vmode[j*m+i] = z[i*nn+k];
+                }
+                j++;
+            }
+        }
+        for (i = 0; i < m; i++)     /* lag for the neglected modes */
+        {
+            for (j = 0; j < m; j++)
+            {
+                lag[(2+j)*m+i] = 0.0;
+            }
+            w = 0.0;
+            for (k = 0; k < nn; k++)
+            {
+                if (!keep[k])
+                {
+                    for (j = 0; j < m; j++)
+                    {
+                        lag[(2+j)*m+i] += z[i*nn+k]*z[j*nn+k]*dc[k];
+                    }
+                    w += z[i*nn+k]*z[i*nn+k]*dc[k]*dc[k];
+                }
+            }
+            lag[i] = (lag[(2+i)*m+i] > 0.0)? w/lag[(2+i)*m+i] : 0.0;
+            lag[m+i] = 0.0;
+        }
+    }
+    return (int_T)r;
+}
+
+
 /* Function: mdlInitializeSizes ===============================================
  * Abstract:
  *   Setup sizes of the various vectors.
  */
 static void mdlInitializeSizes(SimStruct *S)
 {
-    ssSetNumSFcnParams(S, NPARAMS);
+    uint16_T nphi, ngam, nmode, nvec;
+    int_T    nr, i;
+    uint16_T nocells[1], active[MAXNODES], numactive[1];
+    real_T   cap[MAX_L], cond[MAX_L];
+    
+    if (ssGetSFcnParamsCount(S) == NPARAMS_MODETOL)
+    {
+        ssSetNumSFcnParams(S, NPARAMS_MODETOL);
+    }
+    else if (ssGetSFcnParamsCount(S) == NPARAMS_TSAMPLE)
+    {
+        ssSetNumSFcnParams(S, NPARAMS_TSAMPLE);
+    }
+    else
+    {
+        ssSetNumSFcnParams(S, NPARAMS);
+    }
 #if defined(MATLAB_MEX_FILE)
     if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
 	{
@@ -299,9 +641,61 @@ static void mdlInitializeSizes(SimStruct *S)
         return; /* Parameter mismatch will be reported by Simulink */
     }
 #endif
+    /* the number of states depends on the sample time and the tolerance,
+     * the nodes on the layers (not the initial temperature) */
+    ssSetSFcnParamTunable(S, 0, SS_PRM_NOT_TUNABLE);
+    for (i = 2; i < NPARAMS; i++)
+    {
+        ssSetSFcnParamTunable(S, i, SS_PRM_NOT_TUNABLE);
+    }
+    if (ssGetSFcnParamsCount(S) >= NPARAMS_TSAMPLE)
+    {
+        ssSetSFcnParamTunable(S, 7, SS_PRM_NOT_TUNABLE);
+    }
+    if (ssGetSFcnParamsCount(S) >= NPARAMS_MODETOL)
+    {
+        ssSetSFcnParamTunable(S, 8, SS_PRM_NOT_TUNABLE);
+    }
 
-    ssSetNumContStates(S, MAX_L);  /* number of continuous states */
-    ssSetNumDiscStates(S, 0);      /* number of discrete states */
+    if (MODETOL > 0.0)
+    {   /* reduced model: the number of modes is needed for the states */
+        layerwall_geometry(S, nocells, active, cap, cond, numactive);
+        if (ssGetErrorStatus(S) != NULL)
+        {
+            return;
+        }
+        nr = layerwall_modes(S, nocells, active, cap, cond, numactive, NULL, NULL, NULL, NULL);
+        if (nr < 0)
+        {
+            ssSetErrorStatus(S, "Error in wall: eigenvalues for the reduced model did not converge.");
+            return;
+        }
+        nr += 2+numactive[0];   /* one lag per port node */
+        ssSetNumContStates(S, (TSAMPLE > 0.0)? 0 : nr);
+        ssSetNumDiscStates(S, (TSAMPLE > 0.0)? nr : 0);
+        nphi = (uint16_T)nr;    /* exp(lambda*ts) of the modes */
+        ngam = (uint16_T)nr;    /* integral of exp(lambda*t) */
+        nvec = 1;
+        nmode = (uint16_T)nr;
+    }
+    else if (TSAMPLE > 0.0)
+    {   /* discrete model: matrices for the actual number of nodes */
+        ssSetNumContStates(S, 0);
+        ssSetNumDiscStates(S, MAX_DNODES);
+        nphi = MAX_DNODES*MAX_DNODES;
+        ngam = MAX_DNODES*(uint16_T)(2+NDEPTH);
+        nvec = nphi;
+        nmode = 1;
+    }
+    else
+    {
+        ssSetNumContStates(S, MAX_L);  /* number of continuous states */
+        ssSetNumDiscStates(S, 0);      /* number of discrete states */
+        nphi = 1;
+        ngam = 1;
+        nvec = 1;
+        nmode = 1;
+    }
 
     if (!ssSetNumInputPorts(S, 3))
 	{
@@ -331,7 +725,7 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumNonsampledZCs(S, 0);
 	
 	
-	ssSetNumDWork(S, 5);
+	ssSetNumDWork(S, 12);
     ssSetDWorkWidth(S, DWORK_NONODES_NO, 1);
     ssSetDWorkDataType(S, DWORK_NONODES_NO, SS_UINT16);
     ssSetDWorkName(S, DWORK_NONODES_NO, "DWORK_NONODES");
@@ -352,6 +746,34 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetDWorkDataType(S, DWORK_NUMACTIVE_NO, SS_UINT16);
     ssSetDWorkName(S, DWORK_NUMACTIVE_NO, "DWORK_NUMACTIVE");
     ssSetDWorkUsageType(S, DWORK_NUMACTIVE_NO, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_PHI_NO, nphi);
+    ssSetDWorkDataType(S, DWORK_PHI_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_PHI_NO, "DWORK_PHI");
+    ssSetDWorkUsageType(S, DWORK_PHI_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_GAMMA_NO, ngam);
+    ssSetDWorkDataType(S, DWORK_GAMMA_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_GAMMA_NO, "DWORK_GAMMA");
+    ssSetDWorkUsageType(S, DWORK_GAMMA_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_EIGVEC_NO, nvec);
+    ssSetDWorkDataType(S, DWORK_EIGVEC_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_EIGVEC_NO, "DWORK_EIGVEC");
+    ssSetDWorkUsageType(S, DWORK_EIGVEC_NO, SS_DWORK_USED_AS_SCRATCH);
+    ssSetDWorkWidth(S, DWORK_VMODE_NO, nmode*(uint16_T)(2+NDEPTH));
+    ssSetDWorkDataType(S, DWORK_VMODE_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_VMODE_NO, "DWORK_VMODE");
+    ssSetDWorkUsageType(S, DWORK_VMODE_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_LAMBDA_NO, nmode);
+    ssSetDWorkDataType(S, DWORK_LAMBDA_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_LAMBDA_NO, "DWORK_LAMBDA");
+    ssSetDWorkUsageType(S, DWORK_LAMBDA_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_XI0_NO, nmode);
+    ssSetDWorkDataType(S, DWORK_XI0_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_XI0_NO, "DWORK_XI0");
+    ssSetDWorkUsageType(S, DWORK_XI0_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_LAG_NO, (nmode > 1)? (4+(int_T)NDEPTH)*(2+(int_T)NDEPTH) : 1);
+    ssSetDWorkDataType(S, DWORK_LAG_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_LAG_NO, "DWORK_LAG");
+    ssSetDWorkUsageType(S, DWORK_LAG_NO, SS_DWORK_USED_AS_DWORK);
 
     /* Take care when specifying exception free code - see sfuntmpl.doc */
     /* ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE); */
@@ -364,211 +786,214 @@ static void mdlInitializeSizes(SimStruct *S)
 
 /* Function: mdlInitializeSampleTimes =========================================
  * Abstract:
- *    Specifiy that we inherit our sample time from the driving block.
+ *    Continuous model or discrete model with the sample time TSAMPLE.
  */
 static void mdlInitializeSampleTimes(SimStruct *S)
 {
-    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    if (TSAMPLE > 0.0)
+    {
+        ssSetSampleTime(S, 0, TSAMPLE);
+    }
+    else
+    {
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    }
     ssSetOffsetTime(S, 0, 0.0);
 }
 
 
-#define MDL_INITIALIZE_CONDITIONS
-/* Function: mdlInitializeConditions ========================================
+/* Function: layerwall_discretise =============================================
  * Abstract:
- *    Initialize both states to one
+ *    Transition matrix PHI and input matrix GAMMA of the discrete model
+ *    from the eigenvalues of the symmetric node matrix.
  */
-static void mdlInitializeConditions(SimStruct *S)
+static void layerwall_discretise(SimStruct *S)
 {
-    real_T *x0   = ssGetContStates(S);
-    real_T t0    = TINI;
-	
 	uint16_T *dwork_nocells    = (uint16_T *)ssGetDWork(S, DWORK_NONODES_NO);
 	uint16_T *dwork_active     = (uint16_T *)ssGetDWork(S, DWORK_ACTIVE_NO);
+	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
 	real_T   *dwork_cap        = (real_T   *)ssGetDWork(S, DWORK_CAP_NO);
 	real_T   *dwork_cond       = (real_T   *)ssGetDWork(S, DWORK_COND_NO);
-	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
+	real_T   *phi              = (real_T   *)ssGetDWork(S, DWORK_PHI_NO);
+	real_T   *gam              = (real_T   *)ssGetDWork(S, DWORK_GAMMA_NO);
+	real_T   *v                = (real_T   *)ssGetDWork(S, DWORK_EIGVEC_NO);
 
-    real_T   *dnode    = mxGetPr(S_DNODE);
-    real_T   *cond     = mxGetPr(S_COND);
-    real_T   *cwall    = mxGetPr(S_CWALL);
-    real_T   *rho      = mxGetPr(S_RHO);
-    real_T   *depth    = mxGetPr(S_DEPTH);
-
-    uint16_T numlayer,
-		     StartCell,
-			 EndCell,
-			 j, i, n;
-          
-    real_T delx,				/* distance between two nodes */
-           celldepth[MAXNODES], /* position of the cell */
-           k[MAX_L],			/* heat transfer by conduction in W/m/K */
-           c[MAX_L],			/* heat capacity of a layer per surface in J/m*/
-           MatLambda1[MAX_L],	/* thermal conductivity of each node; beginning and ending with 0.0 for the boundary */
-           MatCap1[MAX_L],		/* heat capacity of each sublayer */
-           MatCap[MAX_L];		/* heat capacity for each node */
-		   
-	uint16_T m[MAX_L]; 			/* number of sub layers per layer */
-
-    numlayer = (uint16_T)NDNODE; /* number of major layers */
-	
-	/* no active layer if depth of active layer < 0*/
-    if (depth[0] < 0.0)
-	{
-        NUMACTIVE=0;
-	}
-	else
-	{
-		NUMACTIVE = (uint16_T)NDEPTH;
-	}
-	
-    /* layer capacities, layer resistances und layer conductivities:*/
-	NONODES = 0;
-    for (j = 0;j<numlayer;j++)
+    real_T ts = TSAMPLE;
+    real_T d[MAX_L],            /* diagonal, eigenvalues after eigen_tridiagonal */
+           e[MAX_L],            /* off-diagonal */
+           sc[MAX_L],           /* square root of capacity */
+           ex[MAX_L],           /* exp(lambda*ts) */
+           g[MAX_L],            /* integral of exp(lambda*t) from 0 to ts */
+           lt, sum;
+    uint16_T node[MAXNODES+2];  /* node of each input */
+    uint16_T nn = NONODES, i, j, k, col;
+
+    /* symmetric matrix C^1/2 * A * C^-1/2 */
+    for (i = 0; i < nn; i++)
     {
-        /* m is the number of nodes per layer, equation from Feist */
-        m[j] = (uint16_T)(ceil(sqrt(rho[j]*cwall[j] / (2.0*cond[j]*TAU)) * dnode[j]) + 0.1);
-        if (m[j] < 1)
-		{
-           m[j] = 1;
-		}
-        else if (m[j] > MAX_LAYERS)
-		{
-           m[j] = MAX_LAYERS;
-		}
-        
-        c[j] = rho[j]*cwall[j]*dnode[j]/(2.0*(double)m[j]); /* thermal capacity of node (half at each surface node) C = d*rho*cp */
-        k[j] = cond[j]*(double)m[j]/dnode[j];               /* heat transfer by conduction */
-		NONODES = NONODES + m[j];							/* number of nodes increase by number of sublayers per layer */
-    }
-	NONODES = NONODES + 1; /* we have one node more than layers */
-     
-    /* depth of cells from upper surface*/
-    celldepth[0] = 0.0;
-    n = 1;
-    for (i=0; i<numlayer; i++)
-    {
-		for (j=1; j<=m[i]; j++)
-		{
-			celldepth[n] = celldepth[n-1]+dnode[i]/(double)m[i];
-            n++;
+        sc[i] = sqrt(CAP(i));
+        d[i] = 0.0;
+        if (i > 0)
+        {
+            d[i] -= CONDLEFT(i)/CAP(i);
+        }
+        if (i < nn-1)
+        {
+            d[i] -= CONDRIGHT(i)/CAP(i);
+            e[i] = CONDRIGHT(i)/sqrt(CAP(i)*CAP(i+1));
         }
     }
-     
+    for (i = 0; i < nn; i++)
+    {
+        for (j = 0; j < nn; j++)
+        {
+            v[i*nn+j] = (i == j)? 1.0 : 0.0;
+        }
+    }
+    if (eigen_tridiagonal(d, e, v, (int)nn, (int)nn) != 0)
+    {
+        ssSetErrorStatus(S, "Error in wall: eigenvalues for the discrete model did not converge.");
+        return;
+    }
 
-    /* occupy elements of "MatCap" */
-	for(j=0; j<NONODES; j++)
+    for (k = 0; k < nn; k++)
     {
-        MatCap1[j] = 0.0;
-        MatCap[j] = 0.0;
-        MatLambda1[j] = 0.0;
+        lt = d[k]*ts;
+        ex[k] = exp(lt);
+        /* (exp(lambda*ts)-1)/lambda, ts for the eigenvalue 0 of an adiabatic wall */
+        g[k] = (fabs(lt) < 1.0e-8)? ts*(1.0+0.5*lt) : (ex[k]-1.0)/d[k];
     }
-	MatLambda1[NONODES] = 0.0;
- 
-    /* set initial MatCap for all (SUB-)LAYERS (i.e. NONODES-1)
-	 * j is the number of the main layer, whereas i is the number of the sublayers.
-	 * Afterwards, only the sublayers will be processed.
-	 */
-    StartCell = 0;
-    for (j=0; j<numlayer; j++)
+
+    /* PHI = C^-1/2 * V * exp(lambda*ts) * V' * C^1/2 */
+    for (i = 0; i < nn; i++)
     {
-        EndCell = StartCell + m[j]-1; /* -1: The layer starts with the current element */
-     
-        for (i = StartCell; i<=EndCell; i++)
+        for (j = 0; j < nn; j++)
         {
-            MatCap1[i] = c[j];
+            sum = 0.0;
+            for (k = 0; k < nn; k++)
+            {
+                sum += v[i*nn+k]*ex[k]*v[j*nn+k];
+            }
+            phi[i*nn+j] = sum*sc[j]/sc[i];
         }
+    }
 
-        StartCell = EndCell + 1;
+    /* GAMMA: inputs are q_outside (first node), q_inside (last node) and 
+     * the powers of the active layers, B = C^-1 at the input node */
+    node[0] = 0;
+    node[1] = nn-1;
+    for (i = 0; i < NUMACTIVE; i++)
+    {
+        node[2+i] = ACTIVE(i);
     }
-	
+    for (col = 0; col < 2+NUMACTIVE; col++)
+    {
+        j = node[col];
+        for (i = 0; i < nn; i++)
+        {
+            sum = 0.0;
+            for (k = 0; k < nn; k++)
+            {
+                sum += v[i*nn+k]*g[k]*v[j*nn+k];
+            }
+            gam[col*nn+i] = sum/(sc[i]*sc[j]);
+        }
+    }
+}
 
-    /* occupy elements of "MatLambda" for each LAYER plus the boundary:
-	 * MatLambda1 has two elements more than MatCap1:
-	 * Additional to each layer one element on the right and one on the left side (0.0)
-	 * will be added. This is the thermal conductivity from left and from right.
-	 */
-     StartCell = 1;
-     for (j=0; j<numlayer; j++) 
-     {
-        EndCell = StartCell + (int_T)m[j];
-        for (i = StartCell; i<EndCell; i++)
-		{
-			MatLambda1[i] = k[j];
-		}
 
-        StartCell = i;
-     }
-     MatLambda1[StartCell] = 0.0;
+#define MDL_START
+/* Function: mdlStart =======================================================
+ * Abstract:
+ *    Geometry of the wall and matrices of the discrete model.
+ */
+static void mdlStart(SimStruct *S)
+{
+	uint16_T *dwork_nocells    = (uint16_T *)ssGetDWork(S, DWORK_NONODES_NO);
+	uint16_T *dwork_active     = (uint16_T *)ssGetDWork(S, DWORK_ACTIVE_NO);
+	real_T   *dwork_cap        = (real_T   *)ssGetDWork(S, DWORK_CAP_NO);
+	real_T   *dwork_cond       = (real_T   *)ssGetDWork(S, DWORK_COND_NO);
+	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
+	real_T   *phi              = (real_T   *)ssGetDWork(S, DWORK_PHI_NO);
+	real_T   *gam              = (real_T   *)ssGetDWork(S, DWORK_GAMMA_NO);
+	real_T   *vmode            = (real_T   *)ssGetDWork(S, DWORK_VMODE_NO);
+	real_T   *lam              = (real_T   *)ssGetDWork(S, DWORK_LAMBDA_NO);
+	real_T   *xi0              = (real_T   *)ssGetDWork(S, DWORK_XI0_NO);
+	real_T   *lag              = (real_T   *)ssGetDWork(S, DWORK_LAG_NO);
+    real_T   ts = TSAMPLE, lt;
+    int_T    k, nr;
 
-     /*which of the layers are active layers? store in ACTIVE(...)
-			 insert new nodes if necessary */
-    j = 0;
-    for (i=0; i<NUMACTIVE; i++)
+    layerwall_geometry(S, dwork_nocells, dwork_active, dwork_cap, dwork_cond, dwork_numactive);
+    if (ssGetErrorStatus(S) != NULL)
     {
-        /* find the cell, where to place the active layer */
-		while (depth[i] > celldepth[j])
-		{
-			j++;
-		}		
-		ACTIVE(i) = j;
-        
-        /* if we have an active layer, we have to decide if the active layer become layer j, layer j-1 or if we have to add one layer */
-		if (fabs(depth[i] - celldepth[j])<DBL_EPSILON)
-		{ /* nothing else to do, we are exactly at the right position */
-			continue;
-		}
-        else if (depth[i]-celldepth[j-1] > DMAX_ACTIVE_LAYER_TO_NODE)
+        return;
+    }
+    if (MODETOL > 0.0)
+    {   /* reduced model: the modes are decoupled, discrete model per mode */
+        nr = layerwall_modes(S, dwork_nocells, dwork_active, dwork_cap, dwork_cond, 
+            dwork_numactive, lam, vmode, xi0, lag);
+        if (nr < 0)
+        {
+            ssSetErrorStatus(S, "Error in wall: eigenvalues for the reduced model did not converge.");
+            return;
+        }
+        if (ts > 0.0)
         {
-            if (celldepth[j]-depth[i] > DMAX_ACTIVE_LAYER_TO_NODE)
+            for (k = 0; k < nr; k++)
             {
-                /* Insert a new node for the active layer at curent position */
-                
-                /* shift elements after current position to the right */
-				for (n=NONODES+1;n>=j;n--)
-                {
-                    celldepth[n+1] = celldepth[n];
-                    MatCap1[n+1] = MatCap1[n];
-                    MatLambda1[n+1] = MatLambda1[n];
-                }
-				NONODES++;
-				if (NONODES > MAX_L-2)
-				{
-					ssSetErrorStatus(S, "Error in wall: number of layers exeeded due to active layers!");
-					return;
-				}
-                
-                celldepth[j] = depth[i]; /* insert element at current position*/
-                delx = (depth[i]-celldepth[j-1])/(celldepth[j+1]-celldepth[j-1]);
-                MatCap1[j] = MatCap1[j-1]*(1.0-delx); /*distribute capacity on two nodes*/
-                MatCap1[j-1] = MatCap1[j-1]-MatCap1[j];
-                MatLambda1[j] = 1.0/(delx/MatLambda1[j+1]); /* distribute lambda on two nodes */
-                MatLambda1[j+1] = 1.0/(1.0/MatLambda1[j+1] - 1.0/MatLambda1[j]);
+                lt = lam[k]*ts;
+                phi[k] = exp(lt);
+                gam[k] = (fabs(lt) < 1.0e-8)? ts*(1.0+0.5*lt) : (phi[k]-1.0)/lam[k];
+            }
+            for (k = 0; k < 2+NUMACTIVE; k++)
+            {
+                LAGPHI(k) = (LAGTAU(k) > 0.0)? exp(-ts/LAGTAU(k)) : 0.0;
             }
         }
-        else
-		{
-			ACTIVE(i)=j-1;
-		}
     }
+    else if (ts > 0.0)
+    {
+        layerwall_discretise(S);
+    }
+}
 
-    /* create final MatCap by summing up capacities of inner nodes */
-    /* i.e. except first and last element*/
-    MatCap[0] = MatCap1[0];
-    for (j=1;j<NONODES-1;j++)
-	{
-        MatCap[j] = MatCap1[j-1]+MatCap1[j];
-	}
-	MatCap[NONODES-1] = MatCap1[NONODES-2];
-	
-	for(j=0; j<NONODES; j++)
-	{
-		CAP(j) = MatCap[j];
-		COND(j) = MatLambda1[j];
-	}
-	COND(NONODES) = MatLambda1[NONODES];
 
-    for (n = 0; n <NDNODE*MAX_LAYERS; n++)
+#define MDL_INITIALIZE_CONDITIONS
+/* Function: mdlInitializeConditions ========================================
+ * Abstract:
+ *    Initialize the node temperatures with TINI
+ */
+static void mdlInitializeConditions(SimStruct *S)
+{
+    real_T t0    = TINI;
+    real_T *x0;
+    real_T *xi0  = (real_T *)ssGetDWork(S, DWORK_XI0_NO);
+    uint16_T n, nx;
+
+	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
+
+    if (MODETOL > 0.0)
+    {   /* reduced model: modal states of the uniform temperature TINI, 
+         * lags start at 0 */
+        x0 = (TSAMPLE > 0.0)? ssGetRealDiscStates(S) : ssGetContStates(S);
+        nx = (uint16_T)((TSAMPLE > 0.0)? ssGetNumDiscStates(S) : ssGetNumContStates(S));
+        for (n = 0; n < nx; n++)
+        {
+            x0[n] = (n < nx-2-NUMACTIVE)? xi0[n] : 0.0;
+        }
+        return;
+    }
+    if (TSAMPLE > 0.0)
+    {
+        x0 = ssGetRealDiscStates(S);
+        nx = MAX_DNODES;
+    }
+    else
+    {
+        x0 = ssGetContStates(S);
+        nx = (uint16_T)(NDNODE*MAX_LAYERS);
+    }
+    for (n = 0; n < nx; n++)
 	{
         x0[n] = t0;             /* state-vector is initialized with TINI */ 
 	}		
@@ -583,13 +1008,36 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     real_T   *y0   = ssGetOutputPortRealSignal(S, 0);
     real_T   *y1   = ssGetOutputPortRealSignal(S, 1);
     real_T   *y2   = ssGetOutputPortRealSignal(S, 2);
-    real_T   *Tn   = ssGetContStates(S);
+    real_T   *Tn   = (TSAMPLE > 0.0)? ssGetRealDiscStates(S) : ssGetContStates(S);
 
 	uint16_T *dwork_nocells    = (uint16_T *)ssGetDWork(S, DWORK_NONODES_NO);
 	uint16_T *dwork_active     = (uint16_T *)ssGetDWork(S, DWORK_ACTIVE_NO);
 	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
+	real_T   *vmode            = (real_T   *)ssGetDWork(S, DWORK_VMODE_NO);
    
-    uint16_T n;
+    uint16_T n, k, nr;
+    real_T   Tport[MAXNODES+2];
+
+    if (MODETOL > 0.0)
+    {   /* reduced model: port temperatures from the modes */
+        nr = (uint16_T)((TSAMPLE > 0.0)? ssGetNumDiscStates(S) : ssGetNumContStates(S));
+        nr = nr-2-NUMACTIVE;    /* number of modes, followed by the lags */
+        for (n = 0; n < 2+NUMACTIVE; n++)
+        {
+            Tport[n] = Tn[nr+n];
+            for (k = 0; k < nr; k++)
+            {
+                Tport[n] += VMODE(n,k)*Tn[k];
+            }
+        }
+        y0[0] = Tport[0];
+        for (n = 0; n < NUMACTIVE; n++)
+        {
+            y1[n] = Tport[2+n];
+        }
+        y2[0] = Tport[1];
+        return;
+    }
 
     y0[0] = Tn[0];                   	/* temperature first node */
     for (n = 0; n < NUMACTIVE; n++) 	/* all node temperatures for active layers */
@@ -620,10 +1068,48 @@ static void mdlDerivatives(SimStruct *S)
 	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
 	real_T   *dwork_cap        = (real_T   *)ssGetDWork(S, DWORK_CAP_NO);
 	real_T   *dwork_cond       = (real_T   *)ssGetDWork(S, DWORK_COND_NO);
+	real_T   *vmode            = (real_T   *)ssGetDWork(S, DWORK_VMODE_NO);
+	real_T   *lam              = (real_T   *)ssGetDWork(S, DWORK_LAMBDA_NO);
+	real_T   *lag              = (real_T   *)ssGetDWork(S, DWORK_LAG_NO);
     
     real_T qinside   = Q_INSIDE;
     real_T qoutside  = Q_OUTSIDE;
-    uint16_T  n;
+    real_T uport[MAXNODES+2], sum;
+    uint16_T  n, k, nr;
+
+    if (ssGetNumContStates(S) == 0)     /* discrete model */
+    {
+        return;
+    }
+    
+    if (MODETOL > 0.0)
+    {   /* reduced model: decoupled modes and lags */
+        uport[0] = qoutside;
+        uport[1] = qinside;
+        for (n = 0; n < NUMACTIVE; n++)
+        {
+            uport[2+n] = POWER_PER_NODE(n);
+        }
+        nr = (uint16_T)ssGetNumContStates(S)-2-NUMACTIVE;
+        for (k = 0; k < nr; k++)
+        {
+            dTdt[k] = lam[k]*Tn[k];
+            for (n = 0; n < 2+NUMACTIVE; n++)
+            {
+                dTdt[k] += VMODE(n,k)*uport[n];
+            }
+        }
+        for (n = 0; n < 2+NUMACTIVE; n++)
+        {
+            sum = 0.0;
+            for (k = 0; k < 2+NUMACTIVE; k++)
+            {
+                sum += LAGGAIN(n,k)*uport[k];
+            }
+            dTdt[nr+n] = (LAGTAU(n) > 0.0)? (sum-Tn[nr+n])/LAGTAU(n) : 0.0;
+        }
+        return;
+    }
 
     /* loop over all nodes */
     for (n=0; n<NONODES; n++)   
@@ -669,6 +1155,84 @@ static void mdlDerivatives(SimStruct *S)
 
 
 
+#define MDL_UPDATE
+/* Function: mdlUpdate ======================================================
+ * Abstract:
+ *      discrete model: x(k+1) = PHI*x(k) + GAMMA*u(k)
+ */
+static void mdlUpdate(SimStruct *S, int_T tid)
+{
+    real_T            *Tn   = ssGetRealDiscStates(S);
+    InputRealPtrsType u0    = ssGetInputPortRealSignalPtrs(S, 0);
+    InputRealPtrsType u1    = ssGetInputPortRealSignalPtrs(S, 1);
+    InputRealPtrsType u2    = ssGetInputPortRealSignalPtrs(S, 2);
+	
+	uint16_T *dwork_nocells    = (uint16_T *)ssGetDWork(S, DWORK_NONODES_NO);
+	uint16_T *dwork_numactive  = (uint16_T *)ssGetDWork(S, DWORK_NUMACTIVE_NO);
+	real_T   *phi              = (real_T   *)ssGetDWork(S, DWORK_PHI_NO);
+	real_T   *gam              = (real_T   *)ssGetDWork(S, DWORK_GAMMA_NO);
+	real_T   *vmode            = (real_T   *)ssGetDWork(S, DWORK_VMODE_NO);
+	real_T   *lag              = (real_T   *)ssGetDWork(S, DWORK_LAG_NO);
+
+    real_T   Tnew[MAX_L], uport[MAXNODES+2], sum;
+    uint16_T nn = NONODES, i, j, n, nr;
+
+    if (TSAMPLE <= 0.0)         /* continuous model */
+    {
+        return;
+    }
+
+    if (MODETOL > 0.0)
+    {   /* reduced model: x(k+1) = exp(lambda*ts)*x(k) + g*b'*u(k) per mode */
+        uport[0] = Q_OUTSIDE;
+        uport[1] = Q_INSIDE;
+        for (n = 0; n < NUMACTIVE; n++)
+        {
+            uport[2+n] = POWER_PER_NODE(n);
+        }
+        nr = (uint16_T)ssGetNumDiscStates(S)-2-NUMACTIVE;
+        for (i = 0; i < nr; i++)
+        {
+            sum = 0.0;
+            for (n = 0; n < 2+NUMACTIVE; n++)
+            {
+                sum += VMODE(n,i)*uport[n];
+            }
+            Tn[i] = phi[i]*Tn[i] + gam[i]*sum;
+        }
+        for (n = 0; n < 2+NUMACTIVE; n++)
+        {
+            sum = 0.0;
+            for (j = 0; j < 2+NUMACTIVE; j++)
+            {
+                sum += LAGGAIN(n,j)*uport[j];
+            }
+            Tn[nr+n] = LAGPHI(n)*Tn[nr+n] + (1.0-LAGPHI(n))*sum;
+        }
+        return;
+    }
+
+    for (i = 0; i < nn; i++)
+    {
+        sum = gam[i]*Q_OUTSIDE + gam[nn+i]*Q_INSIDE;
+        for (n = 0; n < NUMACTIVE; n++)
+        {
+            sum += gam[(2+n)*nn+i]*POWER_PER_NODE(n);
+        }
+        for (j = 0; j < nn; j++)
+        {
+            sum += phi[i*nn+j]*Tn[j];
+        }
+        Tnew[i] = sum;
+    }
+    for (i = 0; i < nn; i++)
+    {
+        Tn[i] = Tnew[i];
+    }
+}
+
+
+
 /* Function: mdlTerminate =====================================================
  * Abstract:
  *    No termination needed, but we are required to have this routine.
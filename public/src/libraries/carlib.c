@@ -151,6 +151,46 @@
  * 6.3.1    hf      added equation thermal conductivity for silicon 15nov2016
  *                  oil from H.Teichmann, FHD
  *                  added values for WATER_CONSTANT and AIR_CONSTANT
+ * 6.3.2    hf      added solve_tridiagonal                         19oct2026
+ * 6.3.3    hf      added eigen_tridiagonal                         19oct2026
+ * 6.3.4    hf      eigen_tridiagonal for selected rows of the      19oct2026
+ *                  eigenvector matrix
+ * 6.3.5    hf      added wall_nodes (node model of layerwall)      19oct2026
+ * 6.3.6    hf      added solar_ephemeris: declination, equation    19oct2026
+ *                  of time and extraterrestrial radiation
+ *                  interpolated from a table over one year,
+ *                  used by solar_position, solar_declination,
+ *                  solar_time and extraterrestrial_radiation
+ * 6.3.7    hf      added sky_coefficients, sky_coefficients_batch  19oct2026
+ *                  and sky_diffuse: isotropic, Hay Davies and
+ *                  Perez sky model with the Perez coefficients
+ *                  in a table
+ * 6.3.8    hf      added solar_ephemeris_batch and                 19oct2026
+ *                  solar_position_batch for time series
+ * 6.3.9    hf      added radiation_diagnostics(_batch): direct /   19oct2026
+ *                  diffuse split and cloud index from one solar
+ *                  position
+ * 6.3.10   hf      added sky_temperature and sky_temperature_batch 19oct2026
+ * 6.3.11   hf      added weather_variability: sub-hourly factors   19oct2026
+ *                  of radiation and temperature
+ * 6.3.12   hf      solar_position, solar_declination, solar_time   19oct2026
+ *                  and extraterrestrial_radiation exact again,
+ *                  ephemeris table only in solar_ephemeris and
+ *                  the batch functions, filled once (thread safe)
+ * 6.3.13   hf      weather_variability: direct radiation of sunny  19oct2026
+ *                  steps limited to clear sky, remainder in the
+ *                  covered steps
+ * 6.3.14   hf      added storage_nodes: slices of a cylindrical    19oct2026
+ *                  storage (storage_Tnodes, storage_Tadaptive)
+ * 6.3.15   hf      solar_ephemeris_batch and solar_position_batch  19oct2026
+ *                  evaluate the Spencer series for each time,
+ *                  same results as the scalar functions
+ * 6.3.16   hf      radiation_diagnostics_batch with the exact      19oct2026
+ *                  solar ephemeris (same as radiation_diagnostics)
+ * 6.3.17   hf      radiation_diagnostics: cloud fraction as        19oct2026
+ *                  diag[6]
+ * 6.3.18   hf      ephemeris table removed, solar_ephemeris        19oct2026
+ *                  evaluates the Spencer series
  *
  * 2do:
  *    - include pressure in properties of air
@@ -239,6 +279,318 @@ void solve_quadratic_equation(double *x12, double a, double b, double c)
 } /* end solve_quadratic_equation */
 
 
+/*
+ * solve a tridiagonal linear equation system (Thomas algorithm)
+ *
+ * Syntax : solve_tridiagonal(x, a, b, c, d, n)
+ *          x is the solution vector of size n
+ *          a is the lower diagonal, a[0] is not used
+ *          b is the main diagonal, overwritten during the calculation
+ *          c is the upper diagonal, c[n-1] is not used
+ *          d is the right hand side, overwritten during the calculation
+ *          n is the number of equations
+ *  a[i]*x[i-1] + b[i]*x[i] + c[i]*x[i+1] = d[i]
+ *  No pivoting is done, the matrix must be diagonally dominant, which is
+ *  the case for the implicit discretisation of heat conduction problems.
+ *  x may point to the same memory as d.
+ */
+void solve_tridiagonal(double *x, const double *a, double *b,
+    const double *c, double *d, int n)
+{
+    int    i;
+    double w;
+
+    /* forward elimination */
+    for (i = 1; i < n; i++)
+    {
+        w = a[i]/b[i-1];
+        b[i] -= w*c[i-1];
+        d[i] -= w*d[i-1];
+    }
+
+    /* back substitution */
+    x[n-1] = d[n-1]/b[n-1];
+    for (i = n-2; i >= 0; i--)
+    {
+        x[i] = (d[i]-c[i]*x[i+1])/b[i];
+    }
+} /* end solve_tridiagonal */
+
+
+/*
+ * eigenvalues and eigenvectors of a symmetric tridiagonal matrix 
+ * (QL algorithm with implicit shifts)
+ *
+ * Syntax : eigen_tridiagonal(d, e, z, nz, n)
+ *          d is the main diagonal, on return the eigenvalues
+ *          e is the off-diagonal, e[i] couples i and i+1, e[n-1] is not
+ *            used, overwritten during the calculation
+ *          z is a nz*n matrix (row k at z[k*n]) which is multiplied by 
+ *            the eigenvector matrix V. With z set to the identity matrix
+ *            (nz = n) z[i*n+k] is element i of the normalised 
+ *            eigenvector k on return. With selected rows of the identity
+ *            only these elements of the eigenvectors are calculated.
+ *          nz is the number of rows of z
+ *          n is the size of the matrix
+ *  returns 0, or -1 if the iteration did not converge
+ *  Literature: Press, W.H. et al.: Numerical Recipes in C, 2nd ed., 
+ *              Cambridge University Press 1992, chap. 11.3
+ */
+int eigen_tridiagonal(double *d, double *e, double *z, int nz, int n)
+{
+    int    l, m, i, k, iter;
+    double s, r, p, g, f, dd, c, b;
+
+    e[n-1] = 0.0;
+
+    for (l = 0; l < n; l++)
+    {
+        iter = 0;
+        do
+        {
+            /* look for a small off-diagonal element to split the matrix */
+            for (m = l; m < n-1; m++)
+            {
+                dd = fabs(d[m])+fabs(d[m+1]);
+                if (fabs(e[m]) <= DBL_EPSILON*dd)
+                {
+                    break;
+                }
+            }
+            if (m != l)
+            {
+                if (iter++ == 30)
+                {
+                    return -1;              /* too many iterations */
+                }
+                g = (d[l+1]-d[l])/(2.0*e[l]);
+                r = sqrt(g*g+1.0);
+                g = d[m]-d[l]+e[l]/(g+((g >= 0.0)? r : -r));
+                s = c = 1.0;
+                p = 0.0;
+                for (i = m-1; i >= l; i--)
+                {
+                    f = s*e[i];
+                    b = c*e[i];
+                    r = sqrt(f*f+g*g);
+                    e[i+1] = r;
+                    if (r == 0.0)           /* recover from underflow */
+                    {
+                        d[i+1] -= p;
+                        e[m] = 0.0;
+                        break;
+                    }
+                    s = f/r;
+                    c = g/r;
+                    g = d[i+1]-p;
+                    r = (d[i]-g)*s+2.0*c*b;
+                    p = s*r;
+                    d[i+1] = g+p;
+                    g = c*r-b;
+                    for (k = 0; k < nz; k++) /* eigenvectors */
+                    {
+                        f = z[k*n+i+1];
+                        z[k*n+i+1] = s*z[k*n+i]+c*f;
+                        z[k*n+i] = c*z[k*n+i]-s*f;
+                    }
+                }
+                if (r == 0.0 && i >= l)
+                {
+                    continue;
+                }
+                d[l] -= p;
+                e[l] = g;
+                e[m] = 0.0;
+            }
+        } while (m != l);
+    }
+    return 0;
+} /* end eigen_tridiagonal */
+
+
+/*
+ * nodes of a multilayer wall according to the Beuken model (layerwall)
+ *
+ * Syntax : n = wall_nodes(dnode, cond, cwall, rho, nlayer, depth, ndepth,
+ *                  tau, maxsub, maxnodes, cap, lam, active, work)
+ *          dnode, cond, cwall, rho: thickness [m], conductivity [W/(m*K)],
+ *            heat capacity [J/(kg*K)] and density [kg/m^3] of the layers
+ *          nlayer is the number of layers
+ *          depth: depth of the active layers in m, increasing
+ *          ndepth is the number of active layers (0 for none)
+ *          tau: time constant for the subdivision of the layers in s
+ *          maxsub is the maximum number of sublayers per layer
+ *          maxnodes is the maximum number of nodes
+ *          cap returns the capacity of the nodes in J/(m^2*K) 
+ *            (maxnodes elements)
+ *          lam returns the conduction between node i-1 and i in 
+ *            W/(m^2*K), lam[0] = lam[n] = 0 (maxnodes+1 elements)
+ *          active returns the node of each active layer
+ *          work is a work array of 3*(maxnodes+3) elements
+ *  returns the number of nodes n, or -1 if maxnodes is exceeded
+ *  An additional node is inserted if an active layer is more than 
+ *  WALL_DMAX_ACTIVE from the next node.
+ */
+#define WALL_DMAX_ACTIVE    0.00999     /* max. distance of active layer to node in m */
+
+int wall_nodes(const double *dnode, const double *cond, const double *cwall,
+    const double *rho, int nlayer, const double *depth, int ndepth, double tau,
+    int maxsub, int maxnodes, double *cap, double *lam, int *active, double *work)
+{
+    double *celldepth = work;                   /* position of the nodes */
+    double *cap1 = work+maxnodes+3;             /* capacity of the sublayers */
+    double *lam1 = work+2*(maxnodes+3);         /* conduction, 0 at the boundaries */
+    double c, k, delx;
+    int    nonodes, m, i, j, n;
+
+    for (i = 0; i < 3*(maxnodes+3); i++)
+    {
+        work[i] = 0.0;
+    }
+
+    /* sublayers, equation from Feist */
+    nonodes = 0;
+    celldepth[0] = 0.0;
+    for (j = 0; j < nlayer; j++)
+    {
+        m = (cond[j] > 0.0)? (int)(ceil(sqrt(rho[j]*cwall[j]/(2.0*cond[j]*tau))*dnode[j]) + 0.1) : maxsub;
+        if (m < 1)
+        {
+            m = 1;
+        }
+        else if (m > maxsub)
+        {
+            m = maxsub;
+        }
+        if (nonodes+m+1 > maxnodes)
+        {
+            return -1;
+        }
+        c = rho[j]*cwall[j]*dnode[j]/(2.0*(double)m); /* half capacity of the sublayer at each node */
+        k = cond[j]*(double)m/dnode[j];               /* conduction of the sublayer */
+        for (i = 0; i < m; i++)
+        {
+            cap1[nonodes] = c;
+            lam1[nonodes+1] = k;
+            celldepth[nonodes+1] = celldepth[nonodes]+dnode[j]/(double)m;
+            nonodes++;
+        }
+    }
+    nonodes++;                  /* one node more than sublayers */
+
+    /* nodes of the active layers, insert a new node if necessary */
+    j = 0;
+    for (i = 0; i < ndepth; i++)
+    {
+        while (depth[i] > celldepth[j])
+        {
+            j++;
+        }
+        active[i] = j;
+        if (fabs(depth[i]-celldepth[j]) < DBL_EPSILON)
+        {
+            continue;           /* exactly on the node */
+        }
+        else if (depth[i]-celldepth[j-1] > WALL_DMAX_ACTIVE)
+        {
+            if (celldepth[j]-depth[i] > WALL_DMAX_ACTIVE)
+            {
+                if (nonodes+1 > maxnodes)
+                {
+                    return -1;
+                }
+                for (n = nonodes+1; n >= j; n--)    /* shift right */
+                {
+                    celldepth[n+1] = celldepth[n];
+                    cap1[n+1] = cap1[n];
+                    lam1[n+1] = lam1[n];
+                }
+                nonodes++;
+                celldepth[j] = depth[i];
+                delx = (depth[i]-celldepth[j-1])/(celldepth[j+1]-celldepth[j-1]);
+                cap1[j] = cap1[j-1]*(1.0-delx);     /* distribute capacity on two nodes */
+                cap1[j-1] = cap1[j-1]-cap1[j];
+                lam1[j] = 1.0/(delx/lam1[j+1]);     /* distribute resistance on two nodes */
+                lam1[j+1] = 1.0/(1.0/lam1[j+1]-1.0/lam1[j]);
+            }
+        }
+        else
+        {
+            active[i] = j-1;    /* previous node is close enough */
+        }
+    }
+
+    /* capacity of the nodes: half of the sublayers on both sides */
+    cap[0] = cap1[0];
+    for (j = 1; j < nonodes-1; j++)
+    {
+        cap[j] = cap1[j-1]+cap1[j];
+    }
+    cap[nonodes-1] = cap1[nonodes-2];
+    for (j = 0; j <= nonodes; j++)
+    {
+        lam[j] = lam1[j];
+    }
+    return nonodes;
+} /* end wall_nodes */
+
+
+/*
+ * horizontal slices of a cylindrical storage tank (storage_Tnodes, 
+ * storage_Tadaptive)
+ *
+ * Syntax : dh = storage_nodes(vol, dia, uloss, ubot, utop, nodes, 
+ *                  standing, vnode, loss)
+ *          vol: volume in m^3, dia: diameter in m
+ *          uloss, ubot, utop: heat loss coefficient of the side wall, 
+ *            the bottom and the top in W/(m^2*K)
+ *          nodes is the number of slices, slice 0 is at the bottom
+ *          standing: 1 for a vertical cylinder, 0 for a lying cylinder
+ *            (the losses of the side wall and the ends are distributed 
+ *            equally, ubot and utop are not used)
+ *          vnode returns the volume of the slices in m^3
+ *          loss returns the heat loss of the slices in W/(m^3*K)
+ *  returns the height of one slice in m
+ */
+double storage_nodes(double vol, double dia, double uloss, double ubot, 
+                     double utop, int nodes, int standing, double *vnode, 
+                     double *loss)
+{
+    int    n;
+    double dh, aloss, h1, a1, a2;
+
+    if (standing)                           /* vertical cylinder */
+    {
+        dh = 4.0*vol/(PI*dia*dia*(double)nodes);
+        aloss = PI*dia*dh;
+        for (n = 0; n < nodes; n++)
+        {
+            vnode[n] = vol/(double)nodes;
+            loss[n] = uloss*aloss/vnode[n];
+        }
+        loss[nodes-1] += utop/dh;           /* extra losses of top */
+        loss[0] += ubot/dh;                 /* extra losses of bottom */
+    }
+    else                                    /* lying cylinder */
+    {
+        dh = dia/(double)nodes;
+        aloss = (4.0*vol/dia + 0.5*PI*dia*dia)/(double)nodes;
+        h1 = 0.0;
+        a1 = 0.0;
+        for (n = 0; n < nodes; n++)
+        {
+            h1 = min(h1+dh, dia);           /* avoid sqrt(<0) by rounding in the top slice */
+            a2 = a1;                        /* cross section below the slice */
+            a1 = 0.5*(0.25*dia*dia*2.0*acos(1.0-2.0*h1/dia)
+                - 2.0*sqrt(dia*h1-h1*h1)*(0.5*dia-h1));
+            vnode[n] = (a1-a2)*4.0*vol/(PI*dia*dia);
+            loss[n] = uloss*aloss/vnode[n];
+        }
+    }
+    return dh;
+} /* end storage_nodes */
+
+
 
 /********************************************************************** 
  *                         solar calculation
@@ -302,6 +654,56 @@ void solar_position(real_T *solpos, real_T time, real_T latitude,
     solpos[4] = woz;
 } /* end of function solar_position */
 
+/* Spencer series of the equation of time in s, the declination in radian
+ * and the extraterrestrial radiation in W/m^2
+ * equations from Duffie, Beckman: Solar Engineering of Thermal Processes, 2006
+ * (original source Spencer 1971)
+ * b = 2*pi*time/(365*24*3600), so the series are periodic with 365 days.
+ */
+static double spencer_equation_of_time(double b)
+{
+    return 13752.0*(0.000075 + 0.001868*cos(b) - 0.032077*sin(b)  /* 229.2*60 = 13752 */
+        - 0.014615*cos(2.0*b) - 0.04089*sin(2.0*b));
+}
+
+static double spencer_declination(double b)
+{
+    return 0.006918 - 0.399912*cos(b) + 0.070257*sin(b)
+        - 0.006758*cos(2.0*b) + 0.000907*sin(2.0*b)
+        - 0.002679*cos(3.0*b) + 0.00148*sin(3.0*b);
+}
+
+static double spencer_extraterrestrial(double b)
+{
+    return 1367.0 * (1.00011 + 0.034221*cos(b) + 0.001280*sin(b)
+        + 0.000719*cos(2.0*b) + 0.000077*sin(2.0*b));
+}
+
+/* solar ephemeris from one evaluation of the Spencer series, the results
+ * are the same as solar_declination, solar_time and 
+ * extraterrestrial_radiation
+ * inputs:
+ *  time            : legal time in s, January 1st at 0:00 is 0 s
+ *  timezone        : reference longitude (timezone)
+ *  longitude       : geographical longitude [-180,180], West positive
+ *
+ * outputs: eph is a pointer to double of size 3
+ *  eph[0]: solar declination angle in radian, North positive
+ *  eph[1]: solar time 0 .. 24*3600 s (see solar_time)
+ *  eph[2]: extraterrestrial radiation in W/m^2 on a normal surface
+ */
+void solar_ephemeris(double *eph, double time, double timezone, double longitude)
+{
+    double b = 1.992384990861107e-7*time;
+    int    time_in_days = ((int)(time/SECONDSPERDAY));
+
+    eph[0] = spencer_declination(b);
+    /*          240 s for 1 (24*3600 for 360) */
+    eph[1] = spencer_equation_of_time(b) + 240.0*(timezone-longitude) 
+        + (time - (SECONDSPERDAY*(double)time_in_days));
+    eph[2] = spencer_extraterrestrial(b);
+}
+
 /* solar time 0 .. 24*3600 s
  * equation from Duffie, Beckman: Solar Engineering of Thermal Processes, 2006
  * (original source Spencer 1971) 
@@ -313,8 +715,7 @@ double solar_time(double time, double timezone, double longitude)
 
     time_in_days = ((int)(time/SECONDSPERDAY));
     b = 1.992384990861107e-7*time;
-    e = 13752.0*(0.000075 + 0.001868*cos(b) - 0.032077*sin(b)    /* 229.2*60 = 13752 */
-        - 0.014615*cos(2.0*b) - 0.04089*sin(2.0*b));
+    e = spencer_equation_of_time(b);
     
     /*          240 s for 1 (24*3600 for 360) */
     return (e + 240.0*(timezone-longitude) + (time - (SECONDSPERDAY*(double)time_in_days)));
@@ -326,12 +727,7 @@ double solar_time(double time, double timezone, double longitude)
  */
 double solar_declination(double time)
 {
-    double b;
-    b = 1.992384990861107e-7*time;
-    b = 0.006918 - 0.399912*cos(b) + 0.070257*sin(b)
-        - 0.006758*cos(2.0*b) + 0.000907*sin(2.0*b)
-        - 0.002679*cos(3.0*b) + 0.00148*sin(3.0*b);
-    return b;
+    return spencer_declination(1.992384990861107e-7*time);
 }
 
 /* solar extraterrestrial radiation in W/m^2 on a normal surface
@@ -340,11 +736,594 @@ double solar_declination(double time)
  */
 double extraterrestrial_radiation(double time)
 {
-    double b;
-    b = 1.992384990861107e-7*time;
-    b = 1367.0 * (1.00011 + 0.034221*cos(b) + 0.001280*sin(b) 
-        + 0.000719*cos(2.0*b) + 0.000077*sin(2.0*b));
-    return b;
+    return spencer_extraterrestrial(1.992384990861107e-7*time);
+}
+
+/* solar ephemeris and solar position for a time series
+ * The Spencer series are evaluated for each time, the site terms are 
+ * calculated once. The results are the same (bit by bit) as the scalar
+ * functions solar_declination, solar_time, extraterrestrial_radiation
+ * and solar_position. The loop only reads shared data and is split on 
+ * the threads if compiled with OpenMP (for more than SOLAR_BATCH_SERIAL 
+ * values).
+ */
+#define SOLAR_BATCH_SERIAL  20000
+
+/* inputs:
+ *  n               : number of time values
+ *  time            : legal time in s, January 1st at 0:00 is 0 s
+ *  timezone        : reference longitude (timezone)
+ *  longitude       : geographical longitude [-180,180], West positive
+ *
+ * outputs: vectors of size n, a NULL pointer skips the output
+ *  decl            : solar declination angle in radian, North positive
+ *  soltime         : solar time 0 .. 24*3600 s (see solar_time)
+ *  iextra          : extraterrestrial radiation in W/m^2 on a normal surface
+ */
+void solar_ephemeris_batch(double *decl, double *soltime, double *iextra, int n,
+    const double *time, double timezone, double longitude)
+{
+    double b, lshift = 240.0*(timezone-longitude);
+    int    i;
+
+#ifdef _OPENMP
+    #pragma omp parallel for private(b) schedule(static) if (n > SOLAR_BATCH_SERIAL)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        b = 1.992384990861107e-7*time[i];
+        if (decl)
+            decl[i] = spencer_declination(b);
+        if (soltime)
+            soltime[i] = spencer_equation_of_time(b)
+                + lshift + (time[i] - (SECONDSPERDAY*(double)((int)(time[i]/SECONDSPERDAY))));
+        if (iextra)
+            iextra[i] = spencer_extraterrestrial(b);
+    }
+}
+
+/* inputs:
+ *  n               : number of time values
+ *  time            : legal time in s, January 1st at 0:00 is 0 s
+ *  latitude        : gegraphical latitude [-90,90], North positive
+ *  longitude       : geographical longitude [-180,180], West positive
+ *  longitudenull   : reference longitude (timezone)
+ *
+ * outputs: vectors of size n, a NULL pointer skips the output
+ *  zenith          : zenith angle in radian
+ *  azimuth         : azimut angle in radian, 0 is South, West is positive
+ *  decl            : solar declination angle in radian, North positive
+ *  hourangle       : solar hour angle in radian, West positive
+ *  soltime         : true local time in s
+ */
+void solar_position_batch(real_T *zenith, real_T *azimuth, real_T *decl,
+    real_T *hourangle, real_T *soltime, int n, const real_T *time,
+    real_T latitude, real_T longitude, real_T longitudenull)
+{
+    double lati = DEG2RAD*latitude;
+    double slat = sin(lati), clat = cos(lati);
+    double lshift = 240.0*(longitudenull-longitude);
+    double b, delta, woz, ha, costetaz, tetaz, xx, az;
+    int    i;
+
+#ifdef _OPENMP
+    #pragma omp parallel for private(b, delta, woz, ha, costetaz, tetaz, xx, az) \
+        schedule(static) if (n > SOLAR_BATCH_SERIAL)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        b = 1.992384990861107e-7*time[i];
+        delta = spencer_declination(b);
+        woz = spencer_equation_of_time(b)
+            + lshift + (time[i] - (SECONDSPERDAY*(double)((int)(time[i]/SECONDSPERDAY))));
+        ha = (woz - 43200.0)*7.272205216643040e-5;
+        costetaz = (slat*sin(delta) + clat*cos(delta)*cos(ha));
+        tetaz = acos(costetaz);
+        xx = clat*sin(tetaz);
+        if (fabs(xx) > DBL_EPSILON)
+        {
+            az = acos((slat*costetaz-sin(delta))/xx);
+            az = (ha < 0.0)? -az : az;
+        }
+        else
+        {
+            az = 0.0;
+        }
+        if (zenith)
+            zenith[i] = tetaz;
+        if (azimuth)
+            azimuth[i] = az;
+        if (decl)
+            decl[i] = delta;
+        if (hourangle)
+            hourangle[i] = ha;
+        if (soltime)
+            soltime[i] = woz;
+    }
+}
+
+
+/* radiation diagnostics from the global radiation on the horizontal
+ * The solar position is calculated once and used for the direct / diffuse
+ * split of metrad_s and the cloud index of metcloud_s.
+ * inputs:
+ *  time            : legal time in s, January 1st at 0:00 is 0 s
+ *  iglob           : global radiation on horizontal in W/m^2
+ *  latitude        : gegraphical latitude [-90,90], North positive
+ *  longitude       : geographical longitude [-180,180], West positive
+ *  longitudenull   : reference longitude (timezone)
+ *  skytype         : type of sky for the cloud index, 1: high mountain,
+ *                    2: lowland, 3: urban region, 4: industrial zone,
+ *                    0: no cloud index
+ *
+ * outputs: diag is a pointer to double of size RAD_NDIAG
+ *  diag[0]: direct radiation on horizontal in W/m^2
+ *  diag[1]: diffuse radiation on horizontal in W/m^2, Orgill and Hollands
+ *           correlation from Duffie, Beckman (2006)
+ *  diag[2]: cloud index 0..1 (Kasten and Liu / Jordan clear sky model,
+ *           from Meliss 1993), -1 at night or for skytype 0
+ *  diag[3]: zenith angle in degree
+ *  diag[4]: azimut angle in degree, 0 is South, West is positive
+ *  diag[5]: altitude of the sun in degree, minimum 0.01
+ *  diag[6]: cloud fraction, ratio of global and clear sky radiation 0..1,
+ *           -1 at night or for skytype 0
+ */
+static void radiation_diagnostics_core(double *diag, const double *eph,
+    double iglob, double slat, double clat, int skytype)
+{
+    double delta, hourangle, coszenit, zenith, azimuth, sunangle, iextra,
+        clearindex, idir, idfu, trs, tab, tms, dimness, taudir, taudfu, iclear,
+        cloudfraction, cloudindex;
+    const double a = 0.75;          /* parameters of the cloud index */
+    const double b = 3.2;
+
+    delta = eph[0];
+    /* solar hour angle in radian (noon = 0,  6 a.m. = -PI) */
+    hourangle = (eph[1] - 43200.0)*7.272205216643040e-5;
+    coszenit = slat*sin(delta) + clat*cos(delta)*cos(hourangle);
+    zenith = acos(coszenit)*RAD2DEG;
+    if (zenith != 0.0 && zenith != 180.0)
+    {
+        azimuth = RAD2DEG*acos((slat*coszenit - sin(delta))/(clat*sin(acos(coszenit))));
+        if (hourangle < 0.0)
+            azimuth = -azimuth;
+    }
+    else
+        azimuth = 0.0;
+    sunangle = 90.0 - zenith;
+    if (sunangle < 0.01)
+        sunangle = 0.01;            /* avoids log(0) in the cloud index */
+    iextra = eph[2]*coszenit;       /* extraterrestrial radiation on horizontal */
+
+    /* direct and diffuse radiation, none at night or for negative input */
+    idir = 0.0;
+    idfu = 0.0;
+    if (iglob >= 0.0 && iextra > 0.0)
+    {
+        clearindex = min(1.0, iglob/iextra);
+        if (clearindex <= 0.35)
+            idfu = iglob * (1 - 0.249 * clearindex);
+        else if (clearindex <= 0.75)
+            idfu = iglob * (1.557 - 1.84 * clearindex);
+        else
+            idfu = iglob * 0.177;
+        idir = iglob - idfu;
+    }
+    diag[0] = idir;
+    diag[1] = idfu;
+    diag[3] = zenith;
+    diag[4] = azimuth;
+    diag[5] = sunangle;
+
+    /* cloud index from the clear sky radiation */
+    diag[2] = -1.0;
+    diag[6] = -1.0;
+    if (skytype <= 0 || iextra <= 0.0)
+        return;
+    /* transmission factors, fit of the tables in Meliss (1993) */
+    trs = 0.0101  + 0.4225*(1-exp(-sunangle/15.83705)) + 0.47249*(1+exp(-sunangle/1.56203));
+    tab = 0.01001 + 0.18336*(1-exp(-sunangle/10.72578)) + 0.71278*(1+exp(-sunangle/0.00125));
+    switch (skytype)
+    {
+        case 1: default:            /* high mountain */
+            tms = 0.01 + 0.41882*(1-exp(-sunangle/9.86609))
+                + 0.56058*(1+exp(-sunangle/0.02186));
+            break;
+        case 2:                     /* lowland */
+            tms = 0.01 + 0.66679*(1-exp(-sunangle/13.71293))
+                + 0.23729*(1+exp(-sunangle/0.02186));
+            break;
+        case 3:                     /* urban region */
+            tms = 0.01026 + 0.41079*(1-exp(-sunangle/32.42557))
+                + 0.44058*(1+exp(-sunangle/8.46267));
+            break;
+        case 4:                     /* industrial zone */
+            tms = -0.00021 + 0.38332*(1-exp(-sunangle/24.10493))
+                + 0.38343*(1+exp(-sunangle/24.25446));
+            break;
+    }
+    dimness = 1.0 + ((log(tms) + log(tab)) / log(trs));
+    taudir = exp(-dimness/(0.9 + 9.4 * coszenit));
+    taudfu = 0.2710 - 0.2939 * taudir;
+    iclear = iextra * taudir + iextra * taudfu;
+
+    cloudfraction = min(1.0, iglob/iclear);
+    diag[6] = cloudfraction;
+    cloudindex = pow((1.0/a * (1.0 - cloudfraction)), (1.0/b));
+    diag[2] = min(1.0, cloudindex);
+}
+
+void radiation_diagnostics(double *diag, double time, double iglob,
+    double latitude, double longitude, double longitudenull, int skytype)
+{
+    double eph[3];
+    double lati = DEG2RAD*latitude;
+
+    eph[0] = solar_declination(time);
+    eph[1] = solar_time(time, longitudenull, longitude);
+    eph[2] = extraterrestrial_radiation(time);
+    radiation_diagnostics_core(diag, eph, iglob, sin(lati), cos(lati), skytype);
+}
+
+/* radiation_diagnostics for a time series of one site
+ *  diag            : n*RAD_NDIAG values, the results of time[i] and
+ *                    iglob[i] start at diag + i*RAD_NDIAG
+ * The results are the same as radiation_diagnostics for each time. 
+ * Compiled with OpenMP the series is split on the threads for more than
+ * SOLAR_BATCH_SERIAL values.
+ */
+void radiation_diagnostics_batch(double *diag, int n, const double *time,
+    const double *iglob, double latitude, double longitude, double longitudenull,
+    int skytype)
+{
+    double lati = DEG2RAD*latitude;
+    double slat = sin(lati), clat = cos(lati);
+    double eph[3];
+    int    i;
+
+#ifdef _OPENMP
+    #pragma omp parallel for private(eph) schedule(static) if (n > SOLAR_BATCH_SERIAL)
+#endif
+    for (i = 0; i < n; i++)
+    {
+        eph[0] = solar_declination(time[i]);
+        eph[1] = solar_time(time[i], longitudenull, longitude);
+        eph[2] = extraterrestrial_radiation(time[i]);
+        radiation_diagnostics_core(diag + i*RAD_NDIAG, eph, iglob[i], slat, clat, skytype);
+    }
+}
+
+
+/* sky temperature in degree C
+ * with humidity: Berdahl, Martin (1984) for low clouds (1000 m), the dew
+ * point from VDI 3786 part 4 (1985), without humidity: Unsworth with the
+ * corrected parameters of Feist (1994)
+ *  tamb            : ambient temperature in degree C
+ *  hum             : relative humidity in %, <= 0 if unknown
+ *  cloud           : cloud index 0..1
+ *  costerm         : daily term of Berdahl, Martin 0.013*cos(hourangle),
+ *                    0 to neglect it
+ * The dew point is log(hum/100) + c2*tamb/(c3+tamb), so the saturation
+ * pressure is not needed.
+ */
+static double sky_temperature_core(double tamb, double hum, double cloud, double costerm)
+{
+    const double e = 0.885191547524961;     /* e = exp(-1000.0/8200.0) */
+    double tamb4, c2, c3, d, tdew, emis;
+
+    tamb4 = tamb + TA0;     /* ambient temperature in K */
+    tamb4 *= tamb4;
+    tamb4 *= tamb4;
+
+    if (hum > 0.0)          /* Berdahl, Martin */
+    {
+        if (tamb >= 0.0)
+        {
+            c2 = 17.08;
+            c3 = 234.18;
+        }
+        else
+        {
+            c2 = 17.84;
+            c3 = 245.43;
+        }
+        d = log(0.01*hum) + c2*tamb/(c3+tamb);
+        tdew = c3*d/(c2-d);
+        emis = 0.711 + 0.0056*tdew + 7.3e-5*tdew*tdew + costerm;
+        if (cloud < 1.0e-4)                 /* no clouds */
+            return pow(tamb4*emis, 0.25) - TA0;
+        return pow(tamb4*((1.0-emis)*cloud*e + emis), 0.25) - TA0;
+    }
+    /* no humidity: Unsworth */
+    if (cloud < 1.0e-4)                     /* no clouds */
+        return pow(-150.0/STEFAN_BOLTZMANN + 1.2*tamb4, 0.25) - TA0;
+    return pow(-150.0/STEFAN_BOLTZMANN*(1.0 - cloud*0.9)
+        + (1.2 - 0.2*cloud*0.9)*tamb4, 0.25) - TA0;
+}
+
+/* daily term of the sky emissivity of Berdahl, Martin from the time in s */
+static double sky_temperature_costerm(double time)
+{
+    int days = (int)(time/SECONDSPERDAY);
+    /* 360/(24*3600)*pi/180 = 15/3600*pi/180 = 7.272205216643040e-5 */
+    return 0.013*cos(7.272205216643040e-5*(time - SECONDSPERDAY*(double)days));
+}
+
+/* sky temperature in degree C (see sky_temperature_core)
+ *  time            : time in s, used for the daily term if costerm > 0
+ *  costerm         : 1 with, 0 without the daily term of Berdahl, Martin
+ */
+double sky_temperature(double tamb, double hum, double cloud, double time, int costerm)
+{
+    return sky_temperature_core(tamb, hum, cloud,
+        (costerm > 0)? sky_temperature_costerm(time) : 0.0);
+}
+
+/* sky temperature of a series, tsky[i] from tamb[i], hum[i], cloud[i] and
+ * time[i] (time may be NULL without the daily term). Compiled with OpenMP
+ * the series is split on the threads for more than SOLAR_BATCH_SERIAL
+ * values.
+ */
+void sky_temperature_batch(double *tsky, int n, const double *tamb, const double *hum,
+    const double *cloud, const double *time, int costerm)
+{
+    int i;
+
+    if (costerm > 0 && time == NULL)
+        costerm = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if (n > SOLAR_BATCH_SERIAL)
+#endif
+    for (i = 0; i < n; i++)
+        tsky[i] = sky_temperature_core(tamb[i], hum[i], cloud[i],
+            (costerm > 0)? sky_temperature_costerm(time[i]) : 0.0);
+}
+
+
+/* sub-hourly variability of weather data
+ * Random numbers: 32 bit hash of the seed and the hour as start of a
+ * xorshift generator, so the values of an hour do not depend on the
+ * hours calculated before (random access, same result for every solver).
+ */
+static unsigned int weather_hash(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+/* uniform random number in ]0,1[ */
+static double weather_uniform(unsigned int *state)
+{
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return ((double)x + 0.5)/4294967296.0;
+}
+
+/* normal distributed random number (Box-Muller) */
+static double weather_normal(unsigned int *state)
+{
+    double u1 = weather_uniform(state);
+    double u2 = weather_uniform(state);
+    return sqrt(-2.0*log(u1))*cos(2.0*PI*u2);
+}
+
+/* factors for the sub-hourly variability of one hour of weather data
+ * The sun is covered or not, the state is a Markov chain with the
+ * stationary probability fsun for sun. The probabilities of a change are
+ * (1-fsun)/tau from sun to covered and fsun/tau from covered to sun, so
+ * the mean duration of the sunny periods is tau/(1-fsun) and of the
+ * covered periods tau/fsun time steps (both tau*2 for fsun = 0.5).
+ * The direct radiation is higher when the sun is not covered, but at 
+ * most 1/fsun (the clear sky value), the remainder of the hour is given 
+ * to the covered steps (0 if the sunny steps reach the mean of the hour).
+ * The diffuse radiation is higher when the sun is covered. The factors 
+ * have the mean 1, the temperature deviation the mean 0 in each hour, so
+ * the hourly values of the weather data are kept when they are constant
+ * in the hour.
+ * inputs:
+ *  n               : number of time steps per hour (60 for minutes)
+ *  seed            : seed of the random numbers
+ *  hour            : number of the hour (e.g. floor(time/3600))
+ *  fsun            : direct radiation / clear sky direct radiation 0..1,
+ *                    used as fraction of time with sun
+ *  tau             : time constant of the sun / cover changes in steps
+ *  sigma_t         : standard deviation of the ambient temperature in K
+ * outputs: vectors of size n
+ *  fdir            : factor of the direct radiation
+ *  fdfu            : factor of the diffuse radiation
+ *  dtamb           : deviation of the ambient temperature in K
+ */
+void weather_variability(double *fdir, double *fdfu, double *dtamb, int n,
+    unsigned int seed, long hour, double fsun, double tau, double sigma_t)
+{
+    unsigned int state;
+    double psc, pcs, rho, rho2, x, y, sum, sumt, fsunny, fcovered;
+    int    i, sun, nsun, vary;
+
+    state = weather_hash(seed ^ weather_hash((unsigned int)hour + 0x9e3779b9U));
+    if (state == 0)
+        state = 1;
+    fsun = max(0.0, min(1.0, fsun));
+    tau = max(1.0, tau);
+    psc = (1.0-fsun)/tau;       /* probability sun -> covered */
+    pcs = fsun/tau;             /* probability covered -> sun */
+    rho = exp(-1.0/tau);        /* correlation of the fluctuations */
+    rho2 = sqrt(1.0 - rho*rho);
+
+    /* sun or covered */
+    sun = (weather_uniform(&state) < fsun)? 1 : 0;
+    nsun = 0;
+    for (i = 0; i < n; i++)
+    {
+        if (i > 0)
+        {
+            if (sun)
+                sun = (weather_uniform(&state) < psc)? 0 : 1;
+            else
+                sun = (weather_uniform(&state) < pcs)? 1 : 0;
+        }
+        fdir[i] = (double)sun;
+        nsun += sun;
+    }
+    vary = (nsun > 0 && nsun < n && fsun < 1.0)? 1 : 0;
+
+    /* diffuse radiation and temperature: correlated fluctuations */
+    x = weather_normal(&state);
+    y = weather_normal(&state);
+    sum = 0.0;
+    sumt = 0.0;
+    for (i = 0; i < n; i++)
+    {
+        if (i > 0)
+        {
+            x = rho*x + rho2*weather_normal(&state);
+            y = rho*y + rho2*weather_normal(&state);
+        }
+        fdfu[i] = max(0.0, 1.0 + 0.1*x + ((vary && fdir[i] > 0.0)? -0.1 : 0.1));
+        dtamb[i] = sigma_t*y;
+        sum += fdfu[i];
+        sumt += dtamb[i];
+    }
+    sum = (sum > 0.0)? (double)n/sum : 1.0;
+    sumt /= (double)n;
+    for (i = 0; i < n; i++)
+    {
+        fdfu[i] *= sum;
+        dtamb[i] -= sumt;
+    }
+
+    /* direct radiation: sunny steps at most clear sky (1/fsun) */
+    if (vary)
+    {
+        fsunny = min(1.0/fsun, (double)n/(double)nsun);
+        fcovered = ((double)n - fsunny*(double)nsun)/(double)(n - nsun);
+    }
+    else
+    {                           /* no variation of the direct radiation */
+        fsunny = 1.0;
+        fcovered = 1.0;
+    }
+    for (i = 0; i < n; i++)
+        fdir[i] = (fdir[i] > 0.0)? fsunny : fcovered;
+}
+
+
+/* sky models for the diffuse radiation on tilted surfaces
+ * The diffuse radiation (from sky and ground) on a surface is written for
+ * all sky models as
+ *      idfu_t = k[0] + k[1]*(1-cos(zc)) + k[2]*(1+cos(zc))
+ *             + k[3]*max(k[5],cos(teta)) + k[4]*sin(zc)
+ *  zc      inclination of the surface
+ *  teta    incidence angle of the sun on the surface
+ * The SKY_NCOEF coefficients k depend only on the sun and the sky, so
+ * they are calculated once per time step for all surfaces.
+ * Perez model: brightness coefficients from Duffie, Beckman (2006)
+ * referring to Perez (1990), one row per clearness bin.
+ */
+static const double perez_clearness[7] =
+    {1.065, 1.23, 1.5, 1.95, 2.8, 4.5, 6.2};
+static const double perez_f[8][6] = {
+    /*  f11     f12     f13     f21     f22     f23 */
+    {-0.008,  0.588, -0.062, -0.060,  0.072, -0.022},
+    { 0.130,  0.683, -0.151, -0.019,  0.066, -0.029},
+    { 0.330,  0.487, -0.221,  0.055, -0.064, -0.026},
+    { 0.568,  0.187, -0.295,  0.109, -0.152,  0.014},
+    { 0.873, -0.392, -0.362,  0.226, -0.462,  0.001},
+    { 1.132, -1.237, -0.412,  0.288, -0.823,  0.056},
+    { 1.060, -1.600, -0.359,  0.264, -1.127,  0.131},
+    { 0.678, -0.327, -0.250,  0.156, -1.377,  0.251}};
+#define COS85           0.08715574274765817 /* cos(85), lower limit of cos(zenith) */
+#define PEREZ_KAPPA     5.535e-6            /* for the zenith in degree */
+
+static void sky_coefficients_core(double *k, int skymodel, double zenith,
+    double idir_n, double idfu_h, double iextra_n, double greflect)
+{
+    double zs = DEG2RAD*zenith;
+    double czs = cos(zs);
+    double a, z3, clearness, brightness, F1, F2;
+    const double *f;
+    int j, bin;
+
+    k[0] = k[1] = k[2] = k[3] = k[4] = 0.0;
+    k[5] = -1.0;
+    if (czs < 1.0e-3)   /* no sun */
+        return;
+
+    k[1] = (idfu_h + idir_n*czs)*0.5*greflect;  /* reflected from ground */
+    switch (skymodel)
+    {
+        case 1:         /* isotropic sky model */
+            k[2] = 0.5*idfu_h;
+            break;
+        case 2:         /* Hay Davies sky model */
+            a = idir_n/iextra_n;                /* anisotropy index */
+            k[2] = 0.5*idfu_h*(1.0-a);
+            k[3] = idfu_h*a/czs;
+            break;
+        case 3:         /* Perez sky model */
+            z3 = PEREZ_KAPPA*zenith*zenith*zenith;
+            clearness = ((idfu_h + idir_n)/idfu_h + z3)/(1.0 + z3);
+            bin = 0;
+            for (j = 0; j < 7; j++)
+                bin += (clearness > perez_clearness[j]);
+            f = perez_f[bin];
+            brightness = idfu_h/(czs*iextra_n);
+            F1 = max(0.0, f[0] + f[1]*brightness + f[2]*zs);
+            F2 = f[3] + f[4]*brightness + f[5]*zs;
+            k[2] = 0.5*idfu_h*(1.0-F1);
+            k[3] = idfu_h*F1/max(COS85, czs);
+            k[4] = idfu_h*F2;
+            k[5] = 0.0;                         /* no circumsolar from behind */
+            break;
+        default:        /* no sky model */
+            k[0] = idfu_h;
+            break;
+    }
+}
+
+/* coefficients of the sky model for one time step
+ * inputs:
+ *  skymodel        : 1 isotropic, 2 Hay Davies, 3 Perez, else diffuse
+ *                    radiation on horizontal
+ *  zenith          : zenith angle of the sun in degree
+ *  idir_n          : direct normal radiation in W/m^2
+ *  idfu_h          : diffuse radiation on horizontal in W/m^2
+ *  iextra_n        : extraterrestrial radiation on normal in W/m^2
+ *  greflect        : ground reflectance
+ * outputs: k is a pointer to double of size SKY_NCOEF (all 0 at night)
+ */
+void sky_coefficients(double *k, int skymodel, double zenith,
+    double idir_n, double idfu_h, double iextra_n, double greflect)
+{
+    sky_coefficients_core(k, skymodel, zenith, idir_n, idfu_h, iextra_n, greflect);
+}
+
+/* coefficients of the sky model for n time steps, k has the size
+ * n*SKY_NCOEF, the coefficients of step i start at k[i*SKY_NCOEF]
+ */
+void sky_coefficients_batch(double *k, int n, int skymodel, const double *zenith,
+    const double *idir_n, const double *idfu_h, const double *iextra_n, double greflect)
+{
+    int i;
+    for (i = 0; i < n; i++)
+        sky_coefficients_core(k + i*SKY_NCOEF, skymodel, zenith[i], idir_n[i],
+            idfu_h[i], iextra_n[i], greflect);
+}
+
+/* diffuse radiation on a surface from the coefficients of sky_coefficients
+ *  czc, szc        : cosine and sine of the inclination of the surface
+ *  costeta         : cosine of the incidence angle on the surface
+ */
+double sky_diffuse(const double *k, double czc, double szc, double costeta)
+{
+    return k[0] + k[1]*(1.0-czc) + k[2]*(1.0+czc) + k[3]*max(k[5], costeta) + k[4]*szc;
 }
 
 
@@ -78,6 +78,31 @@
  *                  cs_energy_cogen commented out
  *  6.3.1   hf      cs_energy_cogen removed                       29nov2015
  *                  added declaration of solve_quadratic_equation 
+ *  6.3.2   hf      added solve_tridiagonal                       19oct2026
+ *  6.3.3   hf      added eigen_tridiagonal                       19oct2026
+ *  6.3.4   hf      eigen_tridiagonal for selected rows of the    19oct2026
+ *                  eigenvector matrix
+ *  6.3.5   hf      added wall_nodes (node model of layerwall)    19oct2026
+ *  6.3.6   hf      added solar_ephemeris                         19oct2026
+ *  6.3.7   hf      added sky_coefficients, sky_diffuse and       19oct2026
+ *                  sky_coefficients_batch
+ *  6.3.8   hf      added solar_ephemeris_batch and               19oct2026
+ *                  solar_position_batch
+ *  6.3.9   hf      added radiation_diagnostics and               19oct2026
+ *                  radiation_diagnostics_batch
+ *  6.3.10  hf      added sky_temperature and                     19oct2026
+ *                  sky_temperature_batch
+ *  6.3.11  hf      added weather_variability                     19oct2026
+ *  6.3.12  hf      solar_position etc. exact again, table only   19oct2026
+ *                  in solar_ephemeris and the batch functions
+ *  6.3.13  hf      weather_variability: direct radiation of      19oct2026
+ *                  sunny steps limited to clear sky
+ *  6.3.14  hf      added storage_nodes                           19oct2026
+ *  6.3.15  hf      solar_ephemeris_batch and                     19oct2026
+ *                  solar_position_batch exact
+ *  6.3.16  hf      radiation_diagnostics_batch exact             19oct2026
+ *  6.3.17  hf      RAD_NDIAG 7 (cloud fraction)                  19oct2026
+ *  6.3.18  hf      ephemeris table removed                       19oct2026
  */
  
 
@@ -103,6 +128,8 @@
 #define C_GRAVITATION           9.81                /* m/s                                         */
 #define SIGMA_STEFAN_BOLTZMANN  5.67e-8             /* W/(m^2 * K^4)                                */
 #define SECONDSPERDAY           86400.0             /* result of 365*24*3600                        */
+#define SKY_NCOEF               6                   /* coefficients of the sky model (sky_diffuse)  */
+#define RAD_NDIAG               7                   /* results of radiation_diagnostics             */
 
 #ifndef PI
     #ifdef M_PI
@@ -242,6 +269,9 @@ extern double heat_capacity(double, double, double, double);
 extern double heat_capacity_solid(double, double);
 extern double mixViscosity(double, double, double, double);
 extern double prandtl(double, double, double, double);
+extern void   radiation_diagnostics(double *, double, double, double, double, double, int);
+extern void   radiation_diagnostics_batch(double *, int, const double *, const double *,
+                                          double, double, double, int);
 extern double relativeHumidity2waterContent(double, double, double);
 extern double reynolds(double, double, double, double, double, double);
 extern double saturationproperty(double, double, double, double, double, double);
@@ -250,9 +280,28 @@ extern double square(double);
 extern double specific_volume (double, double, double, double);
 extern double saturationproperty(double, double, double, double, double, double);
 extern double solar_declination(double);
+extern void   solar_ephemeris(double *, double, double, double);
+extern void   solar_ephemeris_batch(double *, double *, double *, int, const double *,
+                                    double, double);
 extern double solar_time(double, double, double);
+extern void   sky_coefficients(double *, int, double, double, double, double, double);
+extern void   sky_coefficients_batch(double *, int, int, const double *, const double *, 
+                                     const double *, const double *, double);
+extern double sky_diffuse(const double *, double, double, double);
+extern double sky_temperature(double, double, double, double, int);
+extern void   sky_temperature_batch(double *, int, const double *, const double *,
+                                    const double *, const double *, int);
 extern void   solar_position(real_T *, real_T, real_T, real_T, real_T);
+extern void   solar_position_batch(real_T *, real_T *, real_T *, real_T *, real_T *, int,
+                                   const real_T *, real_T, real_T, real_T);
 extern void   solve_quadratic_equation(double *, double, double, double);
+extern void   solve_tridiagonal(double *, const double *, double *, const double *, double *, int);
+extern int    eigen_tridiagonal(double *, double *, double *, int, int);
+extern int    wall_nodes(const double *, const double *, const double *, const double *, int, 
+                  const double *, int, double, int, int, double *, double *, int *, double *);
+extern double storage_nodes(double, double, double, double, double, int, int, double *, double *);
+extern void   weather_variability(double *, double *, double *, int, unsigned int, long,
+                                  double, double, double);
 extern double thermal_conductivity_solid(double, double);
 extern double thermal_conductivity(double, double, double, double);
 extern double temperature_conductivity(double, double, double, double);
@@ -38,6 +38,8 @@
  * 0.01.0   Th. Wenzel  created M-script                        18oct99
  * 0.02.0   tw          created S-function                      25nov99
  * 3.1.0    hf          including Berdahl/Martin cos term       31dec2008
+ * 6.1.0    hf          sky temperature from carlib function    19oct2026
+ *                      sky_temperature
  *
  * Copyright (c) 1999 Solar-Institut Juelich, Germany
  * 
@@ -211,81 +213,10 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 {
     InputRealPtrsType   u1Ptrs  = ssGetInputPortRealSignalPtrs(S,0);
     real_T              *y1     = ssGetOutputPortRealSignal(S,0);
-    const real_T        e       = 0.885191547524961;                /* e = exp(-1000.0/8200.0) */
-    const real_T        c1      = 611.0;
-    real_T              time    = TIME;
-
-    real_T  sec, hum, Tamb, Tamb4, c2, c3, d , Tdew, ps, pd , temp;
-    int days;
-     
-    /* ------------------------------------------------------------------------------- 
-     	"Tdew"			Taupunkttemperatur 
-     	"Tsky"			Himmelstemperatur 
-    	"CloudIndex"	Bedeckungsgrad, Diskretisierung in Okta [0, 1/8, 2/8, ... ,8/8]
-     ------------------------------------------------------------------------------- */
-    
-    hum = HUM;              /* relative humidity in % */
-    Tamb  = TAMB;           /* ambient temperature in degree C */
-    Tamb4 = Tamb + TA0;     /* ambient temperature in K */
-    Tamb4 *= Tamb4;         /* Tamb^2 */
-    Tamb4 *= Tamb4;         /* Tamb^4 */
-
-    TSKY = 0;
-    
-    /* time of the day in seconds */
-    days = ((int)(time/SECONDSPERDAY));         /* determine time in days first */
-    sec = time - SECONDSPERDAY*(real_T)days;
-    
-    if (hum > 0)           /* measurement data for relative humidity are available */
-    {
-        if (Tamb >= 0.0)    /* if ambient temperature above zero */
-        {
-            c2 = 17.08;
-            c3 = 234.18;
-        }
-        else
-        {
-            c2 = 17.84;
-            c3 = 245.43;
-        }
-        
-        /* Sttigungsdampfdruck der Luft "ps" in Abh. von der Lufttemperatur "Tamb"*/
-        /* (nach VDI 3786 Blatt 4, 1985), mbar:                                    */
-        ps = c1 * exp( c2*Tamb/(c3+Tamb) );      
-        
-        /* Aktueller Dampfdruck der Luft "pd", mbar:                               */
-        pd = hum/100. * ps;
-        
-        /* Taupunkttemperatur "Tdew" (nach VDI 3786 Blatt 4, 1985):                */
-        d = log(pd/c1);
-        Tdew = c3*d /(c2-d);
-        
-        
-        /* Himmelstemperatur "Tsky" nach BERDAHL, Martin 1984 fr tiefe Wolken (1000 m) */
-        /* (OHNE cos-Term, s. Feist,1994,S.290ff):                                 */
-        temp = 0.711 + 0.0056*Tdew + 7.3e-5*Tdew*Tdew;
-
-        /* cos-Term if needed */
-        if (TSKYMODELL > 0.0)
-        {
-            temp += 0.013*cos(7.272205216643040e-5*sec);    
-            /* 360/(24*3600)*pi/180 = 15/3600*pi/180 = 7.272205216643040e-5 */
-        }
-        
-        if ((CLOUD) < 1.0e-4)                            /* no clouds */
-            TSKY = pow((Tamb4 * temp),0.25) - TA0;
-        else
-            TSKY = pow((Tamb4 * ((1-temp)*CLOUD*e + temp)),0.25) - TA0;
-    }   
-    else /* es liegen KEINE Feuchtewerte vor! -> Himmelstemperatur "Tsky" nach UNSWORTH*/
-    {                           
-        /* (mit korrigierten Parametern, s. Feist,1994,S.290ff):                  */
-        if ((CLOUD) < 1.0e-4)                            /* no clouds */
-            TSKY = pow(( -150./STEFAN_BOLTZMANN + 1.2 *Tamb4 ),0.25) - TA0;
-        else
-            TSKY = pow(( -150./STEFAN_BOLTZMANN * (1.0 - CLOUD*0.9) + 
-                 (1.2 - 0.2*CLOUD*0.9)*Tamb4 ),0.25) - TA0;
-    }
+    int                 costerm = (TSKYMODELL > 0.0)? 1 : 0;
+
+    /* Berdahl, Martin with humidity, Unsworth without humidity (carlib) */
+    TSKY = sky_temperature(TAMB, HUM, CLOUD, TIME, costerm);
 } /* end mdloutputs */
 
 
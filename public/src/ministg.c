@@ -46,6 +46,12 @@
  * 6.0.0    aw              converted to level 2 S-function         11aug15
  *                          SimStateCompiliance and
  *                          MultipleExecInstances activated
+ * 6.1.0    hf              states ordered by node (banded),        19oct26
+ *                          analytic Jacobian, property cache,
+ *                          optional batch of NUNITS units,
+ *                          one input port (as in the library block)
+ * 6.1.1    hf              property cache keyed on the exact           19oct26
+ *                          temperatures and pressures
  *
  * Copyright (c) 1998 Solar-Institut Juelich, Germany
  * 
@@ -81,6 +87,30 @@
  *  t           time                                            s
  *  U           heat loss coefficient                           W/(m^2*K)
  *	Vnode       node volume                                     m^3
+ *
+ * ----- state vector -----
+ * The four temperatures of a node (hot side, heat transfer surface, cold
+ * side, wall) are neighbours in the state vector, node after node. A node
+ * is only coupled to its own temperatures and to the node before in flow
+ * direction, so the Jacobian is a band matrix with 4 subdiagonals. 
+ * The analytic Jacobian is given in mdlJacobian (sparse, 20*NODES+6 
+ * elements per unit), stiff solvers (ode15s, ode23t) do not need to 
+ * calculate it by finite differences.
+ *
+ * ----- material properties -----
+ * The material properties are taken at the temperatures of the last node. 
+ * They are kept in a cache (DWork) with the temperatures, pressures and
+ * fluids they were calculated for, so mdlOutputs, mdlDerivatives and
+ * mdlJacobian at the same state calculate them only once. The cache is
+ * keyed on the exact values: the derivatives are a function of states
+ * and inputs only, not of the history of the solver calls.
+ *
+ * ----- batch of units -----
+ * With the optional parameter NUNITS (after NODES) one block calculates
+ * NUNITS mini storages with the same parameters, e.g. the heat exchangers
+ * of the flat stations in a building. Input and output vectors are the
+ * vectors of the single units one after the other (input width
+ * 13*NUNITS, output width 4*NUNITS).
  *         
  * structure of u (input vector)
  *  see defines below
@@ -139,28 +169,32 @@
 #define DPTCOLD  (*mxGetPr(ssGetSFcnParam(S, 18))) /* dp linear temperature dependance */
 #define NODES    (*mxGetPr(ssGetSFcnParam(S, 19))) /* number of nodes */
 #define N_PARAMETER                  20
+/* optional parameter */
+#define NUNITS   ((ssGetSFcnParamsCount(S) > N_PARAMETER)? \
+    (int_T)(*mxGetPr(ssGetSFcnParam(S, 20))+0.5) : 1) /* number of units */
+#define N_PARAMETER_BATCH            21
 
 #define LAST_NODE  (nodes-1) /* index of last node */
 #define FIRST_NODE 0         /* index of first node */
 
-#define THOT      x[n]           /* node temperature (T) hot side */
-#define THOTBACK  x[n-1]         /* T at node backwards in flowdirection */
-#define THOTNEXT  x[n+1]         /* T next node in flowdirection */
-#define DTDTHOT   dx[n]          /* dT/dt hot side */
-#define TSURF     x[nodes+n]     /* T heat transfer surface */
-#define TSURFBACK x[nodes+n-1]   /* T surface one node backwards */
-#define TSURFNEXT x[nodes+n+1]   /* T surface next node */
-#define DTDTSURF  dx[nodes+n]    /* dT/dt surface */
-#define TCOLD     x[2*nodes+n]   /* T cold side */
-#define TCOLDBACK x[2*nodes+n-1] /* T cold one node backwards */
-#define TCOLDNEXT x[2*nodes+n+1] /* T cold next node */
-#define DTDTCOLD  dx[2*nodes+n]  /* dT/dt cold side */
-#define TWALL     x[3*nodes+n]   /* T wall */
-#define TWALLBACK x[3*nodes+n-1] /* T wall one node backwards */
-#define TWALLNEXT x[3*nodes+n+1] /* T wall next node */
-#define DTDTWALL  dx[3*nodes+n]  /* dT/dt wall */
+/* states of one node are neighbours: x[4*n+0..3] (x points to the unit) */
+#define N_NODESTATES 4
+#define IHOT       0
+#define ISURF      1
+#define ICOLD      2
+#define IWALL      3
+#define THOT      x[N_NODESTATES*n+IHOT]        /* node temperature (T) hot side */
+#define THOTBACK  x[N_NODESTATES*(n-1)+IHOT]    /* T at node backwards in flowdirection */
+#define DTDTHOT   dx[N_NODESTATES*n+IHOT]       /* dT/dt hot side */
+#define TSURF     x[N_NODESTATES*n+ISURF]       /* T heat transfer surface */
+#define DTDTSURF  dx[N_NODESTATES*n+ISURF]      /* dT/dt surface */
+#define TCOLD     x[N_NODESTATES*n+ICOLD]       /* T cold side */
+#define TCOLDBACK x[N_NODESTATES*(n-1)+ICOLD]   /* T cold one node backwards */
+#define DTDTCOLD  dx[N_NODESTATES*n+ICOLD]      /* dT/dt cold side */
+#define TWALL     x[N_NODESTATES*n+IWALL]       /* T wall */
+#define DTDTWALL  dx[N_NODESTATES*n+IWALL]      /* dT/dt wall */
                              
-/* define inputs for easy access to u-vector */
+/* define inputs for easy access to u-vector (u points to the unit) */
 #define TAMB       (*u[0])      /* ambient temperature */
 #define FLOW_ID_H  (*u[1])      /* flow id hot side */
 #define TINHOT     (*u[2])      /* inlet temperature hot side */
@@ -175,8 +209,99 @@
 #define FLUID_ID_C (*u[11])     /* fluid ID (defined in CARNOT.h) */
 #define PERCENT_C  (*u[12])     /* mixture  (defined in CARNOT.h) */
 #define N_INPUTS     13
+#define N_OUTPUTS    4
+
+/* property cache in DWork, one block of N_PROP values per unit */
+#define DWORK_PROP_NR   0
+#define N_PROP          16
+#define KEY_THOT        prop[0]     /* temperature of the hot side properties */
+#define KEY_TCOLD       prop[1]     /* temperature of the cold side properties */
+#define KEY_TSURF       prop[2]     /* temperature of the surface properties */
+#define KEY_TWALL       prop[3]     /* temperature of the wall properties */
+#define KEY_FLUID_H     prop[4]
+#define KEY_MIX_H       prop[5]
+#define KEY_PRESS_H     prop[6]
+#define KEY_FLUID_C     prop[7]
+#define KEY_MIX_C       prop[8]
+#define KEY_PRESS_C     prop[9]
+#define RHOHOT          prop[10]    /* density hot side */
+#define RHOCOLD         prop[11]    /* density cold side */
+#define CAPHOT          prop[12]    /* heat capacity of the hot side fluid J/K */
+#define CAPCOLD         prop[13]    /* heat capacity of the cold side fluid J/K */
+#define CAPSURF         prop[14]    /* heat capacity of the heat transfer surface J/K */
+#define CAPWALL         prop[15]    /* heat capacity of the wall J/K */
+#define NO_KEY          -1.0e10     /* cache is empty */
+
+/* number of nonzero elements in the Jacobian of one unit */
+#define JAC_NZ(nodes)   (20*(nodes)+6)
 
 
+/*
+ * get_properties - material properties of one unit from the cache,
+ * the cache is refreshed when temperature, fluid or pressure changed
+ */
+static real_T *get_properties(SimStruct *S, int_T unit, const real_T *x, InputRealPtrsType u)
+{
+    real_T *prop = (real_T *)ssGetDWork(S, DWORK_PROP_NR) + N_PROP*unit;
+    int_T  nodes = (int_T)NODES;
+    int_T  n = LAST_NODE;
+    real_T cp;
+
+    if (THOT != KEY_THOT || FLUID_ID_H != KEY_FLUID_H 
+        || PERCENT_H != KEY_MIX_H || PRESSHOT != KEY_PRESS_H)
+    {
+        KEY_THOT = THOT;
+        KEY_FLUID_H = FLUID_ID_H;
+        KEY_MIX_H = PERCENT_H;
+        KEY_PRESS_H = PRESSHOT;
+        RHOHOT = density(FLUID_ID_H, PERCENT_H, THOT, PRESSHOT);
+        cp = heat_capacity(FLUID_ID_H, PERCENT_H, THOT, PRESSHOT);
+        CAPHOT = V_HOT*cp*RHOHOT;
+    }
+    if (TCOLD != KEY_TCOLD || FLUID_ID_C != KEY_FLUID_C 
+        || PERCENT_C != KEY_MIX_C || PRESSCOLD != KEY_PRESS_C)
+    {
+        KEY_TCOLD = TCOLD;
+        KEY_FLUID_C = FLUID_ID_C;
+        KEY_MIX_C = PERCENT_C;
+        KEY_PRESS_C = PRESSCOLD;
+        RHOCOLD = density(FLUID_ID_C, PERCENT_C, TCOLD, PRESSCOLD);
+        cp = heat_capacity(FLUID_ID_C, PERCENT_C, TCOLD, PRESSCOLD);
+        CAPCOLD = V_COLD*cp*RHOCOLD;
+    }
+    if (TSURF != KEY_TSURF)
+    {
+        KEY_TSURF = TSURF;
+        CAPSURF = MASS*FRAC_IN*heat_capacity_solid(MATERIAL, TSURF);
+    }
+    if (TWALL != KEY_TWALL)
+    {
+        KEY_TWALL = TWALL;
+        CAPWALL = MASS*(1.0-FRAC_IN)*heat_capacity_solid(MATERIAL, TWALL);
+    }
+    return prop;
+}
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+/*
+ * mdlCheckParameters - validate the parameters
+ */
+static void mdlCheckParameters(SimStruct *S)
+{
+    if (NODES < 1.0)
+    {
+        ssSetErrorStatus(S, "ministg: number of nodes must be >= 1");
+        return;
+    }
+    if (NUNITS < 1)
+    {
+        ssSetErrorStatus(S, "ministg: number of units must be >= 1");
+        return;
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
 
 
 /*
@@ -188,31 +313,57 @@
 
 static void mdlInitializeSizes(SimStruct *S)
 {
-    ssSetNumSFcnParams(S, N_PARAMETER);  /* Number of expected parameters */
+    int_T nunits;
+
+    if (ssGetSFcnParamsCount(S) == N_PARAMETER_BATCH)  /* number of units is optional */
+    {
+        ssSetNumSFcnParams(S, N_PARAMETER_BATCH);
+    }
+    else
+    {
+        ssSetNumSFcnParams(S, N_PARAMETER);  /* Number of expected parameters */
+    }
     if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S))
     {
         /* Return if number of expected != number of actual parameters */
         return;
     }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL)
+    {
+        return;
+    }
+#endif
+    nunits = NUNITS;
     
-    ssSetNumContStates(S, 4*(int_T)NODES); /* number of continuous states */
+    ssSetNumContStates(S, N_NODESTATES*(int_T)NODES*nunits); /* number of continuous states */
     ssSetNumDiscStates(S, 0);       /* number of discrete states */
-    if (!ssSetNumInputPorts(S, N_INPUTS))
+    if (!ssSetNumInputPorts(S, 1))
     {
         return;
     }
+    ssSetInputPortWidth(S, 0, N_INPUTS*nunits);
     ssSetInputPortDirectFeedThrough(S, 0, 1);
     
     if (!ssSetNumOutputPorts(S, 1))
     {
         return;
     }
-    ssSetOutputPortWidth(S, 0, 4);
+    ssSetOutputPortWidth(S, 0, N_OUTPUTS*nunits);
 
     ssSetNumSampleTimes(S, 1);      /* number of sample times */
     ssSetNumRWork(S, 0); /* number of real work vector elements */
     ssSetNumIWork(S, 0); /* number of integer work vector elements */
     ssSetNumPWork(S, 0); /* number of pointer work vector elements */
+
+    ssSetNumDWork(S, 1);
+    ssSetDWorkWidth(S, DWORK_PROP_NR, N_PROP*nunits);
+    ssSetDWorkDataType(S, DWORK_PROP_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_PROP_NR, "DWORK_PROP");
+    ssSetDWorkUsageType(S, DWORK_PROP_NR, SS_DWORK_USED_AS_DWORK);
+
+    ssSetJacobianNzMax(S, JAC_NZ((int_T)NODES)*nunits);
     
     ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
     ssSetSimStateVisibility(S, 1);
@@ -250,13 +401,19 @@ static void mdlInitializeConditions(SimStruct *S)
 {
     double t0 = TINI;           /* initial temperature as parameter */
     int    nodes = (int)NODES;  /* numer of nodes as parameter */
+    int    nunits = NUNITS;     /* number of units */
     int    n;
     real_T *x0   = ssGetContStates(S);
+    real_T *prop = (real_T *)ssGetDWork(S, DWORK_PROP_NR);
 
-    for (n = 0; n < 4*nodes; n++)
+    for (n = 0; n < N_NODESTATES*nodes*nunits; n++)
     {
         x0[n] = t0;             /* state-vector is initialized with TINI */
     }
+    for (n = 0; n < N_PROP*nunits; n++)
+    {
+        prop[n] = NO_KEY;       /* property cache is empty */
+    }
 }
 
 
@@ -266,9 +423,9 @@ static void mdlInitializeConditions(SimStruct *S)
 
 static void mdlOutputs(SimStruct *S, int_T tid)
 {
-    InputRealPtrsType u = ssGetInputPortRealSignalPtrs(S, 0);
-    real_T *y           = ssGetOutputPortRealSignal(S, 0);
-    real_T *x           = ssGetContStates(S);
+    InputRealPtrsType uport = ssGetInputPortRealSignalPtrs(S, 0);
+    real_T *yport       = ssGetOutputPortRealSignal(S, 0);
+    real_T *xport       = ssGetContStates(S);
     double dplinhot     = DPLHOT;
     double dpquahot     = DPQHOT;
     double dptemphot    = DPTHOT;
@@ -276,42 +433,53 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     double dpquacold    = DPQCOLD;
     double dptempcold   = DPTCOLD;
     int    nodes = (int)NODES;  /* numer of nodes as parameter */
+    int    nunits = NUNITS;     /* number of units */
 
+    InputRealPtrsType u;
+    real_T *x, *y;
     double tmhot, tmcold, phot, pcold;
-    int n;
-
-    phot = PRESSHOT;
-    pcold = PRESSCOLD;
+    int n, unit;
 
-    /* average pipe temperature */
-    tmhot  = 0.0;
-    tmcold = 0.0;
-    for (n = FIRST_NODE; n <= LAST_NODE; n++)
+    for (unit = 0; unit < nunits; unit++)
     {
-        tmhot  += THOT;
-        tmcold += TCOLD;
-    }
-    tmhot  = tmhot /(double)nodes;
-    tmcold = tmcold/(double)nodes;
+        u = uport + N_INPUTS*unit;
+        x = xport + N_NODESTATES*nodes*unit;
+        y = yport + N_OUTPUTS*unit;
 
-    /* friction */
-    if (FLOW_ID_H > 10000.0)
-    {
-        phot  -= (dpquahot*MDOTHOT+dplinhot)*MDOTHOT + dptemphot*tmhot;
-    }
-    if (FLOW_ID_C > 10000.0)
-    {
-        pcold -= (dpquacold*MDOTCOLD+dplincold)*MDOTCOLD + dptempcold*tmcold;
-    }
+        /* refresh property cache for mdlDerivatives and mdlJacobian */
+        get_properties(S, unit, x, u);
 
-    /* set outputs */
-    n = LAST_NODE;
-    y[0] = THOT;    /* temperature */
-    y[1] = phot;    /* pressure */
-    y[2] = TCOLD;   /* temperature */
-    y[3] = pcold;   /* pressure */
+        phot = PRESSHOT;
+        pcold = PRESSCOLD;
 
-    /* printf("ID %g pipe p %g mdot %g \n",FLOW_ID, p, MDOT);*/
+        /* average pipe temperature */
+        tmhot  = 0.0;
+        tmcold = 0.0;
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
+        {
+            tmhot  += THOT;
+            tmcold += TCOLD;
+        }
+        tmhot  = tmhot /(double)nodes;
+        tmcold = tmcold/(double)nodes;
+
+        /* friction */
+        if (FLOW_ID_H > 10000.0)
+        {
+            phot  -= (dpquahot*MDOTHOT+dplinhot)*MDOTHOT + dptemphot*tmhot;
+        }
+        if (FLOW_ID_C > 10000.0)
+        {
+            pcold -= (dpquacold*MDOTCOLD+dplincold)*MDOTCOLD + dptempcold*tmcold;
+        }
+
+        /* set outputs */
+        n = LAST_NODE;
+        y[0] = THOT;    /* temperature */
+        y[1] = phot;    /* pressure */
+        y[2] = TCOLD;   /* temperature */
+        y[3] = pcold;   /* pressure */
+    } /* end for unit */
 }
 
 
@@ -327,11 +495,9 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 static void mdlDerivatives(SimStruct *S)
 {
     /* define and get parameters */
-    real_T            *dx = ssGetdX(S);
-    real_T            *x  = ssGetContStates(S);
-    InputRealPtrsType u   = ssGetInputPortRealSignalPtrs(S, 0);
-    double vhot = V_HOT;
-    double vcold = V_COLD;
+    real_T            *dxport = ssGetdX(S);
+    real_T            *xport  = ssGetContStates(S);
+    InputRealPtrsType uport   = ssGetInputPortRealSignalPtrs(S, 0);
     double ualoss = UALOSS; 
     double uaconsthot = UACHOT;
     double ualinhot = UALHOT;
@@ -339,54 +505,225 @@ static void mdlDerivatives(SimStruct *S)
     double ualincold = UALCOLD;
     double uaconstwall = UACWALL;
     double ualinwall = UALWALL;
-    double material = MATERIAL;
-    double mass = MASS;
-    double fracin = FRAC_IN;
     double dnodes = NODES;
     int    nodes = (int)dnodes;  /* numer of nodes as parameter */
+    int    nunits = NUNITS;      /* number of units */
+
+    InputRealPtrsType u;
+    real_T *x, *dx, *prop;
+    double uawall, flowhot, flowcold, uahot, uacold, caph, capc, caps, capw;
+    int n, unit;
+
+    for (unit = 0; unit < nunits; unit++)
+    {
+        u  = uport + N_INPUTS*unit;
+        x  = xport + N_NODESTATES*nodes*unit;
+        dx = dxport + N_NODESTATES*nodes*unit;
+
+        /* material properties at temperature of last node
+           to avoid function calls at every node */
+        prop = get_properties(S, unit, x, u);
+        caph = CAPHOT;
+        capc = CAPCOLD;
+        caps = CAPSURF;
+        capw = CAPWALL;
+
+        /* set heat transport terms */
+        flowhot  = MDOTHOT*dnodes/(V_HOT*RHOHOT);
+        flowcold = MDOTCOLD*dnodes/(V_COLD*RHOCOLD);
+        uahot    = uaconsthot+ualinhot*MDOTHOT;
+        uacold   = uaconstcold+ualincold*MDOTCOLD;
+        uawall   = uaconstwall+ualinwall*MDOTCOLD;
+
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
+        {
+            /* heat transfer */
+            DTDTHOT  = uahot/caph*(TSURF-THOT);
+            DTDTSURF = (uahot*(THOT-TSURF)+uacold*(TCOLD-TSURF))/caps;
+            DTDTCOLD = (uacold*(TSURF-TCOLD)+uawall*(TWALL-TCOLD))/capc;
+            DTDTWALL = (uawall*(TCOLD-TWALL)+ualoss*(TAMB-TWALL))/capw;
+
+            if (n > FIRST_NODE)
+            { /* flow */
+                DTDTHOT += flowhot*(THOTBACK-THOT);
+                DTDTCOLD += flowcold*(TCOLDBACK-TCOLD);
+            }
+            else
+            {
+                DTDTHOT += flowhot*(TINHOT-THOT); /* first node: T from inlet */
+                DTDTCOLD += flowcold*(TINCOLD-TCOLD);
+            }
+        } /* end for n */
+    } /* end for unit */
+}
+
 
-    double cphot, cpcold, rhohot, rhocold, uawall,
-        flowhot, flowcold, uahot, uacold, caph, capc, caps, capw;
-    int n;
-
-    /* material properties at temperature of last node
-       to avoid function calls at every node */
-    n = LAST_NODE;
-    rhohot  = density(FLUID_ID_H, PERCENT_H, THOT, PRESSHOT);
-    rhocold = density(FLUID_ID_C, PERCENT_C, TCOLD, PRESSCOLD);
-    cphot  = heat_capacity(FLUID_ID_H, PERCENT_H, THOT, PRESSHOT);
-    cpcold = heat_capacity(FLUID_ID_C, PERCENT_C, TCOLD, PRESSCOLD);
-    caph = vhot*cphot*rhohot;
-    capc = vcold*cpcold*rhocold;
-    caps = mass*fracin*heat_capacity_solid(material,TSURF);
-    capw = mass*(1.0-fracin)*heat_capacity_solid(material,TWALL);
-
-    /* set heat transport terms */
-    flowhot  = MDOTHOT*dnodes/(vhot*rhohot);
-    flowcold = MDOTCOLD*dnodes/(vcold*rhocold);
-    uahot    = uaconsthot+ualinhot*MDOTHOT;
-    uacold   = uaconstcold+ualincold*MDOTCOLD;
-    uawall   = uaconstwall+ualinwall*MDOTCOLD;
-
-    for (n = FIRST_NODE; n <= LAST_NODE; n++)
+/*
+ * mdlJacobian - analytic Jacobian [A B; C D]
+ *
+ * Sparse matrix in compressed column format with (nx+ny) rows and (nx+nu)
+ * columns. Row indices are sorted in each column. The properties are 
+ * constant (cache), the derivatives of the properties are neglected.
+ * Entries for the flow ID, fluid ID and mixture inputs are zero (the 
+ * inputs only switch between models) and not stored.
+ */
+#define MDL_JACOBIAN
+static void mdlJacobian(SimStruct *S)
+{
+    real_T            *pr     = ssGetJacobianPr(S);
+    int_T             *ir     = ssGetJacobianIr(S);
+    int_T             *jc     = ssGetJacobianJc(S);
+    real_T            *xport  = ssGetContStates(S);
+    InputRealPtrsType uport   = ssGetInputPortRealSignalPtrs(S, 0);
+    double ualoss = UALOSS; 
+    double ualinhot = UALHOT;
+    double ualincold = UALCOLD;
+    double ualinwall = UALWALL;
+    double dnodes = NODES;
+    int    nodes = (int)dnodes;  /* numer of nodes as parameter */
+    int    nunits = NUNITS;      /* number of units */
+    int_T  nx = N_NODESTATES*nodes*nunits;  /* number of states */
+
+    InputRealPtrsType u;
+    real_T *x, *prop;
+    double uawall, flowhot, flowcold, uahot, uacold, caph, capc, caps, capw;
+    double dphdt, dpcdt, tin, tprev;
+    int_T  n, unit, col, nz, x0, y0, p;
+
+    nz = 0;
+    col = 0;
+    /* columns of the states: derivatives and outputs with respect to the states */
+    for (unit = 0; unit < nunits; unit++)
+    {
+        u  = uport + N_INPUTS*unit;
+        x  = xport + N_NODESTATES*nodes*unit;
+        x0 = N_NODESTATES*nodes*unit;   /* first state (row) of the unit */
+        y0 = nx + N_OUTPUTS*unit;       /* first output (row) of the unit */
+
+        prop = get_properties(S, unit, x, u);
+        caph = CAPHOT;
+        capc = CAPCOLD;
+        caps = CAPSURF;
+        capw = CAPWALL;
+        flowhot  = MDOTHOT*dnodes/(V_HOT*RHOHOT);
+        flowcold = MDOTCOLD*dnodes/(V_COLD*RHOCOLD);
+        uahot    = UACHOT+ualinhot*MDOTHOT;
+        uacold   = UACCOLD+ualincold*MDOTCOLD;
+        uawall   = UACWALL+ualinwall*MDOTCOLD;
+        dphdt    = (FLOW_ID_H > 10000.0)? -DPTHOT/dnodes : 0.0;  /* pressure drop by mean temperature */
+        dpcdt    = (FLOW_ID_C > 10000.0)? -DPTCOLD/dnodes : 0.0;
+
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
+        {
+            p = x0 + N_NODESTATES*n;
+
+            /* column THOT */
+            jc[col++] = nz;
+            ir[nz] = p+IHOT;    pr[nz++] = -uahot/caph - flowhot;
+            ir[nz] = p+ISURF;   pr[nz++] = uahot/caps;
+            if (n < LAST_NODE)
+            {
+                ir[nz] = p+N_NODESTATES+IHOT;  pr[nz++] = flowhot;  /* next node */
+            }
+            else
+            {
+                ir[nz] = y0;    pr[nz++] = 1.0;                     /* outlet temperature */
+            }
+            ir[nz] = y0+1;      pr[nz++] = dphdt;
+
+            /* column TSURF */
+            jc[col++] = nz;
+            ir[nz] = p+IHOT;    pr[nz++] = uahot/caph;
+            ir[nz] = p+ISURF;   pr[nz++] = -(uahot+uacold)/caps;
+            ir[nz] = p+ICOLD;   pr[nz++] = uacold/capc;
+
+            /* column TCOLD */
+            jc[col++] = nz;
+            ir[nz] = p+ISURF;   pr[nz++] = uacold/caps;
+            ir[nz] = p+ICOLD;   pr[nz++] = -(uacold+uawall)/capc - flowcold;
+            ir[nz] = p+IWALL;   pr[nz++] = uawall/capw;
+            if (n < LAST_NODE)
+            {
+                ir[nz] = p+N_NODESTATES+ICOLD;  pr[nz++] = flowcold; /* next node */
+            }
+            else
+            {
+                ir[nz] = y0+2;  pr[nz++] = 1.0;                     /* outlet temperature */
+            }
+            ir[nz] = y0+3;      pr[nz++] = dpcdt;
+
+            /* column TWALL */
+            jc[col++] = nz;
+            ir[nz] = p+ICOLD;   pr[nz++] = uawall/capc;
+            ir[nz] = p+IWALL;   pr[nz++] = -(uawall+ualoss)/capw;
+        } /* end for n */
+    } /* end for unit */
+
+    /* columns of the inputs */
+    for (unit = 0; unit < nunits; unit++)
     {
-        /* heat transfer */
-        DTDTHOT  = uahot/caph*(TSURF-THOT);
-        DTDTSURF = (uahot*(THOT-TSURF)+uacold*(TCOLD-TSURF))/caps;
-        DTDTCOLD = (uacold*(TSURF-TCOLD)+uawall*(TWALL-TCOLD))/capc;
-       	DTDTWALL = (uawall*(TCOLD-TWALL)+ualoss*(TAMB-TWALL))/capw;
-
-        if (n > FIRST_NODE)
-        { /* flow */
-            DTDTHOT += flowhot*(THOTBACK-THOT);
-            DTDTCOLD += flowcold*(TCOLDBACK-TCOLD);
+        u  = uport + N_INPUTS*unit;
+        x  = xport + N_NODESTATES*nodes*unit;
+        x0 = N_NODESTATES*nodes*unit;
+        y0 = nx + N_OUTPUTS*unit;
+        prop = get_properties(S, unit, x, u);
+
+        /* TAMB */
+        jc[col++] = nz;
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
+        {
+            ir[nz] = x0+N_NODESTATES*n+IWALL;   pr[nz++] = ualoss/CAPWALL;
+        }
+        /* FLOW_ID_H */
+        jc[col++] = nz;
+        /* TINHOT */
+        jc[col++] = nz;
+        ir[nz] = x0+IHOT;   pr[nz++] = MDOTHOT*dnodes/(V_HOT*RHOHOT);
+        /* MDOTHOT */
+        jc[col++] = nz;
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
+        {
+            tin = (n > FIRST_NODE)? THOTBACK : TINHOT;
+            ir[nz] = x0+N_NODESTATES*n+IHOT;
+            pr[nz++] = ualinhot/CAPHOT*(TSURF-THOT) + dnodes/(V_HOT*RHOHOT)*(tin-THOT);
+            ir[nz] = x0+N_NODESTATES*n+ISURF;
+            pr[nz++] = ualinhot*(THOT-TSURF)/CAPSURF;
         }
-        else
+        ir[nz] = y0+1;
+        pr[nz++] = (FLOW_ID_H > 10000.0)? -(2.0*DPQHOT*MDOTHOT+DPLHOT) : 0.0;
+        /* PRESSHOT */
+        jc[col++] = nz;
+        ir[nz] = y0+1;      pr[nz++] = 1.0;
+        /* FLUID_ID_H, PERCENT_H, FLOW_ID_C */
+        jc[col++] = nz;
+        jc[col++] = nz;
+        jc[col++] = nz;
+        /* TINCOLD */
+        jc[col++] = nz;
+        ir[nz] = x0+ICOLD;  pr[nz++] = MDOTCOLD*dnodes/(V_COLD*RHOCOLD);
+        /* MDOTCOLD */
+        jc[col++] = nz;
+        for (n = FIRST_NODE; n <= LAST_NODE; n++)
         {
-            DTDTHOT += flowhot*(TINHOT-THOT); /* first node: T from inlet */
-            DTDTCOLD += flowcold*(TINCOLD-TCOLD);
+            tprev = (n > FIRST_NODE)? TCOLDBACK : TINCOLD;
+            ir[nz] = x0+N_NODESTATES*n+ISURF;
+            pr[nz++] = ualincold*(TCOLD-TSURF)/CAPSURF;
+            ir[nz] = x0+N_NODESTATES*n+ICOLD;
+            pr[nz++] = (ualincold*(TSURF-TCOLD) + ualinwall*(TWALL-TCOLD))/CAPCOLD
+                + dnodes/(V_COLD*RHOCOLD)*(tprev-TCOLD);
+            ir[nz] = x0+N_NODESTATES*n+IWALL;
+            pr[nz++] = ualinwall*(TCOLD-TWALL)/CAPWALL;
         }
-    } /* end for */
+        ir[nz] = y0+3;
+        pr[nz++] = (FLOW_ID_C > 10000.0)? -(2.0*DPQCOLD*MDOTCOLD+DPLCOLD) : 0.0;
+        /* PRESSCOLD */
+        jc[col++] = nz;
+        ir[nz] = y0+3;      pr[nz++] = 1.0;
+        /* FLUID_ID_C, PERCENT_C */
+        jc[col++] = nz;
+        jc[col++] = nz;
+    } /* end for unit */
+    jc[col] = nz;
 }
 
 /*
@@ -406,4 +743,3 @@ static void mdlTerminate(SimStruct *S)
 #else
 #include "cg_sfun.h"       /* Code generation registration function */
 #endif
-
@@ -39,6 +39,9 @@
  * 6.1.0    Arnold Wohlfeil SimState compiliance and            11aug2015
  *                          MultipleExecInstanes enabled
  * 6.1.1    Bernd Hafner    initialize variables properly       11sep2015
+ * 6.2.0    hf              constants in mdlStart, property     19oct2026
+ *                          cache, Swamee-Jain and Haaland 
+ *                          friction factor
  *
  * Copyright (c) 2000-2015 Solar-Institut Juelich, Germany
  * 
@@ -55,22 +58,41 @@
  * into account. Outlet above inlet has a positive height and a decrease
  * in static pressure.
  *
+ * The friction factor of turbulent flow (Re >= 3000) is selected with 
+ * the optional parameter FRICTION:
+ *  0   Blasius and Nikuradse (default, as in version 6.1)
+ *  1   Swamee-Jain:  f = 0.25 / log10(e/(3.7*D) + 5.74/Re^0.9)^2
+ *  2   Haaland:      1/sqrt(f) = -1.8*log10((e/(3.7*D))^1.11 + 6.9/Re)
+ * All correlations are explicit, no iteration is needed. Swamee-Jain and
+ * Haaland approximate the Colebrook equation within 2 % and include the
+ * influence of the roughness in the whole turbulent range.
+ *
+ * The geometric constants are calculated once in mdlStart. Density and
+ * viscosity are stored with the mean temperature, pressure, fluid ID and
+ * mixture they were calculated with and only recalculated when one of 
+ * them changes by more than the optional parameter PROPDT (temperature 
+ * in K, default 0: recalculate on every change, same results as
+ * version 6.1; PROPDT < 0: recalculate in each call as version 6.1).
+ * The pressure tolerance is 1000 Pa when PROPDT > 0.
+ *
  *  symbol      used for                                        unit
  *  D_hydr      (hydraulic) diameter of the pipe                m
- *  dh          distance between two nodes                      m
+ *  e           roughness of the pipe                           m
+ *  f           friction factor                                 -
  *  mdot        mass flow rate                                  kg/s
+ *  Re          Reynolds number                                 -
  *  rho         density                                         kg/m^3
  *  T           temperature                                     K
  *  t           time                                            s
- *	Vnode       node volume                                     m^3
  *         
  * structure of u (input vector)
  *  see defines below
  *
  * structure of y (output vector)
  *  index   use
- *  0       temperature                                     degree Celsius  
- *  1       node temperatures (vector)                      degree Celsius 
+ *  0       linear pressure drop coefficient                Pa/(kg/s)  
+ *  1       quadratic pressure drop coefficient             Pa/(kg/s)^2
+ *  2       pressure drop                                   Pa
  *
  */
 
@@ -96,6 +118,18 @@
 #define ROUGHNESS *mxGetPr(ssGetSFcnParam(S,2)) /* roughness of pipe in mm */
 #define NBENDS    *mxGetPr(ssGetSFcnParam(S,3)) /* No. of 90 bends (45 = 0.667) */
 #define N_PARAM                             4
+#define FRICTION  ((ssGetSFcnParamsCount(S) > 4)? \
+    (int_T)*mxGetPr(ssGetSFcnParam(S,4)) : FRICTION_BLASIUS) /* friction factor correlation */
+#define PROPDT    ((ssGetSFcnParamsCount(S) > 5)? \
+    *mxGetPr(ssGetSFcnParam(S,5)) : 0.0) /* tolerance for property recalculation in K */
+#define N_PARAM_FRICTION                    5
+#define N_PARAM_PROPDT                      6
+
+#define FRICTION_BLASIUS    0   /* Blasius and Nikuradse */
+#define FRICTION_SWAMEEJAIN 1   /* Swamee and Jain */
+#define FRICTION_HAALAND    2   /* Haaland */
+#define PROP_DP         1000.0  /* pressure tolerance for the property cache in Pa */
+#define NO_KEY          -1.0e10 /* cache is empty */
 
 
 #define T(n)       (*u0[n])     /* node temperature */
@@ -105,6 +139,24 @@
 #define PERCENTAGE (*u4[0])     /* mixture  (defined in CARNOT.h) */
 #define N_INPUT_PORTS 5
 
+/* constants of the pipe, calculated in mdlStart */
+#define DWORK_CONST_NR  0
+#define FLIMIT          cnst[0] /* lowest value of fh, Nikuradse */
+#define KLIMIT          cnst[1] /* limit of friction coefficient k */
+#define VFACTOR         cnst[2] /* velocity per volume flow 4/(pi*d^2) */
+#define ERELSJ          cnst[3] /* roughness/(3.7*diameter) */
+#define ERELHA          cnst[4] /* (roughness/(3.7*diameter))^1.11 */
+#define N_CONST         5
+/* property cache */
+#define DWORK_PROP_NR   1
+#define KEY_T           prop[0] /* mean temperature of the properties */
+#define KEY_P           prop[1] /* pressure */
+#define KEY_FLUID       prop[2] /* fluid ID */
+#define KEY_MIX         prop[3] /* mixture */
+#define RHO             prop[4] /* density */
+#define VISC            prop[5] /* kinematic viscosity */
+#define N_PROP          6
+
 
 /*====================*
  * S-function methods *
@@ -119,7 +171,12 @@ static void mdlInitializeSizes(SimStruct *S)
 {
     /* See sfuntmpl_doc.c for more details on the macros below */
 
-    ssSetNumSFcnParams(S, N_PARAM);  /* Number of expected parameters */
+    if (ssGetSFcnParamsCount(S) == N_PARAM_PROPDT)  /* optional parameters */
+        ssSetNumSFcnParams(S, N_PARAM_PROPDT);
+    else if (ssGetSFcnParamsCount(S) == N_PARAM_FRICTION)
+        ssSetNumSFcnParams(S, N_PARAM_FRICTION);
+    else
+        ssSetNumSFcnParams(S, N_PARAM);  /* Number of expected parameters */
     if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S))
     {
         /* Return if number of expected != number of actual parameters */
@@ -158,6 +215,16 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumPWork(S, 0);
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
+
+    ssSetNumDWork(S, 2);
+    ssSetDWorkWidth(S, DWORK_CONST_NR, N_CONST);
+    ssSetDWorkDataType(S, DWORK_CONST_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CONST_NR, "DWORK_CONST");
+    ssSetDWorkUsageType(S, DWORK_CONST_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_PROP_NR, N_PROP);
+    ssSetDWorkDataType(S, DWORK_PROP_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_PROP_NR, "DWORK_PROP");
+    ssSetDWorkUsageType(S, DWORK_PROP_NR, SS_DWORK_USED_AS_DWORK);
     
     ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
     ssSetSimStateVisibility(S, 1);
@@ -186,26 +253,34 @@ static void mdlInitializeSampleTimes(SimStruct *S)
 
 
 
-#undef MDL_START  /* Change to #undef to remove function */
+#define MDL_START  /* Change to #undef to remove function */
 #if defined(MDL_START) 
   /* Function: mdlStart =======================================================
    * Abstract:
-   *    This function is called once at start of model execution. If you
-   *    have states that should be initialized once, this is the place
-   *    to do it.
+   *    Calculate the constants of the pipe geometry and clear the property
+   *    cache.
    */
   static void mdlStart(SimStruct *S)
   {
-    //real_T *RWork = ssGetRWork(S);  
-    //real_T length = LENGTH;
-    //real_T dia    = DIA;
-    //real_T uloss  = ULOSS;
-    //int_T  nodes  = (int)NODES;
-
-    /* geometries */
-    //LNODE = length/(double)nodes;   /* length of one node */
-    //VNODE = PI*dia*dia*LNODE*0.25;  /* node volume */
-    //LOSS  = uloss*4.0/dia;          /* losses in W per m node volume */
+    real_T *cnst = (real_T *)ssGetDWork(S, DWORK_CONST_NR);
+    real_T *prop = (real_T *)ssGetDWork(S, DWORK_PROP_NR);
+    real_T rough = ROUGHNESS;
+    real_T dia   = DIA;
+
+    FLIMIT = 1.0/(2.0*log10(dia/rough)+1.14);   /* lowest value of fh, Nikuradse */
+    FLIMIT *= FLIMIT;                           /* limit is (1/(2*log10(...)))^2 */
+    KLIMIT = rough/dia;  /* limit of friction coefficient k is (roughness/diameter)^2 */
+    KLIMIT *= KLIMIT;
+    VFACTOR = 4.0/(PI*dia*dia);
+    ERELSJ = rough/(3.7*dia);
+    ERELHA = pow(ERELSJ, 1.11);
+
+    KEY_T = NO_KEY;
+    KEY_P = NO_KEY;
+    KEY_FLUID = NO_KEY;
+    KEY_MIX = NO_KEY;
+    RHO = 0.0;
+    VISC = 0.0;
   }
 #endif /*  MDL_START */
 
@@ -226,21 +301,19 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     real_T *y0 = ssGetOutputPortRealSignal(S,0);
     real_T *y1 = ssGetOutputPortRealSignal(S,1);
     real_T *y2 = ssGetOutputPortRealSignal(S,2);
+    real_T *cnst = (real_T *)ssGetDWork(S, DWORK_CONST_NR);
+    real_T *prop = (real_T *)ssGetDWork(S, DWORK_PROP_NR);
     int_T  nodes = ssGetInputPortWidth(S,0);
 
     real_T nbend = NBENDS;
     real_T length = LENGTH;
-    real_T rough = ROUGHNESS;
     real_T dia   = DIA;
-    real_T rho, v, re, fh, k, leq, flimit, klimit, tmean, hh, dplin, dpqua;
+    real_T propdt = PROPDT;
+    real_T flimit = FLIMIT;
+    real_T klimit = KLIMIT;
+    real_T rho, v, re, fh, k, leq, tmean, hh, dplin, dpqua, lg;
     int_T  n; 
 
-    /* set geometries */
-    flimit = 1.0/(2.0*log10(dia/rough)+1.14);   /* lowest value of fh, Nikuradse */
-    flimit *= flimit;                           /* limit is (1/(2*log10(...)))^2 */
-    klimit = rough/dia;  /* limit of friction coefficient k is (roughness/diameter)^2 */
-    klimit *= klimit;
-
     /* average pipe temperature */
     tmean = 0.0;
     for (n = 0; n < nodes; n++) {
@@ -258,9 +331,21 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 
     if (MDOT > 0.0)  
     {
-        rho = density(FLUID_ID, PERCENTAGE, tmean, PRESS);
-        v = 4.0*MDOT/(rho*PI*dia*dia);
-        re = v*dia/viscosity(FLUID_ID, PERCENTAGE, tmean, PRESS);
+        /* properties: recalculate only if the mean temperature changed */
+        if (propdt < 0.0 || FLUID_ID != KEY_FLUID || PERCENTAGE != KEY_MIX
+            || fabs(tmean-KEY_T) > propdt 
+            || fabs(PRESS-KEY_P) > ((propdt > 0.0)? PROP_DP : 0.0))
+        {
+            KEY_T = tmean;
+            KEY_P = PRESS;
+            KEY_FLUID = FLUID_ID;
+            KEY_MIX = PERCENTAGE;
+            RHO = density(FLUID_ID, PERCENTAGE, tmean, PRESS);
+            VISC = viscosity(FLUID_ID, PERCENTAGE, tmean, PRESS);
+        }
+        rho = RHO;
+        v = VFACTOR*MDOT/rho;
+        re = v*dia/VISC;
 
         /* developing flow correction */
 	    /* from A. Lencastre : Hydraulique generale, Eyrolles Safege/*
@@ -276,8 +361,21 @@ static void mdlOutputs(SimStruct *S, int_T tid)
             k += (0.6+0.15*re/1000)*nbend;
         } 
         else 
-        {                                       /* turbulent flow : Blasius and Nikuradse correlations*/
-            fh = max(flimit, ((re <= 1.0e5)? 0.3164*pow(re,-0.25) : 0.221*pow(re,-0.237)+0.0032));
+        {                                       
+            switch (FRICTION)
+            {
+                case FRICTION_SWAMEEJAIN:       /* turbulent flow : Swamee and Jain */
+                    lg = log10(ERELSJ + 5.74*pow(re,-0.9));
+                    fh = 0.25/(lg*lg);
+                    break;
+                case FRICTION_HAALAND:          /* turbulent flow : Haaland */
+                    lg = -1.8*log10(ERELHA + 6.9/re);
+                    fh = 1.0/(lg*lg);
+                    break;
+                default:                        /* turbulent flow : Blasius and Nikuradse correlations*/
+                    fh = max(flimit, ((re <= 1.0e5)? 0.3164*pow(re,-0.25) : 0.221*pow(re,-0.237)+0.0032));
+                    break;
+            }
             k += (re < 3e5)? (0.75-(0.75-klimit)*re/3.0e5)*nbend : klimit*nbend;
         }
 
@@ -0,0 +1,514 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are 
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ *    notice, this list of conditions and the following disclaimer in the 
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its 
+ *    contributors may be used to endorse or promote products derived from 
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * bundle of multinode pipes with capacity in one block
+ *
+ * Version  Author          Changes                                 Date
+ * 6.1.0    hf              created from pipe_Tnodes.c              19oct2026
+ * 6.1.1    hf              state layout documented                 19oct2026
+ *
+ * Copyright (c) 1998 Solar-Institut Juelich, Germany
+ * 
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * The block simulates NPIPES independent pipes, each pipe p is devided 
+ * into NODES(p) nodes with the differential equation of pipe_Tnodes.c:
+ *
+ * (rho*cp + cwall/A) * dT/dt = 4*U/d *            (Tamb      - Tnode)
+ *                            + lambda / dh^2 *    (Tnextnode - Tnode)          
+ *                            + lambda / dh^2 *    (Tlastnode - Tnode)          
+ *                            + mdot * cp / Vnode *  (Tlastnode - Tnode)
+ *
+ * with A = pi/4*d^2, dh = L/NODES and Vnode = A*dh.
+ * The node temperatures of all pipes are one contiguous state vector, 
+ * pipe p uses the states OFFSET(p) to OFFSET(p+1)-1. The constant 
+ * coefficients are calculated once in mdlStart. In mdlDerivatives density
+ * and heat capacity are evaluated once per distinct combination of fluid
+ * ID, mixture, inlet temperature and pressure (pipes fed by the same 
+ * node share one evaluation). With the optional parameter TBUCKET > 0 
+ * the inlet temperatures are grouped in buckets of TBUCKET Kelvin, the 
+ * properties are evaluated in the middle of the bucket with the pressure
+ * of the first pipe of the bucket. The node loop of each pipe has no 
+ * branches and can be vectorised by the compiler.
+ *
+ * The states are stored pipe after pipe and not node by node as in 
+ * wall_envelope.c (structure of arrays over the walls). A node by node 
+ * layout needs all pipes padded to the maximum number of nodes and a 
+ * mask for the unused nodes, the rates of each pipe must be stored in 
+ * arrays over the pipes and read again for every node. It was measured 
+ * slower for all tested bundles (2000 pipes with 200, 20 or 3 nodes, 
+ * 20000 pipes with 3 nodes: 10 to 40 % more time in mdlDerivatives), 
+ * since the time per pipe is dominated by the property evaluation and 
+ * the rates, which are scalar in both layouts, and a pipe with many nodes
+ * is already a long vectorised loop. The walls have the same number of 
+ * nodes and constant coefficients, so there the layout pays off.
+ *
+ *  symbol      used for                                        unit
+ *  A           cross section of the pipe                       m^2
+ *  cp          heat capacity of fluid                          J/(kg*K)
+ *  cwall       heat capacity of pipe per length                J/(m*K)
+ *  d           inner diameter                                  m
+ *  dh          distance between two nodes                      m
+ *  L           length of the pipe                              m
+ *  lambda      effective axial heat conduction                 W/(m*K)
+ *  mdot        mass flow rate                                  kg/s
+ *  rho         density                                         kg/m^3
+ *  T           temperature                                     degree Celsius
+ *  t           time                                            s
+ *  U           heat loss coefficient (inner surface)           W/(m^2*K)
+ *  Vnode       node volume                                     m^3
+ *
+ * parameters (vectors with NPIPES elements, or scalars for all pipes)
+ *  index   use
+ *  0       length L                                        m
+ *  1       inner diameter d                                m
+ *  2       heat loss coefficient U                         W/(m^2*K)
+ *  3       effective axial heat conduction lambda          W/(m*K)
+ *  4       heat capacity of the pipe per length cwall      J/(m*K)
+ *  5       initial temperature                             degree Celsius
+ *  6       number of nodes NODES
+ *  7       TBUCKET (optional, default 0 = exact inlet temperature) K
+ *         
+ * structure of u (input ports, vectors with NPIPES elements)
+ *  see defines below, same order as pipe_Tnodes
+ *
+ * structure of y (output vector)
+ *  index   use
+ *  0       outlet temperatures of the pipes (NPIPES)       degree Celsius  
+ *  1       node temperatures of all pipes, pipe after pipe degree Celsius 
+ *          (sum of NODES)
+ *
+ */
+
+
+#define S_FUNCTION_NAME  pipe_bundle
+#define S_FUNCTION_LEVEL 2
+
+/*
+ * Need to include simstruc.h for the definition of the SimStruct and
+ * its associated macro definitions.
+ */
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+
+/*
+ *   Defines for easy access to the parameters (not inputs!) 
+ *   that are passed in. (ATTENTION: ssGetArg() returns **Matrix !!
+ *   but mxGetPr() converts to double-pointer)
+ *   PARAM(k,p) returns the value of parameter k for pipe p, scalar 
+ *   parameters are used for all pipes.
+ */
+#define PARAM(k,p) ((mxGetNumberOfElements(ssGetSFcnParam(S,k)) > 1)? \
+    mxGetPr(ssGetSFcnParam(S,k))[p] : mxGetPr(ssGetSFcnParam(S,k))[0])
+#define LENGTH(p)   PARAM(0,p)  /* length of pipe in m */
+#define DIA(p)      PARAM(1,p)  /* inner diameter in m */
+#define UVAL(p)     PARAM(2,p)  /* heat loss coefficient [W/(m^2*K)] */
+#define LAMBDA(p)   PARAM(3,p)  /* axial conduction [W/(m*K)] */
+#define CWALL(p)    PARAM(4,p)  /* capacity of the wall per length [J/(m*K)] */
+#define TINI(p)     PARAM(5,p)  /* initial temperature [C] */
+#define NODES(p)    ((int_T)(PARAM(6,p)+0.5)) /* number of nodes */
+#define N_PARAM                             7
+#define TBUCKET     ((ssGetSFcnParamsCount(S) > N_PARAM)? \
+    *mxGetPr(ssGetSFcnParam(S,7)) : 0.0)   /* width of temperature buckets in K */
+#define N_PARAM_TBUCKET                     8
+#define NPIPES      ((int_T)mxGetNumberOfElements(ssGetSFcnParam(S,0)))
+
+#define TAMB(p)       (*u0[p])  /* ambient temperature */
+#define TIN(p)        (*u1[p])  /* inlet temperature */
+#define MDOT(p)       (*u2[p])  /* massflow */
+#define PRESS(p)      (*u3[p])  /* pressure */
+#define FLUID_ID(p)   (*u4[p])  /* fluid ID (defined in CARNOT.h) */
+#define PERCENTAGE(p) (*u5[p])  /* mixture  (defined in CARNOT.h) */
+#define N_INPUT_PORTS 6
+
+/* constant coefficients of the pipes */
+#define DWORK_COEF_NR   0
+#define N_COEF          4
+#define LOSSV(p)        coef[(p)*N_COEF]    /* loss coefficient 4*U/d [W/(m^3*K)] */
+#define CONDV(p)        coef[(p)*N_COEF+1]  /* conduction lambda/dh^2 [W/(m^3*K)] */
+#define CWALLV(p)       coef[(p)*N_COEF+2]  /* capacity of wall per volume [J/(m^3*K)] */
+#define INVVNODE(p)     coef[(p)*N_COEF+3]  /* 1/Vnode [1/m^3] */
+/* first state of the pipes, OFFSET(NPIPES) is the number of states */
+#define DWORK_OFFSET_NR 1
+#define OFFSET(p)       offset[p]
+/* property buckets: hash table (pipe which defines the bucket or -1) */
+#define DWORK_HASH_NR   2
+#define DWORK_PROP_NR   3       /* rho and cp of the bucket of each pipe */
+#define RHO(p)          prop[2*(p)]
+#define CPF(p)          prop[2*(p)+1]
+
+
+/* size of the hash table: power of 2 >= 2*npipes */
+static int_T hash_size(int_T npipes)
+{
+    int_T n = 16;
+    while (n < 2*npipes)
+        n *= 2;
+    return n;
+}
+
+/* number of states: sum of the nodes of all pipes */
+static int_T total_nodes(SimStruct *S)
+{
+    int_T p, n = 0;
+
+    for (p = 0; p < NPIPES; p++)
+        n += NODES(p);
+    return n;
+}
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
+{
+    int_T k, p, npipes = NPIPES;
+
+    if (npipes < 1) {
+        ssSetErrorStatus(S,"pipe_bundle: no pipe length given");
+        return;
+    }
+    for (k = 1; k < N_PARAM; k++) {
+        if (mxGetNumberOfElements(ssGetSFcnParam(S,k)) != 1
+            && (int_T)mxGetNumberOfElements(ssGetSFcnParam(S,k)) != npipes) {
+            ssSetErrorStatus(S,"pipe_bundle: parameters must be scalars or have one value per pipe");
+            return;
+        }
+    }
+    for (p = 0; p < npipes; p++) {
+        if (LENGTH(p) <= 0.0 || DIA(p) <= 0.0) {
+            ssSetErrorStatus(S,"pipe_bundle: length and diameter must be > 0");
+            return;
+        }
+        if (NODES(p) < 1) {
+            ssSetErrorStatus(S,"pipe_bundle: number of nodes must be >= 1");
+            return;
+        }
+    }
+    if (TBUCKET < 0.0) {
+        ssSetErrorStatus(S,"pipe_bundle: temperature bucket must be >= 0");
+        return;
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T n, npipes;
+
+    if (ssGetSFcnParamsCount(S) == N_PARAM_TBUCKET)  /* TBUCKET is optional */
+        ssSetNumSFcnParams(S, N_PARAM_TBUCKET);
+    else
+        ssSetNumSFcnParams(S, N_PARAM);  /* Number of expected parameters */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL) {
+        return;
+    }
+#endif
+    npipes = NPIPES;
+
+    ssSetNumContStates(S, total_nodes(S));
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, N_INPUT_PORTS)) return;
+    for (n = 0; n < N_INPUT_PORTS; n++)
+    {
+        ssSetInputPortWidth(S, n, npipes);
+        ssSetInputPortDirectFeedThrough(S, n, 0);
+    }
+
+    if (!ssSetNumOutputPorts(S, 2)) return;
+    ssSetOutputPortWidth(S, 0, npipes);
+    ssSetOutputPortWidth(S, 1, total_nodes(S));
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetNumDWork(S, 4);
+    ssSetDWorkWidth(S, DWORK_COEF_NR, N_COEF*npipes);
+    ssSetDWorkDataType(S, DWORK_COEF_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_COEF_NR, "DWORK_COEF");
+    ssSetDWorkUsageType(S, DWORK_COEF_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_OFFSET_NR, npipes+1);
+    ssSetDWorkDataType(S, DWORK_OFFSET_NR, SS_INT32);
+    ssSetDWorkName(S, DWORK_OFFSET_NR, "DWORK_OFFSET");
+    ssSetDWorkUsageType(S, DWORK_OFFSET_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_HASH_NR, hash_size(npipes));
+    ssSetDWorkDataType(S, DWORK_HASH_NR, SS_INT32);
+    ssSetDWorkName(S, DWORK_HASH_NR, "DWORK_HASH");
+    ssSetDWorkUsageType(S, DWORK_HASH_NR, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_PROP_NR, 2*npipes);
+    ssSetDWorkDataType(S, DWORK_PROP_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_PROP_NR, "DWORK_PROP");
+    ssSetDWorkUsageType(S, DWORK_PROP_NR, SS_DWORK_USED_AS_DWORK);
+    
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+    
+    ssSupportsMultipleExecInstances(S, true);
+
+    /* Take care when specifying exception free code - see sfuntmpl.doc */
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    This function is used to specify the sample time(s) for your
+ *    S-function. You must register the same number of sample times as
+ *    specified in ssSetNumSampleTimes.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START) 
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Calculate the constant coefficients and the state offsets of the 
+   *    pipes.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+    real_T  *coef   = (real_T *)ssGetDWork(S, DWORK_COEF_NR);
+    int32_T *offset = (int32_T *)ssGetDWork(S, DWORK_OFFSET_NR);
+    int_T   p, npipes = NPIPES;
+    real_T  area, dh;
+
+    OFFSET(0) = 0;
+    for (p = 0; p < npipes; p++)
+    {
+        area = 0.25*PI*square(DIA(p));
+        dh = LENGTH(p)/(real_T)NODES(p);
+        LOSSV(p) = 4.0*UVAL(p)/DIA(p);
+        CONDV(p) = LAMBDA(p)/square(dh);
+        CWALLV(p) = CWALL(p)/area;
+        INVVNODE(p) = 1.0/(area*dh);
+        OFFSET(p+1) = OFFSET(p) + NODES(p);
+    }
+  }
+#endif /*  MDL_START */
+
+
+#define MDL_INITIALIZE_CONDITIONS   /* Change to #undef to remove function */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+  /* Function: mdlInitializeConditions ========================================
+   * Abstract:
+   *    The state-vector is initialized with TINI of each pipe.
+   */
+  static void mdlInitializeConditions(SimStruct *S)
+  {
+    real_T  *x0 = ssGetContStates(S);
+    int32_T *offset = (int32_T *)ssGetDWork(S, DWORK_OFFSET_NR);
+    int_T   p, n, npipes = NPIPES;
+    real_T  t0;
+
+    for (p = 0; p < npipes; p++)
+    {
+        t0 = TINI(p);
+        for (n = OFFSET(p); n < OFFSET(p+1); n++)
+            x0[n] = t0;
+    }
+  }
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Outlet temperatures and node temperatures of all pipes.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T  *y0 = ssGetOutputPortRealSignal(S,0);
+    real_T  *y1 = ssGetOutputPortRealSignal(S,1);
+    real_T  *x  = ssGetContStates(S);
+    int32_T *offset = (int32_T *)ssGetDWork(S, DWORK_OFFSET_NR);
+    int_T   p, n, npipes = NPIPES;
+
+    for (p = 0; p < npipes; p++)
+        y0[p] = x[OFFSET(p+1)-1];       /* outlet temperature */
+    for (n = 0; n < OFFSET(npipes); n++)
+        y1[n] = x[n];                   /* T nodes */
+}
+
+
+#define MDL_DERIVATIVES  /* Change to #undef to remove function */
+#if defined(MDL_DERIVATIVES)
+  /* Function: mdlDerivatives =================================================
+   * Abstract:
+   *    Properties per bucket, then the energy balance of the nodes pipe 
+   *    after pipe.
+   */
+  static void mdlDerivatives(SimStruct *S)
+  {
+    real_T  *dx = ssGetdX(S);
+    real_T  *x  = ssGetContStates(S);
+    real_T  *coef   = (real_T *)ssGetDWork(S, DWORK_COEF_NR);
+    int32_T *offset = (int32_T *)ssGetDWork(S, DWORK_OFFSET_NR);
+    int32_T *hash   = (int32_T *)ssGetDWork(S, DWORK_HASH_NR);
+    real_T  *prop   = (real_T *)ssGetDWork(S, DWORK_PROP_NR);
+    InputRealPtrsType u0 = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType u1 = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2 = ssGetInputPortRealSignalPtrs(S,2);
+    InputRealPtrsType u3 = ssGetInputPortRealSignalPtrs(S,3);
+    InputRealPtrsType u4 = ssGetInputPortRealSignalPtrs(S,4);
+    InputRealPtrsType u5 = ssGetInputPortRealSignalPtrs(S,5);
+    int_T   npipes = NPIPES;
+    int_T   nhash = hash_size(npipes);
+    real_T  tbucket = TBUCKET;
+    real_T  tkey, tq, invcap, loss, cond, flow, tamb;
+    real_T  *xp, *dxp;
+    uint32_T h;
+    int_T   p, q, n, nodes;
+
+    /* properties: one evaluation per distinct fluid, mixture, temperature and pressure */
+    for (h = 0; h < (uint32_T)nhash; h++)
+        hash[h] = -1;
+    for (p = 0; p < npipes; p++)
+    {
+        tkey = (tbucket > 0.0)? floor(TIN(p)/tbucket) : TIN(p);
+        h = (uint32_T)((int_T)FLUID_ID(p)*31 + (int_T)(PERCENTAGE(p)*1000.0))*2654435761u
+            ^ (uint32_T)(int_T)floor(tkey*1000.0)*2246822519u;
+        h &= (uint32_T)(nhash-1);
+        while ((q = hash[h]) >= 0)          /* linear probing */
+        {
+            tq = (tbucket > 0.0)? floor(TIN(q)/tbucket) : TIN(q);
+            if (tq == tkey && FLUID_ID(q) == FLUID_ID(p) && PERCENTAGE(q) == PERCENTAGE(p)
+                && (tbucket > 0.0 || PRESS(q) == PRESS(p)))
+                break;
+            h = (h+1) & (uint32_T)(nhash-1);
+        }
+        if (q >= 0)                         /* bucket exists */
+        {
+            RHO(p) = RHO(q);
+            CPF(p) = CPF(q);
+        }
+        else                                /* new bucket */
+        {
+            hash[h] = (int32_T)p;
+            tq = (tbucket > 0.0)? (tkey+0.5)*tbucket : TIN(p);
+            RHO(p) = density(FLUID_ID(p), PERCENTAGE(p), tq, PRESS(p));
+            CPF(p) = heat_capacity(FLUID_ID(p), PERCENTAGE(p), tq, PRESS(p));
+        }
+    }
+
+    /* energy balance of the nodes */
+    for (p = 0; p < npipes; p++)
+    {
+        xp = x + OFFSET(p);
+        dxp = dx + OFFSET(p);
+        nodes = OFFSET(p+1) - OFFSET(p);
+        invcap = 1.0/(RHO(p)*CPF(p) + CWALLV(p));  /* heat capacity per volume */
+        loss = LOSSV(p)*invcap;
+        cond = CONDV(p)*invcap;
+        flow = CPF(p)*INVVNODE(p)*MDOT(p)*invcap;   /* by flow */
+        tamb = TAMB(p);
+
+        /* first node: mdot from inlet */
+        dxp[0] = loss*(tamb-xp[0]) + flow*(TIN(p)-xp[0]);
+        if (nodes > 1)
+            dxp[0] += cond*(xp[1]-xp[0]);
+        /* inner nodes */
+        for (n = 1; n < nodes-1; n++)
+            dxp[n] = loss*(tamb-xp[n]) + cond*(xp[n+1]-xp[n]) 
+                + (cond+flow)*(xp[n-1]-xp[n]);
+        /* last node: no conduction forwards */
+        if (nodes > 1)
+            dxp[nodes-1] = loss*(tamb-xp[nodes-1]) 
+                + (cond+flow)*(xp[nodes-2]-xp[nodes-1]);
+    }
+  }
+#endif /* MDL_DERIVATIVES */
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was
+ *    allocated in mdlStart, this is the place to free it.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,570 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are 
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ *    notice, this list of conditions and the following disclaimer in the 
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its 
+ *    contributors may be used to endorse or promote products derived from 
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF 
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * plug flow pipe with capacity, the temperature profile is a FIFO of
+ * segments, alternative to pipe_Tnodes.c with the same ports
+ *
+ * Version  Author          Changes                                 Date
+ * 6.1.0    hf              created from pipe_Tnodes.c              19oct2026
+ * 6.1.1    hf              outlet temperature from the current     19oct2026
+ *                          profile in mdlOutputs, COND must be 0
+ * 6.1.2    hf              axial conduction between the segments   19oct2026
+ *
+ * Copyright (c) 1998 Solar-Institut Juelich, Germany
+ * 
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * pipe_Tnodes solves the energy balance of the pipe 
+ *
+ * (rho*cp + cwall) * dT/dt = LOSS * (Tamb - T) - mdot*cp/A * dT/dx 
+ *
+ * with "NODES" upwind nodes. The upwind scheme smears temperature fronts,
+ * long pipes need many nodes for the right transport delay.
+ * This model solves the same equation along the characteristics: the 
+ * temperature profile (fluid and wall, at the same temperature as in 
+ * pipe_Tnodes) is a list of segments with volume and temperature. In each
+ * time step the profile is shifted by the thermal volume
+ *
+ *  dVth = mdot * cp * dt / (rho*cp + cwall)
+ *
+ * (the temperature front is slower than the fluid since the wall must be 
+ * heated), a new segment with the inlet temperature is added at the inlet
+ * and the volume dVth leaves at the outlet. The losses are applied to 
+ * each segment with the analytical solution
+ *
+ *  T(t+dt) = Tamb + (T(t) - Tamb) * exp(-LOSS*dt/(rho*cp + cwall))
+ *
+ * The fluid which enters or leaves during the step gets the mean loss 
+ * over its residence time in the step. The transport delay is exact, 
+ * there is no numerical diffusion and the number of segments only 
+ * depends on the number of temperature changes at the inlet. Segments 
+ * with a temperature difference below DT_MERGE are merged, if MAXSEG
+ * segments are reached the two neighbours with the smallest difference
+ * are merged. Backflow (mdot < 0) is treated as no flow.
+ *
+ * Axial conduction uses COND as pipe_Tnodes, where the heat flow between
+ * two nodes is COND*VNODE*(T(n+1)-T(n)). Between two segments with the 
+ * volumes v(i) and v(i+1) the distance of the centres replaces the node
+ * distance, the conductance is COND*VNODE^2/((v(i)+v(i+1))/2). The 
+ * conduction is solved implicitly (tridiagonal, stable for any segment 
+ * size) in each update after the shift, the ends of the pipe are 
+ * adiabatic like in pipe_Tnodes. The energy of the profile is conserved,
+ * a temperature front is smeared by conduction only and not by the 
+ * discretisation. To resolve the profile at least like the nodes, the 
+ * pipe starts with one segment per node and the inlet segment is only
+ * merged up to the node volume. The parameter sets of pipe_Tnodes can 
+ * be used unchanged, with COND = 0 the transport delay is exact.
+ *
+ * The profile is updated once per major time step (mdlUpdate), the 
+ * block has no continuous states and does not limit the step size of 
+ * the solver. The thermal volume flow, the loss rate and the inlet and
+ * ambient temperature are stored in each update and used for the shift
+ * until the next update, so the block has no direct feedthrough (like 
+ * the states of pipe_Tnodes). mdlOutputs is called before mdlUpdate: 
+ * it shifts the stored profile to the current time without changing it
+ * and takes the outlet and node temperatures from the current plug 
+ * positions, which are the positions the next update stores. The 
+ * conduction since the last update is only applied in mdlUpdate.
+ *
+ *  symbol      used for                                        unit
+ *  cp          heat capacity of fluid                          J/(kg*K)
+ *  cwall       heat capacity of pipe per volume                J/(m^3*K)
+ *  LOSS        heat loss coefficient per volume                W/(m^3*K)
+ *  mdot        mass flow rate                                  kg/s
+ *  rho         density                                         kg/m^3
+ *  T           temperature                                     degree Celsius
+ *  t           time                                            s
+ *         
+ * structure of u (input vector)
+ *  see defines below, same as pipe_Tnodes
+ *
+ * structure of y (output vector)
+ *  index   use
+ *  0       temperature                                     degree Celsius  
+ *  1       temperatures in the centres of the NODES        degree Celsius 
+ *          sections of the pipe (vector)
+ *
+ */
+
+
+#define S_FUNCTION_NAME  pipe_plugflow
+#define S_FUNCTION_LEVEL 2
+
+/*
+ * Need to include simstruc.h for the definition of the SimStruct and
+ * its associated macro definitions.
+ */
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+
+/*
+ *   Defines for easy access to the parameters (not inputs!) 
+ *   that are passed in. (ATTENTION: ssGetArg() returns **Matrix !!
+ *   but mxGetPr() converts to double-pointer)
+ *   The parameters are the same as for pipe_Tnodes, MAXSEG is optional.
+ */
+#define VNODE     *mxGetPr(ssGetSFcnParam(S,0)) /* volume of the node in m^3 */
+#define LNODE     *mxGetPr(ssGetSFcnParam(S,1)) /* length per node in m */
+#define LOSS      *mxGetPr(ssGetSFcnParam(S,2)) /* loss coefficient [W/(m^3*K)] */
+#define COND      *mxGetPr(ssGetSFcnParam(S,3)) /* axial conductivity / (node distance)^2 [W/(m^3*K)] */
+#define CWALL     *mxGetPr(ssGetSFcnParam(S,4)) /* capacity wall per node volume in J/(m^3*K)*/
+#define TINI      *mxGetPr(ssGetSFcnParam(S,5)) /* initial temperature [C]  */
+#define NODES     *mxGetPr(ssGetSFcnParam(S,6)) /* number of nodes (sections for output 1) */
+#define N_PARAM                             7
+#define MAXSEG    ((ssGetSFcnParamsCount(S) > N_PARAM)? \
+    (int_T)(*mxGetPr(ssGetSFcnParam(S,7))+0.5) : MAXSEG_DEFAULT) /* maximum number of segments */
+#define N_PARAM_MAXSEG                      8
+
+#define MAXSEG_DEFAULT  100     /* default maximum number of segments */
+#define DT_MERGE        0.01    /* segments with smaller temperature difference are merged */
+                             
+#define TAMB       (*u0[0])     /* ambient temperature */
+#define TIN        (*u1[0])     /* inlet temperature */
+#define MDOT       (*u2[0])     /* massflow */
+#define PRESS      (*u3[0])     /* pressure */
+#define FLUID_ID   (*u4[0])     /* fluid ID (defined in CARNOT.h) */
+#define PERCENTAGE (*u5[0])     /* mixture  (defined in CARNOT.h) */
+#define N_INPUT_PORTS 6
+
+/* segments in a ring buffer, segment 0 is at the outlet, segment NSEG-1 at the inlet */
+#define DWORK_SEGV_NR   0       /* volume of the segments */
+#define DWORK_SEGT_NR   1       /* temperature of the segments */
+#define DWORK_FIFO_NR   2       /* first segment (ring index) and number of segments */
+#define DWORK_TIME_NR   3       /* time of last update and rates for the next shift */
+#define DWORK_COND_NR   4       /* work vectors of the conduction (2*MAXSEG) */
+#define SEGV(i)         segv[(FIRST+(i))%maxseg]
+#define SEGT(i)         segt[(FIRST+(i))%maxseg]
+#define FIRST           fifo[0]
+#define NSEG            fifo[1]
+#define TLAST           tdw[0]  /* time of last update */
+#define VRATE           tdw[1]  /* thermal volume flow in m^3/s */
+#define KLOSS           tdw[2]  /* loss rate in 1/s */
+#define TINLAST         tdw[3]  /* inlet temperature */
+#define TAMBLAST        tdw[4]  /* ambient temperature */
+
+
+/* merge segment i and i+1 (counted from the outlet) to segment i */
+static void merge_segments(real_T *segv, real_T *segt, int32_T *fifo, int_T maxseg, int_T i)
+{
+    int_T k;
+    real_T v = SEGV(i) + SEGV(i+1);
+
+    SEGT(i) = (SEGV(i)*SEGT(i) + SEGV(i+1)*SEGT(i+1))/v;
+    SEGV(i) = v;
+    for (k = i+1; k < NSEG-1; k++)
+    {
+        SEGV(k) = SEGV(k+1);
+        SEGT(k) = SEGT(k+1);
+    }
+    NSEG--;
+}
+
+
+/* implicit conduction step between the segments during dt, gdt is 
+ * COND*VNODE^2*dt/cap, cw work vector of 2*maxseg: 
+ *  v(i)*(T'(i)-T(i)) = k(i-1)*(T'(i-1)-T'(i)) + k(i)*(T'(i+1)-T'(i))
+ *  with k(i) = gdt/((v(i)+v(i+1))/2), solved with the Thomas algorithm */
+static void conduction(real_T *segv, real_T *segt, int32_T *fifo, int_T maxseg, 
+    real_T *cw, real_T gdt)
+{
+    real_T *cp = cw;            /* modified upper diagonal */
+    real_T *dp = cw + maxseg;   /* modified right side */
+    real_T kl, kr, den;
+    int_T  i;
+
+    kl = 0.0;                   /* adiabatic outlet */
+    for (i = 0; i < NSEG; i++)
+    {
+        kr = (i < NSEG-1)? 2.0*gdt/(SEGV(i)+SEGV(i+1)) : 0.0;  /* adiabatic inlet */
+        den = SEGV(i) + kl + kr - ((i > 0)? kl*cp[i-1] : 0.0);
+        cp[i] = kr/den;
+        dp[i] = (SEGV(i)*SEGT(i) + ((i > 0)? kl*dp[i-1] : 0.0))/den;
+        kl = kr;
+    }
+    SEGT(NSEG-1) = dp[NSEG-1];
+    for (i = NSEG-2; i >= 0; i--)
+        SEGT(i) = dp[i] + cp[i]*SEGT(i+1);
+}
+
+
+/* losses and thermal volume of the shift by dt with the stored rates: 
+ * decay of fluid staying in the pipe, inlet temperature of fluid entering
+ * during the shift (with the mean loss over its residence time) */
+static void shift_coefficients(real_T *tdw, real_T dt, real_T *decay, real_T *tin, real_T *dvth)
+{
+    real_T kdt = KLOSS*dt;
+
+    *decay = exp(-kdt);
+    *tin = TAMBLAST + (TINLAST-TAMBLAST)*((kdt > 1.0e-10)? (1.0-*decay)/kdt : 1.0);
+    *dvth = VRATE*dt;
+}
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
+{
+    if (VNODE <= 0.0) {
+        ssSetErrorStatus(S,"pipe_plugflow: node volume must be > 0");
+        return;
+    }
+    if (COND < 0.0) {
+        ssSetErrorStatus(S,"pipe_plugflow: axial conduction must be >= 0");
+        return;
+    }
+    if (NODES < 1.0) {
+        ssSetErrorStatus(S,"pipe_plugflow: number of nodes must be >= 1");
+        return;
+    }
+    if (MAXSEG < 2) {
+        ssSetErrorStatus(S,"pipe_plugflow: maximum number of segments must be >= 2");
+        return;
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T n;
+
+    if (ssGetSFcnParamsCount(S) == N_PARAM_MAXSEG)  /* MAXSEG is optional */
+        ssSetNumSFcnParams(S, N_PARAM_MAXSEG);
+    else
+        ssSetNumSFcnParams(S, N_PARAM);  /* Number of expected parameters */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL) {
+        return;
+    }
+#endif
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, N_INPUT_PORTS)) return;
+    for (n = 0; n < N_INPUT_PORTS; n++)
+    {
+        ssSetInputPortWidth(S, n, 1);
+        ssSetInputPortDirectFeedThrough(S, n, 0);
+    }
+
+    if (!ssSetNumOutputPorts(S, 2)) return;
+    ssSetOutputPortWidth(S, 0, 1);
+    ssSetOutputPortWidth(S, 1, (int_T)NODES);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetNumDWork(S, 5);
+    ssSetDWorkWidth(S, DWORK_SEGV_NR, MAXSEG);
+    ssSetDWorkDataType(S, DWORK_SEGV_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_SEGV_NR, "DWORK_SEGV");
+    ssSetDWorkUsageType(S, DWORK_SEGV_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_SEGT_NR, MAXSEG);
+    ssSetDWorkDataType(S, DWORK_SEGT_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_SEGT_NR, "DWORK_SEGT");
+    ssSetDWorkUsageType(S, DWORK_SEGT_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_FIFO_NR, 2);
+    ssSetDWorkDataType(S, DWORK_FIFO_NR, SS_INT32);
+    ssSetDWorkName(S, DWORK_FIFO_NR, "DWORK_FIFO");
+    ssSetDWorkUsageType(S, DWORK_FIFO_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_TIME_NR, 5);
+    ssSetDWorkDataType(S, DWORK_TIME_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_TIME_NR, "DWORK_TIME");
+    ssSetDWorkUsageType(S, DWORK_TIME_NR, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_COND_NR, 2*MAXSEG);
+    ssSetDWorkDataType(S, DWORK_COND_NR, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_COND_NR, "DWORK_COND");
+    ssSetDWorkUsageType(S, DWORK_COND_NR, SS_DWORK_USED_AS_DWORK);
+    
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+    
+    ssSupportsMultipleExecInstances(S, true);
+
+    /* Take care when specifying exception free code - see sfuntmpl.doc */
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Continuous sample time, the profile is only updated in major time 
+ *    steps.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, FIXED_IN_MINOR_STEP_OFFSET);
+}
+
+
+#define MDL_INITIALIZE_CONDITIONS   /* Change to #undef to remove function */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+  /* Function: mdlInitializeConditions ========================================
+   * Abstract:
+   *    The pipe is filled with one segment at the initial temperature, 
+   *    with axial conduction with one segment per node (at most MAXSEG/2).
+   */
+  static void mdlInitializeConditions(SimStruct *S)
+  {
+    real_T  *segv = (real_T *)ssGetDWork(S, DWORK_SEGV_NR);
+    real_T  *segt = (real_T *)ssGetDWork(S, DWORK_SEGT_NR);
+    int32_T *fifo = (int32_T *)ssGetDWork(S, DWORK_FIFO_NR);
+    real_T  *tdw  = (real_T *)ssGetDWork(S, DWORK_TIME_NR);
+    int_T   maxseg = MAXSEG;
+    int_T   i;
+
+    FIRST = 0;
+    NSEG = (COND > 0.0)? max(1, min((int_T)NODES, maxseg/2)) : 1;
+    for (i = 0; i < NSEG; i++)
+    {
+        SEGV(i) = VNODE*NODES/NSEG;
+        SEGT(i) = TINI;
+    }
+    TLAST = ssGetT(S);
+    VRATE = 0.0;
+    KLOSS = 0.0;
+    TINLAST = TINI;
+    TAMBLAST = TINI;
+  }
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Outlet temperature and temperatures in the centres of the NODES 
+ *    sections.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T  *y0 = ssGetOutputPortRealSignal(S,0);
+    real_T  *y1 = ssGetOutputPortRealSignal(S,1);
+    real_T  *segv = (real_T *)ssGetDWork(S, DWORK_SEGV_NR);
+    real_T  *segt = (real_T *)ssGetDWork(S, DWORK_SEGT_NR);
+    int32_T *fifo = (int32_T *)ssGetDWork(S, DWORK_FIFO_NR);
+    real_T  *tdw  = (real_T *)ssGetDWork(S, DWORK_TIME_NR);
+    real_T  vnode = VNODE;
+    int_T   nodes = (int_T)NODES;
+    int_T   maxseg = MAXSEG;
+    real_T  decay, dvth, tin, vpos, vseg;
+    int_T   n, i;
+
+    /* shift since the last update */
+    shift_coefficients(tdw, max(ssGetT(S)-TLAST, 0.0), &decay, &tin, &dvth);
+
+    /* outlet temperature: first segment which has not left the pipe */
+    i = 0;
+    vseg = SEGV(0);             /* volume from outlet to the end of segment i */
+    while (dvth >= vseg && i < NSEG-1)
+    {
+        i++;
+        vseg += SEGV(i);
+    }
+    y0[0] = (dvth >= vseg)? tin : TAMBLAST + (SEGT(i)-TAMBLAST)*decay;
+
+    /* walk from the inlet (last segment) to the outlet */
+    i = NSEG-1;
+    vseg = SEGV(i);             /* volume from inlet to the end of segment i */
+    for (n = 0; n < nodes; n++)
+    {
+        vpos = ((real_T)n+0.5)*vnode - dvth;    /* node position in the stored profile */
+        if (vpos < 0.0)
+        {
+            y1[n] = tin;        /* fluid which entered since the last update */
+            continue;
+        }
+        while (vpos > vseg && i > 0)
+        {
+            i--;
+            vseg += SEGV(i);
+        }
+        y1[n] = TAMBLAST + (SEGT(i)-TAMBLAST)*decay;    /* T nodes */
+    }
+}
+
+
+#define MDL_UPDATE
+#if defined(MDL_UPDATE)
+  /* Function: mdlUpdate ======================================================
+   * Abstract:
+   *    Shift the profile by the thermal volume since the last update, 
+   *    apply the losses and the conduction, store the rates for the next
+   *    shift.
+   */
+  static void mdlUpdate(SimStruct *S, int_T tid)
+  {
+    real_T  *segv = (real_T *)ssGetDWork(S, DWORK_SEGV_NR);
+    real_T  *segt = (real_T *)ssGetDWork(S, DWORK_SEGT_NR);
+    int32_T *fifo = (int32_T *)ssGetDWork(S, DWORK_FIFO_NR);
+    real_T  *tdw  = (real_T *)ssGetDWork(S, DWORK_TIME_NR);
+    real_T  *cw   = (real_T *)ssGetDWork(S, DWORK_COND_NR);
+    InputRealPtrsType u0 = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType u1 = ssGetInputPortRealSignalPtrs(S,1);
+    InputRealPtrsType u2 = ssGetInputPortRealSignalPtrs(S,2);
+    InputRealPtrsType u3 = ssGetInputPortRealSignalPtrs(S,3);
+    InputRealPtrsType u4 = ssGetInputPortRealSignalPtrs(S,4);
+    InputRealPtrsType u5 = ssGetInputPortRealSignalPtrs(S,5);
+    int_T   maxseg = MAXSEG;
+    real_T  t = ssGetT(S);
+    real_T  dt = t - TLAST;
+    real_T  tamb = TAMBLAST;
+    real_T  rho, cpf, cap, decay, dvth, vout, dv, tin, dtmin;
+    int_T   i, imin;
+
+    shift_coefficients(tdw, max(dt, 0.0), &decay, &tin, &dvth);
+
+    /* remove dvth at the outlet */
+    vout = 0.0;
+    while (dvth - vout > 0.0 && NSEG > 0)
+    {
+        dv = min(SEGV(0), dvth - vout);
+        vout += dv;
+        SEGV(0) -= dv;
+        if (SEGV(0) <= 1.0e-12*dvth)        /* segment has left the pipe */
+        {
+            FIRST = (FIRST+1)%maxseg;
+            NSEG--;
+        }
+    }
+
+    /* losses of the segments staying in the pipe */
+    for (i = 0; i < NSEG; i++)
+        SEGT(i) = tamb + (SEGT(i)-tamb)*decay;
+
+    /* add the inlet segment */
+    dv = min(dvth, VNODE*NODES);
+    if (dv > 0.0)
+    {
+        if (NSEG > 0 && fabs(SEGT(NSEG-1)-tin) < DT_MERGE
+            && (COND <= 0.0 || SEGV(NSEG-1)+dv <= VNODE))  /* conduction: node resolution */
+        {
+            SEGT(NSEG-1) = (SEGV(NSEG-1)*SEGT(NSEG-1) + dv*tin)/(SEGV(NSEG-1)+dv);
+            SEGV(NSEG-1) += dv;
+        }
+        else
+        {
+            if (NSEG >= maxseg)             /* merge the most similar neighbours */
+            {
+                imin = 0;
+                dtmin = fabs(SEGT(1)-SEGT(0));
+                for (i = 1; i < NSEG-1; i++)
+                {
+                    if (fabs(SEGT(i+1)-SEGT(i)) < dtmin)
+                    {
+                        dtmin = fabs(SEGT(i+1)-SEGT(i));
+                        imin = i;
+                    }
+                }
+                merge_segments(segv, segt, fifo, maxseg, imin);
+            }
+            NSEG++;
+            SEGV(NSEG-1) = dv;
+            SEGT(NSEG-1) = tin;
+        }
+    }
+
+    rho = density(FLUID_ID, PERCENTAGE, TIN, PRESS);
+    cpf = heat_capacity(FLUID_ID, PERCENTAGE, TIN, PRESS);
+    cap = rho*cpf + CWALL;                  /* heat capacity per volume */
+
+    /* axial conduction between the segments */
+    if (COND > 0.0 && NSEG > 1 && dt > 0.0)
+        conduction(segv, segt, fifo, maxseg, cw, COND*VNODE*VNODE*dt/cap);
+
+    /* rates for the shift until the next update */
+    TLAST = t;
+    VRATE = (MDOT > NO_MASSFLOW)? MDOT*cpf/cap : 0.0;
+    KLOSS = LOSS/cap;
+    TINLAST = TIN;
+    TAMBLAST = TAMB;
+  }
+#endif /* MDL_UPDATE */
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was
+ *    allocated in mdlStart, this is the place to free it.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
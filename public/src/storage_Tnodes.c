@@ -58,6 +58,12 @@
  * 6.1.5    hf      ssSetInputPortDirectFeedThrough to 0        13jan2017
  *                  for all inports, was not the reason for
  *                  Matlab crash
+ * 6.2.0    hf      optional discrete mode with internal upwind  19oct2026
+ *                  advection and Crank-Nicolson conduction step
+ * 6.2.1    hf      geometry from the carlib function           19oct2026
+ *                  storage_nodes
+ * 6.2.2    hf      discrete mode: advection substeps by third  19oct2026
+ *                  order SSP Runge-Kutta
  *
  * Copyright (c) 1998-2017 Solar-Institut Juelich, Germany
  * additional copyright by the authors
@@ -123,6 +129,24 @@
  * The output vector y[] starts with the bottom-temperature (y[0]) and
  * ends with the top-temperature (y[M_PTS]).
  *
+ * ----- Discrete mode -----
+ * With large charge flows the advection term mdot*cp/Vnode*(Tneighbour-T)
+ * makes the system stiff and the variable step solver collapses to very
+ * small steps. If the optional parameter TSAMPLE is given and > 0, the
+ * node temperatures are discrete states and the equation above is 
+ * integrated internally over each sample period in mdlUpdate:
+ *  1. advection by an upwind sweep. The sample period is divided into
+ *     substeps so that no node exchanges more than half of its mass per
+ *     substep. Each substep is a third order strong stability preserving
+ *     Runge-Kutta step (Shu, Osher) of three explicit upwind stages, it
+ *     is monotone like the single explicit sweep but follows the
+ *     thermocline of the continuous model.
+ *  2. losses, axial conduction and power input by a Crank-Nicolson step,
+ *     the tridiagonal system is solved by solve_tridiagonal (carlib).
+ *  3. mixing of inversed thermoclines as in the continuous model.
+ * Density and heat capacity are evaluated once per sample period. Ports
+ * and outputs are the same as for the continuous model.
+ *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  *           Definiton of inputs and outputs 
  *
@@ -186,6 +210,10 @@
 #define NODES           *mxGetPr(ssGetSFcnParam(S, 8))      /* number of nodes */
 #define NCONNECT  (int)(*mxGetPr(ssGetSFcnParam(S, 9))+0.5) /* number of connections */
 #define NPARAMS                                   10
+/* optional parameter: sample time [s] of the discrete mode, 0 or not set = continuous */
+#define TSAMPLE   ((ssGetSFcnParamsCount(S) > NPARAMS) ? *mxGetPr(ssGetSFcnParam(S, 10)) : 0.0)
+#define NPARAMS_DISCRETE                          11
+#define DISCRETE  (TSAMPLE > 0.0)
 
 /* defines for inputs */
 #define TAMB            (*u0[0])            /* ambient temperature is first input */
@@ -212,6 +240,7 @@
 #define DEDT    dx[nodes+1]         /* time derivative of internal energy = power */
 
 #define N_CONT_STATES  ((int_T)NODES+2)
+#define N_DISC_STATES  ((int_T)NODES+2)     /* same states in discrete mode */
 
 
 
@@ -230,6 +259,7 @@
 #define DWORK_QDOTIN_NR         12    /* entering power */
 #define DWORK_TIN_NR            13    /* entering temperature */
 #define DWORK_CHECK_FLUIDS_NR   14    /* flag for checking incomming fluids (once per simulation) */
+#define DWORK_SOLVE_NR          15    /* work arrays of the discrete mode */
 
 #define DH                      dwork_dh[0]           /* heigth of one node */
 #define HCON                    dwork_hcon[0]         /* heat transport by conductivity */
@@ -246,6 +276,13 @@
 #define QDOTIN(n)               dwork_qdotin[n]       /* entering power */
 #define TIN(n)                  dwork_tin[n]          /* entering temperature */
 #define CHECK_FLUIDS            dwork_check_fluids[0] /* flag for checking incomming fluids (once per simulation) */
+#define SUBDIAG(n)              dwork_solve[n]        /* lower diagonal of the tridiagonal system */
+#define MAINDIAG(n)             dwork_solve[n+nodes]  /* main diagonal */
+#define SUPDIAG(n)              dwork_solve[n+2*nodes]/* upper diagonal */
+#define RHS(n)                  dwork_solve[n+3*nodes]/* right hand side, also advection increment */
+#define TSTART(n)               dwork_solve[n+4*nodes]/* node temperature at start of the sample period */
+#define TSUB(n)                 dwork_solve[n+5*nodes]/* node temperature at start of the advection substep */
+#define N_SOLVE                 6                     /* number of work arrays of length nodes */
 
 /* other defines */
 #define TOP                 (nodes-1)
@@ -332,6 +369,13 @@ static void mdlCheckParameters(SimStruct *S)
               return;
           }
       }
+      /* sample time of discrete mode */
+      {
+          if (TSAMPLE < 0.0) {
+              ssSetErrorStatus(S,"Sample time must be >= 0 (0 = continuous)");
+              return;
+          }
+      }
     // printf("end check param");   // *************
 }
 #endif /* MDL_CHECK_PARAMETERS */
@@ -348,7 +392,11 @@ static void mdlInitializeSizes(SimStruct *S)
 
     // printf("start initialize");   // *************
 
-    ssSetNumSFcnParams(S, NPARAMS);
+    /* the sample time of the discrete mode is an optional last parameter */
+    if (ssGetSFcnParamsCount(S) == NPARAMS_DISCRETE)
+        ssSetNumSFcnParams(S, NPARAMS_DISCRETE);
+    else
+        ssSetNumSFcnParams(S, NPARAMS);
     #if defined(MATLAB_MEX_FILE)
     if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
     {
@@ -364,8 +412,16 @@ static void mdlInitializeSizes(SimStruct *S)
     }
     #endif
 
-    ssSetNumContStates(S, N_CONT_STATES);   /* number of continuous states */
-    ssSetNumDiscStates(S, 0);               /* number of discrete states */
+    if (DISCRETE)
+    {
+        ssSetNumContStates(S, 0);               /* number of continuous states */
+        ssSetNumDiscStates(S, N_DISC_STATES);   /* number of discrete states */
+    }
+    else
+    {
+        ssSetNumContStates(S, N_CONT_STATES);   /* number of continuous states */
+        ssSetNumDiscStates(S, 0);               /* number of discrete states */
+    }
 
     if (!ssSetNumInputPorts(S, N_INPUT_PORTS)) return;
 
@@ -386,7 +442,7 @@ static void mdlInitializeSizes(SimStruct *S)
     
     ssSetNumSampleTimes(S, 1);
 
-    ssSetNumDWork(S, 15);
+    ssSetNumDWork(S, 16);
     ssSetDWorkWidth(S, 0, 1); /* heigth of one node */
     ssSetDWorkDataType(S, 0, SS_DOUBLE);
     ssSetDWorkName(S, 0, "DWORK_DH");
@@ -447,6 +503,10 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetDWorkDataType(S, 14, SS_UINT8);
     ssSetDWorkName(S, 14, "DWORK_CHK_FLU");
     ssSetDWorkUsageType(S, 14, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, 15, (DISCRETE)? N_SOLVE*(int)NODES : 1); /* work arrays of discrete mode */
+    ssSetDWorkDataType(S, 15, SS_DOUBLE);
+    ssSetDWorkName(S, 15, "DWORK_SOLVE");
+    ssSetDWorkUsageType(S, 15, SS_DWORK_USED_AS_DWORK);
     
     ssSetNumRWork(S, 0);
     ssSetNumIWork(S, 0);
@@ -464,11 +524,14 @@ static void mdlInitializeSizes(SimStruct *S)
 
 /* Function: mdlInitializeSampleTimes =========================================
  * Abstract:
- *    Specifiy that we inherit our sample time from the driving block.
+ *    Continuous sample time, or the parameter TSAMPLE in discrete mode.
  */
 static void mdlInitializeSampleTimes(SimStruct *S)
 {
-    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    if (DISCRETE)
+        ssSetSampleTime(S, 0, TSAMPLE);
+    else
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
     ssSetOffsetTime(S, 0, 0.0);
 }
 
@@ -489,65 +552,17 @@ static void mdlStart(SimStruct *S)
     real_T *dwork_v_node = (real_T *)ssGetDWork(S, DWORK_V_NODE_NR);
     real_T *dwork_loss   = (real_T *)ssGetDWork(S, DWORK_LOSS_NR);
     
-    real_T vol   = VOLUME;      /* storage volume   */
-    real_T dia   = DIA;         /* storage diameter */
-    real_T uloss = ULOSS;       /* heat loss coefficient */
-    real_T ubot  = UBOT;        /* heat loss coefficient of the bottom */
-    real_T utop  = UTOP;        /* heat loss coefficient of the top */
     real_T cond  = COND;        /* vertical conductivity */
     int_T  nodes = (int_T)NODES;/* numer of nodes   */
-    int_T  standing = (int_T)STANDING;
-    
-    int_T n;
-    real_T Aloss, h1, a1, a2;
-
-    // printf("start mdlStart");   // *************
 
     FLUID = 0.0;                /* no fluid in the storage at the beginning */
     
-    /* height of one node */
-    if (standing)
-        DH = 4.0*vol/(PI*dia*dia*(real_T)nodes);
-    else
-        DH = dia/(real_T)nodes;
+    /* height, volume and loss of the nodes */
+    DH = storage_nodes(VOLUME, DIA, ULOSS, UBOT, UTOP, nodes, STANDING, 
+        dwork_v_node, dwork_loss);
     
     /* heat transport terms */
     HCON  = cond/(DH*DH);                   /* by conductivity in W/m^3/K */
-    
-    /* volume and loss of one node */
-    if (standing)                           /* geometry of a vertical cylinder */
-    {
-        for (n = BOTTOM; n <= TOP; n++) 
-        {
-            V_NODE(n) = vol/(real_T)nodes;  /* volume of node */
-            Aloss = PI*dia*DH;
-            LOSS(n) = uloss*Aloss/V_NODE(n); /* storage losses per node in W/m^3 */     
-        }
-        LOSS(TOP)    += utop/DH;            /* extra losses of top */
-        LOSS(BOTTOM) += ubot/DH;            /* extra losses of bottom */
-    } 
-    else                                    /* values for lying cylinder */
-    {
-        h1 = 0.0;
-        a1 = 0.0;
-        
-        Aloss = (4.0*vol/dia + 0.5*PI*dia*dia)/(real_T)nodes;
-        
-        for (n = BOTTOM; n <= TOP; n++) 
-        {
-            h1 += DH;
-            a2 = a1;                                        /* crosssection surface of slice below */ 
-            a1 = 0.5*(0.25*dia*dia*2.0*acos(1.0-2.0*h1/dia)
-                - 2.0*sqrt(dia*h1-h1*h1)*(0.5*dia-h1));
-            V_NODE(n) = (a1-a2)*4.0*vol/(PI*dia*dia);       /* volume of slice without inner storage*/
-            LOSS(n)  = uloss*Aloss/V_NODE(n);               /* loss of side walls in W/m^3 */
-            
-            //printf("n=%i  a1=%3.2f  a2=%3.2f  h1=%3.2f  V=%3.2f  LOSS=%3.2f \n", n, a1, a2, h1, V_NODE(n), LOSS(n));
-            
-            /* bottom and top losses are not evaluated for lying cylinder */
-        } /* end for */
-    } /* end if ... else ... */
-    // printf("end mdlStart");   // *************
 } /* end mdl_start */
 #endif /*  MDL_START */
 
@@ -561,7 +576,7 @@ static void mdlStart(SimStruct *S)
 #if defined(MDL_INITIALIZE_CONDITIONS)
 static void mdlInitializeConditions(SimStruct *S)
 {
-    real_T *x0    = ssGetContStates(S);
+    real_T *x0    = (DISCRETE)? ssGetRealDiscStates(S) : ssGetContStates(S);
     uint8_T *dwork_check_fluids = (uint8_T*)ssGetDWork(S, DWORK_CHECK_FLUIDS_NR);
     const real_T *t0 = mxGetPr(TINI);                   /* access to vector: see simulink\src\vlimitint.c */
     int_T sizet0 = (int_T)mxGetNumberOfElements(TINI);
@@ -597,37 +612,18 @@ static void mdlInitializeConditions(SimStruct *S)
 
 
 
-/* Function: mdlOutputs =======================================================
+/* Function: mix_inversed_thermocline =======================================
+ * Abstract:
+ *    Mix nodes with a higher temperature below a node with lower
+ *    temperature. Used by mdlOutputs (continuous) and mdlUpdate (discrete).
  */
-static void mdlOutputs(SimStruct *S, int_T tid)
+static void mix_inversed_thermocline(SimStruct *S, real_T *x)
 {
-    real_T *q = ssGetOutputPortRealSignal(S,0);
-    real_T *y = ssGetOutputPortRealSignal(S,1);
-    real_T *x = ssGetContStates(S);
     real_T *dwork_v_node = (real_T*)ssGetDWork(S, DWORK_V_NODE_NR);
     int_T  nodes = (int_T)NODES;    /* numer of nodes   */
     int_T  standing = (int_T)STANDING;
     real_T tmix, vol;
     int_T  n, i, inverse, ind;
-    
-    // printf("start mdlOutputs");   // *************
-    /*  port    index               use
-     *  0       0                   internal change of energy
-     *          1                   energy lost to ambient
-     *  1       0*nodes..1*nodes-1  temperatures of nodes
-     *          1*nodes..2*nodes-1  density of fluid at nodes
-     *          2*nodes..3*nodes-1  heat capacity of fluid at nodes
-     */
-    /* set node temperatures */
-    for (n = BOTTOM; n <= TOP; n++)
-    {
-        y[n] = T(n);
-        //y[n+nodes] = RHO_NODE(n);
-        //y[n+2*nodes] = CP_NODE(n);
-    }
-    /* energy balance */
-    q[0] = ENERGY;   /* internal change of energy */
-    q[1] = QLOSS;     /* thermal losses */
 
     /*****************************
      * inversed thermocline *
@@ -677,20 +673,56 @@ static void mdlOutputs(SimStruct *S, int_T tid)
             n--;
         } while (n > BOTTOM);
     } while (inverse); /* end do */
+} /* end mix_inversed_thermocline */
+
+
+
+/* Function: mdlOutputs =======================================================
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T *q = ssGetOutputPortRealSignal(S,0);
+    real_T *y = ssGetOutputPortRealSignal(S,1);
+    real_T *x = (DISCRETE)? ssGetRealDiscStates(S) : ssGetContStates(S);
+    int_T  nodes = (int_T)NODES;    /* numer of nodes   */
+    int_T  n;
+    
+    // printf("start mdlOutputs");   // *************
+    /*  port    index               use
+     *  0       0                   internal change of energy
+     *          1                   energy lost to ambient
+     *  1       0*nodes..1*nodes-1  temperatures of nodes
+     *          1*nodes..2*nodes-1  density of fluid at nodes
+     *          2*nodes..3*nodes-1  heat capacity of fluid at nodes
+     */
+    /* set node temperatures */
+    for (n = BOTTOM; n <= TOP; n++)
+    {
+        y[n] = T(n);
+        //y[n+nodes] = RHO_NODE(n);
+        //y[n+2*nodes] = CP_NODE(n);
+    }
+    /* energy balance */
+    q[0] = ENERGY;   /* internal change of energy */
+    q[1] = QLOSS;     /* thermal losses */
+
+    /* in discrete mode the layers are mixed in mdlUpdate */
+    if (!DISCRETE)
+        mix_inversed_thermocline(S, x);
 
     // printf("end mdlOutputs");   // *************
 } /* end mdlOutputs */
 
 
 
-#define MDL_DERIVATIVES
-/* Function: mdlDerivatives ================================================= */
-static void mdlDerivatives(SimStruct *S)
+/* Function: sum_connections ================================================
+ * Abstract:
+ *    Check the fluid at the first call and sum up massflows, power and
+ *    mixed inlet temperatures of all connections in the DWork arrays.
+ *    Returns 0 if an error occured.
+ */
+static int_T sum_connections(SimStruct *S)
 {
-    real_T            *dx = ssGetdX(S);
-    real_T            *x  = ssGetContStates(S);
-    real_T *dwork_dh            = (real_T*)ssGetDWork(S, DWORK_DH_NR);
-    real_T *dwork_hcon          = (real_T*)ssGetDWork(S, DWORK_HCON_NR);
     real_T *dwork_fluid         = (real_T*)ssGetDWork(S, DWORK_FLUID_NR);
     real_T *dwork_mix           = (real_T*)ssGetDWork(S, DWORK_MIX_NR);
     real_T *dwork_press         = (real_T*)ssGetDWork(S, DWORK_PRESS_NR);
@@ -699,26 +731,11 @@ static void mdlDerivatives(SimStruct *S)
     real_T *dwork_mdotdown      = (real_T*)ssGetDWork(S, DWORK_MDOTDOWN_NR);
     real_T *dwork_qdotin        = (real_T*)ssGetDWork(S, DWORK_QDOTIN_NR);
     real_T *dwork_tin           = (real_T*)ssGetDWork(S, DWORK_TIN_NR);
-    real_T *dwork_loss          = (real_T*)ssGetDWork(S, DWORK_LOSS_NR);
-    real_T *dwork_v_node        = (real_T*)ssGetDWork(S, DWORK_V_NODE_NR);
-    real_T *dwork_cp_node       = (real_T*)ssGetDWork(S, DWORK_CP_NODE_NR);
-    real_T *dwork_rho_node      = (real_T*)ssGetDWork(S, DWORK_RHO_NODE_NR);
     uint8_T *dwork_check_fluids = (uint8_T*)ssGetDWork(S, DWORK_CHECK_FLUIDS_NR);
-    InputRealPtrsType u0  = ssGetInputPortRealSignalPtrs(S,0);
     InputRealPtrsType u1;
-
-    /* get model parameters */
-    real_T vol  = VOLUME;
-    real_T dia  = DIA;
-    real_T dh   = DH;
-    real_T hcon = HCON;
     int_T  nodes = (int_T)NODES;
-    int_T  standing = (int_T)STANDING;
-    real_T uhx, loss;
     int_T  n, nc;
 
-    // printf("start mdlDerivatives");   // *************
-
     /* At the first function call: check the fluids entering the storage by a pipe connection */
     if (CHECK_FLUIDS)                           /* check incomming fluids once */
     {
@@ -737,7 +754,7 @@ static void mdlDerivatives(SimStruct *S)
             if (FLUID_ID > 0.0 && FLUID != FLUID_ID)
             {
                 ssSetErrorStatus(S,"storage_Tnodes: all entering fluids must be of the same type");
-                return;
+                return 0;
             }
         } /* end if CHECK_FLUIDS */
     }
@@ -751,11 +768,8 @@ static void mdlDerivatives(SimStruct *S)
         MDOTUP(n)   = 0.0;
         MDOTDOWN(n) = 0.0;
         QDOTIN(n)   = 0.0;
-        DTDT(n)     = 0.0;
         TIN(n)      = 0.0;
     }
-    DLOSSDT = 0.0;                          /* energy loss of storage is 0 */
-    DEDT = 0.0;                             /* energy change of storage is 0 */
 
     /* sum up massflow and power   */
     for (nc = 1; nc <= NCONNECT; nc++)      /* loop over all connections */
@@ -777,6 +791,56 @@ static void mdlDerivatives(SimStruct *S)
         } /* loop over nodes */
     } /* loop over connections */
 
+    return 1;
+} /* end sum_connections */
+
+
+
+#define MDL_DERIVATIVES
+/* Function: mdlDerivatives ================================================= */
+static void mdlDerivatives(SimStruct *S)
+{
+    real_T            *dx = ssGetdX(S);
+    real_T            *x  = ssGetContStates(S);
+    real_T *dwork_dh            = (real_T*)ssGetDWork(S, DWORK_DH_NR);
+    real_T *dwork_hcon          = (real_T*)ssGetDWork(S, DWORK_HCON_NR);
+    real_T *dwork_fluid         = (real_T*)ssGetDWork(S, DWORK_FLUID_NR);
+    real_T *dwork_mix           = (real_T*)ssGetDWork(S, DWORK_MIX_NR);
+    real_T *dwork_press         = (real_T*)ssGetDWork(S, DWORK_PRESS_NR);
+    real_T *dwork_mdotin        = (real_T*)ssGetDWork(S, DWORK_MDOTIN_NR);
+    real_T *dwork_mdotup        = (real_T*)ssGetDWork(S, DWORK_MDOTUP_NR);
+    real_T *dwork_mdotdown      = (real_T*)ssGetDWork(S, DWORK_MDOTDOWN_NR);
+    real_T *dwork_qdotin        = (real_T*)ssGetDWork(S, DWORK_QDOTIN_NR);
+    real_T *dwork_tin           = (real_T*)ssGetDWork(S, DWORK_TIN_NR);
+    real_T *dwork_loss          = (real_T*)ssGetDWork(S, DWORK_LOSS_NR);
+    real_T *dwork_v_node        = (real_T*)ssGetDWork(S, DWORK_V_NODE_NR);
+    real_T *dwork_cp_node       = (real_T*)ssGetDWork(S, DWORK_CP_NODE_NR);
+    real_T *dwork_rho_node      = (real_T*)ssGetDWork(S, DWORK_RHO_NODE_NR);
+    InputRealPtrsType u0  = ssGetInputPortRealSignalPtrs(S,0);
+
+    /* get model parameters */
+    real_T vol  = VOLUME;
+    real_T dia  = DIA;
+    real_T dh   = DH;
+    real_T hcon = HCON;
+    int_T  nodes = (int_T)NODES;
+    int_T  standing = (int_T)STANDING;
+    real_T uhx, loss;
+    int_T  n;
+
+    // printf("start mdlDerivatives");   // *************
+
+    /* sum up inputs of all connections */
+    if (!sum_connections(S))
+        return;
+
+    for (n = BOTTOM; n <= TOP; n++)  /* n counts from BOTTOM (0) to TOP (nodes-1) */
+    {
+        DTDT(n) = 0.0;
+    }
+    DLOSSDT = 0.0;                          /* energy loss of storage is 0 */
+    DEDT = 0.0;                             /* energy change of storage is 0 */
+
     /**********************************
      * start of main calculation loop *
      **********************************/
@@ -856,6 +920,147 @@ static void mdlDerivatives(SimStruct *S)
 } /* end mdlDerivatives */
 
 
+#define MDL_UPDATE
+/* Function: mdlUpdate ======================================================
+ * Abstract:
+ *    Discrete mode only: integrate the node temperatures over one sample
+ *    period. 1. upwind advection in Runge-Kutta substeps, 2. Crank-
+ *    Nicolson step for losses, conduction and power input, 3. mixing of
+ *    inversed thermoclines.
+ */
+static void mdlUpdate(SimStruct *S, int_T tid)
+{
+    real_T *x = ssGetRealDiscStates(S);
+    real_T *dwork_hcon          = (real_T*)ssGetDWork(S, DWORK_HCON_NR);
+    real_T *dwork_fluid         = (real_T*)ssGetDWork(S, DWORK_FLUID_NR);
+    real_T *dwork_mix           = (real_T*)ssGetDWork(S, DWORK_MIX_NR);
+    real_T *dwork_press         = (real_T*)ssGetDWork(S, DWORK_PRESS_NR);
+    real_T *dwork_mdotin        = (real_T*)ssGetDWork(S, DWORK_MDOTIN_NR);
+    real_T *dwork_mdotup        = (real_T*)ssGetDWork(S, DWORK_MDOTUP_NR);
+    real_T *dwork_mdotdown      = (real_T*)ssGetDWork(S, DWORK_MDOTDOWN_NR);
+    real_T *dwork_qdotin        = (real_T*)ssGetDWork(S, DWORK_QDOTIN_NR);
+    real_T *dwork_tin           = (real_T*)ssGetDWork(S, DWORK_TIN_NR);
+    real_T *dwork_loss          = (real_T*)ssGetDWork(S, DWORK_LOSS_NR);
+    real_T *dwork_v_node        = (real_T*)ssGetDWork(S, DWORK_V_NODE_NR);
+    real_T *dwork_cp_node       = (real_T*)ssGetDWork(S, DWORK_CP_NODE_NR);
+    real_T *dwork_rho_node      = (real_T*)ssGetDWork(S, DWORK_RHO_NODE_NR);
+    real_T *dwork_solve         = (real_T*)ssGetDWork(S, DWORK_SOLVE_NR);
+    InputRealPtrsType u0  = ssGetInputPortRealSignalPtrs(S,0);
+
+    real_T dt    = TSAMPLE;
+    real_T hcon  = HCON;
+    int_T  nodes = (int_T)NODES;
+    real_T rate, ratemax, dts, rhocp, a, l, qloss;
+    int_T  n, k, st, nsub;
+    /* weight of the substep start in the stages of the SSP Runge-Kutta */
+    static const real_T ssp_weight[3] = {0.0, 0.75, 1.0/3.0};
+
+    if (!DISCRETE)
+        return;
+
+    /* sum up inputs of all connections */
+    if (!sum_connections(S))
+        return;
+
+    /* fluid properties are constant during the sample period */
+    ratemax = 0.0;
+    for (n = BOTTOM; n <= TOP; n++)
+    {
+        CP_NODE(n) = heat_capacity(FLUID, MIX, T(n), PRESS);
+        RHO_NODE(n) = density(FLUID, MIX, T(n), PRESS);
+        TSTART(n) = T(n);
+
+        /* massflow entering the node related to the node mass in 1/s */
+        rate = MDOTIN(n);
+        if (n < TOP && MDOTUP(n) < MDOTDOWN(n))
+            rate += MDOTDOWN(n)-MDOTUP(n);
+        if (n > BOTTOM && MDOTUP(n-1) > MDOTDOWN(n-1))
+            rate += MDOTUP(n-1)-MDOTDOWN(n-1);
+        rate /= RHO_NODE(n)*V_NODE(n);
+        ratemax = max(ratemax, rate);
+    }
+
+    /*******************************
+     * 1. advection, upwind sweep  *
+     *******************************/
+    /* a node must not exchange more than half of its mass in one substep */
+    nsub = (int_T)ceil(2.0*ratemax*dt);
+    if (nsub < 1)
+        nsub = 1;
+    dts = dt/(real_T)nsub;
+
+    for (k = 0; k < nsub; k++)
+    {
+        for (n = BOTTOM; n <= TOP; n++)
+            TSUB(n) = T(n);
+
+        /* third order SSP Runge-Kutta: three explicit upwind stages, each
+         * stage is mixed with the temperature at the start of the substep */
+        for (st = 0; st < 3; st++)
+        {
+            for (n = BOTTOM; n <= TOP; n++)
+            {
+                RHS(n) = 0.0;                           /* mdot * T_diff */
+                if (MDOTIN(n) > 0.0)
+                    RHS(n) = MDOTIN(n)*(TIN(n)-T(n));
+                if (n < TOP && MDOTUP(n) < MDOTDOWN(n))
+                    RHS(n) += (MDOTDOWN(n)-MDOTUP(n))*(T(n+1)-T(n));
+                if (n > BOTTOM && MDOTUP(n-1) > MDOTDOWN(n-1))
+                    RHS(n) += (MDOTUP(n-1)-MDOTDOWN(n-1))*(T(n-1)-T(n));
+            }
+            for (n = BOTTOM; n <= TOP; n++)
+                T(n) = ssp_weight[st]*TSUB(n) + (1.0-ssp_weight[st])
+                    *(T(n) + dts*RHS(n)/(RHO_NODE(n)*V_NODE(n)));
+        }
+    }
+
+    /*****************************************
+     * 2. losses, conduction and power input *
+     *****************************************/
+    /* Crank-Nicolson: (I - dt/2*A) * Tnew = (I + dt/2*A) * T + dt*b */
+    qloss = 0.0;
+    for (n = BOTTOM; n <= TOP; n++)
+    {
+        rhocp = RHO_NODE(n)*CP_NODE(n);
+        a = 0.5*dt*hcon/rhocp;
+        l = 0.5*dt*LOSS(n)/rhocp;
+        qloss += LOSS(n)*V_NODE(n)*(TAMB-T(n));     /* losses at begin of the step */
+
+        SUBDIAG(n) = 0.0;
+        SUPDIAG(n) = 0.0;
+        MAINDIAG(n) = 1.0 + l;
+        RHS(n) = T(n) + 2.0*l*(TAMB-0.5*T(n)) + dt*QDOTIN(n)/(rhocp*V_NODE(n));
+        if (n < TOP)
+        {
+            MAINDIAG(n) += a;
+            SUPDIAG(n) = -a;
+            RHS(n) += a*(T(n+1)-T(n));
+        }
+        if (n > BOTTOM)
+        {
+            MAINDIAG(n) += a;
+            SUBDIAG(n) = -a;
+            RHS(n) += a*(T(n-1)-T(n));
+        }
+    }
+    solve_tridiagonal(&T(BOTTOM), &SUBDIAG(0), &MAINDIAG(0), &SUPDIAG(0), &RHS(0), nodes);
+
+    for (n = BOTTOM; n <= TOP; n++)
+        qloss += LOSS(n)*V_NODE(n)*(TAMB-T(n));     /* losses at end of the step */
+    QLOSS += 0.5*dt*qloss;                          /* trapezoidal rule like Crank-Nicolson */
+
+    /*******************************
+     * 3. inversed thermocline     *
+     *******************************/
+    mix_inversed_thermocline(S, x);
+
+    /* energy balance */
+    for (n = BOTTOM; n <= TOP; n++)
+        ENERGY += RHO_NODE(n)*CP_NODE(n)*V_NODE(n)*(T(n)-TSTART(n));
+} /* end mdlUpdate */
+
+
+
 /* Function: mdlTerminate =====================================================
  * Abstract:
  *    No termination needed, but we are required to have this routine.
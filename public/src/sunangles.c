@@ -48,6 +48,7 @@
  * 6.1.0    hf      call solar_position in carlib               18sep2015
  * 6.1.1    aw      unused variable coszenit in declination()   17jan2017
  *                  deleted
+ * 6.2.0    hf      whole time vector in solar_position_batch   19oct2026
  *
  * Copyright (c) 1999-2015 Solar-Institut Juelich, Germany
  * 
@@ -125,78 +126,21 @@ void declination(real_T *time, real_T *latitude, real_T *longitude,
         real_T *out_zenith, real_T *out_azimuth, real_T *out_hourangle,
         mwSize n_cells)
 {
-    real_T delta, deltaangle, woz, HourAngle, sunangle, IextraDay;
-    real_T azimut, zenith, lati;
-    real_T solpos[5];
-    int i;
+    mwSize i;
 
+    /* solar position of the whole time vector in the carlib function, 
+     * results in radian (out_altitude is not used by carlib) */
+    solar_position_batch(out_zenith, out_azimuth, out_decl, out_hourangle, 
+        NULL, (int)n_cells, time, *latitude, *longitude, *longitudenull);
+
+    /* transfer to degree, altitude is the angle between sun and horizon */
     for (i = 0; i < n_cells; i++)
     {
-        lati = (real_T)DEG2RAD*latitude[0];
-        
-        /* calculate solar position in the carlib function    */
-        solar_position(solpos, time[i], *latitude, *longitude, *longitudenull);
-        zenith = solpos[0]*RAD2DEG; // zenith angle in degree, 0 is solar position vertical above ground
-        azimut = solpos[1]*RAD2DEG; // azimut angle in degree, 0 is South, West is positive
-        delta = solpos[2];          // solar declination angle in radian, North positive
-        HourAngle = solpos[3];      // solar hour angle in radian, West positive
-        woz = solpos[4];            // true local time in s
-        /* declination of the sun in radian */
-//         DeclDay = solar_declination(time[i]);
-
-        /* Tagesmittelwert der extraterrestrischen Strahlung "IextraDay", die senkrecht*/
-        /* auf eine zur Sonne orientierten Flche fllt (nach Duffie/Beckman,1993,S.10):*/
-        /* IextraDay = 1353 * (1+0.033*cos(2*PI*day/365));   */
-        IextraDay = extraterrestrial_radiation(time[i]);
-       
-       /* ------------------------------------------------------------------------------- 
-    	* 	"Decl"			Deklination der Sonne
-    	*	"HourAngle" 	Stundenwinkel der Sonne 
-    	*	"zenit"			zenithwinkel 
-        *	"SunAngle"		Sonnenhhenwinkel
-    	* 	"azimut"			Azimutwinkel 
-    	*	"Iextra"			Extraterrestrische Strahlung auf HORIZONTALE Flche
-        *	"SunHour"		Tag-/Nachterkennung rkennung
-        *   "dimness"		Trbungsfaktor der Atmosphre
-        * 	"Idirclear"		direkte Strahlung auf der Erdoberflche fr KLAREN Himmel 
-    	* 	"Idfuclear"		diffuse Strahlung auf der Erdoberflche fr KLAREN Himmel 
-       /* -------------------------------------------------------------------------------*/ 
-
-        /* solar time 0 .. 24*3600 s */
-//         woz = solar_time(time[i], longitudenull[0], longitude[0]);      /* solar time from carlib */
-
-        /* determine solar hour angle in radian (noon = 0,  6 a.m. = -PI) */
-//         HourAngle = (woz - (real_T)43200.0)*(real_T)7.272205216643040e-5;
-
-        /* declination of the sun */
-//         delta = solar_declination(time[i]); 
-        deltaangle = RAD2DEG*delta;
-    
-        /* solar zenith angle in degrees (0 = zenith position, 90 = horizont) */
-//         coszenit = sin(lati)*sin(delta) + cos(lati)*cos(delta)*cos(HourAngle);
-//         zenith  =  acos(coszenit)*(real_T)RAD2DEG;   
-    
-        /* solar azimuth angle */
-//         if (zenith != (real_T)0.0)   /* for angles above 0 */
-//         {
-//             azimuth = (real_T)RAD2DEG*acos((sin(lati)*coszenit - sin(delta))
-//                 /(cos(lati)*sin(acos(coszenit))));
-//             if (HourAngle < (real_T)0.0)
-//                 azimuth = -azimuth;
-//         }
-//         else
-//             azimuth = (real_T)0.0;
-       
-        /* Sonnenhhenwinkel "SunAngle":*/
-        sunangle = 90.0 - zenith;
-//         if (sunangle < (real_T)0.01)
-//             sunangle = (real_T)0.01; /* da sonst Warnung "log(0)" (s.u.), falls SunAngle = 0.*/
-        
-        out_decl[i]      = deltaangle;
-        out_azimuth[i]   = azimut;
-        out_altitude[i]  = sunangle;
-        out_zenith[i]    = zenith; 
-        out_hourangle[i] = HourAngle*RAD2DEG;   
+        out_zenith[i]    = out_zenith[i]*RAD2DEG;
+        out_altitude[i]  = 90.0 - out_zenith[i];
+        out_azimuth[i]   = out_azimuth[i]*RAD2DEG;
+        out_decl[i]      = RAD2DEG*out_decl[i];
+        out_hourangle[i] = out_hourangle[i]*RAD2DEG;
     } // end for i
 } /* end declination */
 
@@ -255,12 +199,12 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
    
         decl        = mxGetPr(plhs[0]);
         altitude    = mxGetPr(plhs[1]);
-        azimuth     = mxGetPr(plhs[2]);
-        zenith      = mxGetPr(plhs[3]);
+        zenith      = mxGetPr(plhs[2]);
+        azimuth     = mxGetPr(plhs[3]);
         hourangle   = mxGetPr(plhs[4]);
 
         /* Do the actual computations in a subroutine */
-        declination(time,latitude,longitude,longitudenull,decl,altitude,azimuth,zenith,hourangle,n_cells);
+        declination(time,latitude,longitude,longitudenull,decl,altitude,zenith,azimuth,hourangle,n_cells);
    }
 } // end mexFunction
 
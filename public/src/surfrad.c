@@ -67,6 +67,8 @@
  * 6.1.2    aw      implicite casts replaced by explicite casts     10sep2015
  *                  unused variables deleted
  * 6.1.3    hf      modified no-sun condition                       23sep2016
+ * 6.1.4    hf      sky models from carlib (sky_coefficients,       19oct2026
+ *                  sky_diffuse), Perez coefficients from a table
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * parameters                                                           
  * index    use                                             units       
@@ -300,7 +302,7 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 
     real_T time = TIME;
     int_T skymodel = (int_T)SKYMODEL;
-    real_T idir_sun_h, idir_sun_n, idfu_sun_h;
+    real_T idir_sun_n, idfu_sun_h;
     
     real_T tetatrans = -9999.0; /* incidence angle transversal coll. plane */
     real_T tetalong  = -9999.0; /* incidence angle longitudinal coll. plane */
@@ -309,11 +311,9 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     real_T idfu_t    = 0.0;     /* diffuse radiation on surface */
     real_T iextra_n  = 0.0;     /* extraterrestrial radiation on horizontal */
     
-    real_T as, zs, rc, zc, ac, rb;
+    real_T as, zs, rc, zc, ac;
     real_T szc, czs, szs, czc, src, crc, sda, cda;
-    
-    real_T clearness, F1, F2, a, b, f11, f12, f13, f21, f22, f23, brightness; 	/* parameters Perez model */
-    real_T z3;                  /* dummy for zenith^3 */
+    real_T ksky[SKY_NCOEF];     /* coefficients of the sky model */
  	
     /* initialisation of variables */
     idir_sun_n = *uPtrs0[3];    /* direct normal beam radiation */
@@ -358,59 +358,10 @@ static void mdlOutputs(SimStruct *S, int_T tid)
         tetatrans = acos(costeta/sqrt(square(crc*sda*szs-src*(szc*cda*szs+czc*czs))+square(costeta)));
     
         /* ---- radiation on tilted surface ----- */
-        rb = costeta/czs;                                           /* ratio of direct radiation */
-        idir_sun_h = idir_sun_n*czs;                                /* direct radiation on horizontal */
-        idfu_t = (idfu_sun_h + idir_sun_h)*0.5*GREFLECT*(1.0-czc);  /* reflected from ground */
-    
-        switch (skymodel)       /* diffuse radiation on surface depends on sky model */
-        {
-            case 1:             /* isotropic sky model */
-                idfu_t += 0.5*idfu_sun_h*(1.0+czc);
-                break;
-            case 2:             /* Hay Davies sky model */
-                idfu_t += idfu_sun_h*((1.0-idir_sun_n/iextra_n)*0.5*(1.0+czc) + rb*idir_sun_n/iextra_n);
-                break;
-            case 3:             /* Perez sky model */
-                /* Testdataset from example 2.16.2 of Duffie Beckmann, 2006, p.95) */
-                /* czs = 0.466; zenith = 62.2; zs = DEG2RAD*62.2; rb = 1.71; time = 4352400; idfu_t = 0.787; costeta = 0.799 */
-                
-                a = max(0.0,costeta); 
-                b = max(cos(DEG2RAD*85),cos(zs));
-
-                /* clearness = ((idfu_t + idir_sun/czs)/idfu_sun + 5.535*1e-6*pow(zenith,3))/(1+5.535*1e-6*pow(zenith,3)); */ /* test example */
-                z3 = ZENITH*ZENITH*ZENITH;
-                clearness = ((idfu_sun_h + idir_sun_n)/idfu_sun_h + 5.535*1e-6*z3)/(1+5.535*1e-6*z3); 
-                
-                /* determination of brightness coefficients from Duffie-Beckman (2006) referring to Perez (1990) */	
-                if (clearness <= 1.065) {
-                    f11 = -0.008; f12 =  0.588; f13 = -0.062; f21 = -0.060; f22 = 0.072; f23 = -0.022;
-                } else if (clearness <= 1.23) {
-                    f11 =  0.130; f12 =  0.683; f13 = -0.151; f21 = -0.019; f22 = 0.066; f23 = -0.029;
-                } else if (clearness <= 1.5) {	
-                    f11 =  0.330; f12 =  0.487; f13 = -0.221; f21 =  0.055; f22 =-0.064; f23 = -0.026;
-                } else if (clearness <= 1.95) {
-                    f11 =  0.568; f12 =  0.187; f13 = -0.295; f21 =  0.109; f22 =-0.152; f23 =  0.014;
-                } else if (clearness < 2.8) {	
-                    f11 =  0.873; f12 = -0.392; f13 = -0.362; f21 =  0.226; f22 =-0.462; f23 =  0.001;
-                } else if (clearness < 4.5) {
-                    f11 =  1.132; f12 = -1.237; f13 = -0.412; f21 =  0.288; f22 =-0.823; f23 =  0.056;
-                } else if (clearness < 6.2) {
-                    f11 =  1.060; f12 = -1.600; f13 = -0.359; f21 =  0.264; f22 =-1.127; f23 =  0.131;
-                } else {
-                   f11 =  0.678; f12 = -0.327; f13 = -0.250; f21 =  0.156; f22 =-1.377; f23 =  0.251;
-                }
-
-                brightness = 1.0/czs * idfu_sun_h/iextra_n;
-	            F1 = max(0.0,(f11 + f12*brightness + f13*zs));
-                F2 = (f21 + f22*brightness + f23*zs);
-
-		        /* calculation of diffuse */
-          	    idfu_t += idfu_sun_h*((1.0-F1)*0.5*(1.0+czc) + F1*a/b + F2*szc);
-                break;
-            default: /* no sky model */
-                idfu_t += idfu_sun_h;
-                break;
-        }
+        /* diffuse radiation on surface depends on sky model (from carlib function) */
+        sky_coefficients(ksky, skymodel, ZENITH, idir_sun_n, idfu_sun_h, iextra_n, GREFLECT);
+        idfu_t = sky_diffuse(ksky, czc, szc, costeta);
+
         /* limited to iextra_n to avoid peaks at high ZENITH angles of sun */
         idfu_t = min(iextra_n, idfu_t);  /* diffuse radiation on surface  */
        
@@ -0,0 +1,358 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This s-function calculates the radiation on NPLANES tilted surfaces
+ * from the sun position. It is the vector form of surfrad: all surfaces
+ * of a building see the same sun and the same sky, so the sun angles,
+ * the extraterrestrial radiation and the coefficients of the sky model
+ * are calculated once per time step. The sines and cosines of the
+ * surface angles are calculated once in mdlStart. The loop over the
+ * surfaces has no trigonometric functions except the acos of the
+ * incidence angles. The sky models are the carlib functions
+ * sky_coefficients and sky_diffuse.
+ * The results are the same as with one surfrad block per surface.
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ * Version  Author  Changes                                         Date
+ * 6.1.0    hf      created                                         19oct2026
+ * 6.1.1    hf      sky models from carlib (sky_coefficients,       19oct2026
+ *                  sky_diffuse)
+ * 6.1.2    hf      other sky models than 1..3 accepted like in     19oct2026
+ *                  surfrad (diffuse radiation not changed)
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * parameters
+ * index    use                                             units
+ * 0        sky model (1=isotropic, 2=Hay Davies, 3=Perez,  -
+ *          other values: diffuse radiation not changed)
+ * 1        ground reflectance (0..1)                       -
+ * 2        surfaces, matrix NPLANES x 3 with one row per surface:
+ *          inclination of the surface (0 = horizontal)    degree
+ *          azimut of the surface (0=south, east negativ)  degree
+ *          collector rotation angle                        degree
+ *
+ * Definiton of INPUTS and OUTPUTS
+ * structure of the input vector
+ * port index   use                                             units
+ * 0    0..17   weather data vector (index see surfrad)
+ *
+ * structure of the output vector, all ports have the width NPLANES
+ * port  description                                         units
+ *  0    incidence angle on surface (0 = vertical)          degree
+ *  1    incidence angle in a vertical plane on the collecor degree
+ *       orientation of the plane is parallel to the risers,
+ *       referred as longitudinal plane in EN 12975
+ *  2    incidence angle in a vertical plane on the collecor degree
+ *       orientation of the plane is parallel to the headers
+ *       referred as transversal plane in EN 12975
+ *  3    direct solar radiation on surface                   W/m^2
+ *  4    diffuse solar radiation on surface                  W/m^2
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  L I T E R A T U R E
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * /1/  Duffie, Beckman: Solar Engineering of Thermal Processes, 2006
+ */
+
+#define S_FUNCTION_NAME surfrad_multi
+#define S_FUNCTION_LEVEL 2
+
+#include "tmwtypes.h"
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+#include <string.h>
+
+#define ZENITH      u0[1]
+#define AZIMUT      u0[2]
+#define IDIR_N      u0[3]       /* direct normal beam radiation */
+#define IDFU_H      u0[4]       /* diffuse radiation on horizontal */
+
+#define SKYMODEL    *mxGetPr(ssGetSFcnParam(S, 0)) /* sky model */
+#define GREFLECT    *mxGetPr(ssGetSFcnParam(S, 1)) /* ground reflectance */
+#define S_PLANES    ssGetSFcnParam(S, 2)           /* surfaces */
+#define NPLANES     ((int_T)mxGetM(S_PLANES))      /* number of surfaces */
+#define COLANGLE(i)  mxGetPr(S_PLANES)[i]
+#define COLAZIMUT(i) mxGetPr(S_PLANES)[NPLANES+(i)]
+#define COLROTATE(i) mxGetPr(S_PLANES)[2*NPLANES+(i)]
+
+#define TIME        ssGetT(S)
+
+#define DWORK_GEOM_NO   0       /* sin and cos of the surface angles */
+#define NGEOM           6       /* szc, czc, sac, cac, src, crc per surface */
+
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      /* */
+      {
+          if (GREFLECT < 0.0) {
+              ssSetErrorStatus(S,"Error in surfrad_multi: ground reflectance mustbe >= 0");
+              return;
+          }
+      }
+      /* */
+      {
+          if (NPLANES < 1 || mxGetN(S_PLANES) != 3) {
+              ssSetErrorStatus(S,"Error in surfrad_multi: surfaces must be a matrix with 3 columns (inclination, azimut, rotation)");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T n;
+
+    ssSetNumSFcnParams(S, 3);  /* Number of expected parameters */
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S)) {
+        mdlCheckParameters(S);
+        if(ssGetErrorStatus(S) != NULL) return;
+    } else {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#endif
+    /* the sines and cosines of the surfaces are calculated in mdlStart */
+    ssSetSFcnParamTunable(S, 2, SS_PRM_NOT_TUNABLE);
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, 18);
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+    ssSetInputPortRequiredContiguous(S, 0, true); /*direct input signal access*/
+
+    if (!ssSetNumOutputPorts(S, 5)) return;
+    for (n = 0; n < 5; n++)
+        ssSetOutputPortWidth(S, n, NPLANES);
+
+    ssSetNumDWork(S, 1);
+    ssSetDWorkWidth(S, DWORK_GEOM_NO, NGEOM*NPLANES);
+    ssSetDWorkDataType(S, DWORK_GEOM_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_GEOM_NO, "DWORK_GEOM");
+    ssSetDWorkUsageType(S, DWORK_GEOM_NO, SS_DWORK_USED_AS_DWORK);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+	ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+
+    ssSupportsMultipleExecInstances(S, true);
+
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    This function is used to specify the sample time(s) for your
+ *    S-function. You must register the same number of sample times as
+ *    specified in ssSetNumSampleTimes.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Sines and cosines of inclination, azimut and rotation angle of the
+   *    surfaces.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      real_T *geom = (real_T *)ssGetDWork(S, DWORK_GEOM_NO);
+      int_T  np = NPLANES;
+      int_T  i;
+
+      for (i = 0; i < np; i++)
+      {
+          geom[i]        = sin(DEG2RAD*COLANGLE(i));   /* szc */
+          geom[np+i]     = cos(DEG2RAD*COLANGLE(i));   /* czc */
+          geom[2*np+i]   = sin(DEG2RAD*COLAZIMUT(i));  /* sac */
+          geom[3*np+i]   = cos(DEG2RAD*COLAZIMUT(i));  /* cac */
+          geom[4*np+i]   = sin(DEG2RAD*COLROTATE(i));  /* src */
+          geom[5*np+i]   = cos(DEG2RAD*COLROTATE(i));  /* crc */
+      }
+  }
+#endif /*  MDL_START */
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Sky coefficients once (carlib sky_coefficients), then the loop over
+ *    the surfaces.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    const real_T *u0 = ssGetInputPortRealSignal(S, 0);
+    real_T *yteta  = ssGetOutputPortRealSignal(S, 0);
+    real_T *ylong  = ssGetOutputPortRealSignal(S, 1);
+    real_T *ytrans = ssGetOutputPortRealSignal(S, 2);
+    real_T *ydir   = ssGetOutputPortRealSignal(S, 3);
+    real_T *ydfu   = ssGetOutputPortRealSignal(S, 4);
+    const real_T *geom = (const real_T *)ssGetDWork(S, DWORK_GEOM_NO);
+    const real_T *szc = geom;
+    const real_T *czc = geom + NPLANES;
+    const real_T *sac = geom + 2*NPLANES;
+    const real_T *cac = geom + 3*NPLANES;
+    const real_T *src = geom + 4*NPLANES;
+    const real_T *crc = geom + 5*NPLANES;
+
+    real_T time = TIME;
+    int_T  np = NPLANES;
+    int_T  skymodel = (int_T)SKYMODEL;
+    int_T  i;
+    real_T idir_sun_n = IDIR_N;
+    real_T idfu_sun_h = IDFU_H;
+    real_T iextra_n, costeta, cda, sda, idir_t, idfu_t;
+    real_T as, zs, szs, czs, sas, cas;
+    real_T ksky[SKY_NCOEF];     /* coefficients of the sky model */
+
+    if (ZENITH == -9999.0 || AZIMUT == -9999.0)
+    {
+        ssSetErrorStatus(S,"surfrad_multi: weather data does not include sunposition.");
+        return;
+    }
+
+    as = DEG2RAD * AZIMUT;
+    zs = DEG2RAD * ZENITH;
+    szs = sin(zs);      /* sine ZENITH angle of sun */
+    czs = cos(zs);      /* cosine ZENITH angle of sun */
+    sas = sin(as);
+    cas = cos(as);
+
+    if (czs < 1.0e-3)   /* no sun */
+    {
+        for (i = 0; i < np; i++)
+        {
+            yteta[i] = 90.0;
+            ylong[i] = 90.0;
+            ytrans[i] = 90.0;
+            ydir[i] = 0.0;
+            ydfu[i] = 0.0;
+        }
+        return;
+    }
+
+    /* ---- sky dependent terms, same for all surfaces ---- */
+    iextra_n = extraterrestrial_radiation(time);
+    sky_coefficients(ksky, skymodel, ZENITH, idir_sun_n, idfu_sun_h, iextra_n, GREFLECT);
+
+    /* ---- loop over the surfaces ---- */
+    for (i = 0; i < np; i++)
+    {
+        sda = sas*cac[i] - cas*sac[i];  /* sin(as-ac) */
+        cda = cas*cac[i] + sas*sac[i];  /* cos(as-ac) */
+
+        /* cos of incidence angle on surface */
+        costeta = src[i]*sda*szs + crc[i]*(szc[i]*cda*szs + czc[i]*czs);
+        yteta[i] = min(90.0, RAD2DEG*acos(costeta));
+        /* incidence angle in longitudinal collector plane (direction riser - vertical on window) */
+        ylong[i] = min(90.0, RAD2DEG*acos(costeta/sqrt(square(czc[i]*cda*szs - szc[i]*czs)
+            + square(costeta))));
+        /* incidence angle in transversal collector plane (direction header - vertical on window) */
+        ytrans[i] = min(90.0, RAD2DEG*acos(costeta/sqrt(square(crc[i]*sda*szs
+            - src[i]*(szc[i]*cda*szs + czc[i]*czs)) + square(costeta))));
+
+        idfu_t = sky_diffuse(ksky, czc[i], szc[i], costeta);
+        /* limited to iextra_n to avoid peaks at high ZENITH angles of sun */
+        idfu_t = min(iextra_n, idfu_t);
+        idir_t = min(iextra_n, idir_sun_n*costeta);
+
+        ydir[i] = max(0.0, idir_t);
+        ydfu[i] = max(0.0, idfu_t);
+    }
+} // end mdlOutputs
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was
+ *    allocated in mdlStart, this is the place to free it.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,439 @@
+/***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * This s-function calculates the angles of NTRACK tracked collectors.
+ * It is the vector form of tracking: all trackers of a collector field
+ * see the same sun, so the sines and cosines of the sun angles are
+ * calculated once per tracking step. The sines and cosines of the axis
+ * angles are calculated once in mdlStart, the loop over the trackers
+ * has only the acos of the transversal incidence angle.
+ * Each tracker has its own tracking type. Single axis trackers (type 1)
+ * turn around the collector riser, a N-S axis has the azimut 0, an E-W
+ * axis the azimut 90. They can be limited to a maximum rotation and
+ * can use backtracking to avoid shading between the rows.
+ * Without backtracking and rotation limit the results are the same as
+ * with one tracking block per collector.
+ *
+ * author list:     hf -> Bernd Hafner
+ *
+ * version: CarnotVersion.MajorVersionOfFunction.SubversionOfFunction
+ * Version  Author  Changes                                         Date
+ * 6.1.0    hf      created                                         19oct2026
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * parameters
+ * index    use                                             units
+ * 0        tracking time                                   s
+ * 1        trackers, matrix NTRACK x 6 with one row per tracker:
+ *          tracking type
+ *              1 = turning around collector riser (single axis)
+ *              2 = turning around vertical axis
+ *              3 = turning around vertical and horizontal axis
+ *              4 = no tracking, fixed surface
+ *          inclination of surface or axis (0 = horizontal) degree
+ *          azimut of surface or axis (0=south, east negativ) degree
+ *          rotation of surface                             degree
+ *          maximum rotation of single axis trackers (0..90) degree
+ *          ground coverage ratio for backtracking (collector width
+ *          / row distance, 0 = no backtracking)            -
+ *
+ * Definiton of INPUTS and OUTPUTS
+ * structure of the input vector
+ * index    use                                             units
+ * 0        ZENITH angle of sun (at time, not averaged)     degree
+ * 1        azimut angle of sun (0=south, east negative)   degree
+ *
+ * structure of the output vector, all ports have the width NTRACK
+ * port  description                                         units
+ *  0    collector inclination angle                         degree
+ *  1    collector azimut angle                              degree
+ *  2    collector rotation angle                            degree
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  L I T E R A T U R E
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * /1/  Lorenzo, Narvarte, Munoz: Tracking and back-tracking, Progress in
+ *      Photovoltaics 19 (2011), p. 747-753
+ */
+
+#define S_FUNCTION_NAME tracking_multi
+#define S_FUNCTION_LEVEL 2
+
+#include "tmwtypes.h"
+#include "simstruc.h"
+#include "carlib.h"
+#include <math.h>
+
+#define ZENITH      u0[0]
+#define AZIMUT      u0[1]
+
+#define TRACKTIME   (*mxGetPr(ssGetSFcnParam(S, 0))) /* time of tracking */
+#define S_TRACKERS  ssGetSFcnParam(S, 1)             /* trackers */
+#define NTRACK      ((int_T)mxGetM(S_TRACKERS))      /* number of trackers */
+#define NTRACKCOL   6
+#define TRACKTYPE(i) mxGetPr(S_TRACKERS)[i]
+#define AXISANGLE(i) mxGetPr(S_TRACKERS)[NTRACK+(i)]
+#define AXISAZIMUT(i) mxGetPr(S_TRACKERS)[2*NTRACK+(i)]
+#define ROTATION(i)  mxGetPr(S_TRACKERS)[3*NTRACK+(i)]
+#define ROTMAX(i)    mxGetPr(S_TRACKERS)[4*NTRACK+(i)]
+#define GCR(i)       mxGetPr(S_TRACKERS)[5*NTRACK+(i)]
+#define NPARAM      2
+
+#define TIME        ssGetT(S)
+
+#define DWORK_OLDTRACKTIME_NO   0   /* time of the last tracking */
+#define DWORK_ANGLES_NO         1   /* inclination, azimut, rotation per tracker */
+#define DWORK_GEOM_NO           2   /* sin and cos of the axis angles */
+#define NGEOM                   6   /* szc, czc, sac, cac, src, crc per tracker */
+#define OLDTRACKTIME            dwork_oldtracktime[0]
+
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      int_T i;
+
+      /* */
+      {
+          if (TRACKTIME <= 0.0) {
+              ssSetErrorStatus(S,"Error in tracking_multi: tracking time must be > 0");
+              return;
+          }
+      }
+      /* */
+      {
+          if (NTRACK < 1 || mxGetN(S_TRACKERS) != NTRACKCOL) {
+              ssSetErrorStatus(S,"Error in tracking_multi: trackers must be a matrix with 6 columns "
+                  "(type, inclination, azimut, rotation, maximum rotation, ground coverage ratio)");
+              return;
+          }
+      }
+      /* */
+      for (i = 0; i < NTRACK; i++)
+      {
+          if (TRACKTYPE(i) < 0.5 || TRACKTYPE(i) > 4.5) {
+              ssSetErrorStatus(S,"Error in tracking_multi: tracking type must be 1, 2, 3 or 4");
+              return;
+          }
+          if (ROTMAX(i) < 0.0 || ROTMAX(i) > 90.0) {
+              ssSetErrorStatus(S,"Error in tracking_multi: maximum rotation must be 0..90");
+              return;
+          }
+          if (GCR(i) < 0.0 || GCR(i) > 1.0) {
+              ssSetErrorStatus(S,"Error in tracking_multi: ground coverage ratio must be 0..1");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T n;
+
+    ssSetNumSFcnParams(S, NPARAM);  /* Number of expected parameters */
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S)) {
+        mdlCheckParameters(S);
+        if(ssGetErrorStatus(S) != NULL) return;
+    } else {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#endif
+    /* the sines and cosines of the axes are calculated in mdlStart */
+    ssSetSFcnParamTunable(S, 0, SS_PRM_NOT_TUNABLE);
+    ssSetSFcnParamTunable(S, 1, SS_PRM_NOT_TUNABLE);
+
+    ssSetNumContStates(S, 0);
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, 2);
+    ssSetInputPortDirectFeedThrough(S, 0, 1);
+    ssSetInputPortRequiredContiguous(S, 0, true); /*direct input signal access*/
+
+    if (!ssSetNumOutputPorts(S, 3)) return;
+    for (n = 0; n < 3; n++)
+        ssSetOutputPortWidth(S, n, NTRACK);
+
+    ssSetNumDWork(S, 3);
+    ssSetDWorkWidth(S, DWORK_OLDTRACKTIME_NO, 1);
+    ssSetDWorkDataType(S, DWORK_OLDTRACKTIME_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_OLDTRACKTIME_NO, "D_OLDTRACKTIME");
+    ssSetDWorkUsageType(S, DWORK_OLDTRACKTIME_NO, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_ANGLES_NO, 3*NTRACK);
+    ssSetDWorkDataType(S, DWORK_ANGLES_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_ANGLES_NO, "D_ANGLES");
+    ssSetDWorkUsageType(S, DWORK_ANGLES_NO, SS_DWORK_USED_AS_DSTATE);
+    ssSetDWorkWidth(S, DWORK_GEOM_NO, NGEOM*NTRACK);
+    ssSetDWorkDataType(S, DWORK_GEOM_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_GEOM_NO, "DWORK_GEOM");
+    ssSetDWorkUsageType(S, DWORK_GEOM_NO, SS_DWORK_USED_AS_DWORK);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+
+    ssSupportsMultipleExecInstances(S, true);
+
+#ifdef  EXCEPTION_FREE_CODE
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+#endif
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    This function is used to specify the sample time(s) for your
+ *    S-function. You must register the same number of sample times as
+ *    specified in ssSetNumSampleTimes.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, TRACKTIME);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Sines and cosines of inclination, azimut and rotation angle of the
+   *    trackers.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      real_T *geom = (real_T *)ssGetDWork(S, DWORK_GEOM_NO);
+      int_T  nt = NTRACK;
+      int_T  i;
+
+      for (i = 0; i < nt; i++)
+      {
+          geom[i]        = sin(DEG2RAD*AXISANGLE(i));  /* szc */
+          geom[nt+i]     = cos(DEG2RAD*AXISANGLE(i));  /* czc */
+          geom[2*nt+i]   = sin(DEG2RAD*AXISAZIMUT(i)); /* sac */
+          geom[3*nt+i]   = cos(DEG2RAD*AXISAZIMUT(i)); /* cac */
+          geom[4*nt+i]   = sin(DEG2RAD*ROTATION(i));   /* src */
+          geom[5*nt+i]   = cos(DEG2RAD*ROTATION(i));   /* crc */
+      }
+  }
+#endif /*  MDL_START */
+
+
+/* set the angles of all trackers to the parameter values */
+static void set_parameter_angles(SimStruct *S, real_T *angles)
+{
+    int_T nt = NTRACK;
+    int_T i;
+
+    for (i = 0; i < nt; i++)
+    {
+        angles[i]      = AXISANGLE(i);
+        angles[nt+i]   = AXISAZIMUT(i);
+        angles[2*nt+i] = ROTATION(i);
+    }
+}
+
+
+#define MDL_INITIALIZE_CONDITIONS
+/* Function: mdlInitializeConditions ==========================================
+ * Abstract:
+ *    Collector angles from the parameters, first tracking at start.
+ */
+static void mdlInitializeConditions(SimStruct *S)
+{
+    real_T *dwork_oldtracktime = (real_T *)ssGetDWork(S, DWORK_OLDTRACKTIME_NO);
+    real_T *angles             = (real_T *)ssGetDWork(S, DWORK_ANGLES_NO);
+
+    OLDTRACKTIME = ssGetTStart(S) - 2.0*TRACKTIME;  /* last tracking was done before starttime -> first tracking at start */
+    set_parameter_angles(S, angles);
+}
+
+
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *    Sines and cosines of the sun angles once, then the loop over the
+ *    trackers.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    const real_T *u0 = ssGetInputPortRealSignal(S, 0);
+    real_T *yangle  = ssGetOutputPortRealSignal(S, 0);
+    real_T *yazimut = ssGetOutputPortRealSignal(S, 1);
+    real_T *yrotate = ssGetOutputPortRealSignal(S, 2);
+    real_T *dwork_oldtracktime = (real_T *)ssGetDWork(S, DWORK_OLDTRACKTIME_NO);
+    real_T *angles = (real_T *)ssGetDWork(S, DWORK_ANGLES_NO);
+    const real_T *geom = (const real_T *)ssGetDWork(S, DWORK_GEOM_NO);
+    int_T  nt = NTRACK;
+    const real_T *szc = geom;
+    const real_T *czc = geom + nt;
+    const real_T *sac = geom + 2*nt;
+    const real_T *cac = geom + 3*nt;
+    const real_T *src = geom + 4*nt;
+    const real_T *crc = geom + 5*nt;
+    real_T *angle1 = angles;
+    real_T *angle2 = angles + nt;
+    real_T *angle3 = angles + 2*nt;
+
+    real_T time = TIME;
+    int_T  i;
+    real_T as, zs, szs, czs, sas, cas, sda, cda, szcda, costeta,
+        tetatrans, gcr, cb;
+
+    if (ZENITH <= -9998.0 || AZIMUT <= -9998.0) /* value is -9999.0, but check for equality with doubles is problematic */
+    {
+        ssSetErrorStatus(S,"Weather data does not include sunposition. "
+            "Use block carnot/weather/set_sun_position.\n");
+        return;
+    }
+
+    if (ZENITH >= 90.0)     /* no sun when zenith angle is 90 or more */
+    {
+        set_parameter_angles(S, angles);
+    }
+    else if (OLDTRACKTIME+TRACKTIME < time)
+    {                       /* sun is there, start tracking */
+        OLDTRACKTIME = time;                /* keep time for next tracking */
+        set_parameter_angles(S, angles);    /* overwriting them with the tracked values later */
+
+        /* ---- sun dependent terms, same for all trackers ---- */
+        zs = DEG2RAD * ZENITH;
+        as = DEG2RAD * AZIMUT;
+        szs = sin(zs);      /* sine zenith angle of sun */
+        czs = cos(zs);      /* cosine zenith angle of sun */
+        sas = sin(as);
+        cas = cos(as);
+
+        /* ---- loop over the trackers ---- */
+        for (i = 0; i < nt; i++)
+        {
+            switch ((int_T)(TRACKTYPE(i)+0.5))
+            {
+                case 1:     /* tracking axis is collector riser = axis of collector rotation */
+                    sda = sac[i]*cas - cac[i]*sas;  /* sin(ac-as) */
+                    cda = cac[i]*cas + sac[i]*sas;  /* cos(ac-as) */
+                    szcda = szc[i]*cda*szs + czc[i]*czs;
+
+                    /* cos of incidence angle on surface */
+                    costeta = src[i]*sda*szs + crc[i]*szcda;
+
+                    /* incidence angle in transversal collector plane (direction header - vertical on collector plane) */
+                    tetatrans = acos(costeta/sqrt(square(crc[i]*sda*szs - src[i]*szcda)
+                        + square(costeta)));
+                    tetatrans = min(RAD2DEG*tetatrans, 90.0);
+
+                    /* backtracking: turn back until the shadow of the
+                     * neighbouring row ends at the edge of the collector /1/ */
+                    gcr = GCR(i);
+                    if (gcr > 0.0)
+                    {
+                        cb = cos(DEG2RAD*tetatrans)/gcr;
+                        if (cb < 1.0)
+                            tetatrans -= RAD2DEG*acos(cb);
+                    }
+                    tetatrans = min(tetatrans, ROTMAX(i));
+                    angle3[i] = (as < 0.0)? -tetatrans : tetatrans; /* negative in the morning */
+                    break;
+                case 2:     /* turn around vertical axis */
+                    angle2[i] = AZIMUT;         /* collector azimut is sun azimut */
+                    break;
+                case 3:     /* turn around vertical and horizontal axis */
+                    angle1[i] = ZENITH;         /* collector inclination is sun zenith angle */
+                    angle2[i] = AZIMUT;         /* collector azimut is sun azimut */
+                    break;
+                case 4: default:    /* no tracking, fixed surface */
+                    /* nothing to do, angles already set */
+                    break;
+            } /* end switch */
+        } /* end for i */
+    } /* end if ZENITH, check for sunset */
+
+    for (i = 0; i < nt; i++)
+    {
+        yangle[i]  = angle1[i];     /* inclination */
+        yazimut[i] = angle2[i];     /* azimuth */
+        yrotate[i] = angle3[i];     /* rotation */
+    }
+} // end mdlOutputs
+
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    In this function, you should perform any actions that are necessary
+ *    at the termination of a simulation.  For example, if memory was
+ *    allocated in mdlStart, this is the place to free it.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+/*======================================================*
+ * See sfuntmpl_doc.c for the optional S-function methods *
+ *======================================================*/
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
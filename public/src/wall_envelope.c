@@ -0,0 +1,579 @@
+/***********************************************************************
+ *  M O D E L    O R    F U N C T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * building envelope: many multinode walls (layerwall) in one block
+ *
+ * Author list
+ *  hf -> Bernd Hafner
+ *
+ * Version  Author  Changes                                     Date
+ * 6.1.0    hf      created from layerwall.c                    19oct2026
+ *
+ ***********************************************************************
+ * This file is part of the CARNOT Blockset.
+ * Copyright (c) 1998-2015, Solar-Institute Juelich of the FH Aachen.
+ * Additional Copyright for this file see list auf authors.
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ * $Revision$
+ * $Author$
+ * $Date$
+ * $HeadURL$
+ ***********************************************************************
+
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  D E S C R I P T I O N
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * The block simulates NWALLS walls with the node model of layerwall.c
+ * (Beuken model, nodes from the carlib function wall_nodes):
+ *
+ * rho*cp*d_node * dT/dt =
+ *        q_outside                               % only first node
+ *      + q_inside                                % only last node
+ *      + cond/d_node * (Tnextnode - Tnode)       % not last node
+ *      + cond/d_node * (Tpreviousnode - Tnode)   % not first node
+ *      + qdot_heating                            % active nodes
+ *
+ * The walls are given as a table: each row of the layer parameters
+ * is one wall, each column one layer. Layers with thickness 0 are not
+ * used, so walls can have a different number of layers.
+ * The states are stored node by node: state n*NWALLS+w is node n of
+ * wall w. All walls have NMAX nodes (the maximum of all walls), the
+ * additional nodes of thinner walls are not coupled and keep their
+ * initial temperature. The coefficients COND/CAP to the left and to the
+ * right are calculated once in mdlStart, so the loop over the walls in
+ * mdlDerivatives has no branches and no divisions and can be vectorised
+ * by the compiler.
+ *
+ *  symbol      used for                                        unit
+ *	cond        effective axial heat conduction                 W/(m*K)
+ *  cp          heat capacity of layer material                 J/(kg*K)
+ *  d_node      distance between two layer nodes                m
+ *  rho         density of layer material                       kg/m
+ *  T           temperature                                     K
+ *  t           time                                            s
+ *  q_          power per surface (positive for energy gain)    W/(m^2)
+ *
+ * parameters
+ *  index   use
+ *  0       time constant TAU (scalar or one per wall)          s
+ *  1       initial temperature (scalar or one per wall)        C
+ *  2       thickness of the layers (NWALLS x NLAYERS)          m
+ *  3       conductivity of the layers (NWALLS x NLAYERS)       W/(m*K)
+ *  4       heat capacity of the layers (NWALLS x NLAYERS)      J/(kg*K)
+ *  5       density of the layers (NWALLS x NLAYERS)            kg/m^3
+ *  6       depth of the active layers (NWALLS x NACTIVE, or    m
+ *          one row for all walls), negative values: no active layer
+ *
+ * structure of u (input ports)
+ *  index   use
+ *  0       power per surface outside node (NWALLS)         W/m^2
+ *  1       power of the active layers (NWALLS*NACTIVE,     W/m^2
+ *          wall after wall)
+ *  2       power per surface inside node (NWALLS)          W/m^2
+ *
+ * structure of y (output ports)
+ *  index   use
+ *  0       temperature outside node (NWALLS)               C
+ *  1       temperature of the active nodes (NWALLS*NACTIVE C
+ *          wall after wall, 0 for unused active layers)
+ *  2       temperature inside node (NWALLS)                C
+ *
+ * Literature:
+ * Feist, W.: Thermische Gebaeudesimulation, Dissertation Uni Kassel,
+ *              Mller 2004
+ */
+
+#define S_FUNCTION_NAME     wall_envelope
+#define S_FUNCTION_LEVEL    2
+
+#include <stdio.h>
+#include <math.h>
+#include "simstruc.h"
+#include "carlib.h"
+
+/*
+ *   Defines for easy access to the parameters
+ *   WPARAM(k,w) returns the value of parameter k for wall w, scalar
+ *   parameters are used for all walls.
+ */
+#define WPARAM(k,w) ((mxGetNumberOfElements(ssGetSFcnParam(S,k)) > 1)? \
+    mxGetPr(ssGetSFcnParam(S,k))[w] : mxGetPr(ssGetSFcnParam(S,k))[0])
+#define TAU(w)          WPARAM(0,w)                 /* time-constant */
+#define TINI(w)         WPARAM(1,w)                 /* initial temperature [C] */
+#define S_DNODE         ssGetSFcnParam(S,2)         /* thickness of layers in m */
+#define S_COND          ssGetSFcnParam(S,3)         /* conductivity [W/(m*K)] */
+#define S_CWALL         ssGetSFcnParam(S,4)         /* capacity [J/(kg*K)] */
+#define S_RHO           ssGetSFcnParam(S,5)         /* density [kg/m^3] */
+#define S_DEPTH         ssGetSFcnParam(S,6)         /* depth of active layers [m] */
+#define NPARAMS         7
+
+#define NWALLS          ((int_T)mxGetM(S_DNODE))    /* number of walls */
+#define NLAYERS         ((int_T)mxGetN(S_DNODE))    /* number of layer columns */
+#define NACTIVE         ((int_T)mxGetN(S_DEPTH))    /* number of active layer columns */
+/* value of wall w in column c of a table, tables with one row for all walls */
+#define TABLE(p,w,c)    ((mxGetM(p) > 1)? mxGetPr(p)[(c)*mxGetM(p)+(w)] : mxGetPr(p)[c])
+
+#define Q_OUTSIDE(w)        (*u0[w])                /* power per surface outside node */
+#define POWER_PER_NODE(w,i) (*u1[(w)*nact+(i)])     /* power of active layer i */
+#define Q_INSIDE(w)         (*u2[w])                /* power per surface inside node */
+
+#define DWORK_CL_NO         0   /* COND/CAP to the left, node by node */
+#define DWORK_CR_NO         1   /* COND/CAP to the right, node by node */
+#define DWORK_INVCAP_NO     2   /* 1/CAP of outside, inside and active nodes */
+#define DWORK_PORT_NO       3   /* last node and active nodes of the walls */
+#define CL(n,w)             cl[(n)*nw+(w)]
+#define CR(n,w)             cr[(n)*nw+(w)]
+#define INVCAP_OUT(w)       invcap[w]
+#define INVCAP_IN(w)        invcap[nw+(w)]
+#define INVCAP_ACT(w,i)     invcap[2*nw+(w)*nact+(i)]
+#define LASTNODE(w)         port[w]
+#define ACTNODE(w,i)        port[nw+(w)*nact+(i)]   /* -1 if not used */
+
+#define MAXLAYERS           20      /* maximum number of layers per wall */
+#define MAX_SUBLAYERS       10      /* sublayers per layer */
+#define MAX_L               (MAXLAYERS*MAX_SUBLAYERS+2) /* maximum number of nodes per wall */
+
+
+/* Function: envelope_wall ====================================================
+ * Abstract:
+ *    Nodes of wall w (carlib function wall_nodes). Returns the number of
+ *    nodes, active(i) is -1 for unused active layers.
+ */
+static int_T envelope_wall(SimStruct *S, int_T w, real_T *cap, real_T *lam, int_T *active)
+{
+    real_T dnode[MAXLAYERS], cond[MAXLAYERS], cwall[MAXLAYERS], rho[MAXLAYERS];
+    real_T depth[MAXLAYERS], work[3*(MAX_L+3)];
+    int    act[MAXLAYERS];
+    int_T  nw = NWALLS, nl = 0, na = 0, l, n;
+
+    for (l = 0; l < NLAYERS; l++)   /* used layers */
+    {
+        if (mxGetPr(S_DNODE)[l*nw+w] > 0.0)
+        {
+            dnode[nl] = mxGetPr(S_DNODE)[l*nw+w];
+            cond[nl]  = mxGetPr(S_COND)[l*nw+w];
+            cwall[nl] = mxGetPr(S_CWALL)[l*nw+w];
+            rho[nl]   = mxGetPr(S_RHO)[l*nw+w];
+            nl++;
+        }
+    }
+    for (l = 0; l < NACTIVE; l++)   /* used active layers */
+    {
+        if (TABLE(S_DEPTH,w,l) >= 0.0)
+        {
+            depth[na] = TABLE(S_DEPTH,w,l);
+            na++;
+        }
+    }
+    n = wall_nodes(dnode, cond, cwall, rho, (int)nl, depth, (int)na, TAU(w),
+        MAX_SUBLAYERS, MAX_L, cap, lam, act, work);
+    na = 0;
+    for (l = 0; l < NACTIVE; l++)
+    {
+        active[l] = (TABLE(S_DEPTH,w,l) >= 0.0)? (int_T)act[na++] : -1;
+    }
+    return n;
+}
+
+
+/* Function: envelope_maxnodes ================================================
+ * Abstract:
+ *    Maximum number of nodes of all walls, -1 if a wall has too many nodes.
+ */
+static int_T envelope_maxnodes(SimStruct *S)
+{
+    real_T cap[MAX_L], lam[MAX_L+1];
+    int_T  active[MAXLAYERS], w, n, nmax = 0;
+
+    for (w = 0; w < NWALLS; w++)
+    {
+        n = envelope_wall(S, w, cap, lam, active);
+        if (n < 0)
+        {
+            return -1;
+        }
+        nmax = max(nmax, n);
+    }
+    return nmax;
+}
+
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+static void mdlCheckParameters(SimStruct *S)
+{
+    int_T  nw = NWALLS, w, l, nl;
+    real_T sum, dlast;
+
+    if (nw < 1 || NLAYERS < 1)
+    {
+        ssSetErrorStatus(S, "Error in wall_envelope: no walls defined");
+        return;
+    }
+    if (NLAYERS > MAXLAYERS || NACTIVE > MAXLAYERS)
+    {
+        ssSetErrorStatus(S, "Error in wall_envelope: too many layers or active layers. "
+            "Recompile wall_envelope.c with higher number for MAXLAYERS.");
+        return;
+    }
+    for (l = 3; l <= 5; l++)
+    {
+        if (mxGetM(ssGetSFcnParam(S,l)) != mxGetM(S_DNODE)
+            || mxGetN(ssGetSFcnParam(S,l)) != mxGetN(S_DNODE))
+        {
+            ssSetErrorStatus(S, "Error in wall_envelope: thickness, conductivity, heat capacity "
+                "and density must be tables of the same size (one row per wall)");
+            return;
+        }
+    }
+    for (l = 0; l <= 1; l++)
+    {
+        if (mxGetNumberOfElements(ssGetSFcnParam(S,l)) != 1
+            && (int_T)mxGetNumberOfElements(ssGetSFcnParam(S,l)) != nw)
+        {
+            ssSetErrorStatus(S, "Error in wall_envelope: time constant and initial temperature "
+                "must be scalars or have one value per wall");
+            return;
+        }
+    }
+    if (mxGetM(S_DEPTH) != 1 && (int_T)mxGetM(S_DEPTH) != nw)
+    {
+        ssSetErrorStatus(S, "Error in wall_envelope: depth of active layers must have one row "
+            "or one row per wall");
+        return;
+    }
+
+    for (w = 0; w < nw; w++)
+    {
+        if (TAU(w) <= 0.0)
+        {
+            ssSetErrorStatus(S, "Error in wall_envelope: time-constant must be > 0 s");
+            return;
+        }
+        sum = 0.0;
+        nl = 0;
+        for (l = 0; l < NLAYERS; l++)
+        {
+            if (mxGetPr(S_DNODE)[l*nw+w] > 0.0)
+            {
+                if (mxGetPr(S_COND)[l*nw+w] < 0.0)
+                {
+                    ssSetErrorStatus(S, "Error in wall_envelope: heat conductivity must be >= 0");
+                    return;
+                }
+                if (mxGetPr(S_CWALL)[l*nw+w] <= 0.0 || mxGetPr(S_RHO)[l*nw+w] <= 0.0)
+                {
+                    ssSetErrorStatus(S, "Error in wall_envelope: heat capacity and density must be > 0");
+                    return;
+                }
+                sum += mxGetPr(S_DNODE)[l*nw+w];
+                nl++;
+            }
+        }
+        if (nl == 0)
+        {
+            ssSetErrorStatus(S, "Error in wall_envelope: each wall needs at least one layer with thickness > 0");
+            return;
+        }
+        dlast = 0.0;
+        for (l = 0; l < NACTIVE; l++)
+        {
+            if (TABLE(S_DEPTH,w,l) >= 0.0)
+            {
+                if (TABLE(S_DEPTH,w,l) < dlast)
+                {
+                    ssSetErrorStatus(S, "Error in wall_envelope: depth of active layers must be monotonicaly increasing.");
+                    return;
+                }
+                if (TABLE(S_DEPTH,w,l) > sum)
+                {
+                    ssSetErrorStatus(S, "Error in wall_envelope: position of active layer is outside of wall.");
+                    return;
+                }
+                dlast = TABLE(S_DEPTH,w,l);
+            }
+        }
+    }
+}
+#endif /* MDL_CHECK_PARAMETERS */
+
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *   Setup sizes of the various vectors.
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    int_T nw, nmax;
+
+    ssSetNumSFcnParams(S, NPARAMS);
+#if defined(MATLAB_MEX_FILE)
+    if (ssGetNumSFcnParams(S) == ssGetSFcnParamsCount(S))
+	{
+        mdlCheckParameters(S);
+        if (ssGetErrorStatus(S) != NULL)
+		{
+            return;
+        }
+    }
+	else
+	{
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+#endif
+    nw = NWALLS;
+    nmax = envelope_maxnodes(S);
+    if (nmax < 0)
+    {
+        ssSetErrorStatus(S, "Error in wall_envelope: number of nodes of a wall exceeded");
+        return;
+    }
+
+    ssSetNumContStates(S, nmax*nw);  /* all nodes of all walls */
+    ssSetNumDiscStates(S, 0);
+
+    if (!ssSetNumInputPorts(S, 3))
+	{
+		return;
+	}
+    ssSetInputPortWidth(S, 0, nw);
+    ssSetInputPortDirectFeedThrough(S, 0, 0);
+    ssSetInputPortWidth(S, 1, nw*NACTIVE);
+    ssSetInputPortDirectFeedThrough(S, 1, 0);
+    ssSetInputPortWidth(S, 2, nw);
+    ssSetInputPortDirectFeedThrough(S, 2, 0);
+
+    if (!ssSetNumOutputPorts(S, 3))
+	{
+		return;
+	}
+    ssSetOutputPortWidth(S, 0, nw);
+    ssSetOutputPortWidth(S, 1, nw*NACTIVE);
+    ssSetOutputPortWidth(S, 2, nw);
+
+    ssSetNumSampleTimes(S, 1);
+
+    ssSetNumIWork(S, 0);
+	ssSetNumRWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+	ssSetNumDWork(S, 4);
+    ssSetDWorkWidth(S, DWORK_CL_NO, nmax*nw);
+    ssSetDWorkDataType(S, DWORK_CL_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CL_NO, "DWORK_CL");
+    ssSetDWorkUsageType(S, DWORK_CL_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_CR_NO, nmax*nw);
+    ssSetDWorkDataType(S, DWORK_CR_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_CR_NO, "DWORK_CR");
+    ssSetDWorkUsageType(S, DWORK_CR_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_INVCAP_NO, nw*(2+NACTIVE));
+    ssSetDWorkDataType(S, DWORK_INVCAP_NO, SS_DOUBLE);
+    ssSetDWorkName(S, DWORK_INVCAP_NO, "DWORK_INVCAP");
+    ssSetDWorkUsageType(S, DWORK_INVCAP_NO, SS_DWORK_USED_AS_DWORK);
+    ssSetDWorkWidth(S, DWORK_PORT_NO, nw*(1+NACTIVE));
+    ssSetDWorkDataType(S, DWORK_PORT_NO, SS_INT32);
+    ssSetDWorkName(S, DWORK_PORT_NO, "DWORK_PORT");
+    ssSetDWorkUsageType(S, DWORK_PORT_NO, SS_DWORK_USED_AS_DWORK);
+
+    /* Take care when specifying exception free code - see sfuntmpl.doc */
+    /* ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE); */
+
+	ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    ssSetSimStateVisibility(S, 1);
+    ssSupportsMultipleExecInstances(S, true);
+}
+
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Continuous sample time.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+
+#define MDL_START
+/* Function: mdlStart =======================================================
+ * Abstract:
+ *    Nodes of all walls and the constant coefficients COND/CAP.
+ */
+static void mdlStart(SimStruct *S)
+{
+	real_T  *cl     = (real_T  *)ssGetDWork(S, DWORK_CL_NO);
+	real_T  *cr     = (real_T  *)ssGetDWork(S, DWORK_CR_NO);
+	real_T  *invcap = (real_T  *)ssGetDWork(S, DWORK_INVCAP_NO);
+	int32_T *port   = (int32_T *)ssGetDWork(S, DWORK_PORT_NO);
+    real_T  cap[MAX_L], lam[MAX_L+1];
+    int_T   active[MAXLAYERS];
+    int_T   nw = NWALLS, nact = NACTIVE, nmax, w, n, i, nonodes;
+
+    nmax = ssGetNumContStates(S)/nw;
+    for (w = 0; w < nw; w++)
+    {
+        nonodes = envelope_wall(S, w, cap, lam, active);
+        for (n = 0; n < nmax; n++)
+        {
+            if (n < nonodes)
+            {   /* lam[0] and lam[nonodes] are 0 (adiabatic ends) */
+                CL(n,w) = lam[n]/cap[n];
+                CR(n,w) = lam[n+1]/cap[n];
+            }
+            else
+            {   /* additional node of a thinner wall */
+                CL(n,w) = 0.0;
+                CR(n,w) = 0.0;
+            }
+        }
+        LASTNODE(w) = (int32_T)(nonodes-1);
+        INVCAP_OUT(w) = 1.0/cap[0];
+        INVCAP_IN(w) = 1.0/cap[nonodes-1];
+        for (i = 0; i < nact; i++)
+        {
+            ACTNODE(w,i) = (int32_T)active[i];
+            INVCAP_ACT(w,i) = (active[i] >= 0)? 1.0/cap[active[i]] : 0.0;
+        }
+    }
+}
+
+
+#define MDL_INITIALIZE_CONDITIONS
+/* Function: mdlInitializeConditions ========================================
+ * Abstract:
+ *    Initialize the node temperatures with TINI of the wall
+ */
+static void mdlInitializeConditions(SimStruct *S)
+{
+    real_T *x0 = ssGetContStates(S);
+    int_T  nw = NWALLS, nmax = ssGetNumContStates(S)/nw, n, w;
+
+    for (n = 0; n < nmax; n++)
+	{
+        for (w = 0; w < nw; w++)
+        {
+            x0[n*nw+w] = TINI(w);
+        }
+	}
+}
+
+
+/* Function: mdlOutputs =======================================================
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T  *y0   = ssGetOutputPortRealSignal(S, 0);
+    real_T  *y1   = ssGetOutputPortRealSignal(S, 1);
+    real_T  *y2   = ssGetOutputPortRealSignal(S, 2);
+    real_T  *Tn   = ssGetContStates(S);
+	int32_T *port = (int32_T *)ssGetDWork(S, DWORK_PORT_NO);
+    int_T   nw = NWALLS, nact = NACTIVE, w, i;
+
+    for (w = 0; w < nw; w++)
+    {
+        y0[w] = Tn[w];                          /* temperature first node */
+        y2[w] = Tn[LASTNODE(w)*nw+w];           /* temperature last node */
+        for (i = 0; i < nact; i++)              /* active layers */
+        {
+            y1[w*nact+i] = (ACTNODE(w,i) >= 0)? Tn[ACTNODE(w,i)*nw+w] : 0.0;
+        }
+    }
+}
+
+
+#define MDL_DERIVATIVES
+/* Function: mdlDerivatives =================================================
+ * Abstract:
+ *      xdot = Ax + Bu
+ */
+static void mdlDerivatives(SimStruct *S)
+{
+    real_T            *dTdt = ssGetdX(S);
+    real_T            *Tn   = ssGetContStates(S);
+    InputRealPtrsType u0    = ssGetInputPortRealSignalPtrs(S, 0);
+    InputRealPtrsType u1    = ssGetInputPortRealSignalPtrs(S, 1);
+    InputRealPtrsType u2    = ssGetInputPortRealSignalPtrs(S, 2);
+	real_T            *cl     = (real_T  *)ssGetDWork(S, DWORK_CL_NO);
+	real_T            *cr     = (real_T  *)ssGetDWork(S, DWORK_CR_NO);
+	real_T            *invcap = (real_T  *)ssGetDWork(S, DWORK_INVCAP_NO);
+	int32_T           *port   = (int32_T *)ssGetDWork(S, DWORK_PORT_NO);
+    int_T nw = NWALLS, nact = NACTIVE, nmax = ssGetNumContStates(S)/nw, n, w, i, k;
+
+    /* conduction: first node, inner nodes, last node of all walls */
+    for (w = 0; w < nw; w++)
+    {
+        dTdt[w] = CR(0,w)*(Tn[nw+w]-Tn[w]);
+    }
+    for (n = 1; n < nmax-1; n++)
+    {
+        for (w = 0; w < nw; w++)
+        {
+            k = n*nw+w;
+            dTdt[k] = cl[k]*(Tn[k-nw]-Tn[k]) + cr[k]*(Tn[k+nw]-Tn[k]);
+        }
+    }
+    for (w = 0; w < nw; w++)
+    {
+        k = (nmax-1)*nw+w;
+        dTdt[k] = cl[k]*(Tn[k-nw]-Tn[k]);
+    }
+
+    /* boundaries and active layers */
+    for (w = 0; w < nw; w++)
+    {
+        dTdt[w] += Q_OUTSIDE(w)*INVCAP_OUT(w);
+        dTdt[LASTNODE(w)*nw+w] += Q_INSIDE(w)*INVCAP_IN(w);
+        for (i = 0; i < nact; i++)
+        {
+            if (ACTNODE(w,i) >= 0)
+            {
+                dTdt[ACTNODE(w,i)*nw+w] += POWER_PER_NODE(w,i)*INVCAP_ACT(w,i);
+            }
+        }
+    }
+}
+
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+}
+
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif